@@ -53,6 +53,9 @@
 #ifndef _STRING_H
 #include <string.h>
 #endif
+#ifndef _CTYPE_H_
+#include <ctype.h>
+#endif
 #ifndef _LIBGEN_H
 #include <libgen.h>
 #endif
@@ -63,6 +66,9 @@
 #endif
 
 //Project #includes
+#ifndef ___CONTEXT_H___
+#include "context.h"
+#endif
 #ifndef ___LOG_H___
 #include "log.h"
 #endif
@@ -78,33 +84,65 @@
 
 //------------------------------------------------------------------------------
 //Static Data
-static char* s_cpPassedFilePath = NULL;
-static char* s_cpPassedFileName = NULL;
-static char* s_cpArgumentCopy = NULL;
-static char* s_cpPassedBaseFileName = NULL;
+static char** s_cppSourceFiles = NULL;
+static uint32_t s_iNumberOfSourceFiles = 0;
+static uint32_t s_iSourceFilesCapacity = 0;
+
+//The pipe names given with the serve and connect options, or NULL.
+static char* s_cpServePipeName = NULL;
+static char* s_cpConnectPipeName = NULL;
+
+//The manifest given with the build option, or NULL.
+static char* s_cpBuildManifest = NULL;
 
-static uint8_t s_bIsListingFileEnabled = TRUE;
-static uint8_t s_bIsSymbolTableEnabled = TRUE;
+//Set by the watch option.
+static uint8_t s_bIsWatchEnabled = FALSE;
+
+//The options from the command line.  Every assembler context starts out with a
+//copy of these.
+static AssemblerOptions s_commandLineOptions;
+
+//The options before the command line is processed.
+static const AssemblerOptions s_defaultOptions =
+{
+    TRUE,   //m_bIsListingFileEnabled
+    TRUE,   //m_bIsSymbolTableEnabled
+    FALSE,  //m_bIsStatisticsEnabled
+    FALSE,  //m_bIsDirectPageEnabled
+    0,      //m_iDirectPage
+    1       //m_iMaxErrors
+};
 
 static const struct option s_aLongOptions[] =
 {
+    {"build", required_argument, NULL, 'b'},
+    {"connect", required_argument, NULL, 'C'},
+    {"direct-page", required_argument, NULL, 'd'},
     {"help", no_argument, NULL, 'h'},
+    {"max-errors", required_argument, NULL, 'e'},
     {"listing-file", required_argument, NULL, 'l'},
+    {"serve", required_argument, NULL, 'S'},
     {"symbol-table", required_argument, NULL, 's'},
+    {"statistics", no_argument, NULL, 't'},
     {"version", no_argument, NULL, 'v'},
+    {"watch", no_argument, NULL, 'w'},
     {NULL, 0, NULL, 0}
 };
 
 //------------------------------------------------------------------------------
 //Static Prototypes
-static int parse_passed_file_path_and_name(const char* cpArgument);
+static int add_source_file(const char* cpArgument, size_t iLength);
+static int read_response_file(const char* cpResponseFile);
+static int parse_passed_file_path_and_name(AssemblerContext* pContext, const char* cpArgument);
 static void display_usage(void);
 
 //==============================================================================
 //Functions
 /*------------------------------------------------------------------------------
  * Function name:  process_arguments
- * Function Description:  Processes the arguments passed to the program.
+ * Function Description:  Processes the arguments passed to the program.  It
+ *                        can be called again, after free_argument_memory(), to
+ *                        process another command line.
  * Parameters:
  * iArgc - Number of arguments passed to the program.
  * acpArgv - Array of character pointers passed to the program.
@@ -117,19 +155,72 @@ int process_arguments(int iArgc, char* acpArgv[])
 
     extern int optind;
 
+    char* cpEnd;
+
     int iOption;
 
-    //Initialize variables.
-    s_cpPassedFilePath = NULL;
-    s_cpPassedFileName = NULL;
-    s_cpArgumentCopy = NULL;
-    s_cpPassedBaseFileName = NULL;
+    unsigned long iMaxErrors;
+    unsigned long iDirectPage;
+
+    int iReturnValue;
+
+    //Start from the defaults.  An option index of zero has getopt_long() start
+    //over on a new command line.
+    s_commandLineOptions = s_defaultOptions;
+    s_cpServePipeName = NULL;
+    s_cpConnectPipeName = NULL;
+    s_cpBuildManifest = NULL;
+    s_bIsWatchEnabled = FALSE;
+    optind = 0;
 
     //Parse the options until there are none left or an error is encountered.
-    while((iOption = getopt_long(iArgc, acpArgv, "hl:s:v", s_aLongOptions, NULL)) != -1)
+    while((iOption = getopt_long(iArgc, acpArgv, "b:C:d:e:hl:S:s:tvw", s_aLongOptions, NULL)) != -1)
     {
         switch(iOption)
         {
+            case 'b' :
+                //Build option.  The source files are the modules of the
+                //manifest.
+                s_cpBuildManifest = optarg;
+                break;
+            case 'C' :
+                //Connect option.  The command line is assembled by the server
+                //on the named pipe.
+                s_cpConnectPipeName = optarg;
+                break;
+            case 'd' :
+                //Direct page option.  Should be the page, 0 to 255, that the
+                //direct page register will hold.
+                iDirectPage = strtoul(optarg, &cpEnd, 10);
+                if(optarg[0] >= '0' && optarg[0] <= '9' && *cpEnd == '\0' && iDirectPage <= UINT8_MAX)
+                {
+                    s_commandLineOptions.m_bIsDirectPageEnabled = TRUE;
+                    s_commandLineOptions.m_iDirectPage = (uint8_t)iDirectPage;
+                }
+                else
+                {
+                    //Unknown argument.
+                    print_error(__func__, UnknownDirectPageOptionArgument);
+                    display_usage();
+                    return -UnknownDirectPageOptionArgument;
+                }
+                break;
+            case 'e' :
+                //Maximum number of errors option.  Should be a whole number
+                //where zero means there is no maximum.
+                iMaxErrors = strtoul(optarg, &cpEnd, 10);
+                if(optarg[0] >= '0' && optarg[0] <= '9' && *cpEnd == '\0' && iMaxErrors <= UINT32_MAX)
+                {
+                    s_commandLineOptions.m_iMaxErrors = (uint32_t)iMaxErrors;
+                }
+                else
+                {
+                    //Unknown argument.
+                    print_error(__func__, UnknownMaxErrorsOptionArgument);
+                    display_usage();
+                    return -UnknownMaxErrorsOptionArgument;
+                }
+                break;
             case 'h' :
                 //Help request.  Print usage and return.
                 display_usage();
@@ -140,12 +231,12 @@ int process_arguments(int iArgc, char* acpArgv[])
                 if(strcasecmp(optarg, "LIST") == 0)
                 {
                     //Enable listing file.
-                    s_bIsListingFileEnabled = TRUE;
+                    s_commandLineOptions.m_bIsListingFileEnabled = TRUE;
                 }
                 else if(strcasecmp(optarg, "NOLIST") == 0)
                 {
                     //Disable listing file.
-                    s_bIsListingFileEnabled = FALSE;
+                    s_commandLineOptions.m_bIsListingFileEnabled = FALSE;
                 }
                 else
                 {
@@ -155,18 +246,23 @@ int process_arguments(int iArgc, char* acpArgv[])
                     return -UnknownListingFileOptionArgument;
                 }
                 break;
+            case 'S' :
+                //Serve option.  Assemble the command lines of clients on the
+                //named pipe.
+                s_cpServePipeName = optarg;
+                break;
             case 's' :
                 //Symbol table option.  Should be a string of either "YES" or
                 //"NO".
                 if(strcasecmp(optarg, "SYM") == 0)
                 {
                     //Enable listing file.
-                    s_bIsSymbolTableEnabled = TRUE;
+                    s_commandLineOptions.m_bIsSymbolTableEnabled = TRUE;
                 }
                 else if(strcasecmp(optarg, "NOSYM") == 0)
                 {
                     //Disable listing file.
-                    s_bIsSymbolTableEnabled = FALSE;
+                    s_commandLineOptions.m_bIsSymbolTableEnabled = FALSE;
                 }
                 else
                 {
@@ -176,11 +272,19 @@ int process_arguments(int iArgc, char* acpArgv[])
                     return -UnknownSymbolTableOptionArgument;
                 }
                 break;
+            case 't' :
+                //Statistics option.
+                s_commandLineOptions.m_bIsStatisticsEnabled = TRUE;
+                break;
             case 'v' :
                 //Print version number.
                 printf("NANOCORE ASSEMBLER %s\n", VERSION);
                 return 1;
                 break;
+            case 'w' :
+                //Watch option.
+                s_bIsWatchEnabled = TRUE;
+                break;
             default :
                 //Unknown option so print the error, display the usage and
                 //return with the error.
@@ -191,10 +295,37 @@ int process_arguments(int iArgc, char* acpArgv[])
         }
     }
 
-    //We are done parsing options and if we are here there were no errors.  The
-    //option index should be one less than the argument count since the last
-    //remaining argument is the file path and name.
-    if((optind + 1) != iArgc)
+    //We are done parsing options and if we are here there were no errors.  A
+    //server takes its source files from its clients so it can't have any of
+    //its own, and it can't be a client as well.
+    if(s_cpServePipeName != NULL)
+    {
+        if(optind < iArgc || s_cpConnectPipeName != NULL || s_cpBuildManifest != NULL || s_bIsWatchEnabled == TRUE)
+        {
+            print_error(__func__, MalformedCommandLine);
+            display_usage();
+            return -MalformedCommandLine;
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+    //A build takes its source files from the manifest.
+    if(s_cpBuildManifest != NULL)
+    {
+        if(optind < iArgc || s_bIsWatchEnabled == TRUE)
+        {
+            print_error(__func__, MalformedCommandLine);
+            display_usage();
+            return -MalformedCommandLine;
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+    //The remaining arguments are the source files, at least one is needed.
+    //The files are watched here, not by a server.
+    if(optind >= iArgc || (s_bIsWatchEnabled == TRUE && s_cpConnectPipeName != NULL))
     {
         //The option index is not what was expected so print the error, display
         //the usage and set the return value.
@@ -203,43 +334,117 @@ int process_arguments(int iArgc, char* acpArgv[])
         return -MalformedCommandLine;
     }
 
-    //The option index is what it is suppose to be so pass the final argument to
-    //the parser for the file path and name.
-    return parse_passed_file_path_and_name(acpArgv[(uint32_t)iArgc - 1]);
+    //Collect the source files.  An argument starting with '@' is a response
+    //file which holds more source files, one per line.
+    for(; optind < iArgc; optind++)
+    {
+        if(acpArgv[optind][0] == RESPONSE_FILE_PREFIX)
+            iReturnValue = read_response_file(acpArgv[optind] + 1);
+        else
+            iReturnValue = add_source_file(acpArgv[optind], strlen(acpArgv[optind]));
+
+        if(iReturnValue != EXIT_SUCCESS)
+            return iReturnValue;
+    }
+
+    //A response file may not have had any source files in it.
+    if(s_iNumberOfSourceFiles == 0)
+    {
+        print_error(__func__, MalformedCommandLine);
+        display_usage();
+        return -MalformedCommandLine;
+    }
+
+    return EXIT_SUCCESS;
 }
 
 /*------------------------------------------------------------------------------
  * Function name:  is_listing_file_enabled
  * Function Description:  Getter function for the listing file option.
- * Parameters:  None.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
  * Returns:  TRUE if the listing file is to be printed and FALSE otherwise.
 ------------------------------------------------------------------------------*/
-uint8_t is_listing_file_enabled(void)
+uint8_t is_listing_file_enabled(AssemblerContext* pContext)
 {
-    return s_bIsListingFileEnabled;
+    return pContext->m_arguments.m_options.m_bIsListingFileEnabled;
 }
 
 /*------------------------------------------------------------------------------
  * Function name:  is_symbol_table_enabled
  * Function Description:  Getter function for the symbol table option.
- * Parameters:  None.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
  * Returns:  TRUE if the symbol table is to be printed and FALSE otherwise.
 ------------------------------------------------------------------------------*/
-uint8_t is_symbol_table_enabled(void)
+uint8_t is_symbol_table_enabled(AssemblerContext* pContext)
+{
+    return pContext->m_arguments.m_options.m_bIsSymbolTableEnabled;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  is_direct_page_enabled
+ * Function Description:  Getter function for the direct page option.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  TRUE if absolute operands within the direct page should use the
+ *           direct page form, otherwise FALSE.
+------------------------------------------------------------------------------*/
+uint8_t is_direct_page_enabled(AssemblerContext* pContext)
 {
-    return s_bIsSymbolTableEnabled;
+    return pContext->m_arguments.m_options.m_bIsDirectPageEnabled;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  get_direct_page
+ * Function Description:  Getter function for the page given with the direct
+ *                        page option.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  The direct page.
+------------------------------------------------------------------------------*/
+uint8_t get_direct_page(AssemblerContext* pContext)
+{
+    return pContext->m_arguments.m_options.m_iDirectPage;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  is_statistics_enabled
+ * Function Description:  Getter function for the statistics option.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  TRUE if assembly statistics should be printed, otherwise FALSE.
+------------------------------------------------------------------------------*/
+uint8_t is_statistics_enabled(AssemblerContext* pContext)
+{
+    return pContext->m_arguments.m_options.m_bIsStatisticsEnabled;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  get_max_errors
+ * Function Description:  Getter function for the maximum number of errors
+ *                        option.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  The number of errors after which the assembly stops, or zero if
+ *           there is no maximum.
+------------------------------------------------------------------------------*/
+uint32_t get_max_errors(AssemblerContext* pContext)
+{
+    return pContext->m_arguments.m_options.m_iMaxErrors;
 }
 
 /*------------------------------------------------------------------------------
  * Function name:  get_assembly_source_file_path
  * Function Description:  Getter function for the assembly source file path that
  *                        was passed to the program.
- * Parameters:  None.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
  * Returns:  Character pointer to the path.
 ------------------------------------------------------------------------------*/
-const char* get_assembly_source_file_path(void)
+const char* get_assembly_source_file_path(AssemblerContext* pContext)
 {
-    return (const char*)s_cpPassedFilePath;
+    return (const char*)pContext->m_arguments.m_cpPassedFilePath;
 }
 
 /*------------------------------------------------------------------------------
@@ -247,12 +452,13 @@ const char* get_assembly_source_file_path(void)
  * Function Description:  Getter function for the assembly source file name that
  *                        was passed to the program.  This is the full file name
  *                        that contains both the base and extension.
- * Parameters:  None.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
  * Returns:  Character pointer to the path.
 ------------------------------------------------------------------------------*/
-const char* get_assembly_source_full_file_name(void)
+const char* get_assembly_source_full_file_name(AssemblerContext* pContext)
 {
-    return (const char*)s_cpPassedFileName;
+    return (const char*)pContext->m_arguments.m_cpPassedFileName;
 }
 
 /*------------------------------------------------------------------------------
@@ -260,12 +466,189 @@ const char* get_assembly_source_full_file_name(void)
  * Function Description:  Getter function for the assembly source file name that
  *                        was passed to the program.  This only returns the base
  *                        portion of the file name without the extension.
- * Parameters:  None.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
  * Returns:  Character pointer to the path.
 ------------------------------------------------------------------------------*/
-const char* get_assembly_source_base_file_name(void)
+const char* get_assembly_source_base_file_name(AssemblerContext* pContext)
+{
+    return (pContext->m_arguments.m_cpPassedBaseFileName != NULL) ? (const char*)pContext->m_arguments.m_cpPassedBaseFileName : (const char*)pContext->m_arguments.m_cpPassedFileName;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  get_number_of_source_files
+ * Function Description:  Getter function for the number of source files passed
+ *                        to the program, including those in response files.
+ * Parameters:  None.
+ * Returns:  The number of source files.
+------------------------------------------------------------------------------*/
+uint32_t get_number_of_source_files(void)
+{
+    return s_iNumberOfSourceFiles;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  get_source_file_argument
+ * Function Description:  Getter function for a source file as it was passed to
+ *                        the program.
+ * Parameters:
+ * iIndex - The index of the source file.
+ * Returns:  Character pointer to the path and file name.
+------------------------------------------------------------------------------*/
+const char* get_source_file_argument(uint32_t iIndex)
+{
+    return (const char*)s_cppSourceFiles[iIndex];
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  get_serve_pipe_name
+ * Function Description:  Getter function for the serve option.
+ * Parameters:  None.
+ * Returns:  Character pointer to the name of the pipe to serve on, or NULL if
+ *           the program isn't a server.
+------------------------------------------------------------------------------*/
+const char* get_serve_pipe_name(void)
+{
+    return (const char*)s_cpServePipeName;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  get_connect_pipe_name
+ * Function Description:  Getter function for the connect option.
+ * Parameters:  None.
+ * Returns:  Character pointer to the name of the server's pipe, or NULL if the
+ *           program isn't a client.
+------------------------------------------------------------------------------*/
+const char* get_connect_pipe_name(void)
+{
+    return (const char*)s_cpConnectPipeName;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  get_build_manifest_name
+ * Function Description:  Getter function for the build option.
+ * Parameters:  None.
+ * Returns:  Character pointer to the path and file name of the build manifest,
+ *           or NULL if there is no build.
+------------------------------------------------------------------------------*/
+const char* get_build_manifest_name(void)
 {
-    return (s_cpPassedBaseFileName != NULL) ? (const char*)s_cpPassedBaseFileName : (const char*)s_cpPassedFileName;
+    return (const char*)s_cpBuildManifest;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  is_watch_enabled
+ * Function Description:  Getter function for the watch option.
+ * Parameters:  None.
+ * Returns:  TRUE if the source files are to be watched and assembled again when
+ *           they change, otherwise FALSE.
+------------------------------------------------------------------------------*/
+uint8_t is_watch_enabled(void)
+{
+    return s_bIsWatchEnabled;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  copy_command_line_options
+ * Function Description:  Gives an assembler context the options that were
+ *                        passed on the command line.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+void copy_command_line_options(AssemblerContext* pContext)
+{
+    pContext->m_arguments.m_options = s_commandLineOptions;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  select_source_file
+ * Function Description:  Makes one of the passed source files the one that is
+ *                        assembled.  The path and file name getters then return
+ *                        the parts of this file.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * iIndex - The index of the source file.
+ * Returns:  Zero for success and a negative number for failure.
+------------------------------------------------------------------------------*/
+int select_source_file(AssemblerContext* pContext, uint32_t iIndex)
+{
+    free_source_file_names(pContext);
+
+    return parse_passed_file_path_and_name(pContext, s_cppSourceFiles[iIndex]);
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  select_source_name
+ * Function Description:  Makes a name the name of the source that is assembled,
+ *                        for a source that isn't one of the passed files.  The
+ *                        path and file name getters then return the parts of
+ *                        the name.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * cpName - The path and file name of the source.
+ * Returns:  Zero for success and a negative number for failure.
+------------------------------------------------------------------------------*/
+int select_source_name(AssemblerContext* pContext, const char* cpName)
+{
+    free_source_file_names(pContext);
+
+    return parse_passed_file_path_and_name(pContext, cpName);
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  get_default_options
+ * Function Description:  Gets the options an assembly is done with when none
+ *                        are passed on the command line.
+ * Parameters:
+ * pOptions - Pointer to where to store the options.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+void get_default_options(AssemblerOptions* pOptions)
+{
+    *pOptions = s_defaultOptions;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  set_assembly_options
+ * Function Description:  Gives an assembler context options of its own in place
+ *                        of the ones passed on the command line.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * pOptions - Pointer to the options, or NULL for the defaults.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+void set_assembly_options(AssemblerContext* pContext, const AssemblerOptions* pOptions)
+{
+    pContext->m_arguments.m_options = (pOptions != NULL) ? *pOptions : s_defaultOptions;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  free_source_file_names
+ * Function Description:  Frees the path and file names of the source file an
+ *                        assembler context is assembling.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+void free_source_file_names(AssemblerContext* pContext)
+{
+    if(pContext->m_arguments.m_cpPassedFilePath != NULL)
+        free(pContext->m_arguments.m_cpPassedFilePath);
+
+    if(pContext->m_arguments.m_cpPassedFileName != NULL)
+        free(pContext->m_arguments.m_cpPassedFileName);
+
+    if(pContext->m_arguments.m_cpArgumentCopy != NULL)
+        free(pContext->m_arguments.m_cpArgumentCopy);
+
+    if(pContext->m_arguments.m_cpPassedBaseFileName != NULL)
+        free(pContext->m_arguments.m_cpPassedBaseFileName);
+
+    pContext->m_arguments.m_cpPassedFilePath = NULL;
+    pContext->m_arguments.m_cpPassedFileName = NULL;
+    pContext->m_arguments.m_cpArgumentCopy = NULL;
+    pContext->m_arguments.m_cpPassedBaseFileName = NULL;
 }
 
 /*------------------------------------------------------------------------------
@@ -277,17 +660,137 @@ const char* get_assembly_source_base_file_name(void)
 ------------------------------------------------------------------------------*/
 void free_argument_memory(void)
 {
-    if(s_cpPassedFilePath != NULL)
-        free(s_cpPassedFilePath);
+    uint32_t iIndex;
 
-    if(s_cpPassedFileName != NULL)
-        free(s_cpPassedFileName);
+    for(iIndex = 0; iIndex < s_iNumberOfSourceFiles; iIndex++)
+        free(s_cppSourceFiles[iIndex]);
 
-    if(s_cpArgumentCopy != NULL)
-        free(s_cpArgumentCopy);
+    if(s_cppSourceFiles != NULL)
+        free(s_cppSourceFiles);
 
-    if(s_cpPassedBaseFileName != NULL)
-        free(s_cpPassedBaseFileName);
+    s_cppSourceFiles = NULL;
+    s_iNumberOfSourceFiles = 0;
+    s_iSourceFilesCapacity = 0;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  add_source_file
+ * Function Description:  Adds a copy of a source file path and name to the list
+ *                        of source files to assemble.
+ * Parameters:
+ * cpArgument - Character pointer to the path and file name.
+ * iLength - The number of characters in the path and file name.
+ * Returns:  Zero for success and a negative number for failure.
+------------------------------------------------------------------------------*/
+static int add_source_file(const char* cpArgument, size_t iLength)
+{
+    char** cppNewSourceFiles;
+
+    if(s_iNumberOfSourceFiles == s_iSourceFilesCapacity)
+    {
+        s_iSourceFilesCapacity = (s_iSourceFilesCapacity == 0) ? SOURCE_FILES_INITIAL_CAPACITY : s_iSourceFilesCapacity * 2;
+        cppNewSourceFiles = realloc(s_cppSourceFiles, s_iSourceFilesCapacity * sizeof(char*));
+        if(cppNewSourceFiles == NULL)
+        {
+            print_error(__func__, MallocReturnedNull);
+            return -MallocReturnedNull;
+        }
+
+        s_cppSourceFiles = cppNewSourceFiles;
+    }
+
+    s_cppSourceFiles[s_iNumberOfSourceFiles] = (char*)malloc(iLength + NULL_TERMINATING_BYTE_LENGTH);
+    if(s_cppSourceFiles[s_iNumberOfSourceFiles] == NULL)
+    {
+        print_error(__func__, MallocReturnedNull);
+        return -MallocReturnedNull;
+    }
+
+    memcpy(s_cppSourceFiles[s_iNumberOfSourceFiles], cpArgument, iLength);
+    s_cppSourceFiles[s_iNumberOfSourceFiles][iLength] = '\0';
+    s_iNumberOfSourceFiles++;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  read_response_file
+ * Function Description:  Adds the source files listed in a response file.  Each
+ *                        line holds one path and file name.  White spaces at
+ *                        the start and end of a line are ignored, as are empty
+ *                        lines.
+ * Parameters:
+ * cpResponseFile - Character pointer to the path and file name of the response
+ *                  file.
+ * Returns:  Zero for success and a negative number for failure.
+------------------------------------------------------------------------------*/
+static int read_response_file(const char* cpResponseFile)
+{
+    char* cpBuffer;
+    char* cpLine;
+    char* cpEnd;
+    char* cpLineEnd;
+
+    FILE* pResponseFile;
+
+    long iFileLength;
+
+    int iReturnValue;
+
+    //Read the whole file into memory.
+    pResponseFile = fopen(cpResponseFile, "rb");
+    if(pResponseFile == NULL)
+    {
+        print_error(__func__, ResponseFileError);
+        return -ResponseFileError;
+    }
+
+    cpBuffer = NULL;
+    iFileLength = -1;
+    if(fseek(pResponseFile, 0, SEEK_END) == 0)
+        iFileLength = ftell(pResponseFile);
+
+    if(iFileLength >= 0 && fseek(pResponseFile, 0, SEEK_SET) == 0)
+        cpBuffer = (char*)malloc((size_t)iFileLength + NULL_TERMINATING_BYTE_LENGTH);
+
+    if(cpBuffer == NULL || fread(cpBuffer, 1, (size_t)iFileLength, pResponseFile) != (size_t)iFileLength)
+    {
+        free(cpBuffer);
+        fclose(pResponseFile);
+        print_error(__func__, ResponseFileError);
+        return -ResponseFileError;
+    }
+
+    fclose(pResponseFile);
+    cpBuffer[iFileLength] = '\0';
+
+    //Go through the lines.
+    iReturnValue = EXIT_SUCCESS;
+    cpEnd = cpBuffer + iFileLength;
+    for(cpLine = cpBuffer; cpLine < cpEnd && iReturnValue == EXIT_SUCCESS; cpLine = cpLineEnd + 1)
+    {
+        cpLineEnd = memchr(cpLine, '\n', (size_t)(cpEnd - cpLine));
+        if(cpLineEnd == NULL)
+            cpLineEnd = cpEnd;
+
+        //Trim the white spaces, which includes a carriage return.
+        while(cpLine < cpLineEnd && isspace(*cpLine) != 0)
+            cpLine++;
+
+        while(cpLineEnd > cpLine && isspace(*(cpLineEnd - 1)) != 0)
+            cpLineEnd--;
+
+        if(cpLineEnd > cpLine)
+            iReturnValue = add_source_file(cpLine, (size_t)(cpLineEnd - cpLine));
+
+        //Move back to the end of the line.
+        while(cpLineEnd < cpEnd && *cpLineEnd != '\n')
+            cpLineEnd++;
+    }
+
+    free(cpBuffer);
+
+    return iReturnValue;
 }
 
 /*------------------------------------------------------------------------------
@@ -295,10 +798,11 @@ void free_argument_memory(void)
  * Function Description:  Parser function that takes the passed argument and
  *                        saves the directory portion and the file name portion.
  * Parameters:
+ * pContext - Pointer to the assembler context.
  * cpArgument - Character pointer to the passed argument.
  * Returns:  Zero for success and a negative number for failure.
 ------------------------------------------------------------------------------*/
-static int parse_passed_file_path_and_name(const char* cpArgument)
+static int parse_passed_file_path_and_name(AssemblerContext* pContext, const char* cpArgument)
 {
     char* cpString;
 
@@ -334,36 +838,36 @@ static int parse_passed_file_path_and_name(const char* cpArgument)
     //We have a non-empty string to work with.  We are going to use dirname() and
     //basename() library functions which alter the passed argument so we need to
     //make a copy of the passed argument.  First alocate memory.
-    s_cpArgumentCopy = (char*)malloc(iArgumentLength + NULL_TERMINATING_BYTE_LENGTH);
-    if(s_cpArgumentCopy == NULL)
+    pContext->m_arguments.m_cpArgumentCopy = (char*)malloc(iArgumentLength + NULL_TERMINATING_BYTE_LENGTH);
+    if(pContext->m_arguments.m_cpArgumentCopy == NULL)
     {
         print_error(__func__, MallocReturnedNull);
         return -MallocReturnedNull;
     }
 
     //Get the path.
-    strncpy(s_cpArgumentCopy, cpArgument, iArgumentLength + NULL_TERMINATING_BYTE_LENGTH);
-    cpString = dirname(s_cpArgumentCopy);
+    strncpy(pContext->m_arguments.m_cpArgumentCopy, cpArgument, iArgumentLength + NULL_TERMINATING_BYTE_LENGTH);
+    cpString = dirname(pContext->m_arguments.m_cpArgumentCopy);
 
     //Allocate memory for the path string.  Function dirname() returns the string
     //up to, but not including, the final '\' so add one to the length because we
     //going to concatenate that character into the string.  Also, add one for the
     //NULL terminating byte.
     iPathLength = strlen(cpString) + 1 + NULL_TERMINATING_BYTE_LENGTH;
-    s_cpPassedFilePath = (char*)malloc(iPathLength);
-    if(s_cpPassedFilePath == NULL)
+    pContext->m_arguments.m_cpPassedFilePath = (char*)malloc(iPathLength);
+    if(pContext->m_arguments.m_cpPassedFilePath == NULL)
     {
         print_error(__func__, MallocReturnedNull);
         return -MallocReturnedNull;
     }
 
     //Memory allocated so build the path name.
-    strncpy(s_cpPassedFilePath, cpString, iPathLength);
-    strncat(s_cpPassedFilePath, "\\", 1);
+    strncpy(pContext->m_arguments.m_cpPassedFilePath, cpString, iPathLength);
+    strncat(pContext->m_arguments.m_cpPassedFilePath, "\\", 1);
 
     //Get the file name.
-    strncpy(s_cpArgumentCopy, cpArgument, iArgumentLength + NULL_TERMINATING_BYTE_LENGTH);
-    cpString = basename(s_cpArgumentCopy);
+    strncpy(pContext->m_arguments.m_cpArgumentCopy, cpArgument, iArgumentLength + NULL_TERMINATING_BYTE_LENGTH);
+    cpString = basename(pContext->m_arguments.m_cpArgumentCopy);
 
     //Allocate memory for the file name string.  The GNU version of basename()
     //returns the empty string when path has a trailing slash so check for a
@@ -375,24 +879,24 @@ static int parse_passed_file_path_and_name(const char* cpArgument)
         return -FileNameLengthZero;
     }
 
-    s_cpPassedFileName = (char*)malloc(iNameLength);
-    if(s_cpPassedFileName == NULL)
+    pContext->m_arguments.m_cpPassedFileName = (char*)malloc(iNameLength);
+    if(pContext->m_arguments.m_cpPassedFileName == NULL)
     {
         print_error(__func__, MallocReturnedNull);
         return -MallocReturnedNull;
     }
 
     //Memory allocated so copy in the file name.
-    strncpy(s_cpPassedFileName, cpString, iNameLength);
+    strncpy(pContext->m_arguments.m_cpPassedFileName, cpString, iNameLength);
 
     //Check if this is a legitimate file name.  Look for:
     //1.  Length of one with only character being '/'
     //2.  Length of one with only character being '.'
     //3.  Length of two with only characters being ".."
     if(
-       (strlen(s_cpPassedFileName) == 1 && s_cpPassedFileName[0] == '/') ||
-       (strlen(s_cpPassedFileName) == 1 && s_cpPassedFileName[0] == '.') ||
-       (strlen(s_cpPassedFileName) == 2 && s_cpPassedFileName[0] == '.' && s_cpPassedFileName[1] == '.')
+       (strlen(pContext->m_arguments.m_cpPassedFileName) == 1 && pContext->m_arguments.m_cpPassedFileName[0] == '/') ||
+       (strlen(pContext->m_arguments.m_cpPassedFileName) == 1 && pContext->m_arguments.m_cpPassedFileName[0] == '.') ||
+       (strlen(pContext->m_arguments.m_cpPassedFileName) == 2 && pContext->m_arguments.m_cpPassedFileName[0] == '.' && pContext->m_arguments.m_cpPassedFileName[1] == '.')
       )
     {
         print_error(__func__, InvalidFileName);
@@ -401,7 +905,7 @@ static int parse_passed_file_path_and_name(const char* cpArgument)
 
     //We want to check for an extension and if one exists then record just the
     //base name.
-    cpString = strrchr(s_cpPassedFileName, '.');
+    cpString = strrchr(pContext->m_arguments.m_cpPassedFileName, '.');
     if(cpString != NULL)
     {
         //There is an extension.  The pointer cpString is currently pointing at
@@ -409,11 +913,11 @@ static int parse_passed_file_path_and_name(const char* cpArgument)
         //file name.  The length of the base name is the current pointer position
         //minus the starting pointer of the string.  Add one for the NULL
         //terminating byte.
-        iBaseNameLength = (size_t)cpString - (size_t)s_cpPassedFileName + NULL_TERMINATING_BYTE_LENGTH;
+        iBaseNameLength = (size_t)cpString - (size_t)pContext->m_arguments.m_cpPassedFileName + NULL_TERMINATING_BYTE_LENGTH;
 
         //Allocate memory for the base name.
-        s_cpPassedBaseFileName = (char*)malloc(iBaseNameLength);
-        if(s_cpPassedBaseFileName == NULL)
+        pContext->m_arguments.m_cpPassedBaseFileName = (char*)malloc(iBaseNameLength);
+        if(pContext->m_arguments.m_cpPassedBaseFileName == NULL)
         {
             print_error(__func__, MallocReturnedNull);
             return -MallocReturnedNull;
@@ -422,8 +926,8 @@ static int parse_passed_file_path_and_name(const char* cpArgument)
         //Memory allocated so copy in only the base part of the file name.  Since
         //the length of the base name if less than the length of the entire file
         //name strncpy() will not copy in a NULL terminating byte.
-        memset(s_cpPassedBaseFileName, '\0', iBaseNameLength);
-        strncpy(s_cpPassedBaseFileName, s_cpPassedFileName, iBaseNameLength - NULL_TERMINATING_BYTE_LENGTH);
+        memset(pContext->m_arguments.m_cpPassedBaseFileName, '\0', iBaseNameLength);
+        strncpy(pContext->m_arguments.m_cpPassedBaseFileName, pContext->m_arguments.m_cpPassedFileName, iBaseNameLength - NULL_TERMINATING_BYTE_LENGTH);
     }
 
     return EXIT_SUCCESS;
@@ -439,23 +943,69 @@ static void display_usage(void)
 {
     printf("NANOCORE ASSEMBLER\n\n");
     printf("Assembler for the nanocore CPU.  Generates a program listing file and\n");
-    printf("binary machine code file from the passed assembly source file.\n");
+    printf("binary machine code file from each passed assembly source file.\n");
+    printf("\n");
+    printf("Usage:  nanocore-as.exe [OPTIONS] FILE...\n");
+    printf("  or:   nanocore-as.exe [OPTIONS] --watch FILE...\n");
+    printf("  or:   nanocore-as.exe [OPTIONS] --build=MANIFEST\n");
+    printf("  or:   nanocore-as.exe --serve=PIPE\n");
+    printf("\n");
+    printf("The files are assembled at the same time, one per processor, and what\n");
+    printf("is printed for each comes out in the order they were passed.  A FILE\n");
+    printf("of @RESPONSE reads the source files from the file RESPONSE, one per\n");
+    printf("line.\n");
+    printf("\n");
+    printf("With --build each line of MANIFEST is a source file, optionally\n");
+    printf("followed by a colon and the source files it depends on, all separated\n");
+    printf("by white space.  A source file is assembled after the ones it depends\n");
+    printf("on, and not at all if one of them fails.  Source files that don't\n");
+    printf("depend on each other are assembled at the same time.\n");
+    printf("\n");
+    printf("With --watch the assembler stays running after the files are\n");
+    printf("assembled and assembles each file again whenever it is saved.  Each\n");
+    printf("assembly starts from the beginning, the same as running the\n");
+    printf("assembler again, it only saves having to start it by hand.\n");
     printf("\n");
-    printf("Usage:  nanocore-as.exe [OPTIONS] FILE\n");
+    printf("With --serve the assembler stays resident and assembles the command\n");
+    printf("lines of clients that connect to the named pipe \\\\.\\pipe\\PIPE, one\n");
+    printf("at a time, until it is ended.  Only the user running the server can\n");
+    printf("connect, and only from the same computer.\n");
     printf("\n");
     printf("Mandatory arguments to long options are mandatory for short options too.\n");
     printf("\n");
     printf("Options:\n");
+    printf("-b, --build=MANIFEST       assemble the source files of MANIFEST in the\n");
+    printf("                           order of their dependencies.\n");
+    printf("-C, --connect=PIPE         have the server on PIPE assemble the rest of\n");
+    printf("                           the command line in the current directory.\n");
+    printf("                           Its output and exit value are passed on.\n");
+    printf("-d, --direct-page=PAGE     use the shorter direct page form of LDA and\n");
+    printf("                           STA for absolute operands within PAGE, 0 to\n");
+    printf("                           255.  The program must keep PAGE in the\n");
+    printf("                           direct page register.\n");
+    printf("-e, --max-errors=COUNT     stop the assembly after COUNT errors have\n");
+    printf("                           been reported.  A COUNT of zero means there\n");
+    printf("                           is no limit.  A binary file is not written\n");
+    printf("                           if there are any errors.  Without this option\n");
+    printf("                           the assembly stops at the first error.\n");
     printf("-h, --help                 display this help and exit.\n");
     printf("-l, --listing-file=ACTION  if ACTION is LIST, a listing file will be\n");
     printf("                           printed.  If ACTION is NOLIST, a listing file\n");
     printf("                           will not be printed.  Without this option a\n");
     printf("                           listing file will be printed.\n");
+    printf("-S, --serve=PIPE           stay resident and assemble the command lines\n");
+    printf("                           of clients on PIPE.\n");
     printf("-s, --symbol-table=ACTION  if ACTION is SYM, a symbol table will be\n");
     printf("                           included in the listing file.  If ACTION is\n");
     printf("                           NOSYM, the symbol table will be excluded from\n");
     printf("                           the listing file.  Without this option a\n");
     printf("                           symbol table will be included in the listing\n");
     printf("                           file.\n");
+    printf("-t, --statistics           print how many times the value of a repeated\n");
+    printf("                           operand expression was reused, and how many\n");
+    printf("                           times the layout was gone over to settle the\n");
+    printf("                           instruction sizes.\n");
     printf("-v, --version              output the version number and exit.\n");
+    printf("-w, --watch                assemble the files again whenever they\n");
+    printf("                           change, until the program is ended.\n");
 }
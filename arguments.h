@@ -38,7 +38,8 @@
 
 //------------------------------------------------------------------------------
 //Defines
-//None
+#define SOURCE_FILES_INITIAL_CAPACITY   (16)
+#define RESPONSE_FILE_PREFIX            '@'
 
 //------------------------------------------------------------------------------
 //Enumerations
@@ -46,16 +47,53 @@
 
 //------------------------------------------------------------------------------
 //Structures
-//None
+//The options an assembly is done with.
+typedef struct tagAssemblerOptions
+{
+    uint8_t m_bIsListingFileEnabled;
+    uint8_t m_bIsSymbolTableEnabled;
+    uint8_t m_bIsStatisticsEnabled;
+    uint8_t m_bIsDirectPageEnabled;
+    uint8_t m_iDirectPage;
+    uint32_t m_iMaxErrors;
+} AssemblerOptions;
+
+//The options of one assembly and the parts of the path and file name of the
+//source file it assembles.
+typedef struct tagArgumentsContext
+{
+    AssemblerOptions m_options;
+
+    char* m_cpPassedFilePath;
+    char* m_cpPassedFileName;
+    char* m_cpArgumentCopy;
+    char* m_cpPassedBaseFileName;
+} ArgumentsContext;
 
 //------------------------------------------------------------------------------
 //Prototypes
 int process_arguments(int iArgc, char* acpArgv[]);
-uint8_t is_listing_file_enabled(void);
-uint8_t is_symbol_table_enabled(void);
-const char* get_assembly_source_file_path(void);
-const char* get_assembly_source_full_file_name(void);
-const char* get_assembly_source_base_file_name(void);
+uint8_t is_listing_file_enabled(AssemblerContext* pContext);
+uint8_t is_symbol_table_enabled(AssemblerContext* pContext);
+uint8_t is_statistics_enabled(AssemblerContext* pContext);
+uint8_t is_direct_page_enabled(AssemblerContext* pContext);
+uint8_t get_direct_page(AssemblerContext* pContext);
+uint32_t get_max_errors(AssemblerContext* pContext);
+const char* get_assembly_source_file_path(AssemblerContext* pContext);
+const char* get_assembly_source_full_file_name(AssemblerContext* pContext);
+const char* get_assembly_source_base_file_name(AssemblerContext* pContext);
+const char* get_serve_pipe_name(void);
+const char* get_connect_pipe_name(void);
+const char* get_build_manifest_name(void);
+uint8_t is_watch_enabled(void);
+uint32_t get_number_of_source_files(void);
+const char* get_source_file_argument(uint32_t iIndex);
+void copy_command_line_options(AssemblerContext* pContext);
+int select_source_file(AssemblerContext* pContext, uint32_t iIndex);
+int select_source_name(AssemblerContext* pContext, const char* cpName);
+void get_default_options(AssemblerOptions* pOptions);
+void set_assembly_options(AssemblerContext* pContext, const AssemblerOptions* pOptions);
+void free_source_file_names(AssemblerContext* pContext);
 void free_argument_memory(void);
 
 #endif /*___ARGUMENTS_H___*/
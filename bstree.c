@@ -26,7 +26,9 @@
  **
  ** Description:
  ** This translation (compilation) unit contains the functions for building,
- ** maintaining, and deleting a binary search tree.
+ ** maintaining, and deleting a binary search tree.  The tree is a red-black
+ ** tree so that keys inserted in order, such as L1, L2, L3, can't leave it a
+ ** list.
  ********************************************************************************
  ** Version 1.0.0
  ********************************************************************************
@@ -75,6 +77,11 @@
 //Static Prototypes
 static void bstree_transplant(BSTreeNode** root, BSTreeNode* pSubtreeOne, BSTreeNode* pSubtreeTwo);
 static BSTreeNode* bstree_minimum(BSTreeNode* pNode);
+static void bstree_rotate_left(BSTreeNode** ppTreeRoot, BSTreeNode* pNode);
+static void bstree_rotate_right(BSTreeNode** ppTreeRoot, BSTreeNode* pNode);
+static void bstree_insert_fixup(BSTreeNode** ppTreeRoot, BSTreeNode* pNode);
+static void bstree_delete_fixup(BSTreeNode** ppTreeRoot, BSTreeNode* pNode, BSTreeNode* pParentNode);
+static uint8_t bstree_color(BSTreeNode* pNode);
 
 //==============================================================================
 //Functions
@@ -95,9 +102,12 @@ BSTreeNode* bstree_insert(BSTreeNode** ppTreeRoot, void* vpKey, size_t iKeySize,
     BSTreeNode* pCurrentNode;
     BSTreeNode* pCurrentParentNode;
 
+    int iCompare;
+
     //Initialize variables.
     pCurrentNode = *ppTreeRoot;
     pCurrentParentNode = NULL;
+    iCompare = 0;
 
     //Loop until an available node is located.
     while(pCurrentNode != NULL)
@@ -105,7 +115,8 @@ BSTreeNode* bstree_insert(BSTreeNode** ppTreeRoot, void* vpKey, size_t iKeySize,
         //Node not available.  Make it the parent node and select the next node
         //based on a comparison of the passed symbol and the current node symbol.
         pCurrentParentNode = pCurrentNode;
-        pCurrentNode = (fpBSTreeKeyCompareFunction(vpKey, pCurrentNode->m_vpKey) < 0) ? pCurrentNode->m_pLeft : pCurrentNode->m_pRight;
+        iCompare = fpBSTreeKeyCompareFunction(vpKey, pCurrentNode->m_vpKey);
+        pCurrentNode = (iCompare < 0) ? pCurrentNode->m_pLeft : pCurrentNode->m_pRight;
     }
 
     //Available node found.  Allocate memory for the node.
@@ -124,13 +135,17 @@ BSTreeNode* bstree_insert(BSTreeNode** ppTreeRoot, void* vpKey, size_t iKeySize,
     pCurrentNode->m_pParent = pCurrentParentNode;
     pCurrentNode->m_pLeft = NULL;
     pCurrentNode->m_pRight = NULL;
+    pCurrentNode->m_iColor = BSTreeNodeRed;
     if(pCurrentParentNode == NULL)
         *ppTreeRoot = pCurrentNode;
-    else if(fpBSTreeKeyCompareFunction(vpKey, pCurrentParentNode->m_vpKey) < 0)
+    else if(iCompare < 0)
         pCurrentParentNode->m_pLeft = pCurrentNode;
     else
         pCurrentParentNode->m_pRight = pCurrentNode;
 
+    //The new node is red which may put it under a red parent.
+    bstree_insert_fixup(ppTreeRoot, pCurrentNode);
+
     return pCurrentNode;
 }
 
@@ -148,8 +163,10 @@ BSTreeNode* bstree_insert(BSTreeNode** ppTreeRoot, void* vpKey, size_t iKeySize,
 ------------------------------------------------------------------------------*/
 BSTreeNode* bstree_search(BSTreeNode* pNode, void* vpKey, BSTreeKeyCompareFunction fpBSTreeKeyCompareFunction)
 {
-    while(pNode != NULL && fpBSTreeKeyCompareFunction(vpKey, pNode->m_vpKey) != 0)
-        pNode = (fpBSTreeKeyCompareFunction(vpKey, pNode->m_vpKey) < 0) ? pNode->m_pLeft : pNode->m_pRight;
+    int iCompare;
+
+    while(pNode != NULL && (iCompare = fpBSTreeKeyCompareFunction(vpKey, pNode->m_vpKey)) != 0)
+        pNode = (iCompare < 0) ? pNode->m_pLeft : pNode->m_pRight;
 
     return pNode;
 }
@@ -166,29 +183,54 @@ BSTreeNode* bstree_search(BSTreeNode* pNode, void* vpKey, BSTreeKeyCompareFuncti
 void bstree_delete(BSTreeNode** ppTreeRoot, BSTreeNode* pNodeToDelete)
 {
     BSTreeNode* pMinimumNode;
+    BSTreeNode* pMovedNode;
+    BSTreeNode* pMovedParentNode;
 
+    uint8_t iRemovedColor;
+
+    //The node that takes the place of the one removed from the tree, and its
+    //parent since it may be NULL.
+    iRemovedColor = pNodeToDelete->m_iColor;
     if(pNodeToDelete->m_pLeft == NULL)
     {
+        pMovedNode = pNodeToDelete->m_pRight;
+        pMovedParentNode = pNodeToDelete->m_pParent;
         bstree_transplant(ppTreeRoot, pNodeToDelete, pNodeToDelete->m_pRight);
     }
     else if(pNodeToDelete->m_pRight == NULL)
     {
+        pMovedNode = pNodeToDelete->m_pLeft;
+        pMovedParentNode = pNodeToDelete->m_pParent;
         bstree_transplant(ppTreeRoot, pNodeToDelete, pNodeToDelete->m_pLeft);
     }
     else
     {
+        //The minimum node is the one removed from its place.  It takes the color
+        //of the node being deleted along with its place.
         pMinimumNode = bstree_minimum(pNodeToDelete->m_pRight);
+        iRemovedColor = pMinimumNode->m_iColor;
+        pMovedNode = pMinimumNode->m_pRight;
         if(pMinimumNode->m_pParent != pNodeToDelete)
         {
+            pMovedParentNode = pMinimumNode->m_pParent;
             bstree_transplant(ppTreeRoot, pMinimumNode, pMinimumNode->m_pRight);
             pMinimumNode->m_pRight = pNodeToDelete->m_pRight;
             pMinimumNode->m_pRight->m_pParent = pMinimumNode;
         }
+        else
+        {
+            pMovedParentNode = pMinimumNode;
+        }
         bstree_transplant(ppTreeRoot, pNodeToDelete, pMinimumNode);
         pMinimumNode->m_pLeft = pNodeToDelete->m_pLeft;
         pMinimumNode->m_pLeft->m_pParent = pMinimumNode;
+        pMinimumNode->m_iColor = pNodeToDelete->m_iColor;
     }
 
+    //Removing a black node leaves its paths one black node short.
+    if(iRemovedColor == BSTreeNodeBlack)
+        bstree_delete_fixup(ppTreeRoot, pMovedNode, pMovedParentNode);
+
     if(pNodeToDelete->m_vpDataElement != NULL)
         free(pNodeToDelete->m_vpDataElement);
     free(pNodeToDelete->m_vpKey);
@@ -205,16 +247,18 @@ void bstree_delete(BSTreeNode** ppTreeRoot, BSTreeNode* pNodeToDelete)
  * fpBSTreeWalkCurrentNodeFunction - Pointer to the function to call when the
  *                                   walk reaches a point where it has the next
  *                                   node in ascending order ready.
+ * vpWalkData - Pointer passed on to the walk function, or NULL if it does not
+ *              need one.
  * Returns:  None.
 ------------------------------------------------------------------------------*/
-void bstree_in_order_walk(BSTreeNode* pNode, BSTreeWalkCurrentNodeFunction fpBSTreeWalkCurrentNodeFunction)
+void bstree_in_order_walk(BSTreeNode* pNode, BSTreeWalkCurrentNodeFunction fpBSTreeWalkCurrentNodeFunction, void* vpWalkData)
 {
     if(pNode != NULL)
     {
-        bstree_in_order_walk(pNode->m_pLeft, fpBSTreeWalkCurrentNodeFunction);
+        bstree_in_order_walk(pNode->m_pLeft, fpBSTreeWalkCurrentNodeFunction, vpWalkData);
         if(fpBSTreeWalkCurrentNodeFunction != NULL)
-            fpBSTreeWalkCurrentNodeFunction(pNode);
-        bstree_in_order_walk(pNode->m_pRight, fpBSTreeWalkCurrentNodeFunction);
+            fpBSTreeWalkCurrentNodeFunction(pNode, vpWalkData);
+        bstree_in_order_walk(pNode->m_pRight, fpBSTreeWalkCurrentNodeFunction, vpWalkData);
     }
 }
 
@@ -271,3 +315,230 @@ static BSTreeNode* bstree_minimum(BSTreeNode* pNode)
 
     return pNode;
 }
+
+/*------------------------------------------------------------------------------
+ * Function name:  bstree_rotate_left
+ * Function Description:  Makes the right child of a node its parent.  The order
+ *                        of the keys is not changed.
+ * Parameters:
+ * ppTreeRoot - A pointer to a pointer that is the root node of the binary tree.
+ * pNode - A pointer to the node to rotate.  It must have a right child.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void bstree_rotate_left(BSTreeNode** ppTreeRoot, BSTreeNode* pNode)
+{
+    BSTreeNode* pChildNode;
+
+    pChildNode = pNode->m_pRight;
+    pNode->m_pRight = pChildNode->m_pLeft;
+    if(pChildNode->m_pLeft != NULL)
+        pChildNode->m_pLeft->m_pParent = pNode;
+
+    bstree_transplant(ppTreeRoot, pNode, pChildNode);
+    pChildNode->m_pLeft = pNode;
+    pNode->m_pParent = pChildNode;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  bstree_rotate_right
+ * Function Description:  Makes the left child of a node its parent.  The order
+ *                        of the keys is not changed.
+ * Parameters:
+ * ppTreeRoot - A pointer to a pointer that is the root node of the binary tree.
+ * pNode - A pointer to the node to rotate.  It must have a left child.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void bstree_rotate_right(BSTreeNode** ppTreeRoot, BSTreeNode* pNode)
+{
+    BSTreeNode* pChildNode;
+
+    pChildNode = pNode->m_pLeft;
+    pNode->m_pLeft = pChildNode->m_pRight;
+    if(pChildNode->m_pRight != NULL)
+        pChildNode->m_pRight->m_pParent = pNode;
+
+    bstree_transplant(ppTreeRoot, pNode, pChildNode);
+    pChildNode->m_pRight = pNode;
+    pNode->m_pParent = pChildNode;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  bstree_insert_fixup
+ * Function Description:  Restores the red-black properties after a red node was
+ *                        inserted.  A red node can't have a red parent, and the
+ *                        root is black.
+ * Parameters:
+ * ppTreeRoot - A pointer to a pointer that is the root node of the binary tree.
+ * pNode - A pointer to the inserted node.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void bstree_insert_fixup(BSTreeNode** ppTreeRoot, BSTreeNode* pNode)
+{
+    BSTreeNode* pUncleNode;
+
+    //A red parent is never the root so there is always a grandparent.
+    while(pNode->m_pParent != NULL && pNode->m_pParent->m_iColor == BSTreeNodeRed)
+    {
+        if(pNode->m_pParent == pNode->m_pParent->m_pParent->m_pLeft)
+        {
+            pUncleNode = pNode->m_pParent->m_pParent->m_pRight;
+            if(bstree_color(pUncleNode) == BSTreeNodeRed)
+            {
+                //Push the red up to the grandparent and check from there.
+                pNode->m_pParent->m_iColor = BSTreeNodeBlack;
+                pUncleNode->m_iColor = BSTreeNodeBlack;
+                pNode->m_pParent->m_pParent->m_iColor = BSTreeNodeRed;
+                pNode = pNode->m_pParent->m_pParent;
+            }
+            else
+            {
+                //Rotate the red pair into a line and then rotate the parent up
+                //over the grandparent.
+                if(pNode == pNode->m_pParent->m_pRight)
+                {
+                    pNode = pNode->m_pParent;
+                    bstree_rotate_left(ppTreeRoot, pNode);
+                }
+                pNode->m_pParent->m_iColor = BSTreeNodeBlack;
+                pNode->m_pParent->m_pParent->m_iColor = BSTreeNodeRed;
+                bstree_rotate_right(ppTreeRoot, pNode->m_pParent->m_pParent);
+            }
+        }
+        else
+        {
+            //The same with left and right swapped.
+            pUncleNode = pNode->m_pParent->m_pParent->m_pLeft;
+            if(bstree_color(pUncleNode) == BSTreeNodeRed)
+            {
+                pNode->m_pParent->m_iColor = BSTreeNodeBlack;
+                pUncleNode->m_iColor = BSTreeNodeBlack;
+                pNode->m_pParent->m_pParent->m_iColor = BSTreeNodeRed;
+                pNode = pNode->m_pParent->m_pParent;
+            }
+            else
+            {
+                if(pNode == pNode->m_pParent->m_pLeft)
+                {
+                    pNode = pNode->m_pParent;
+                    bstree_rotate_right(ppTreeRoot, pNode);
+                }
+                pNode->m_pParent->m_iColor = BSTreeNodeBlack;
+                pNode->m_pParent->m_pParent->m_iColor = BSTreeNodeRed;
+                bstree_rotate_left(ppTreeRoot, pNode->m_pParent->m_pParent);
+            }
+        }
+    }
+
+    (*ppTreeRoot)->m_iColor = BSTreeNodeBlack;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  bstree_delete_fixup
+ * Function Description:  Restores the red-black properties after a black node
+ *                        was removed.  The node that took its place counts as
+ *                        one extra black until the paths through it are back
+ *                        to the same number of black nodes as the others.
+ * Parameters:
+ * ppTreeRoot - A pointer to a pointer that is the root node of the binary tree.
+ * pNode - A pointer to the node that took the removed node's place, which may
+ *         be NULL.
+ * pParentNode - A pointer to the parent of pNode.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void bstree_delete_fixup(BSTreeNode** ppTreeRoot, BSTreeNode* pNode, BSTreeNode* pParentNode)
+{
+    BSTreeNode* pSiblingNode;
+
+    //The sibling of a node with an extra black always exists since its side of
+    //the tree has at least one black node.
+    while(pNode != *ppTreeRoot && bstree_color(pNode) == BSTreeNodeBlack)
+    {
+        if(pNode == pParentNode->m_pLeft)
+        {
+            pSiblingNode = pParentNode->m_pRight;
+            if(pSiblingNode->m_iColor == BSTreeNodeRed)
+            {
+                //Make the sibling black by rotating the red one up.
+                pSiblingNode->m_iColor = BSTreeNodeBlack;
+                pParentNode->m_iColor = BSTreeNodeRed;
+                bstree_rotate_left(ppTreeRoot, pParentNode);
+                pSiblingNode = pParentNode->m_pRight;
+            }
+
+            if(bstree_color(pSiblingNode->m_pLeft) == BSTreeNodeBlack && bstree_color(pSiblingNode->m_pRight) == BSTreeNodeBlack)
+            {
+                //Take a black off the sibling's side and move the extra black
+                //up to the parent.
+                pSiblingNode->m_iColor = BSTreeNodeRed;
+                pNode = pParentNode;
+                pParentNode = pNode->m_pParent;
+            }
+            else
+            {
+                //Get a red node on the far side of the sibling and then rotate
+                //the sibling up, which uses up the extra black.
+                if(bstree_color(pSiblingNode->m_pRight) == BSTreeNodeBlack)
+                {
+                    pSiblingNode->m_pLeft->m_iColor = BSTreeNodeBlack;
+                    pSiblingNode->m_iColor = BSTreeNodeRed;
+                    bstree_rotate_right(ppTreeRoot, pSiblingNode);
+                    pSiblingNode = pParentNode->m_pRight;
+                }
+                pSiblingNode->m_iColor = pParentNode->m_iColor;
+                pParentNode->m_iColor = BSTreeNodeBlack;
+                pSiblingNode->m_pRight->m_iColor = BSTreeNodeBlack;
+                bstree_rotate_left(ppTreeRoot, pParentNode);
+                pNode = *ppTreeRoot;
+            }
+        }
+        else
+        {
+            //The same with left and right swapped.
+            pSiblingNode = pParentNode->m_pLeft;
+            if(pSiblingNode->m_iColor == BSTreeNodeRed)
+            {
+                pSiblingNode->m_iColor = BSTreeNodeBlack;
+                pParentNode->m_iColor = BSTreeNodeRed;
+                bstree_rotate_right(ppTreeRoot, pParentNode);
+                pSiblingNode = pParentNode->m_pLeft;
+            }
+
+            if(bstree_color(pSiblingNode->m_pLeft) == BSTreeNodeBlack && bstree_color(pSiblingNode->m_pRight) == BSTreeNodeBlack)
+            {
+                pSiblingNode->m_iColor = BSTreeNodeRed;
+                pNode = pParentNode;
+                pParentNode = pNode->m_pParent;
+            }
+            else
+            {
+                if(bstree_color(pSiblingNode->m_pLeft) == BSTreeNodeBlack)
+                {
+                    pSiblingNode->m_pRight->m_iColor = BSTreeNodeBlack;
+                    pSiblingNode->m_iColor = BSTreeNodeRed;
+                    bstree_rotate_left(ppTreeRoot, pSiblingNode);
+                    pSiblingNode = pParentNode->m_pLeft;
+                }
+                pSiblingNode->m_iColor = pParentNode->m_iColor;
+                pParentNode->m_iColor = BSTreeNodeBlack;
+                pSiblingNode->m_pLeft->m_iColor = BSTreeNodeBlack;
+                bstree_rotate_right(ppTreeRoot, pParentNode);
+                pNode = *ppTreeRoot;
+            }
+        }
+    }
+
+    if(pNode != NULL)
+        pNode->m_iColor = BSTreeNodeBlack;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  bstree_color
+ * Function Description:  Gets the color of a node.
+ * Parameters:
+ * pNode - A pointer to the node, or NULL.
+ * Returns:  The color of the node.  NULL is black.
+------------------------------------------------------------------------------*/
+static uint8_t bstree_color(BSTreeNode* pNode)
+{
+    return (pNode != NULL) ? pNode->m_iColor : BSTreeNodeBlack;
+}
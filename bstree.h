@@ -42,7 +42,12 @@
 
 //------------------------------------------------------------------------------
 //Enumerations
-//None
+//The tree is kept balanced as a red-black tree.  A NULL child counts as black.
+enum BSTreeNodeColors
+{
+    BSTreeNodeRed = 0,
+    BSTreeNodeBlack
+};
 
 //------------------------------------------------------------------------------
 //Structures
@@ -53,6 +58,7 @@ typedef struct tagBSTreeNode
     struct tagBSTreeNode* m_pLeft;
     struct tagBSTreeNode* m_pRight;
     struct tagBSTreeNode* m_pParent;
+    uint8_t m_iColor;
 } BSTreeNode;
 
 //------------------------------------------------------------------------------
@@ -68,15 +74,16 @@ typedef int (*BSTreeKeyCompareFunction)(const void* vpKey1, const void* vpKey2);
 //Binary search tree walk current node function pointer.  Use this function to
 //print out, analyze, or otherwise use the data of the current node in the walk.
 //pCurrentNode - Pointer to the current node of the walk.
+//vpWalkData - The pointer that was passed to the walk.
 //Returns:  None.
-typedef void (*BSTreeWalkCurrentNodeFunction)(BSTreeNode* pCurrentNode);
+typedef void (*BSTreeWalkCurrentNodeFunction)(BSTreeNode* pCurrentNode, void* vpWalkData);
 
 //------------------------------------------------------------------------------
 //Prototypes
 BSTreeNode* bstree_insert(BSTreeNode** ppTreeRoot, void* vpKey, size_t iKeySize, BSTreeKeyCompareFunction fpBSTreeKeyCompareFunction);
 BSTreeNode* bstree_search(BSTreeNode* pNode, void* vpKey, BSTreeKeyCompareFunction fpBSTreeKeyCompareFunction);
 void bstree_delete(BSTreeNode** ppTreeRoot, BSTreeNode* pNodeToDelete);
-void bstree_in_order_walk(BSTreeNode* pNode, BSTreeWalkCurrentNodeFunction fpBSTreeWalkCurrentNodeFunction);
+void bstree_in_order_walk(BSTreeNode* pNode, BSTreeWalkCurrentNodeFunction fpBSTreeWalkCurrentNodeFunction, void* vpWalkData);
 int bstree_key_compare(const void* vpKey1, const void* vpKey2);
 
 #endif /*___BSTREE_H___*/
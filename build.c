@@ -0,0 +1,1089 @@
+/*
+ ********************************************************************************
+ ** Copyright (C) 2026 Donald J. Bartley <djbcoffee@gmail.com>
+ **
+ ** This source file may be used and distributed without restriction provided
+ ** that this copyright statement is not removed from the file and that any
+ ** derivative work contains the original copyright notice and the associated
+ ** disclaimer.
+ **
+ ** This source file is free software; you can redistribute it and/or modify it
+ ** under the terms of the GNU General Public License as published by the Free
+ ** Software Foundation; either version 2 of the License, or (at your option) any
+ ** later version.
+ **
+ ** This source file is distributed in the hope that it will be useful, but
+ ** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along with
+ ** this source file.  If not, see <http://www.gnu.org/licenses/> or write to the
+ ** Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ ** 02110-1301, USA.
+ ********************************************************************************
+ ** File: nanocore-as/src/build.c
+ **
+ ** Description:
+ ** This translation (compilation) unit contains the build of the modules in a
+ ** manifest.  Each module is a source file that is assembled after the modules
+ ** it depends on.  The modules that are ready are assembled at the same time on
+ ** a pool of workers and what each one prints is held back so the output comes
+ ** out in the order of the manifest.  The source files of a command line are
+ ** built the same way, as modules that don't depend on each other.
+ ********************************************************************************
+ ** Version 1.0.0
+ ********************************************************************************
+ */
+
+//System #includes
+#ifndef _WINDOWS_H
+#include <windows.h>
+#endif
+#ifndef _CTYPE_H
+#include <ctype.h>
+#endif
+#ifndef _STDIO_H
+#include <stdio.h>
+#endif
+#ifndef _STDINT_H
+#include <stdint.h>
+#endif
+#ifndef _STDLIB_H
+#include <stdlib.h>
+#endif
+#ifndef _STRING_H
+#include <string.h>
+#endif
+
+//Project-wide #includes
+#ifndef ___UNIVERSAL_H___
+#include "universal.h"
+#endif
+
+//Project #includes
+#ifndef ___ARGUMENTS_H___
+#include "arguments.h"
+#endif
+#ifndef ___CONTEXT_H___
+#include "context.h"
+#endif
+#ifndef ___FILES_H___
+#include "files.h"
+#endif
+#ifndef ___LEXER_H___
+#include "lexer.h"
+#endif
+#ifndef ___LOG_H___
+#include "log.h"
+#endif
+
+//Reflective #includes
+#ifndef ___BUILD_H___
+#include "build.h"
+#endif
+
+//------------------------------------------------------------------------------
+//Global Data
+//None
+
+//------------------------------------------------------------------------------
+//Static Data
+//None
+
+//------------------------------------------------------------------------------
+//Static Prototypes
+static int read_build_manifest(BuildContext* pBuild, const char* cpManifestFile);
+static int parse_build_manifest_line(BuildContext* pBuild, char* cpLine, uint32_t iLineNumber);
+static int add_source_file_modules(BuildContext* pBuild);
+static int add_build_module(BuildContext* pBuild, const char* cpFileName, uint32_t iLineNumber);
+static int append_build_module(BuildContext* pBuild, const char* cpFileName);
+static int add_build_dependency(BuildModule* pModule, char* cpDependencyName);
+static uint32_t find_build_module(BuildContext* pBuild, const char* cpFileName);
+static int link_build_modules(BuildContext* pBuild);
+static int add_build_dependent(BuildContext* pBuild, uint32_t iDependencyIndex, uint32_t iIndex);
+static int check_build_for_cycles(BuildContext* pBuild);
+static int run_build_modules(BuildContext* pBuild);
+static int schedule_build_modules(BuildContext* pBuild);
+static void start_build_workers(BuildContext* pBuild);
+static void stop_build_workers(BuildContext* pBuild);
+static DWORD WINAPI build_worker_thread(LPVOID vpBuild);
+static void assemble_build_module(BuildContext* pBuild, uint32_t iIndex);
+static void queue_build_module(BuildContext* pBuild, uint32_t iIndex);
+static uint32_t take_finished_module(BuildContext* pBuild);
+static void finish_build_module(BuildContext* pBuild, uint32_t iIndex);
+static void print_finished_modules(BuildContext* pBuild);
+static void lock_build(BuildContext* pBuild);
+static void unlock_build(BuildContext* pBuild);
+static void free_build_memory(BuildContext* pBuild);
+
+//==============================================================================
+//Functions
+/*------------------------------------------------------------------------------
+ * Function name:  run_build
+ * Function Description:  Assembles the modules of a build manifest.  A module
+ *                        is assembled once the modules it depends on are, and
+ *                        is not assembled if one of them failed.
+ * Parameters:
+ * cpManifestFile - The path and file name of the build manifest.
+ * Returns:  Zero if every module assembled, otherwise the exit value of the
+ *           first failure in the manifest.
+------------------------------------------------------------------------------*/
+int run_build(const char* cpManifestFile)
+{
+    BuildContext build;
+
+    int iReturnValue;
+
+    memset(&build, 0, sizeof(build));
+
+    iReturnValue = read_build_manifest(&build, cpManifestFile);
+    if(iReturnValue == EXIT_SUCCESS)
+        iReturnValue = run_build_modules(&build);
+
+    free_build_memory(&build);
+
+    return iReturnValue;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  assemble_source_files
+ * Function Description:  Assembles the passed source files as a build of
+ *                        modules that don't depend on each other, so they are
+ *                        assembled at the same time on the workers.  What each
+ *                        one prints comes out in the order they were passed.
+ * Parameters:  None.
+ * Returns:  Zero if every file assembled, otherwise the exit value of the first
+ *           failure.
+------------------------------------------------------------------------------*/
+int assemble_source_files(void)
+{
+    BuildContext build;
+
+    int iReturnValue;
+
+    memset(&build, 0, sizeof(build));
+
+    iReturnValue = add_source_file_modules(&build);
+    if(iReturnValue == EXIT_SUCCESS)
+        iReturnValue = run_build_modules(&build);
+
+    free_build_memory(&build);
+
+    return iReturnValue;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  run_build_modules
+ * Function Description:  Assembles the modules that have been added to a build
+ *                        and says how many of them assembled.
+ * Parameters:
+ * pBuild - Pointer to the build.
+ * Returns:  Zero if every module assembled, otherwise the exit value of the
+ *           first failure in the order the modules were added.
+------------------------------------------------------------------------------*/
+static int run_build_modules(BuildContext* pBuild)
+{
+    int iReturnValue;
+
+    uint32_t iIndex;
+    uint32_t iNumberOfSuccesses;
+
+    iReturnValue = link_build_modules(pBuild);
+    if(iReturnValue == EXIT_SUCCESS)
+        iReturnValue = schedule_build_modules(pBuild);
+    if(iReturnValue == EXIT_SUCCESS)
+    {
+        //The first failure becomes the exit value, the same for a manifest as
+        //for the source files of a command line.
+        iNumberOfSuccesses = 0;
+        for(iIndex = 0; iIndex < pBuild->m_iNumberOfModules; iIndex++)
+        {
+            if(pBuild->m_pModules[iIndex].m_iReturnValue == EXIT_SUCCESS)
+                iNumberOfSuccesses++;
+            else if(iReturnValue == EXIT_SUCCESS)
+                iReturnValue = pBuild->m_pModules[iIndex].m_iReturnValue;
+        }
+        if(pBuild->m_iNumberOfModules > 1)
+            printf("\n%u of %u file(s) assembled successfully.\n", iNumberOfSuccesses, pBuild->m_iNumberOfModules);
+    }
+
+    return iReturnValue;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  read_build_manifest
+ * Function Description:  Reads the modules from a build manifest.  Each line
+ *                        names a source file, which can be followed by a colon
+ *                        and the source files it depends on, all separated by
+ *                        white space.  Anything after a semicolon is a comment.
+ * Parameters:
+ * pBuild - Pointer to the build.
+ * cpManifestFile - The path and file name of the build manifest.
+ * Returns:  Zero for success and a negative number for failure.
+------------------------------------------------------------------------------*/
+static int read_build_manifest(BuildContext* pBuild, const char* cpManifestFile)
+{
+    char* cpLine;
+    char* cpEnd;
+    char* cpLineEnd;
+
+    FILE* pManifestFile;
+
+    long iFileLength;
+
+    int iReturnValue;
+
+    uint32_t iLineNumber;
+
+    //Read the whole file into memory.  The names of the modules are left in it
+    //for the rest of the build.
+    pManifestFile = fopen(cpManifestFile, "rb");
+    if(pManifestFile == NULL)
+    {
+        print_error(__func__, BuildManifestError);
+        return -BuildManifestError;
+    }
+
+    iFileLength = -1;
+    if(fseek(pManifestFile, 0, SEEK_END) == 0)
+        iFileLength = ftell(pManifestFile);
+
+    if(iFileLength >= 0 && fseek(pManifestFile, 0, SEEK_SET) == 0)
+        pBuild->m_cpManifest = (char*)malloc((size_t)iFileLength + NULL_TERMINATING_BYTE_LENGTH);
+
+    if(pBuild->m_cpManifest == NULL || fread(pBuild->m_cpManifest, 1, (size_t)iFileLength, pManifestFile) != (size_t)iFileLength)
+    {
+        fclose(pManifestFile);
+        print_error(__func__, BuildManifestError);
+        return -BuildManifestError;
+    }
+
+    fclose(pManifestFile);
+    pBuild->m_cpManifest[iFileLength] = '\0';
+
+    //Go through the lines.  Each one is ended where it is so the names in it
+    //end there as well.
+    iReturnValue = EXIT_SUCCESS;
+    iLineNumber = 0;
+    cpEnd = pBuild->m_cpManifest + iFileLength;
+    for(cpLine = pBuild->m_cpManifest; cpLine < cpEnd && iReturnValue == EXIT_SUCCESS; cpLine = cpLineEnd + 1)
+    {
+        iLineNumber++;
+
+        cpLineEnd = memchr(cpLine, '\n', (size_t)(cpEnd - cpLine));
+        if(cpLineEnd == NULL)
+            cpLineEnd = cpEnd;
+
+        *cpLineEnd = '\0';
+        iReturnValue = parse_build_manifest_line(pBuild, cpLine, iLineNumber);
+    }
+
+    //A manifest with nothing in it is no build at all.
+    if(iReturnValue == EXIT_SUCCESS && pBuild->m_iNumberOfModules == 0)
+    {
+        print_error(__func__, BuildManifestError);
+        return -BuildManifestError;
+    }
+
+    return iReturnValue;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  parse_build_manifest_line
+ * Function Description:  Adds the module on a line of the build manifest and
+ *                        the modules it depends on.  The names are ended in the
+ *                        line.
+ * Parameters:
+ * pBuild - Pointer to the build.
+ * cpLine - The line, which is ended at the end of the line.
+ * iLineNumber - The number of the line in the manifest.
+ * Returns:  Zero for success and a negative number for failure.
+------------------------------------------------------------------------------*/
+static int parse_build_manifest_line(BuildContext* pBuild, char* cpLine, uint32_t iLineNumber)
+{
+    char* cpName;
+    char* cpNameEnd;
+
+    uint32_t iNameIndex;
+
+    uint8_t bIsLastName;
+
+    int iReturnValue;
+
+    //Drop the comment.
+    cpName = strchr(cpLine, BUILD_COMMENT_CHARACTER);
+    if(cpName != NULL)
+        *cpName = '\0';
+
+    //The first name is the module, the second has to be the separator, and the
+    //rest are the modules it depends on.  White spaces include a carriage
+    //return.
+    iReturnValue = EXIT_SUCCESS;
+    cpName = cpLine;
+    for(iNameIndex = 0; iReturnValue == EXIT_SUCCESS; iNameIndex++)
+    {
+        while(*cpName != '\0' && isspace(*cpName) != 0)
+            cpName++;
+
+        if(*cpName == '\0')
+            break;
+
+        cpNameEnd = cpName;
+        while(*cpNameEnd != '\0' && isspace(*cpNameEnd) == 0)
+            cpNameEnd++;
+
+        bIsLastName = (*cpNameEnd == '\0') ? TRUE : FALSE;
+        *cpNameEnd = '\0';
+
+        if(iNameIndex == 0 && strcmp(cpName, BUILD_DEPENDENCY_SEPARATOR) != 0)
+        {
+            iReturnValue = add_build_module(pBuild, cpName, iLineNumber);
+        }
+        else if(iNameIndex == 1 && strcmp(cpName, BUILD_DEPENDENCY_SEPARATOR) == 0)
+        {
+            //Nothing to do for the separator.
+        }
+        else if(iNameIndex > 1)
+        {
+            iReturnValue = add_build_dependency(&pBuild->m_pModules[pBuild->m_iNumberOfModules - 1], cpName);
+        }
+        else
+        {
+            print_error(__func__, BuildManifestError);
+            printf("Line %u of the build manifest.\n", iLineNumber);
+            iReturnValue = -BuildManifestError;
+        }
+
+        if(bIsLastName == TRUE)
+            break;
+
+        cpName = cpNameEnd + 1;
+    }
+
+    return iReturnValue;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  add_source_file_modules
+ * Function Description:  Adds a module for each passed source file.  A source
+ *                        file passed more than once waits for the copy before
+ *                        it, since both write the same files, but is assembled
+ *                        even if that one fails.
+ * Parameters:
+ * pBuild - Pointer to the build.
+ * Returns:  Zero for success and a negative number for failure.
+------------------------------------------------------------------------------*/
+static int add_source_file_modules(BuildContext* pBuild)
+{
+    int iReturnValue;
+
+    uint32_t iIndex;
+    uint32_t iPreviousCopy;
+
+    for(iIndex = 0; iIndex < get_number_of_source_files(); iIndex++)
+    {
+        iReturnValue = append_build_module(pBuild, get_source_file_argument(iIndex));
+        if(iReturnValue != EXIT_SUCCESS)
+            return iReturnValue;
+
+        for(iPreviousCopy = iIndex; iPreviousCopy > 0; iPreviousCopy--)
+        {
+            if(strcasecmp(pBuild->m_pModules[iPreviousCopy - 1].m_cpFileName, pBuild->m_pModules[iIndex].m_cpFileName) == 0)
+            {
+                pBuild->m_pModules[iIndex].m_iPreviousCopy = iPreviousCopy - 1;
+                break;
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  add_build_module
+ * Function Description:  Adds a module of the manifest to the build.  A source
+ *                        file can only be a module once.
+ * Parameters:
+ * pBuild - Pointer to the build.
+ * cpFileName - The path and file name of the source file.
+ * iLineNumber - The number of the line in the manifest.
+ * Returns:  Zero for success and a negative number for failure.
+------------------------------------------------------------------------------*/
+static int add_build_module(BuildContext* pBuild, const char* cpFileName, uint32_t iLineNumber)
+{
+    int iReturnValue;
+
+    if(find_build_module(pBuild, cpFileName) != BUILD_NO_MODULE)
+    {
+        print_error(__func__, BuildManifestError);
+        printf("Line %u of the build manifest.\n", iLineNumber);
+        return -BuildManifestError;
+    }
+
+    iReturnValue = append_build_module(pBuild, cpFileName);
+    if(iReturnValue == EXIT_SUCCESS)
+        pBuild->m_pModules[pBuild->m_iNumberOfModules - 1].m_iManifestLineNumber = iLineNumber;
+
+    return iReturnValue;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  append_build_module
+ * Function Description:  Adds a module to the end of the modules.
+ * Parameters:
+ * pBuild - Pointer to the build.
+ * cpFileName - The path and file name of the source file.
+ * Returns:  Zero for success and a negative number for failure.
+------------------------------------------------------------------------------*/
+static int append_build_module(BuildContext* pBuild, const char* cpFileName)
+{
+    BuildModule* pModules;
+
+    uint32_t iCapacity;
+
+    //Grow the modules when they are full.
+    if(pBuild->m_iNumberOfModules == pBuild->m_iModulesCapacity)
+    {
+        iCapacity = (pBuild->m_iModulesCapacity == 0) ? BUILD_MODULES_INITIAL_CAPACITY : pBuild->m_iModulesCapacity * 2;
+        pModules = (BuildModule*)realloc(pBuild->m_pModules, iCapacity * sizeof(BuildModule));
+        if(pModules == NULL)
+        {
+            print_error(__func__, MallocReturnedNull);
+            return -MallocReturnedNull;
+        }
+
+        pBuild->m_pModules = pModules;
+        pBuild->m_iModulesCapacity = iCapacity;
+    }
+
+    memset(&pBuild->m_pModules[pBuild->m_iNumberOfModules], 0, sizeof(BuildModule));
+    pBuild->m_pModules[pBuild->m_iNumberOfModules].m_cpFileName = cpFileName;
+    pBuild->m_pModules[pBuild->m_iNumberOfModules].m_iPreviousCopy = BUILD_NO_MODULE;
+    pBuild->m_iNumberOfModules++;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  add_build_dependency
+ * Function Description:  Adds the name of a module that a module depends on.
+ *                        The name is looked up once the whole manifest is read.
+ * Parameters:
+ * pModule - Pointer to the module.
+ * cpDependencyName - The path and file name of the module depended on.
+ * Returns:  Zero for success and a negative number for failure.
+------------------------------------------------------------------------------*/
+static int add_build_dependency(BuildModule* pModule, char* cpDependencyName)
+{
+    char** cppNames;
+
+    uint32_t iCapacity;
+
+    if(pModule->m_iNumberOfDependencies == pModule->m_iDependenciesCapacity)
+    {
+        iCapacity = (pModule->m_iDependenciesCapacity == 0) ? BUILD_DEPENDENCIES_INITIAL_CAPACITY : pModule->m_iDependenciesCapacity * 2;
+        cppNames = (char**)realloc(pModule->m_cppDependencyNames, iCapacity * sizeof(char*));
+        if(cppNames == NULL)
+        {
+            print_error(__func__, MallocReturnedNull);
+            return -MallocReturnedNull;
+        }
+
+        pModule->m_cppDependencyNames = cppNames;
+        pModule->m_iDependenciesCapacity = iCapacity;
+    }
+
+    pModule->m_cppDependencyNames[pModule->m_iNumberOfDependencies] = cpDependencyName;
+    pModule->m_iNumberOfDependencies++;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  find_build_module
+ * Function Description:  Finds a module of the build by the name of its source
+ *                        file.  Case doesn't matter, the same as for the files
+ *                        themselves.
+ * Parameters:
+ * pBuild - Pointer to the build.
+ * cpFileName - The path and file name of the source file.
+ * Returns:  The index of the module, or BUILD_NO_MODULE if there is none.
+------------------------------------------------------------------------------*/
+static uint32_t find_build_module(BuildContext* pBuild, const char* cpFileName)
+{
+    uint32_t iIndex;
+
+    for(iIndex = 0; iIndex < pBuild->m_iNumberOfModules; iIndex++)
+    {
+        if(strcasecmp(pBuild->m_pModules[iIndex].m_cpFileName, cpFileName) == 0)
+            return iIndex;
+    }
+
+    return BUILD_NO_MODULE;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  link_build_modules
+ * Function Description:  Looks up the modules each module depends on and has
+ *                        them point back to it, so that finishing a module
+ *                        tells which ones can go next.  A module also waits for
+ *                        the copy of it before it.
+ * Parameters:
+ * pBuild - Pointer to the build.
+ * Returns:  Zero for success and a negative number for failure.
+------------------------------------------------------------------------------*/
+static int link_build_modules(BuildContext* pBuild)
+{
+    BuildModule* pModule;
+
+    int iReturnValue;
+
+    uint32_t iIndex;
+    uint32_t iDependency;
+    uint32_t iDependencyIndex;
+
+    for(iIndex = 0; iIndex < pBuild->m_iNumberOfModules; iIndex++)
+    {
+        pModule = &pBuild->m_pModules[iIndex];
+        if(pModule->m_iPreviousCopy != BUILD_NO_MODULE)
+        {
+            iReturnValue = add_build_dependent(pBuild, pModule->m_iPreviousCopy, iIndex);
+            if(iReturnValue != EXIT_SUCCESS)
+                return iReturnValue;
+        }
+
+        for(iDependency = 0; iDependency < pModule->m_iNumberOfDependencies; iDependency++)
+        {
+            iDependencyIndex = find_build_module(pBuild, pModule->m_cppDependencyNames[iDependency]);
+            if(iDependencyIndex == BUILD_NO_MODULE)
+            {
+                print_error(__func__, UnknownBuildModuleError);
+                printf("Line %u of the build manifest.\n", pModule->m_iManifestLineNumber);
+                return -UnknownBuildModuleError;
+            }
+
+            iReturnValue = add_build_dependent(pBuild, iDependencyIndex, iIndex);
+            if(iReturnValue != EXIT_SUCCESS)
+                return iReturnValue;
+        }
+    }
+
+    return check_build_for_cycles(pBuild);
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  add_build_dependent
+ * Function Description:  Has a module wait for another one.
+ * Parameters:
+ * pBuild - Pointer to the build.
+ * iDependencyIndex - The index of the module that is waited for.
+ * iIndex - The index of the module that waits.
+ * Returns:  Zero for success and a negative number for failure.
+------------------------------------------------------------------------------*/
+static int add_build_dependent(BuildContext* pBuild, uint32_t iDependencyIndex, uint32_t iIndex)
+{
+    BuildModule* pDependency = &pBuild->m_pModules[iDependencyIndex];
+
+    uint32_t* ipDependents;
+
+    uint32_t iCapacity;
+
+    if(pDependency->m_iNumberOfDependents == pDependency->m_iDependentsCapacity)
+    {
+        iCapacity = (pDependency->m_iDependentsCapacity == 0) ? BUILD_DEPENDENCIES_INITIAL_CAPACITY : pDependency->m_iDependentsCapacity * 2;
+        ipDependents = (uint32_t*)realloc(pDependency->m_ipDependents, iCapacity * sizeof(uint32_t));
+        if(ipDependents == NULL)
+        {
+            print_error(__func__, MallocReturnedNull);
+            return -MallocReturnedNull;
+        }
+
+        pDependency->m_ipDependents = ipDependents;
+        pDependency->m_iDependentsCapacity = iCapacity;
+    }
+
+    pDependency->m_ipDependents[pDependency->m_iNumberOfDependents] = iIndex;
+    pDependency->m_iNumberOfDependents++;
+    pBuild->m_pModules[iIndex].m_iUnfinishedDependencies++;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  check_build_for_cycles
+ * Function Description:  Makes sure every module can be reached by finishing
+ *                        the ones it depends on first.  Modules that depend on
+ *                        each other, directly or not, would wait forever.
+ * Parameters:
+ * pBuild - Pointer to the build.
+ * Returns:  Zero for success and a negative number for failure.
+------------------------------------------------------------------------------*/
+static int check_build_for_cycles(BuildContext* pBuild)
+{
+    BuildModule* pModule;
+
+    uint32_t* ipUnfinished;
+    uint32_t* ipOrder;
+
+    uint32_t iIndex;
+    uint32_t iDependent;
+    uint32_t iNumberOrdered;
+    uint32_t iNumberVisited;
+
+    ipUnfinished = (uint32_t*)malloc(pBuild->m_iNumberOfModules * sizeof(uint32_t));
+    ipOrder = (uint32_t*)malloc(pBuild->m_iNumberOfModules * sizeof(uint32_t));
+    if(ipUnfinished == NULL || ipOrder == NULL)
+    {
+        free(ipUnfinished);
+        free(ipOrder);
+        print_error(__func__, MallocReturnedNull);
+        return -MallocReturnedNull;
+    }
+
+    //Finish the modules that depend on nothing and keep finishing the ones
+    //that no longer wait.  Anything left over is in a cycle.
+    iNumberOrdered = 0;
+    for(iIndex = 0; iIndex < pBuild->m_iNumberOfModules; iIndex++)
+    {
+        ipUnfinished[iIndex] = pBuild->m_pModules[iIndex].m_iUnfinishedDependencies;
+        if(ipUnfinished[iIndex] == 0)
+            ipOrder[iNumberOrdered++] = iIndex;
+    }
+
+    for(iNumberVisited = 0; iNumberVisited < iNumberOrdered; iNumberVisited++)
+    {
+        pModule = &pBuild->m_pModules[ipOrder[iNumberVisited]];
+        for(iDependent = 0; iDependent < pModule->m_iNumberOfDependents; iDependent++)
+        {
+            iIndex = pModule->m_ipDependents[iDependent];
+            ipUnfinished[iIndex]--;
+            if(ipUnfinished[iIndex] == 0)
+                ipOrder[iNumberOrdered++] = iIndex;
+        }
+    }
+
+    free(ipUnfinished);
+    free(ipOrder);
+
+    if(iNumberOrdered != pBuild->m_iNumberOfModules)
+    {
+        print_error(__func__, CircularBuildDependencyError);
+        return -CircularBuildDependencyError;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  schedule_build_modules
+ * Function Description:  Assembles the modules as they become ready, on the
+ *                        workers when there are any.  This thread keeps track of
+ *                        what is finished and prints the modules in order.
+ * Parameters:
+ * pBuild - Pointer to the build.
+ * Returns:  Zero for success and a negative number for failure.  Failures of
+ *           the modules themselves are left in the modules.
+------------------------------------------------------------------------------*/
+static int schedule_build_modules(BuildContext* pBuild)
+{
+    uint32_t iIndex;
+
+    //Every module goes through each queue once, and each worker is sent one
+    //more entry to stop it.
+    pBuild->m_ipReadyModules = (uint32_t*)malloc((pBuild->m_iNumberOfModules + BUILD_MAX_WORKERS) * sizeof(uint32_t));
+    pBuild->m_ipFinishedModules = (uint32_t*)malloc(pBuild->m_iNumberOfModules * sizeof(uint32_t));
+    pBuild->m_ipSkippedModules = (uint32_t*)malloc(pBuild->m_iNumberOfModules * sizeof(uint32_t));
+    if(pBuild->m_ipReadyModules == NULL || pBuild->m_ipFinishedModules == NULL || pBuild->m_ipSkippedModules == NULL)
+    {
+        print_error(__func__, MallocReturnedNull);
+        return -MallocReturnedNull;
+    }
+
+    start_build_workers(pBuild);
+
+    for(iIndex = 0; iIndex < pBuild->m_iNumberOfModules; iIndex++)
+    {
+        if(pBuild->m_pModules[iIndex].m_iUnfinishedDependencies == 0)
+            queue_build_module(pBuild, iIndex);
+    }
+
+    //There is always a module ready or being assembled until all of them are
+    //finished since the manifest has no cycles.
+    while(pBuild->m_iNumberOfFinishedModules < pBuild->m_iNumberOfModules)
+    {
+        if(pBuild->m_iNumberOfWorkers == 0)
+        {
+            iIndex = pBuild->m_ipReadyModules[pBuild->m_iReadyTakeIndex];
+            pBuild->m_iReadyTakeIndex++;
+            assemble_build_module(pBuild, iIndex);
+        }
+        else
+        {
+            iIndex = take_finished_module(pBuild);
+        }
+
+        finish_build_module(pBuild, iIndex);
+    }
+
+    stop_build_workers(pBuild);
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  start_build_workers
+ * Function Description:  Starts a worker for each processor, up to the number
+ *                        of modules.  When there is one processor, or the
+ *                        workers can't be started, the build goes without them.
+ * Parameters:
+ * pBuild - Pointer to the build.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void start_build_workers(BuildContext* pBuild)
+{
+    SYSTEM_INFO systemInfo;
+
+    uint32_t iNumberOfWorkers;
+    uint32_t iWorker;
+
+    GetSystemInfo(&systemInfo);
+    iNumberOfWorkers = (uint32_t)systemInfo.dwNumberOfProcessors;
+    if(iNumberOfWorkers > pBuild->m_iNumberOfModules)
+        iNumberOfWorkers = pBuild->m_iNumberOfModules;
+
+    if(iNumberOfWorkers > BUILD_MAX_WORKERS)
+        iNumberOfWorkers = BUILD_MAX_WORKERS;
+
+    if(iNumberOfWorkers < 2)
+        return;
+
+    pBuild->m_hLock = CreateSemaphore(NULL, 1, 1, NULL);
+    pBuild->m_hReadyModules = CreateSemaphore(NULL, 0, (LONG)(pBuild->m_iNumberOfModules + BUILD_MAX_WORKERS), NULL);
+    pBuild->m_hFinishedModules = CreateSemaphore(NULL, 0, (LONG)pBuild->m_iNumberOfModules, NULL);
+    if(pBuild->m_hLock != NULL && pBuild->m_hReadyModules != NULL && pBuild->m_hFinishedModules != NULL)
+    {
+        for(iWorker = 0; iWorker < iNumberOfWorkers; iWorker++)
+        {
+            pBuild->m_haWorkers[pBuild->m_iNumberOfWorkers] = CreateThread(NULL, 0, build_worker_thread, pBuild, 0, NULL);
+            if(pBuild->m_haWorkers[pBuild->m_iNumberOfWorkers] != NULL)
+                pBuild->m_iNumberOfWorkers++;
+        }
+    }
+
+    //Without a worker the semaphores aren't needed.
+    if(pBuild->m_iNumberOfWorkers == 0)
+        stop_build_workers(pBuild);
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  stop_build_workers
+ * Function Description:  Sends every worker the entry that stops it, waits for
+ *                        them to end, and closes the semaphores.
+ * Parameters:
+ * pBuild - Pointer to the build.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void stop_build_workers(BuildContext* pBuild)
+{
+    uint32_t iWorker;
+
+    for(iWorker = 0; iWorker < pBuild->m_iNumberOfWorkers; iWorker++)
+        queue_build_module(pBuild, BUILD_NO_MODULE);
+
+    for(iWorker = 0; iWorker < pBuild->m_iNumberOfWorkers; iWorker++)
+    {
+        WaitForSingleObject(pBuild->m_haWorkers[iWorker], INFINITE);
+        CloseHandle(pBuild->m_haWorkers[iWorker]);
+        pBuild->m_haWorkers[iWorker] = NULL;
+    }
+
+    pBuild->m_iNumberOfWorkers = 0;
+
+    if(pBuild->m_hLock != NULL)
+        CloseHandle(pBuild->m_hLock);
+
+    if(pBuild->m_hReadyModules != NULL)
+        CloseHandle(pBuild->m_hReadyModules);
+
+    if(pBuild->m_hFinishedModules != NULL)
+        CloseHandle(pBuild->m_hFinishedModules);
+
+    pBuild->m_hLock = NULL;
+    pBuild->m_hReadyModules = NULL;
+    pBuild->m_hFinishedModules = NULL;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  build_worker_thread
+ * Function Description:  The thread function of a build worker.  Whichever
+ *                        worker is free takes the next ready module, assembles
+ *                        it, and hands it back finished, until it takes the
+ *                        entry that stops it.
+ * Parameters:
+ * vpBuild - Pointer to the build.
+ * Returns:  Zero.
+------------------------------------------------------------------------------*/
+static DWORD WINAPI build_worker_thread(LPVOID vpBuild)
+{
+    BuildContext* pBuild = (BuildContext*)vpBuild;
+
+    uint32_t iIndex;
+
+    while(TRUE)
+    {
+        WaitForSingleObject(pBuild->m_hReadyModules, INFINITE);
+        lock_build(pBuild);
+        iIndex = pBuild->m_ipReadyModules[pBuild->m_iReadyTakeIndex];
+        pBuild->m_iReadyTakeIndex++;
+        unlock_build(pBuild);
+
+        if(iIndex == BUILD_NO_MODULE)
+            break;
+
+        assemble_build_module(pBuild, iIndex);
+
+        lock_build(pBuild);
+        pBuild->m_ipFinishedModules[pBuild->m_iFinishedPutIndex] = iIndex;
+        pBuild->m_iFinishedPutIndex++;
+        unlock_build(pBuild);
+        ReleaseSemaphore(pBuild->m_hFinishedModules, 1, NULL);
+    }
+
+    return 0;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  assemble_build_module
+ * Function Description:  Assembles a module in an assembler context of its own.
+ *                        What the assembly prints is kept in the module.
+ * Parameters:
+ * pBuild - Pointer to the build.
+ * iIndex - The index of the module.
+ * Returns:  None.  The exit value is left in the module.
+------------------------------------------------------------------------------*/
+static void assemble_build_module(BuildContext* pBuild, uint32_t iIndex)
+{
+    BuildModule* pModule = &pBuild->m_pModules[iIndex];
+
+    AssemblerContext* pContext;
+
+    int iReturnValue;
+
+    redirect_message_output(&pModule->m_messages);
+
+    //The path and the file name are taken apart by functions that may not be
+    //safe on two threads at once, so only one worker at a time does it.
+    lock_build(pBuild);
+    pContext = create_assembler_context();
+    if(pContext == NULL)
+        iReturnValue = -MallocReturnedNull;
+    else
+        iReturnValue = select_source_name(pContext, pModule->m_cpFileName);
+    unlock_build(pBuild);
+
+    if(iReturnValue == EXIT_SUCCESS)
+    {
+        iReturnValue = do_assembly(pContext);
+        if(iReturnValue == EXIT_SUCCESS)
+            print_message("Assembly successful.\n");
+    }
+
+    if(pContext != NULL)
+        free_assembler_context(pContext);
+
+    redirect_message_output(NULL);
+
+    pModule->m_iReturnValue = iReturnValue;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  queue_build_module
+ * Function Description:  Puts a module that is ready on the ready queue.
+ * Parameters:
+ * pBuild - Pointer to the build.
+ * iIndex - The index of the module, or BUILD_NO_MODULE to stop a worker.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void queue_build_module(BuildContext* pBuild, uint32_t iIndex)
+{
+    lock_build(pBuild);
+    pBuild->m_ipReadyModules[pBuild->m_iReadyPutIndex] = iIndex;
+    pBuild->m_iReadyPutIndex++;
+    unlock_build(pBuild);
+
+    if(pBuild->m_iNumberOfWorkers != 0)
+        ReleaseSemaphore(pBuild->m_hReadyModules, 1, NULL);
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  take_finished_module
+ * Function Description:  Waits for a worker to finish a module.
+ * Parameters:
+ * pBuild - Pointer to the build.
+ * Returns:  The index of the module.
+------------------------------------------------------------------------------*/
+static uint32_t take_finished_module(BuildContext* pBuild)
+{
+    uint32_t iIndex;
+
+    WaitForSingleObject(pBuild->m_hFinishedModules, INFINITE);
+    lock_build(pBuild);
+    iIndex = pBuild->m_ipFinishedModules[pBuild->m_iFinishedTakeIndex];
+    pBuild->m_iFinishedTakeIndex++;
+    unlock_build(pBuild);
+
+    return iIndex;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  finish_build_module
+ * Function Description:  Marks a module finished and queues the modules that
+ *                        were only waiting for it.  Those that depend on a
+ *                        module that failed are finished without being
+ *                        assembled, along with everything that depends on them.
+ * Parameters:
+ * pBuild - Pointer to the build.
+ * iIndex - The index of the module.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void finish_build_module(BuildContext* pBuild, uint32_t iIndex)
+{
+    BuildModule* pModule;
+    BuildModule* pDependent;
+
+    uint32_t iNumberSkipped;
+    uint32_t iModuleIndex;
+    uint32_t iDependent;
+    uint32_t iDependentIndex;
+
+    //A module is only skipped once, when the last of its dependencies
+    //finishes, so the skipped modules always fit.
+    pBuild->m_ipSkippedModules[0] = iIndex;
+    iNumberSkipped = 1;
+    while(iNumberSkipped != 0)
+    {
+        iNumberSkipped--;
+        iModuleIndex = pBuild->m_ipSkippedModules[iNumberSkipped];
+        pModule = &pBuild->m_pModules[iModuleIndex];
+        pModule->m_bIsFinished = TRUE;
+        pBuild->m_iNumberOfFinishedModules++;
+
+        for(iDependent = 0; iDependent < pModule->m_iNumberOfDependents; iDependent++)
+        {
+            iDependentIndex = pModule->m_ipDependents[iDependent];
+            pDependent = &pBuild->m_pModules[iDependentIndex];
+            //Waiting for the copy before it is only so the two don't write
+            //the same files at once.
+            if(pModule->m_iReturnValue != EXIT_SUCCESS && pDependent->m_iPreviousCopy != iModuleIndex)
+                pDependent->m_bHasFailedDependency = TRUE;
+
+            pDependent->m_iUnfinishedDependencies--;
+            if(pDependent->m_iUnfinishedDependencies != 0)
+                continue;
+
+            if(pDependent->m_bHasFailedDependency == TRUE)
+            {
+                redirect_message_output(&pDependent->m_messages);
+                print_error(__func__, FailedBuildDependencyError);
+                redirect_message_output(NULL);
+                pDependent->m_iReturnValue = -FailedBuildDependencyError;
+
+                pBuild->m_ipSkippedModules[iNumberSkipped] = iDependentIndex;
+                iNumberSkipped++;
+            }
+            else
+            {
+                queue_build_module(pBuild, iDependentIndex);
+            }
+        }
+    }
+
+    print_finished_modules(pBuild);
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  print_finished_modules
+ * Function Description:  Prints what the finished modules printed, in the order
+ *                        of the manifest, up to the first module that isn't
+ *                        finished yet.
+ * Parameters:
+ * pBuild - Pointer to the build.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void print_finished_modules(BuildContext* pBuild)
+{
+    BuildModule* pModule;
+
+    while(pBuild->m_iNextModuleToPrint < pBuild->m_iNumberOfModules)
+    {
+        pModule = &pBuild->m_pModules[pBuild->m_iNextModuleToPrint];
+        if(pModule->m_bIsFinished == FALSE)
+            break;
+
+        //Only name the module when there is more than one so the output for a
+        //single module is the same as for a single file.
+        if(pBuild->m_iNumberOfModules > 1)
+            printf("%sAssembling %s\n", (pBuild->m_iNextModuleToPrint == 0) ? "" : "\n", pModule->m_cpFileName);
+
+        if(pModule->m_messages.m_iLength != 0)
+            fwrite(pModule->m_messages.m_cpData, 1, pModule->m_messages.m_iLength, stdout);
+
+        free_memory_buffer(&pModule->m_messages);
+        pBuild->m_iNextModuleToPrint++;
+    }
+
+    fflush(stdout);
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  lock_build
+ * Function Description:  Takes the lock on the queues when there are workers.
+ * Parameters:
+ * pBuild - Pointer to the build.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void lock_build(BuildContext* pBuild)
+{
+    if(pBuild->m_hLock != NULL)
+        WaitForSingleObject(pBuild->m_hLock, INFINITE);
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  unlock_build
+ * Function Description:  Gives back the lock on the queues.
+ * Parameters:
+ * pBuild - Pointer to the build.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void unlock_build(BuildContext* pBuild)
+{
+    if(pBuild->m_hLock != NULL)
+        ReleaseSemaphore(pBuild->m_hLock, 1, NULL);
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  free_build_memory
+ * Function Description:  Frees the memory of the build.
+ * Parameters:
+ * pBuild - Pointer to the build.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void free_build_memory(BuildContext* pBuild)
+{
+    uint32_t iIndex;
+
+    for(iIndex = 0; iIndex < pBuild->m_iNumberOfModules; iIndex++)
+    {
+        free(pBuild->m_pModules[iIndex].m_cppDependencyNames);
+        free(pBuild->m_pModules[iIndex].m_ipDependents);
+        free_memory_buffer(&pBuild->m_pModules[iIndex].m_messages);
+    }
+
+    free(pBuild->m_pModules);
+    free(pBuild->m_ipReadyModules);
+    free(pBuild->m_ipFinishedModules);
+    free(pBuild->m_ipSkippedModules);
+    free(pBuild->m_cpManifest);
+    memset(pBuild, 0, sizeof(BuildContext));
+}
@@ -0,0 +1,116 @@
+/*
+ ********************************************************************************
+ ** Copyright (C) 2026 Donald J. Bartley <djbcoffee@gmail.com>
+ **
+ ** This source file may be used and distributed without restriction provided
+ ** that this copyright statement is not removed from the file and that any
+ ** derivative work contains the original copyright notice and the associated
+ ** disclaimer.
+ **
+ ** This source file is free software; you can redistribute it and/or modify it
+ ** under the terms of the GNU General Public License as published by the Free
+ ** Software Foundation; either version 2 of the License, or (at your option) any
+ ** later version.
+ **
+ ** This source file is distributed in the hope that it will be useful, but
+ ** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along with
+ ** this source file.  If not, see <http://www.gnu.org/licenses/> or write to the
+ ** Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ ** 02110-1301, USA.
+ ********************************************************************************
+ ** File: nanocore-as/src/build.h
+ **
+ ** Description:
+ ** Header file that goes with build.c
+ ********************************************************************************
+ ** Version 1.0.0
+ ********************************************************************************
+ */
+
+#ifndef ___BUILD_H___
+#define ___BUILD_H___
+
+//------------------------------------------------------------------------------
+//Defines
+#define BUILD_MODULES_INITIAL_CAPACITY          (16)
+#define BUILD_DEPENDENCIES_INITIAL_CAPACITY     (4)
+#define BUILD_MAX_WORKERS                       (64)
+#define BUILD_DEPENDENCY_SEPARATOR              ":"
+#define BUILD_COMMENT_CHARACTER                 ';'
+#define BUILD_NO_MODULE                         (UINT32_MAX)
+
+//------------------------------------------------------------------------------
+//Enumerations
+//None
+
+//------------------------------------------------------------------------------
+//Structures
+//A module of a build, which is a source file and the modules that have to be
+//assembled before it.  The names point into the text of the manifest, or to
+//the passed source files.  The previous copy is the module before it with the
+//same source file, which can only happen for passed source files.  The
+//dependents are the modules that wait for this one, and the messages are what
+//its assembly printed.
+typedef struct tagBuildModule
+{
+    const char* m_cpFileName;
+    uint32_t m_iManifestLineNumber;
+    uint32_t m_iPreviousCopy;
+
+    char** m_cppDependencyNames;
+    uint32_t m_iNumberOfDependencies;
+    uint32_t m_iDependenciesCapacity;
+
+    uint32_t* m_ipDependents;
+    uint32_t m_iNumberOfDependents;
+    uint32_t m_iDependentsCapacity;
+
+    uint32_t m_iUnfinishedDependencies;
+    uint8_t m_bHasFailedDependency;
+    uint8_t m_bIsFinished;
+    int m_iReturnValue;
+    MemoryBuffer m_messages;
+} BuildModule;
+
+//The modules of a build and the queues between the thread that schedules them
+//and the workers that assemble them.  Every module goes through each queue at
+//most once, so the queues are arrays that are only added to, with the indexes
+//moved under the lock.  The ready semaphore counts the modules waiting for a
+//worker and the finished semaphore counts the modules waiting to be scheduled
+//after.  A build without workers assembles the ready modules itself.
+typedef struct tagBuildContext
+{
+    char* m_cpManifest;
+
+    BuildModule* m_pModules;
+    uint32_t m_iNumberOfModules;
+    uint32_t m_iModulesCapacity;
+
+    uint32_t* m_ipReadyModules;
+    uint32_t m_iReadyPutIndex;
+    uint32_t m_iReadyTakeIndex;
+    uint32_t* m_ipFinishedModules;
+    uint32_t m_iFinishedPutIndex;
+    uint32_t m_iFinishedTakeIndex;
+    uint32_t* m_ipSkippedModules;
+
+    uint32_t m_iNumberOfFinishedModules;
+    uint32_t m_iNextModuleToPrint;
+
+    HANDLE m_hLock;
+    HANDLE m_hReadyModules;
+    HANDLE m_hFinishedModules;
+    HANDLE m_haWorkers[BUILD_MAX_WORKERS];
+    uint32_t m_iNumberOfWorkers;
+} BuildContext;
+
+//------------------------------------------------------------------------------
+//Prototypes
+int run_build(const char* cpManifestFile);
+int assemble_source_files(void);
+
+#endif /*___BUILD_H___*/
@@ -0,0 +1,150 @@
+/*
+ ********************************************************************************
+ ** Copyright (C) 2026 Donald J. Bartley <djbcoffee@gmail.com>
+ **
+ ** This source file may be used and distributed without restriction provided
+ ** that this copyright statement is not removed from the file and that any
+ ** derivative work contains the original copyright notice and the associated
+ ** disclaimer.
+ **
+ ** This source file is free software; you can redistribute it and/or modify it
+ ** under the terms of the GNU General Public License as published by the Free
+ ** Software Foundation; either version 2 of the License, or (at your option) any
+ ** later version.
+ **
+ ** This source file is distributed in the hope that it will be useful, but
+ ** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along with
+ ** this source file.  If not, see <http://www.gnu.org/licenses/> or write to the
+ ** Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ ** 02110-1301, USA.
+ ********************************************************************************
+ ** File: nanocore-as/src/context.c
+ **
+ ** Description:
+ ** This translation (compilation) unit creates and frees assembler contexts.  A
+ ** context holds all of the state of one assembly, which is passed to every
+ ** function that needs it.
+ ********************************************************************************
+ ** Version 1.0.0
+ ********************************************************************************
+ */
+
+//System #includes
+#ifndef _WINDOWS_H
+#include <windows.h>
+#endif
+#ifndef _STDIO_H
+#include <stdio.h>
+#endif
+#ifndef _STDINT_H
+#include <stdint.h>
+#endif
+#ifndef _STDLIB_H
+#include <stdlib.h>
+#endif
+
+//Project-wide #includes
+#ifndef ___UNIVERSAL_H___
+#include "universal.h"
+#endif
+
+//Project #includes
+#ifndef ___ARGUMENTS_H___
+#include "arguments.h"
+#endif
+#ifndef ___BSTREE_H___
+#include "bstree.h"
+#endif
+#ifndef ___EXPRESSION_H___
+#include "expression.h"
+#endif
+#ifndef ___FILES_H___
+#include "files.h"
+#endif
+#ifndef ___LAYOUT_H___
+#include "layout.h"
+#endif
+#ifndef ___LEXER_H___
+#include "lexer.h"
+#endif
+#ifndef ___LISTING_H___
+#include "listing.h"
+#endif
+#ifndef ___LOG_H___
+#include "log.h"
+#endif
+
+//Reflective #includes
+#ifndef ___CONTEXT_H___
+#include "context.h"
+#endif
+
+//------------------------------------------------------------------------------
+//Global Data
+//None
+
+//------------------------------------------------------------------------------
+//Static Data
+//None
+
+//------------------------------------------------------------------------------
+//Static Prototypes
+//None
+
+//==============================================================================
+//Functions
+/*------------------------------------------------------------------------------
+ * Function name:  create_assembler_context
+ * Function Description:  Allocates an empty assembler context.  It starts out
+ *                        with the options passed on the command line.
+ * Parameters:  None.
+ * Returns:  Pointer to the context or NULL if it could not be allocated.
+------------------------------------------------------------------------------*/
+AssemblerContext* create_assembler_context(void)
+{
+    AssemblerContext* pContext;
+
+    //All of the state starts out as zero and NULL.
+    pContext = (AssemblerContext*)calloc(1, sizeof(AssemblerContext));
+    if(pContext == NULL)
+    {
+        print_error(__func__, MallocReturnedNull);
+        return NULL;
+    }
+
+    copy_command_line_options(pContext);
+
+    return pContext;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  free_assembler_context
+ * Function Description:  Closes the files of an assembler context and frees all
+ *                        of its memory, including the context itself.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+void free_assembler_context(AssemblerContext* pContext)
+{
+    if(pContext == NULL)
+        return;
+
+    //Close all open files from the files translation (compilation) unit.
+    //This is done first since the listing and binary files are moved into
+    //place by the name of the source file.
+    close_all_files(pContext);
+
+    //Free all allocated memory from each translation (compilation) unit.
+    free_source_file_names(pContext);
+    free_lexer_memory(pContext);
+    free_expression_memory(pContext);
+    free_layout_memory(pContext);
+    free_listing_memory(pContext);
+
+    free(pContext);
+}
@@ -0,0 +1,89 @@
+/*
+ ********************************************************************************
+ ** Copyright (C) 2026 Donald J. Bartley <djbcoffee@gmail.com>
+ **
+ ** This source file may be used and distributed without restriction provided
+ ** that this copyright statement is not removed from the file and that any
+ ** derivative work contains the original copyright notice and the associated
+ ** disclaimer.
+ **
+ ** This source file is free software; you can redistribute it and/or modify it
+ ** under the terms of the GNU General Public License as published by the Free
+ ** Software Foundation; either version 2 of the License, or (at your option) any
+ ** later version.
+ **
+ ** This source file is distributed in the hope that it will be useful, but
+ ** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along with
+ ** this source file.  If not, see <http://www.gnu.org/licenses/> or write to the
+ ** Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ ** 02110-1301, USA.
+ ********************************************************************************
+ ** File: nanocore-as/src/context.h
+ **
+ ** Description:
+ ** Header file that goes with context.c
+ ********************************************************************************
+ ** Version 1.0.0
+ ********************************************************************************
+ */
+
+#ifndef ___CONTEXT_H___
+#define ___CONTEXT_H___
+
+//Project #includes
+//The assembler context is made up of the context of each translation
+//(compilation) unit so their headers are needed for the complete type.
+#ifndef ___ARGUMENTS_H___
+#include "arguments.h"
+#endif
+#ifndef ___BSTREE_H___
+#include "bstree.h"
+#endif
+#ifndef ___EXPRESSION_H___
+#include "expression.h"
+#endif
+#ifndef ___FILES_H___
+#include "files.h"
+#endif
+#ifndef ___LAYOUT_H___
+#include "layout.h"
+#endif
+#ifndef ___LEXER_H___
+#include "lexer.h"
+#endif
+#ifndef ___LISTING_H___
+#include "listing.h"
+#endif
+
+//------------------------------------------------------------------------------
+//Defines
+//None
+
+//------------------------------------------------------------------------------
+//Enumerations
+//None
+
+//------------------------------------------------------------------------------
+//Structures
+//Everything needed to assemble one source file.  Nothing is shared between two
+//contexts so each one can be assembled on its own thread.
+struct tagAssemblerContext
+{
+    ArgumentsContext m_arguments;
+    ExpressionContext m_expression;
+    FilesContext m_files;
+    LayoutContext m_layout;
+    LexerContext m_lexer;
+    ListingContext m_listing;
+};
+
+//------------------------------------------------------------------------------
+//Prototypes
+AssemblerContext* create_assembler_context(void);
+void free_assembler_context(AssemblerContext* pContext);
+
+#endif /*___CONTEXT_H___*/
@@ -61,6 +61,9 @@
 #ifndef _WINDOWS_H
 #include <windows.h>
 #endif
+#ifndef _STDIO_H
+#include <stdio.h>
+#endif
 #ifndef _STDINT_H
 #include <stdint.h>
 #endif
@@ -76,6 +79,9 @@
 #ifndef _STDLIB_H
 #include <stdlib.h>
 #endif
+#ifndef _LIMITS_H
+#include <limits.h>
+#endif
 
 //Project-wide #includes
 #ifndef ___UNIVERSAL_H___
@@ -86,6 +92,9 @@
 #ifndef ___BSTREE_H___
 #include "bstree.h"
 #endif
+#ifndef ___CONTEXT_H___
+#include "context.h"
+#endif
 #ifndef ___LEXER_H___
 #include "lexer.h"
 #endif
@@ -101,52 +110,641 @@
 
 //------------------------------------------------------------------------------
 //Static Data
-//None
+//Precedence of each opcode on the operator stack.  Zero for everything that
+//isn't a binary operator so the parentheses are never popped by an operator.
+static const uint8_t s_iaOperatorPrecedence[] =
+{
+    0,  //ConstantOp
+    0,  //SymbolOp
+    0,  //LocationCounterOp
+    0,  //NegateOp
+    3,  //AddOp
+    3,  //SubtractOp
+    4,  //MultiplyOp
+    4,  //DivideOp
+    2,  //AndOp
+    1,  //OrOp
+    0,  //LeftParenthesisOp
+    0   //NegatedLeftParenthesisOp
+};
 
 //------------------------------------------------------------------------------
 //Static Prototypes
-static int get_b_expression(ExpressionParseInfo* pExpressionInfo, char** cppSourceLine);
-static int get_b_term(ExpressionParseInfo* pExpressionInfo, char** cppSourceLine);
-static int get_expression(ExpressionParseInfo* pExpressionInfo, char** cppSourceLine);
-static int get_term(ExpressionParseInfo* pExpressionInfo, char** cppSourceLine);
-static int get_signed_factor(ExpressionParseInfo* pExpressionInfo, char** cppSourceLine);
-static int get_factor(ExpressionParseInfo* pExpressionInfo, char** cppSourceLine);
-static int get_number(ExpressionParseInfo* pExpressionInfo, char** cppSourceLine);
-static int push_number_stack(ExpressionParseInfo* pExpressionInfo);
-static int pop_number_stack(ExpressionParseInfo* pExpressionInfo);
+static int compile_to_ops(AssemblerContext* pContext, char** cppSourceLine, CompiledExpression* pExpression);
+static int evaluate_ops(AssemblerContext* pContext, const CompiledExpression* pExpression, uint32_t iLocationCounter, int* ipValue, uint32_t* ipErrorPosition);
+static int run_ops(AssemblerContext* pContext, const CompiledExpression* pExpression, uint32_t iLocationCounter, int* ipValue, uint32_t* ipErrorPosition, SymbolInfo** ppUnresolvedSymbol);
+static int resolve_symbol(AssemblerContext* pContext, SymbolInfo* pSymbolInfo, uint32_t* ipErrorPosition);
+static int push_resolve_stack(AssemblerContext* pContext, SymbolInfo* pSymbolInfo, uint32_t iDepth);
+static int find_unknown_symbol(AssemblerContext* pContext, const CompiledExpression* pExpression, uint32_t* ipErrorPosition);
+static CompiledExpression* find_compiled_expression(AssemblerContext* pContext);
+static int store_compiled_expression(AssemblerContext* pContext, const CompiledExpression* pExpression);
+static int emit_op(AssemblerContext* pContext, uint8_t iOpcode, int iValue, uint32_t iPosition);
+static int emit_symbol_op(AssemblerContext* pContext, const char* cpSymbol, uint32_t iPosition);
+static int find_symbol_reference(AssemblerContext* pContext, const char* cpSymbol, uint32_t* ipReference);
+static int grow_symbol_reference_slots(AssemblerContext* pContext);
+static SymbolInfo* get_referenced_symbol(AssemblerContext* pContext, uint32_t iReference);
+static int reserve_number_stack(AssemblerContext* pContext, uint32_t iDepth);
+static int find_expression_memo(AssemblerContext* pContext, const char* cpText, uint32_t iLength, uint32_t* ipMemo);
+static int grow_memo_slots(AssemblerContext* pContext);
+static int parse_expression(AssemblerContext* pContext, ExpressionParseInfo* pExpressionInfo, char** cppSourceLine);
+static uint8_t get_binary_operator(char cCharacter);
+static int push_operator(AssemblerContext* pContext, uint8_t iOpcode, uint32_t iPosition);
+static int pop_operators(AssemblerContext* pContext, uint8_t iPrecedence);
+static int get_factor(AssemblerContext* pContext, ExpressionParseInfo* pExpressionInfo, char** cppSourceLine);
+static int get_number(AssemblerContext* pContext, ExpressionParseInfo* pExpressionInfo, char** cppSourceLine);
+static int get_binary_number(char** cppSourceLine, uint64_t* ipValue);
+static int get_hexadecimal_number(char** cppSourceLine, uint64_t* ipValue);
+static int get_decimal_number(char** cppSourceLine, uint64_t* ipValue);
+static uint64_t load_swar_block(const char* cpBlock);
 static void inc_chr_pointer(char** cppSourceLine);
 
 //==============================================================================
 //Functions
 /*------------------------------------------------------------------------------
  * Function name:  do_expression
- * Function Description:  Parses an expression from the source line.
+ * Function Description:  Gets the value of an expression from the source line.
+ *                        During pass two the expression compiled for it during
+ *                        pass one is used so the text doesn't need to be parsed
+ *                        again.  Otherwise the expression is compiled first.
  * Parameters:
+ * pContext - Pointer to the assembler context.
  * cppSourceLine - Pointer to a character pointer which is the current position
  *                 within the source line.
  * ipValue - A pointer to where to store the final value of the expression.
  * Returns:  Zero for success and a negative value if an error occurs.
 ------------------------------------------------------------------------------*/
-int do_expression(char** cppSourceLine, int* ipValue)
+int do_expression(AssemblerContext* pContext, char** cppSourceLine, int* ipValue)
 {
+    char* cpStartOfExpression;
+
     int iFunctionReturnValue;
 
-    ExpressionParseInfo expressionInfo;
+    uint32_t iNumberOfOps;
+    uint32_t iErrorPosition;
+
+    CompiledExpression* pExpression;
+    CompiledExpression expression;
+
+    ExpressionMemo* pMemo;
 
     //Initialize variables.
-    expressionInfo.m_iNumberStackIndex = NUMBER_STACK_MAX;
+    cpStartOfExpression = *cppSourceLine;
+    iNumberOfOps = pContext->m_expression.m_iNumberOfOps;
+    pExpression = NULL;
+    pMemo = NULL;
+
+    //Look for the expression compiled during pass one.  One that failed to
+    //compile is compiled again so the error is found at the right place.
+    if(get_current_pass(pContext) == PassTwo)
+    {
+        pExpression = find_compiled_expression(pContext);
+        if(pExpression != NULL && pExpression->m_iError != EXIT_SUCCESS)
+            pExpression = NULL;
+    }
+
+    if(pExpression == NULL)
+    {
+        //A shared context can't add to the compiled expressions it shares.
+        if(pContext->m_expression.m_bIsShared == TRUE)
+            return -UncompiledExpressionError;
+
+        iFunctionReturnValue = compile_to_ops(pContext, cppSourceLine, &expression);
+        if(iFunctionReturnValue == -MallocReturnedNull)
+            return iFunctionReturnValue;
+
+        //If there is a compile error any symbol before it must be known first.
+        //The error for an unknown symbol would have stopped the parse sooner.
+        if(iFunctionReturnValue != EXIT_SUCCESS)
+        {
+            if(find_unknown_symbol(pContext, &expression, &iErrorPosition) != EXIT_SUCCESS)
+            {
+                *cppSourceLine = cpStartOfExpression + iErrorPosition;
+                iFunctionReturnValue = -UnknownSymbolError;
+            }
+
+            pContext->m_expression.m_iNumberOfOps = iNumberOfOps;
+            return iFunctionReturnValue;
+        }
+
+        //Only pass one keeps what it compiles.
+        if(get_current_pass(pContext) == PassOne)
+        {
+            iFunctionReturnValue = store_compiled_expression(pContext, &expression);
+            if(iFunctionReturnValue != EXIT_SUCCESS)
+                return iFunctionReturnValue;
+
+            //A detached context doesn't have the symbols or location counter of
+            //the lines before it.
+            if(pContext->m_expression.m_bIsDetached == TRUE && expression.m_bIsConstant == FALSE)
+                return -DetachedExpressionError;
+        }
+
+        pExpression = &expression;
+    }
+    else
+    {
+        //Move past the expression just as the compile would have.
+        *cppSourceLine += pExpression->m_iLength;
+
+        //If the same expression was already evaluated use its value.
+        if(pExpression->m_iMemo != 0)
+        {
+            pMemo = &pContext->m_expression.m_pMemos[pExpression->m_iMemo - 1];
+            if(pMemo->m_bIsValid == TRUE)
+            {
+                pContext->m_expression.m_iMemoHits++;
+                *ipValue = pMemo->m_iValue;
+                return EXIT_SUCCESS;
+            }
+
+            pContext->m_expression.m_iMemoMisses++;
+        }
+    }
+
+    //Run the postfix instructions.
+    iFunctionReturnValue = evaluate_ops(pContext, pExpression, get_location_counter_value(pContext), ipValue, &iErrorPosition);
+
+    //Instructions compiled during pass two are only needed for this call.
+    if(get_current_pass(pContext) == PassTwo)
+        pContext->m_expression.m_iNumberOfOps = iNumberOfOps;
 
-    //Start getting the expression.
-    iFunctionReturnValue = get_b_expression(&expressionInfo, cppSourceLine);
     if(iFunctionReturnValue != EXIT_SUCCESS)
+    {
+        *cppSourceLine = cpStartOfExpression + iErrorPosition;
         return iFunctionReturnValue;
+    }
 
-    //We are done with the expression.  Set the vale of the expression.
-    *ipValue = expressionInfo.m_iRightOperand;
+    //Keep the value for the next copy of the expression.
+    if(pMemo != NULL)
+    {
+        pMemo->m_iValue = *ipValue;
+        pMemo->m_bIsValid = TRUE;
+    }
 
     return EXIT_SUCCESS;
 }
 
+/*------------------------------------------------------------------------------
+ * Function name:  compile_expression
+ * Function Description:  Compiles an expression during pass one without getting
+ *                        its value, for expressions whose value isn't needed
+ *                        until pass two.  Errors aren't reported here, they are
+ *                        reported when the expression is used in pass two.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * cpSourceLine - Character pointer to the start of the expression within the
+ *                source line.
+ * Returns:  Zero for success and a negative value if memory could not be
+ *           allocated.
+------------------------------------------------------------------------------*/
+int compile_expression(AssemblerContext* pContext, char* cpSourceLine)
+{
+    int iFunctionReturnValue;
+
+    CompiledExpression expression;
+
+    iFunctionReturnValue = compile_to_ops(pContext, &cpSourceLine, &expression);
+    if(iFunctionReturnValue == -MallocReturnedNull)
+        return iFunctionReturnValue;
+
+    //Keep the error, the instructions aren't needed.
+    if(iFunctionReturnValue != EXIT_SUCCESS)
+    {
+        pContext->m_expression.m_iNumberOfOps = expression.m_iFirstOp;
+        expression.m_iNumberOfOps = 0;
+        expression.m_iError = iFunctionReturnValue;
+    }
+
+    return store_compiled_expression(pContext, &expression);
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  do_symbol_expression
+ * Function Description:  Gets the value of the expression for an EQU symbol.
+ *                        During pass one an expression which refers to symbols
+ *                        that aren't known yet is kept unresolved so it can
+ *                        refer to later labels and EQUs.  Its value is worked
+ *                        out when it is first needed, or at the latest when the
+ *                        EQU is reached during pass two.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * cppSourceLine - Pointer to a character pointer which is the current position
+ *                 within the source line.
+ * pSymbolInfo - Pointer to the symbol information.  During pass one it is
+ *               filled in, during pass two it is the one in the symbol table.
+ * Returns:  Zero for success and a negative value if an error occurs.
+------------------------------------------------------------------------------*/
+int do_symbol_expression(AssemblerContext* pContext, char** cppSourceLine, SymbolInfo* pSymbolInfo)
+{
+    char* cpStartOfExpression;
+
+    int iFunctionReturnValue;
+    int iValue;
+
+    uint32_t iErrorPosition;
+
+    CompiledExpression* pExpression;
+    CompiledExpression expression;
+
+    //Initialize variables.
+    cpStartOfExpression = *cppSourceLine;
+
+    if(get_current_pass(pContext) == PassOne)
+    {
+        iFunctionReturnValue = compile_to_ops(pContext, cppSourceLine, &expression);
+        if(iFunctionReturnValue != EXIT_SUCCESS)
+        {
+            if(iFunctionReturnValue != -MallocReturnedNull)
+                pContext->m_expression.m_iNumberOfOps = expression.m_iFirstOp;
+
+            return iFunctionReturnValue;
+        }
+
+        iFunctionReturnValue = store_compiled_expression(pContext, &expression);
+        if(iFunctionReturnValue != EXIT_SUCCESS)
+            return iFunctionReturnValue;
+
+        //A detached context can't tell if the symbols are known yet.
+        if(pContext->m_expression.m_bIsDetached == TRUE && expression.m_bIsConstant == FALSE)
+            return -DetachedExpressionError;
+
+        pSymbolInfo->m_iValue = 0;
+        pSymbolInfo->m_iLocationCounter = get_location_counter_value(pContext);
+        pSymbolInfo->m_iExpression = pContext->m_expression.m_iNumberOfCompiledExpressions - 1;
+        pSymbolInfo->m_iState = SymbolUnresolved;
+
+        //Try for the value now.  If it can't be had yet any error is reported
+        //during pass two.
+        if(evaluate_ops(pContext, &expression, pSymbolInfo->m_iLocationCounter, &iValue, &iErrorPosition) == EXIT_SUCCESS)
+        {
+            pSymbolInfo->m_iValue = (uint32_t)iValue;
+            pSymbolInfo->m_iState = SymbolResolved;
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+    //This is pass two.  Without a compiled expression just get the value.
+    pExpression = find_compiled_expression(pContext);
+    if(pExpression == NULL)
+    {
+        iFunctionReturnValue = do_expression(pContext, cppSourceLine, &iValue);
+        if(iFunctionReturnValue != EXIT_SUCCESS)
+            return iFunctionReturnValue;
+
+        pSymbolInfo->m_iValue = (uint32_t)iValue;
+        pSymbolInfo->m_iState = SymbolResolved;
+
+        return EXIT_SUCCESS;
+    }
+
+    //Move past the expression and make sure the symbol has its value.
+    *cppSourceLine += pExpression->m_iLength;
+    iFunctionReturnValue = resolve_symbol(pContext, pSymbolInfo, &iErrorPosition);
+    if(iFunctionReturnValue != EXIT_SUCCESS)
+    {
+        *cppSourceLine = cpStartOfExpression + iErrorPosition;
+        return iFunctionReturnValue;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  reset_compiled_expressions
+ * Function Description:  Throws away all compiled expressions.  Used before pass
+ *                        one.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+void reset_compiled_expressions(AssemblerContext* pContext)
+{
+    pContext->m_expression.m_iNumberOfOps = 0;
+    pContext->m_expression.m_iSymbolNamesUsed = 0;
+    pContext->m_expression.m_iNumberOfCompiledExpressions = 0;
+    pContext->m_expression.m_iCompiledExpressionIndex = 0;
+
+    pContext->m_expression.m_iNumberOfSymbolReferences = 0;
+    if(pContext->m_expression.m_ipSymbolReferenceSlots != NULL)
+        memset(pContext->m_expression.m_ipSymbolReferenceSlots, 0, pContext->m_expression.m_iNumberOfSymbolReferenceSlots * sizeof(uint32_t));
+
+    pContext->m_expression.m_iNumberOfMemos = 0;
+    pContext->m_expression.m_iMemoTextUsed = 0;
+    pContext->m_expression.m_iMemoHits = 0;
+    pContext->m_expression.m_iMemoMisses = 0;
+    if(pContext->m_expression.m_ipMemoSlots != NULL)
+        memset(pContext->m_expression.m_ipMemoSlots, 0, pContext->m_expression.m_iNumberOfMemoSlots * sizeof(uint32_t));
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  rewind_compiled_expressions
+ * Function Description:  Goes back to the first compiled expression and looks
+ *                        up every symbol reference not already found, marking
+ *                        the ones still missing as unknown.  Used before pass
+ *                        two.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+void rewind_compiled_expressions(AssemblerContext* pContext)
+{
+    uint32_t i;
+
+    pContext->m_expression.m_iCompiledExpressionIndex = 0;
+
+    for(i = 0; i < pContext->m_expression.m_iNumberOfSymbolReferences; i++)
+    {
+        if(get_referenced_symbol(pContext, i) == NULL)
+            pContext->m_expression.m_pSymbolReferences[i].m_bIsUnknown = TRUE;
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  get_number_of_compiled_expressions
+ * Function Description:  Getter function for the number of compiled expressions.
+ *                        The last expression compiled during pass one has an
+ *                        index of one less than this.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  The number of compiled expressions.
+------------------------------------------------------------------------------*/
+uint32_t get_number_of_compiled_expressions(AssemblerContext* pContext)
+{
+    return pContext->m_expression.m_iNumberOfCompiledExpressions;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  evaluate_compiled_expression
+ * Function Description:  Gets the value of an expression compiled during pass
+ *                        one using the symbol values as they are now.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * iExpression - The index of the compiled expression.
+ * iLocationCounter - The value of the location counter for the expression.
+ * ipValue - A pointer to where to store the value of the expression.
+ * Returns:  Zero for success and a negative value if an error occurs.
+------------------------------------------------------------------------------*/
+int evaluate_compiled_expression(AssemblerContext* pContext, uint32_t iExpression, uint32_t iLocationCounter, int* ipValue)
+{
+    uint32_t iErrorPosition;
+
+    if(pContext->m_expression.m_pCompiledExpressions[iExpression].m_iError != EXIT_SUCCESS)
+        return pContext->m_expression.m_pCompiledExpressions[iExpression].m_iError;
+
+    return evaluate_ops(pContext, &pContext->m_expression.m_pCompiledExpressions[iExpression], iLocationCounter, ipValue, &iErrorPosition);
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  resolve_equ_symbol
+ * Function Description:  Works out the value of an EQU symbol now rather than
+ *                        when it is first needed.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * pSymbolInfo - Pointer to the symbol information.
+ * Returns:  Zero for success and a negative value if an error occurs.
+------------------------------------------------------------------------------*/
+int resolve_equ_symbol(AssemblerContext* pContext, SymbolInfo* pSymbolInfo)
+{
+    uint32_t iErrorPosition;
+
+    return resolve_symbol(pContext, pSymbolInfo, &iErrorPosition);
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  share_compiled_expressions
+ * Function Description:  Sets up a context to use the compiled expressions of
+ *                        another context during pass two.  The shared context
+ *                        gets its own work stacks and a copy of the memos so
+ *                        the two can evaluate expressions at the same time.
+ *                        Every symbol must already be resolved since resolving
+ *                        one changes the symbol table.
+ * Parameters:
+ * pContext - Pointer to the assembler context that will share.
+ * pOwnerContext - Pointer to the assembler context the compiled expressions
+ *                 belong to.
+ * Returns:  Zero for success and a negative value if an error occurs.
+------------------------------------------------------------------------------*/
+int share_compiled_expressions(AssemblerContext* pContext, AssemblerContext* pOwnerContext)
+{
+    pContext->m_expression = pOwnerContext->m_expression;
+    pContext->m_expression.m_bIsShared = TRUE;
+
+    pContext->m_expression.m_pOperatorStack = NULL;
+    pContext->m_expression.m_iNumberOfOperators = 0;
+    pContext->m_expression.m_iOperatorStackCapacity = 0;
+
+    pContext->m_expression.m_ipNumberStack = NULL;
+    pContext->m_expression.m_iNumberStackCapacity = 0;
+
+    pContext->m_expression.m_ppResolveStack = NULL;
+    pContext->m_expression.m_iResolveStackCapacity = 0;
+
+    pContext->m_expression.m_pMemos = NULL;
+    pContext->m_expression.m_iMemosCapacity = 0;
+    pContext->m_expression.m_iMemoHits = 0;
+    pContext->m_expression.m_iMemoMisses = 0;
+
+    if(pOwnerContext->m_expression.m_iNumberOfMemos != 0)
+    {
+        pContext->m_expression.m_pMemos = malloc(pOwnerContext->m_expression.m_iNumberOfMemos * sizeof(ExpressionMemo));
+        if(pContext->m_expression.m_pMemos == NULL)
+            return -MallocReturnedNull;
+
+        memcpy(pContext->m_expression.m_pMemos, pOwnerContext->m_expression.m_pMemos, pOwnerContext->m_expression.m_iNumberOfMemos * sizeof(ExpressionMemo));
+        pContext->m_expression.m_iMemosCapacity = pOwnerContext->m_expression.m_iNumberOfMemos;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  free_shared_expression_memory
+ * Function Description:  Frees the memory a shared context has of its own.  The
+ *                        compiled expressions are left for the context they
+ *                        belong to.
+ * Parameters:
+ * pContext - Pointer to the assembler context that shares.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+void free_shared_expression_memory(AssemblerContext* pContext)
+{
+    if(pContext->m_expression.m_pOperatorStack != NULL)
+        free(pContext->m_expression.m_pOperatorStack);
+
+    if(pContext->m_expression.m_ipNumberStack != NULL)
+        free(pContext->m_expression.m_ipNumberStack);
+
+    if(pContext->m_expression.m_ppResolveStack != NULL)
+        free(pContext->m_expression.m_ppResolveStack);
+
+    if(pContext->m_expression.m_pMemos != NULL)
+        free(pContext->m_expression.m_pMemos);
+
+    pContext->m_expression.m_pOperatorStack = NULL;
+    pContext->m_expression.m_ipNumberStack = NULL;
+    pContext->m_expression.m_ppResolveStack = NULL;
+    pContext->m_expression.m_pMemos = NULL;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  free_expression_memory
+ * Function Description:  Frees all allocated memory used by the expression
+ *                        compiler.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+void free_expression_memory(AssemblerContext* pContext)
+{
+    if(pContext->m_expression.m_pOps != NULL)
+        free(pContext->m_expression.m_pOps);
+
+    if(pContext->m_expression.m_cpSymbolNames != NULL)
+        free(pContext->m_expression.m_cpSymbolNames);
+
+    if(pContext->m_expression.m_pSymbolReferences != NULL)
+        free(pContext->m_expression.m_pSymbolReferences);
+
+    if(pContext->m_expression.m_ipSymbolReferenceSlots != NULL)
+        free(pContext->m_expression.m_ipSymbolReferenceSlots);
+
+    if(pContext->m_expression.m_pCompiledExpressions != NULL)
+        free(pContext->m_expression.m_pCompiledExpressions);
+
+    if(pContext->m_expression.m_pOperatorStack != NULL)
+        free(pContext->m_expression.m_pOperatorStack);
+
+    if(pContext->m_expression.m_ipNumberStack != NULL)
+        free(pContext->m_expression.m_ipNumberStack);
+
+    if(pContext->m_expression.m_ppResolveStack != NULL)
+        free(pContext->m_expression.m_ppResolveStack);
+
+    if(pContext->m_expression.m_pMemos != NULL)
+        free(pContext->m_expression.m_pMemos);
+
+    if(pContext->m_expression.m_ipMemoSlots != NULL)
+        free(pContext->m_expression.m_ipMemoSlots);
+
+    if(pContext->m_expression.m_cpMemoText != NULL)
+        free(pContext->m_expression.m_cpMemoText);
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  get_expression_memo_hits
+ * Function Description:  Getter function for the number of times pass two used
+ *                        the value of an expression that was already evaluated.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  The number of hits.
+------------------------------------------------------------------------------*/
+uint32_t get_expression_memo_hits(AssemblerContext* pContext)
+{
+    return pContext->m_expression.m_iMemoHits;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  get_expression_memo_misses
+ * Function Description:  Getter function for the number of times pass two had to
+ *                        evaluate an expression that could have its value shared.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  The number of misses.
+------------------------------------------------------------------------------*/
+uint32_t get_expression_memo_misses(AssemblerContext* pContext)
+{
+    return pContext->m_expression.m_iMemoMisses;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  add_expression_memo_counts
+ * Function Description:  Adds the memo hits and misses of a shared context to
+ *                        those of the context it shares with.
+ * Parameters:
+ * pContext - Pointer to the assembler context with the compiled expressions.
+ * pSharedContext - Pointer to the assembler context that shares.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+void add_expression_memo_counts(AssemblerContext* pContext, AssemblerContext* pSharedContext)
+{
+    pContext->m_expression.m_iMemoHits += pSharedContext->m_expression.m_iMemoHits;
+    pContext->m_expression.m_iMemoMisses += pSharedContext->m_expression.m_iMemoMisses;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  append_compiled_expressions
+ * Function Description:  Adds the expressions compiled by another context during
+ *                        pass one to the end of the compiled expressions.  The
+ *                        symbol references and memos they use are looked up by
+ *                        name and text so copies are shared as if they had been
+ *                        compiled here.
+ * Parameters:
+ * pContext - Pointer to the assembler context to add to.
+ * pOtherContext - Pointer to the assembler context that compiled the
+ *                 expressions.
+ * iLineNumberOffset - The number of source lines in front of the first line of
+ *                     the other context.
+ * Returns:  Zero for success and a negative value if an error occurs.
+------------------------------------------------------------------------------*/
+int append_compiled_expressions(AssemblerContext* pContext, AssemblerContext* pOtherContext, uint32_t iLineNumberOffset)
+{
+    int iFunctionReturnValue;
+
+    uint32_t* ipReferences;
+    uint32_t* ipMemos;
+    uint32_t iFirstOp;
+    uint32_t i;
+
+    const ExpressionOp* pOp;
+
+    const ExpressionMemo* pMemo;
+
+    CompiledExpression expression;
+
+    //Both maps are made in one block.  The memo map holds one more than the
+    //memo index, the same as a compiled expression does.
+    ipReferences = malloc((pOtherContext->m_expression.m_iNumberOfSymbolReferences + pOtherContext->m_expression.m_iNumberOfMemos + 1) * sizeof(uint32_t));
+    if(ipReferences == NULL)
+        return -MallocReturnedNull;
+
+    ipMemos = ipReferences + pOtherContext->m_expression.m_iNumberOfSymbolReferences;
+
+    iFunctionReturnValue = EXIT_SUCCESS;
+    for(i = 0; i < pOtherContext->m_expression.m_iNumberOfSymbolReferences && iFunctionReturnValue == EXIT_SUCCESS; i++)
+        iFunctionReturnValue = find_symbol_reference(pContext, pOtherContext->m_expression.m_cpSymbolNames + pOtherContext->m_expression.m_pSymbolReferences[i].m_iNameOffset, &ipReferences[i]);
+
+    for(i = 0; i < pOtherContext->m_expression.m_iNumberOfMemos && iFunctionReturnValue == EXIT_SUCCESS; i++)
+    {
+        pMemo = &pOtherContext->m_expression.m_pMemos[i];
+        iFunctionReturnValue = find_expression_memo(pContext, pOtherContext->m_expression.m_cpMemoText + pMemo->m_iTextOffset, pMemo->m_iTextLength, &ipMemos[i]);
+    }
+
+    //Copy the instructions with each symbol instruction holding the index of
+    //the reference here.
+    iFirstOp = pContext->m_expression.m_iNumberOfOps;
+    for(i = 0; i < pOtherContext->m_expression.m_iNumberOfOps && iFunctionReturnValue == EXIT_SUCCESS; i++)
+    {
+        pOp = &pOtherContext->m_expression.m_pOps[i];
+        iFunctionReturnValue = emit_op(pContext, pOp->m_iOpcode, (pOp->m_iOpcode == SymbolOp) ? (int)ipReferences[pOp->m_iValue] : pOp->m_iValue, pOp->m_iPosition);
+    }
+
+    for(i = 0; i < pOtherContext->m_expression.m_iNumberOfCompiledExpressions && iFunctionReturnValue == EXIT_SUCCESS; i++)
+    {
+        expression = pOtherContext->m_expression.m_pCompiledExpressions[i];
+        expression.m_iSourceLineNumber += iLineNumberOffset;
+        expression.m_iFirstOp += iFirstOp;
+        if(expression.m_iMemo != 0)
+            expression.m_iMemo = ipMemos[expression.m_iMemo - 1];
+
+        iFunctionReturnValue = store_compiled_expression(pContext, &expression);
+    }
+
+    free(ipReferences);
+
+    return iFunctionReturnValue;
+}
+
 /*------------------------------------------------------------------------------
  * Function name:  get_symbol
  * Function Description:  Processes a symbol from the source file line.
@@ -219,243 +817,1070 @@ int get_esc_character(char cEscCharacter)
 }
 
 /*------------------------------------------------------------------------------
- * Function name:  get_b_expression
- * Function Description:  Parses the b-expression portion of the source line.
+ * Function name:  compile_to_ops
+ * Function Description:  Compiles the expression at the current position into
+ *                        postfix instructions.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * cppSourceLine - Pointer to a character pointer which is the current position
+ *                 within the source line.
+ * pExpression - Pointer to where to describe the compiled expression.
+ * Returns:  Zero for success and a negative value if an error occurs.
+------------------------------------------------------------------------------*/
+static int compile_to_ops(AssemblerContext* pContext, char** cppSourceLine, CompiledExpression* pExpression)
+{
+    int iFunctionReturnValue;
+    int iValue;
+
+    uint32_t iErrorPosition;
+    uint32_t iDepth;
+    uint32_t i;
+
+    ExpressionParseInfo expressionInfo;
+
+    //Initialize variables.
+    expressionInfo.m_cpStartOfExpression = *cppSourceLine;
+    expressionInfo.m_iOpenParentheses = 0;
+    expressionInfo.m_bHasReferences = FALSE;
+    expressionInfo.m_bHasLocationCounter = FALSE;
+
+    pExpression->m_iSourceLineNumber = get_source_line_number(pContext);
+    pExpression->m_iFirstOp = pContext->m_expression.m_iNumberOfOps;
+    pExpression->m_iError = EXIT_SUCCESS;
+    pExpression->m_iNumberStackDepth = 0;
+    pExpression->m_iMemo = 0;
+    pExpression->m_iValue = 0;
+    pExpression->m_bIsConstant = FALSE;
+
+    //Start getting the expression.
+    iFunctionReturnValue = parse_expression(pContext, &expressionInfo, cppSourceLine);
+
+    pExpression->m_iNumberOfOps = pContext->m_expression.m_iNumberOfOps - pExpression->m_iFirstOp;
+    pExpression->m_iLength = (uint32_t)(*cppSourceLine - expressionInfo.m_cpStartOfExpression);
+
+    if(iFunctionReturnValue != EXIT_SUCCESS)
+        return iFunctionReturnValue;
+
+    //Work out how deep the number stack gets when the expression is evaluated.
+    //Values push one number and binary operators take one off.
+    iDepth = 0;
+    for(i = pExpression->m_iFirstOp; i < pContext->m_expression.m_iNumberOfOps; i++)
+    {
+        if(pContext->m_expression.m_pOps[i].m_iOpcode <= LocationCounterOp)
+        {
+            iDepth++;
+            pExpression->m_iNumberStackDepth = bmc_max(iDepth, pExpression->m_iNumberStackDepth);
+        }
+        else if(pContext->m_expression.m_pOps[i].m_iOpcode != NegateOp)
+        {
+            iDepth--;
+        }
+    }
+
+    //Without symbols or the location counter the value can never change so
+    //fold it now and drop the instructions.  One that fails, such as dividing by
+    //zero, is left to report its error when it is used.
+    if(expressionInfo.m_bHasReferences == FALSE && evaluate_ops(pContext, pExpression, 0, &iValue, &iErrorPosition) == EXIT_SUCCESS)
+    {
+        pContext->m_expression.m_iNumberOfOps = pExpression->m_iFirstOp;
+        pExpression->m_iNumberOfOps = 0;
+        pExpression->m_iValue = iValue;
+        pExpression->m_bIsConstant = TRUE;
+    }
+
+    //Expressions kept during pass one share their value with every other copy of
+    //the same text, unless the value depends on where the expression is.
+    if(get_current_pass(pContext) == PassOne && pExpression->m_bIsConstant == FALSE && expressionInfo.m_bHasLocationCounter == FALSE)
+        return find_expression_memo(pContext, expressionInfo.m_cpStartOfExpression, pExpression->m_iLength, &(pExpression->m_iMemo));
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  evaluate_ops
+ * Function Description:  Runs the postfix instructions of a compiled expression.
+ *                        A symbol whose value hasn't been worked out yet is
+ *                        resolved first and the instructions are run again.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * pExpression - Pointer to the compiled expression.
+ * iLocationCounter - The value of the location counter symbol.
+ * ipValue - A pointer to where to store the final value of the expression.
+ * ipErrorPosition - A pointer to where to store the position of the failing
+ *                   instruction if an error occurs.
+ * Returns:  Zero for success and a negative value if an error occurs.
+------------------------------------------------------------------------------*/
+static int evaluate_ops(AssemblerContext* pContext, const CompiledExpression* pExpression, uint32_t iLocationCounter, int* ipValue, uint32_t* ipErrorPosition)
+{
+    int iFunctionReturnValue;
+
+    uint32_t iSymbolErrorPosition;
+
+    SymbolInfo* pUnresolvedSymbol;
+
+    while(TRUE)
+    {
+        iFunctionReturnValue = run_ops(pContext, pExpression, iLocationCounter, ipValue, ipErrorPosition, &pUnresolvedSymbol);
+        if(iFunctionReturnValue != EXIT_SUCCESS || pUnresolvedSymbol == NULL)
+            return iFunctionReturnValue;
+
+        //The error is shown at this symbol since the expression that failed
+        //belongs to another line.
+        iFunctionReturnValue = resolve_symbol(pContext, pUnresolvedSymbol, &iSymbolErrorPosition);
+        if(iFunctionReturnValue != EXIT_SUCCESS)
+        {
+            if(iFunctionReturnValue != -CircularSymbolError && iFunctionReturnValue != -MallocReturnedNull)
+                iFunctionReturnValue = -UnresolvedSymbolError;
+
+            return iFunctionReturnValue;
+        }
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  run_ops
+ * Function Description:  Runs the postfix instructions of a compiled expression
+ *                        up to the first symbol whose value hasn't been worked
+ *                        out yet.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * pExpression - Pointer to the compiled expression.
+ * iLocationCounter - The value of the location counter symbol.
+ * ipValue - A pointer to where to store the final value of the expression.
+ * ipErrorPosition - A pointer to where to store the position of the failing
+ *                   instruction if an error occurs, or of the unresolved
+ *                   symbol.
+ * ppUnresolvedSymbol - A pointer to where to store the symbol the instructions
+ *                      stopped at, or NULL if they all ran and the value was
+ *                      stored.
+ * Returns:  Zero for success and a negative value if an error occurs.
+------------------------------------------------------------------------------*/
+static int run_ops(AssemblerContext* pContext, const CompiledExpression* pExpression, uint32_t iLocationCounter, int* ipValue, uint32_t* ipErrorPosition, SymbolInfo** ppUnresolvedSymbol)
+{
+    int* ipStack;
+    int iFunctionReturnValue;
+
+    uint32_t iDepth;
+
+    const ExpressionOp* pOp;
+    const ExpressionOp* pEndOfOps;
+
+    SymbolInfo* pSymbolInfo;
+
+    *ppUnresolvedSymbol = NULL;
+
+    //A folded expression already has its value.
+    if(pExpression->m_bIsConstant == TRUE)
+    {
+        *ipValue = pExpression->m_iValue;
+        return EXIT_SUCCESS;
+    }
+
+    //Make room for the deepest the number stack gets in this expression.
+    iFunctionReturnValue = reserve_number_stack(pContext, pExpression->m_iNumberStackDepth);
+    if(iFunctionReturnValue != EXIT_SUCCESS)
+        return iFunctionReturnValue;
+
+    ipStack = pContext->m_expression.m_ipNumberStack;
+
+    iDepth = 0;
+    pEndOfOps = pContext->m_expression.m_pOps + pExpression->m_iFirstOp + pExpression->m_iNumberOfOps;
+    for(pOp = pContext->m_expression.m_pOps + pExpression->m_iFirstOp; pOp < pEndOfOps; pOp++)
+    {
+        switch(pOp->m_iOpcode)
+        {
+            case ConstantOp :
+                ipStack[iDepth++] = pOp->m_iValue;
+                break;
+            case SymbolOp :
+                pSymbolInfo = get_referenced_symbol(pContext, (uint32_t)pOp->m_iValue);
+                if(pSymbolInfo == NULL)
+                {
+                    *ipErrorPosition = pOp->m_iPosition;
+                    return -UnknownSymbolError;
+                }
+
+                if(pSymbolInfo->m_iState != SymbolResolved)
+                {
+                    *ipErrorPosition = pOp->m_iPosition;
+                    *ppUnresolvedSymbol = pSymbolInfo;
+                    return EXIT_SUCCESS;
+                }
+
+                ipStack[iDepth++] = (int)pSymbolInfo->m_iValue;
+                break;
+            case LocationCounterOp :
+                ipStack[iDepth++] = (int)iLocationCounter;
+                break;
+            case NegateOp :
+                ipStack[iDepth - 1] = 0 - ipStack[iDepth - 1];
+                break;
+            case AddOp :
+                iDepth--;
+                ipStack[iDepth - 1] = ipStack[iDepth - 1] + ipStack[iDepth];
+                break;
+            case SubtractOp :
+                iDepth--;
+                ipStack[iDepth - 1] = ipStack[iDepth - 1] - ipStack[iDepth];
+                break;
+            case MultiplyOp :
+                iDepth--;
+                ipStack[iDepth - 1] = ipStack[iDepth - 1] * ipStack[iDepth];
+                break;
+            case DivideOp :
+                iDepth--;
+                if(ipStack[iDepth] == 0)
+                {
+                    *ipErrorPosition = pOp->m_iPosition;
+                    return -DivideByZeroError;
+                }
+
+                //Dividing the most negative number by -1 traps so negate it
+                //instead.
+                if(ipStack[iDepth] == -1)
+                    ipStack[iDepth - 1] = (int)(0U - (uint32_t)ipStack[iDepth - 1]);
+                else
+                    ipStack[iDepth - 1] = ipStack[iDepth - 1] / ipStack[iDepth];
+                break;
+            case AndOp :
+                iDepth--;
+                ipStack[iDepth - 1] = ipStack[iDepth - 1] & ipStack[iDepth];
+                break;
+            case OrOp :
+                iDepth--;
+                ipStack[iDepth - 1] = ipStack[iDepth - 1] | ipStack[iDepth];
+                break;
+            default :
+                break;
+        }
+    }
+
+    *ipValue = ipStack[0];
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  resolve_symbol
+ * Function Description:  Works out the value of an EQU symbol that was left
+ *                        unresolved during pass one.  Any unresolved symbols it
+ *                        refers to are resolved first.  They are kept on a work
+ *                        stack rather than resolved by recursion, so a long
+ *                        chain of EQUs that each refer to the next can't run
+ *                        out of call stack.  A symbol found again while it is
+ *                        on the work stack refers back to itself.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * pSymbolInfo - Pointer to the symbol information.
+ * ipErrorPosition - A pointer to where to store the position within the
+ *                   symbol's expression if an error occurs.
+ * Returns:  Zero for success and a negative value if an error occurs.
+------------------------------------------------------------------------------*/
+static int resolve_symbol(AssemblerContext* pContext, SymbolInfo* pSymbolInfo, uint32_t* ipErrorPosition)
+{
+    int iFunctionReturnValue;
+    int iValue;
+
+    uint32_t iDepth;
+    uint32_t iPosition;
+
+    SymbolInfo* pTopSymbolInfo;
+    SymbolInfo* pUnresolvedSymbol;
+
+    if(pSymbolInfo->m_iState == SymbolResolved)
+        return EXIT_SUCCESS;
+
+    if(pSymbolInfo->m_iState == SymbolResolving)
+    {
+        *ipErrorPosition = 0;
+        return -CircularSymbolError;
+    }
+
+    iFunctionReturnValue = push_resolve_stack(pContext, pSymbolInfo, 0);
+    if(iFunctionReturnValue != EXIT_SUCCESS)
+        return iFunctionReturnValue;
+
+    //Run the expression of the symbol on top.  If it stops at a symbol that
+    //isn't resolved yet that one goes on top, otherwise the symbol on top now
+    //has its value.
+    iDepth = 1;
+    while(iDepth != 0)
+    {
+        pTopSymbolInfo = pContext->m_expression.m_ppResolveStack[iDepth - 1];
+        iFunctionReturnValue = run_ops(pContext, &pContext->m_expression.m_pCompiledExpressions[pTopSymbolInfo->m_iExpression], pTopSymbolInfo->m_iLocationCounter, &iValue, &iPosition, &pUnresolvedSymbol);
+        if(iFunctionReturnValue != EXIT_SUCCESS)
+            break;
+
+        if(pUnresolvedSymbol == NULL)
+        {
+            pTopSymbolInfo->m_iValue = (uint32_t)iValue;
+            pTopSymbolInfo->m_iState = SymbolResolved;
+            iDepth--;
+            continue;
+        }
+
+        if(pUnresolvedSymbol->m_iState == SymbolResolving)
+        {
+            iFunctionReturnValue = -CircularSymbolError;
+            break;
+        }
+
+        //Only the position in the first symbol's own expression is reported.
+        if(iDepth == 1)
+            *ipErrorPosition = iPosition;
+
+        iFunctionReturnValue = push_resolve_stack(pContext, pUnresolvedSymbol, iDepth);
+        if(iFunctionReturnValue != EXIT_SUCCESS)
+            break;
+
+        iDepth++;
+    }
+
+    if(iFunctionReturnValue == EXIT_SUCCESS)
+        return EXIT_SUCCESS;
+
+    //An error in a symbol further up the stack is shown at the symbol the
+    //first expression stopped at, just as for any other line.
+    if(iDepth == 1)
+        *ipErrorPosition = iPosition;
+    else if(iFunctionReturnValue != -CircularSymbolError && iFunctionReturnValue != -MallocReturnedNull)
+        iFunctionReturnValue = -UnresolvedSymbolError;
+
+    //Leave every symbol on the stack to be tried again.
+    while(iDepth != 0)
+    {
+        iDepth--;
+        pContext->m_expression.m_ppResolveStack[iDepth]->m_iState = SymbolUnresolved;
+    }
+
+    return iFunctionReturnValue;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  push_resolve_stack
+ * Function Description:  Marks a symbol as being resolved and puts it on the
+ *                        resolve work stack.  The stack grows as needed.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * pSymbolInfo - Pointer to the symbol information.
+ * iDepth - The number of symbols already on the stack.
+ * Returns:  Zero for success and a negative value if an error occurs.
+------------------------------------------------------------------------------*/
+static int push_resolve_stack(AssemblerContext* pContext, SymbolInfo* pSymbolInfo, uint32_t iDepth)
+{
+    SymbolInfo** ppNewResolveStack;
+
+    uint32_t iNewCapacity;
+
+    if(iDepth == pContext->m_expression.m_iResolveStackCapacity)
+    {
+        iNewCapacity = (pContext->m_expression.m_iResolveStackCapacity == 0) ? RESOLVE_STACK_INITIAL_CAPACITY : pContext->m_expression.m_iResolveStackCapacity * 2;
+        ppNewResolveStack = realloc(pContext->m_expression.m_ppResolveStack, iNewCapacity * sizeof(SymbolInfo*));
+        if(ppNewResolveStack == NULL)
+            return -MallocReturnedNull;
+
+        pContext->m_expression.m_ppResolveStack = ppNewResolveStack;
+        pContext->m_expression.m_iResolveStackCapacity = iNewCapacity;
+    }
+
+    pSymbolInfo->m_iState = SymbolResolving;
+    pContext->m_expression.m_ppResolveStack[iDepth] = pSymbolInfo;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  reserve_number_stack
+ * Function Description:  Makes sure there is room on the number stack for an
+ *                        expression, growing it if needed.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * iDepth - The number of values the expression needs on the stack.
+ * Returns:  Zero for success and a negative value if an error occurs.
+------------------------------------------------------------------------------*/
+static int reserve_number_stack(AssemblerContext* pContext, uint32_t iDepth)
+{
+    int* ipNewNumberStack;
+
+    uint32_t iNewCapacity;
+
+    if(pContext->m_expression.m_iNumberStackCapacity >= iDepth)
+        return EXIT_SUCCESS;
+
+    iNewCapacity = (pContext->m_expression.m_iNumberStackCapacity == 0) ? NUMBER_STACK_INITIAL_CAPACITY : pContext->m_expression.m_iNumberStackCapacity;
+    while(iNewCapacity < iDepth)
+        iNewCapacity *= 2;
+
+    ipNewNumberStack = realloc(pContext->m_expression.m_ipNumberStack, iNewCapacity * sizeof(int));
+    if(ipNewNumberStack == NULL)
+        return -MallocReturnedNull;
+
+    pContext->m_expression.m_ipNumberStack = ipNewNumberStack;
+    pContext->m_expression.m_iNumberStackCapacity = iNewCapacity;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  find_expression_memo
+ * Function Description:  Finds the memo for an expression's text, adding one if
+ *                        this is the first copy of the text.  White spaces are
+ *                        left out so they don't make copies look different.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * cpText - Character pointer to the start of the expression text.
+ * iLength - The length of the expression text.
+ * ipMemo - A pointer to where to store one more than the index of the memo.
+ * Returns:  Zero for success and a negative value if an error occurs.
+------------------------------------------------------------------------------*/
+static int find_expression_memo(AssemblerContext* pContext, const char* cpText, uint32_t iLength, uint32_t* ipMemo)
+{
+    char* cpNewMemoText;
+    char* cpNormalizedText;
+
+    int iFunctionReturnValue;
+
+    uint32_t iNormalizedLength;
+    uint32_t iSlot;
+    uint32_t i;
+
+    uint64_t iHash;
+
+    ExpressionMemo* pNewMemos;
+    ExpressionMemo* pMemo;
+
+    //Make sure the text fits at the end of the text pool.  It is only kept there
+    //if a new memo is added.
+    if(pContext->m_expression.m_iMemoTextSize - pContext->m_expression.m_iMemoTextUsed < iLength)
+    {
+        pContext->m_expression.m_iMemoTextSize = (pContext->m_expression.m_iMemoTextSize == 0) ? EXPRESSION_MEMO_TEXT_INITIAL_SIZE : pContext->m_expression.m_iMemoTextSize;
+        while(pContext->m_expression.m_iMemoTextSize - pContext->m_expression.m_iMemoTextUsed < iLength)
+            pContext->m_expression.m_iMemoTextSize *= 2;
+
+        cpNewMemoText = realloc(pContext->m_expression.m_cpMemoText, pContext->m_expression.m_iMemoTextSize);
+        if(cpNewMemoText == NULL)
+            return -MallocReturnedNull;
+
+        pContext->m_expression.m_cpMemoText = cpNewMemoText;
+    }
+
+    //Copy the text without white spaces and hash it with 64-bit FNV-1a.
+    cpNormalizedText = pContext->m_expression.m_cpMemoText + pContext->m_expression.m_iMemoTextUsed;
+    iNormalizedLength = 0;
+    iHash = FNV_64_OFFSET_BASIS;
+    for(i = 0; i < iLength; i++)
+    {
+        if(isspace(cpText[i]) != 0)
+            continue;
+
+        cpNormalizedText[iNormalizedLength++] = cpText[i];
+        iHash ^= (uint8_t)cpText[i];
+        iHash *= FNV_64_PRIME;
+    }
+
+    //Keep the slots no more than half full.
+    if(pContext->m_expression.m_iNumberOfMemos >= pContext->m_expression.m_iNumberOfMemoSlots / 2)
+    {
+        iFunctionReturnValue = grow_memo_slots(pContext);
+        if(iFunctionReturnValue != EXIT_SUCCESS)
+            return iFunctionReturnValue;
+    }
+
+    //Look for the text.  The slots hold one more than the memo index so zero is
+    //an empty slot.
+    iSlot = (uint32_t)iHash & (pContext->m_expression.m_iNumberOfMemoSlots - 1);
+    while(pContext->m_expression.m_ipMemoSlots[iSlot] != 0)
+    {
+        pMemo = &pContext->m_expression.m_pMemos[pContext->m_expression.m_ipMemoSlots[iSlot] - 1];
+        if(pMemo->m_iHash == iHash && pMemo->m_iTextLength == iNormalizedLength && memcmp(pContext->m_expression.m_cpMemoText + pMemo->m_iTextOffset, cpNormalizedText, iNormalizedLength) == 0)
+        {
+            *ipMemo = pContext->m_expression.m_ipMemoSlots[iSlot];
+            return EXIT_SUCCESS;
+        }
+
+        iSlot = (iSlot + 1) & (pContext->m_expression.m_iNumberOfMemoSlots - 1);
+    }
+
+    //This is the first copy of the text so add a memo for it.
+    if(pContext->m_expression.m_iNumberOfMemos == pContext->m_expression.m_iMemosCapacity)
+    {
+        pContext->m_expression.m_iMemosCapacity = (pContext->m_expression.m_iMemosCapacity == 0) ? EXPRESSION_MEMOS_INITIAL_CAPACITY : pContext->m_expression.m_iMemosCapacity * 2;
+        pNewMemos = realloc(pContext->m_expression.m_pMemos, pContext->m_expression.m_iMemosCapacity * sizeof(ExpressionMemo));
+        if(pNewMemos == NULL)
+            return -MallocReturnedNull;
+
+        pContext->m_expression.m_pMemos = pNewMemos;
+    }
+
+    pMemo = &pContext->m_expression.m_pMemos[pContext->m_expression.m_iNumberOfMemos];
+    pMemo->m_iHash = iHash;
+    pMemo->m_iTextOffset = pContext->m_expression.m_iMemoTextUsed;
+    pMemo->m_iTextLength = iNormalizedLength;
+    pMemo->m_iValue = 0;
+    pMemo->m_bIsValid = FALSE;
+
+    pContext->m_expression.m_iMemoTextUsed += iNormalizedLength;
+    pContext->m_expression.m_iNumberOfMemos++;
+    pContext->m_expression.m_ipMemoSlots[iSlot] = pContext->m_expression.m_iNumberOfMemos;
+    *ipMemo = pContext->m_expression.m_iNumberOfMemos;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  grow_memo_slots
+ * Function Description:  Doubles the number of memo slots and puts the memos
+ *                        back into them.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  Zero for success and a negative value if an error occurs.
+------------------------------------------------------------------------------*/
+static int grow_memo_slots(AssemblerContext* pContext)
+{
+    uint32_t* ipNewMemoSlots;
+
+    uint32_t iNumberOfSlots;
+    uint32_t iSlot;
+    uint32_t i;
+
+    iNumberOfSlots = (pContext->m_expression.m_iNumberOfMemoSlots == 0) ? EXPRESSION_MEMOS_INITIAL_CAPACITY * 2 : pContext->m_expression.m_iNumberOfMemoSlots * 2;
+    ipNewMemoSlots = calloc(iNumberOfSlots, sizeof(uint32_t));
+    if(ipNewMemoSlots == NULL)
+        return -MallocReturnedNull;
+
+    for(i = 0; i < pContext->m_expression.m_iNumberOfMemos; i++)
+    {
+        iSlot = (uint32_t)pContext->m_expression.m_pMemos[i].m_iHash & (iNumberOfSlots - 1);
+        while(ipNewMemoSlots[iSlot] != 0)
+            iSlot = (iSlot + 1) & (iNumberOfSlots - 1);
+
+        ipNewMemoSlots[iSlot] = i + 1;
+    }
+
+    if(pContext->m_expression.m_ipMemoSlots != NULL)
+        free(pContext->m_expression.m_ipMemoSlots);
+
+    pContext->m_expression.m_ipMemoSlots = ipNewMemoSlots;
+    pContext->m_expression.m_iNumberOfMemoSlots = iNumberOfSlots;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  find_unknown_symbol
+ * Function Description:  Looks for the first symbol of a compiled expression
+ *                        that isn't in the symbol table.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * pExpression - Pointer to the compiled expression.
+ * ipErrorPosition - A pointer to where to store the position of the symbol.
+ * Returns:  Zero if all the symbols are known and a negative value otherwise.
+------------------------------------------------------------------------------*/
+static int find_unknown_symbol(AssemblerContext* pContext, const CompiledExpression* pExpression, uint32_t* ipErrorPosition)
+{
+    const ExpressionOp* pOp;
+    const ExpressionOp* pEndOfOps;
+
+    pEndOfOps = pContext->m_expression.m_pOps + pExpression->m_iFirstOp + pExpression->m_iNumberOfOps;
+    for(pOp = pContext->m_expression.m_pOps + pExpression->m_iFirstOp; pOp < pEndOfOps; pOp++)
+    {
+        if(pOp->m_iOpcode == SymbolOp && get_referenced_symbol(pContext, (uint32_t)pOp->m_iValue) == NULL)
+        {
+            *ipErrorPosition = pOp->m_iPosition;
+            return -UnknownSymbolError;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  find_compiled_expression
+ * Function Description:  Finds the next expression compiled during pass one for
+ *                        the current source line.  Expressions are used in the
+ *                        same order they were compiled.  Any left over from
+ *                        earlier lines, such as a line that stopped on an error,
+ *                        are skipped.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  A pointer to the compiled expression or NULL if there isn't one.
+------------------------------------------------------------------------------*/
+static CompiledExpression* find_compiled_expression(AssemblerContext* pContext)
+{
+    uint32_t iSourceLineNumber;
+
+    iSourceLineNumber = get_source_line_number(pContext);
+    while(pContext->m_expression.m_iCompiledExpressionIndex < pContext->m_expression.m_iNumberOfCompiledExpressions && pContext->m_expression.m_pCompiledExpressions[pContext->m_expression.m_iCompiledExpressionIndex].m_iSourceLineNumber < iSourceLineNumber)
+        pContext->m_expression.m_iCompiledExpressionIndex++;
+
+    if(pContext->m_expression.m_iCompiledExpressionIndex < pContext->m_expression.m_iNumberOfCompiledExpressions && pContext->m_expression.m_pCompiledExpressions[pContext->m_expression.m_iCompiledExpressionIndex].m_iSourceLineNumber == iSourceLineNumber)
+    {
+        pContext->m_expression.m_iCompiledExpressionIndex++;
+        return &pContext->m_expression.m_pCompiledExpressions[pContext->m_expression.m_iCompiledExpressionIndex - 1];
+    }
+
+    return NULL;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  store_compiled_expression
+ * Function Description:  Adds a compiled expression to the end of the list of
+ *                        compiled expressions.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * pExpression - Pointer to the compiled expression.
+ * Returns:  Zero for success and a negative value if an error occurs.
+------------------------------------------------------------------------------*/
+static int store_compiled_expression(AssemblerContext* pContext, const CompiledExpression* pExpression)
+{
+    CompiledExpression* pNewCompiledExpressions;
+
+    if(pContext->m_expression.m_iNumberOfCompiledExpressions == pContext->m_expression.m_iCompiledExpressionsCapacity)
+    {
+        pContext->m_expression.m_iCompiledExpressionsCapacity = (pContext->m_expression.m_iCompiledExpressionsCapacity == 0) ? COMPILED_EXPRESSIONS_INITIAL_CAPACITY : pContext->m_expression.m_iCompiledExpressionsCapacity * 2;
+        pNewCompiledExpressions = realloc(pContext->m_expression.m_pCompiledExpressions, pContext->m_expression.m_iCompiledExpressionsCapacity * sizeof(CompiledExpression));
+        if(pNewCompiledExpressions == NULL)
+            return -MallocReturnedNull;
+
+        pContext->m_expression.m_pCompiledExpressions = pNewCompiledExpressions;
+    }
+
+    pContext->m_expression.m_pCompiledExpressions[pContext->m_expression.m_iNumberOfCompiledExpressions] = *pExpression;
+    pContext->m_expression.m_iNumberOfCompiledExpressions++;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  emit_op
+ * Function Description:  Adds a postfix instruction to the expression being
+ *                        compiled.
  * Parameters:
- * pExpressionInfo - Pointer to the expression information structure.
- * cppSourceLine - Pointer to a character pointer which is the current position
- *                 within the source line.
+ * pContext - Pointer to the assembler context.
+ * iOpcode - The instruction.
+ * iValue - The value used by the instruction.
+ * iPosition - The offset from the start of the expression to show if the
+ *             instruction fails.
  * Returns:  Zero for success and a negative value if an error occurs.
 ------------------------------------------------------------------------------*/
-static int get_b_expression(ExpressionParseInfo* pExpressionInfo, char** cppSourceLine)
+static int emit_op(AssemblerContext* pContext, uint8_t iOpcode, int iValue, uint32_t iPosition)
 {
-    int iFunctionReturnValue;
+    ExpressionOp* pNewOps;
 
-    //Get the first b-term.
-    iFunctionReturnValue = get_b_term(pExpressionInfo, cppSourceLine);
-    if(iFunctionReturnValue != EXIT_SUCCESS)
-        return iFunctionReturnValue;
-
-    //Now check for orops.  Loop as long as they continue.
-    while(**cppSourceLine == '|')
+    if(pContext->m_expression.m_iNumberOfOps == pContext->m_expression.m_iOpsCapacity)
     {
-        //Put the current value in the right operand unto the stack.
-        iFunctionReturnValue = push_number_stack(pExpressionInfo);
-        if(iFunctionReturnValue != EXIT_SUCCESS)
-            return iFunctionReturnValue;
-
-        //The current number was placed in storage.  Now point to the next
-        //character and get the next b-term.
-        inc_chr_pointer(cppSourceLine);
-        iFunctionReturnValue = get_b_term(pExpressionInfo, cppSourceLine);
-        if(iFunctionReturnValue != EXIT_SUCCESS)
-            return iFunctionReturnValue;
-
-        //Next b-term retrieved into right operand.  Put the current number on
-        //the stack into the left operand.
-        iFunctionReturnValue = pop_number_stack(pExpressionInfo);
-        if(iFunctionReturnValue != EXIT_SUCCESS)
-            return iFunctionReturnValue;
+        pContext->m_expression.m_iOpsCapacity = (pContext->m_expression.m_iOpsCapacity == 0) ? EXPRESSION_OPS_INITIAL_CAPACITY : pContext->m_expression.m_iOpsCapacity * 2;
+        pNewOps = realloc(pContext->m_expression.m_pOps, pContext->m_expression.m_iOpsCapacity * sizeof(ExpressionOp));
+        if(pNewOps == NULL)
+            return -MallocReturnedNull;
 
-        //Do bitwise OR.
-        pExpressionInfo->m_iRightOperand = pExpressionInfo->m_iLeftOperand | pExpressionInfo->m_iRightOperand;
+        pContext->m_expression.m_pOps = pNewOps;
     }
 
+    pContext->m_expression.m_pOps[pContext->m_expression.m_iNumberOfOps].m_iOpcode = iOpcode;
+    pContext->m_expression.m_pOps[pContext->m_expression.m_iNumberOfOps].m_iValue = iValue;
+    pContext->m_expression.m_pOps[pContext->m_expression.m_iNumberOfOps].m_iPosition = iPosition;
+    pContext->m_expression.m_iNumberOfOps++;
+
     return EXIT_SUCCESS;
 }
 
 /*------------------------------------------------------------------------------
- * Function name:  get_b_term
- * Function Description:  Parses the b-term portion of the source line.
+ * Function name:  emit_symbol_op
+ * Function Description:  Adds a symbol instruction to the expression being
+ *                        compiled.  The instruction holds the index of the
+ *                        symbol's reference.
  * Parameters:
- * pExpressionInfo - Pointer to the expression information structure.
- * cppSourceLine - Pointer to a character pointer which is the current position
- *                 within the source line.
+ * pContext - Pointer to the assembler context.
+ * cpSymbol - The NULL terminated symbol.
+ * iPosition - The offset from the start of the expression to show if the symbol
+ *             isn't known.
  * Returns:  Zero for success and a negative value if an error occurs.
 ------------------------------------------------------------------------------*/
-static int get_b_term(ExpressionParseInfo* pExpressionInfo, char** cppSourceLine)
+static int emit_symbol_op(AssemblerContext* pContext, const char* cpSymbol, uint32_t iPosition)
 {
     int iFunctionReturnValue;
 
-    //Get the first expression.
-    iFunctionReturnValue = get_expression(pExpressionInfo, cppSourceLine);
+    uint32_t iReference;
+
+    iFunctionReturnValue = find_symbol_reference(pContext, cpSymbol, &iReference);
     if(iFunctionReturnValue != EXIT_SUCCESS)
         return iFunctionReturnValue;
 
-    //Now check for andops.  Loop as long as they continue.
-    while(**cppSourceLine == '&')
+    return emit_op(pContext, SymbolOp, (int)iReference, iPosition);
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  find_symbol_reference
+ * Function Description:  Finds the reference for a symbol name, adding one if
+ *                        this is the first time the name is used.  The name is
+ *                        kept in the symbol name pool.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * cpSymbol - The NULL terminated symbol.
+ * ipReference - A pointer to where to store the index of the reference.
+ * Returns:  Zero for success and a negative value if an error occurs.
+------------------------------------------------------------------------------*/
+static int find_symbol_reference(AssemblerContext* pContext, const char* cpSymbol, uint32_t* ipReference)
+{
+    char* cpNewSymbolNames;
+
+    int iFunctionReturnValue;
+
+    uint32_t iSymbolLength;
+    uint32_t iSlot;
+    uint32_t i;
+
+    uint64_t iHash;
+
+    SymbolReference* pNewSymbolReferences;
+    SymbolReference* pSymbolReference;
+
+    //Hash the name with 64-bit FNV-1a.
+    iSymbolLength = strlen(cpSymbol) + NULL_TERMINATING_BYTE_LENGTH;
+    iHash = FNV_64_OFFSET_BASIS;
+    for(i = 0; i < iSymbolLength - NULL_TERMINATING_BYTE_LENGTH; i++)
     {
-        //Put the current value in the right operand unto the stack.
-        iFunctionReturnValue = push_number_stack(pExpressionInfo);
-        if(iFunctionReturnValue != EXIT_SUCCESS)
-            return iFunctionReturnValue;
+        iHash ^= (uint8_t)cpSymbol[i];
+        iHash *= FNV_64_PRIME;
+    }
 
-        //The current number was placed in storage.  Now point to the next
-        //character and get the next expression.
-        inc_chr_pointer(cppSourceLine);
-        iFunctionReturnValue = get_expression(pExpressionInfo, cppSourceLine);
+    //Keep the slots no more than half full.
+    if(pContext->m_expression.m_iNumberOfSymbolReferences >= pContext->m_expression.m_iNumberOfSymbolReferenceSlots / 2)
+    {
+        iFunctionReturnValue = grow_symbol_reference_slots(pContext);
         if(iFunctionReturnValue != EXIT_SUCCESS)
             return iFunctionReturnValue;
+    }
 
-        //Next expression retrieved into right operand.  Put the current number
-        //on the stack into the left operand.
-        iFunctionReturnValue = pop_number_stack(pExpressionInfo);
-        if(iFunctionReturnValue != EXIT_SUCCESS)
-            return iFunctionReturnValue;
+    //Look for the name.  The slots hold one more than the reference index so
+    //zero is an empty slot.
+    iSlot = (uint32_t)iHash & (pContext->m_expression.m_iNumberOfSymbolReferenceSlots - 1);
+    while(pContext->m_expression.m_ipSymbolReferenceSlots[iSlot] != 0)
+    {
+        pSymbolReference = &pContext->m_expression.m_pSymbolReferences[pContext->m_expression.m_ipSymbolReferenceSlots[iSlot] - 1];
+        if(pSymbolReference->m_iHash == iHash && strcmp(pContext->m_expression.m_cpSymbolNames + pSymbolReference->m_iNameOffset, cpSymbol) == 0)
+        {
+            *ipReference = pContext->m_expression.m_ipSymbolReferenceSlots[iSlot] - 1;
+            return EXIT_SUCCESS;
+        }
+
+        iSlot = (iSlot + 1) & (pContext->m_expression.m_iNumberOfSymbolReferenceSlots - 1);
+    }
+
+    //This is the first time the name is used so add a reference for it.
+    if(pContext->m_expression.m_iSymbolNamesSize - pContext->m_expression.m_iSymbolNamesUsed < iSymbolLength)
+    {
+        pContext->m_expression.m_iSymbolNamesSize = (pContext->m_expression.m_iSymbolNamesSize == 0) ? EXPRESSION_NAMES_INITIAL_SIZE : pContext->m_expression.m_iSymbolNamesSize * 2;
+        cpNewSymbolNames = realloc(pContext->m_expression.m_cpSymbolNames, pContext->m_expression.m_iSymbolNamesSize);
+        if(cpNewSymbolNames == NULL)
+            return -MallocReturnedNull;
+
+        pContext->m_expression.m_cpSymbolNames = cpNewSymbolNames;
+    }
+
+    if(pContext->m_expression.m_iNumberOfSymbolReferences == pContext->m_expression.m_iSymbolReferencesCapacity)
+    {
+        pContext->m_expression.m_iSymbolReferencesCapacity = (pContext->m_expression.m_iSymbolReferencesCapacity == 0) ? SYMBOL_REFERENCES_INITIAL_CAPACITY : pContext->m_expression.m_iSymbolReferencesCapacity * 2;
+        pNewSymbolReferences = realloc(pContext->m_expression.m_pSymbolReferences, pContext->m_expression.m_iSymbolReferencesCapacity * sizeof(SymbolReference));
+        if(pNewSymbolReferences == NULL)
+            return -MallocReturnedNull;
 
-        //Do bitwise AND.
-        pExpressionInfo->m_iRightOperand = pExpressionInfo->m_iLeftOperand & pExpressionInfo->m_iRightOperand;
+        pContext->m_expression.m_pSymbolReferences = pNewSymbolReferences;
     }
 
+    memcpy(pContext->m_expression.m_cpSymbolNames + pContext->m_expression.m_iSymbolNamesUsed, cpSymbol, iSymbolLength);
+
+    pSymbolReference = &pContext->m_expression.m_pSymbolReferences[pContext->m_expression.m_iNumberOfSymbolReferences];
+    pSymbolReference->m_pSymbolInfo = NULL;
+    pSymbolReference->m_iHash = iHash;
+    pSymbolReference->m_iNameOffset = pContext->m_expression.m_iSymbolNamesUsed;
+    pSymbolReference->m_bIsUnknown = FALSE;
+
+    pContext->m_expression.m_iSymbolNamesUsed += iSymbolLength;
+    pContext->m_expression.m_iNumberOfSymbolReferences++;
+    pContext->m_expression.m_ipSymbolReferenceSlots[iSlot] = pContext->m_expression.m_iNumberOfSymbolReferences;
+    *ipReference = pContext->m_expression.m_iNumberOfSymbolReferences - 1;
+
     return EXIT_SUCCESS;
 }
 
 /*------------------------------------------------------------------------------
- * Function name:  get_expression
- * Function Description:  Parses the expression portion of the source line.
+ * Function name:  grow_symbol_reference_slots
+ * Function Description:  Doubles the number of symbol reference slots and puts
+ *                        the references back into them.
  * Parameters:
- * pExpressionInfo - Pointer to the expression information structure.
- * cppSourceLine - Pointer to a character pointer which is the current position
- *                 within the source line.
+ * pContext - Pointer to the assembler context.
  * Returns:  Zero for success and a negative value if an error occurs.
 ------------------------------------------------------------------------------*/
-static int get_expression(ExpressionParseInfo* pExpressionInfo, char** cppSourceLine)
+static int grow_symbol_reference_slots(AssemblerContext* pContext)
 {
-    char cAddOp;
+    uint32_t* ipNewSymbolReferenceSlots;
 
-    int iFunctionReturnValue;
+    uint32_t iNumberOfSlots;
+    uint32_t iSlot;
+    uint32_t i;
 
-    //Get the first term.
-    iFunctionReturnValue = get_term(pExpressionInfo, cppSourceLine);
-    if(iFunctionReturnValue != EXIT_SUCCESS)
-        return iFunctionReturnValue;
+    iNumberOfSlots = (pContext->m_expression.m_iNumberOfSymbolReferenceSlots == 0) ? SYMBOL_REFERENCES_INITIAL_CAPACITY * 2 : pContext->m_expression.m_iNumberOfSymbolReferenceSlots * 2;
+    ipNewSymbolReferenceSlots = calloc(iNumberOfSlots, sizeof(uint32_t));
+    if(ipNewSymbolReferenceSlots == NULL)
+        return -MallocReturnedNull;
 
-    //Now check for addops.  Loop as long as they continue.
-    while(**cppSourceLine == '+' || **cppSourceLine == '-')
+    for(i = 0; i < pContext->m_expression.m_iNumberOfSymbolReferences; i++)
     {
-        //Save the current addop.
-        cAddOp = **cppSourceLine;
+        iSlot = (uint32_t)pContext->m_expression.m_pSymbolReferences[i].m_iHash & (iNumberOfSlots - 1);
+        while(ipNewSymbolReferenceSlots[iSlot] != 0)
+            iSlot = (iSlot + 1) & (iNumberOfSlots - 1);
 
-        //Put the current value in the right operand unto the stack.
-        iFunctionReturnValue = push_number_stack(pExpressionInfo);
-        if(iFunctionReturnValue != EXIT_SUCCESS)
-            return iFunctionReturnValue;
+        ipNewSymbolReferenceSlots[iSlot] = i + 1;
+    }
 
-        //The current number was placed in storage.  Now point to the next
-        //character and get the next term.
-        inc_chr_pointer(cppSourceLine);
-        iFunctionReturnValue = get_term(pExpressionInfo, cppSourceLine);
-        if(iFunctionReturnValue != EXIT_SUCCESS)
-            return iFunctionReturnValue;
+    if(pContext->m_expression.m_ipSymbolReferenceSlots != NULL)
+        free(pContext->m_expression.m_ipSymbolReferenceSlots);
 
-        //Next term retrieved into right operand.  Put the current number on the
-        //stack into the left operand.
-        iFunctionReturnValue = pop_number_stack(pExpressionInfo);
-        if(iFunctionReturnValue != EXIT_SUCCESS)
-            return iFunctionReturnValue;
+    pContext->m_expression.m_ipSymbolReferenceSlots = ipNewSymbolReferenceSlots;
+    pContext->m_expression.m_iNumberOfSymbolReferenceSlots = iNumberOfSlots;
 
-        //Do work based on the addop.
-        if(cAddOp == '+')
-            pExpressionInfo->m_iRightOperand = pExpressionInfo->m_iLeftOperand + pExpressionInfo->m_iRightOperand;
-        else
-            pExpressionInfo->m_iRightOperand = pExpressionInfo->m_iLeftOperand - pExpressionInfo->m_iRightOperand;
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  get_referenced_symbol
+ * Function Description:  Gets the symbol information for a symbol reference.
+ *                        The symbol table is only searched until the symbol is
+ *                        found, after that the reference points straight at it.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * iReference - The index of the symbol reference.
+ * Returns:  A pointer to the symbol information or NULL if the symbol isn't
+ *           known.
+------------------------------------------------------------------------------*/
+static SymbolInfo* get_referenced_symbol(AssemblerContext* pContext, uint32_t iReference)
+{
+    BSTreeNode* pNode;
+
+    SymbolReference* pSymbolReference;
+
+    pSymbolReference = &pContext->m_expression.m_pSymbolReferences[iReference];
+    if(pSymbolReference->m_pSymbolInfo == NULL && pSymbolReference->m_bIsUnknown == FALSE)
+    {
+        pNode = bstree_search(get_symbol_table_root(pContext), pContext->m_expression.m_cpSymbolNames + pSymbolReference->m_iNameOffset, bstree_key_compare);
+        if(pNode != NULL)
+            pSymbolReference->m_pSymbolInfo = (SymbolInfo*)(pNode->m_vpDataElement);
     }
 
-    return EXIT_SUCCESS;
+    return pSymbolReference->m_pSymbolInfo;
 }
 
 /*------------------------------------------------------------------------------
- * Function name:  get_term
- * Function Description:  Parses the term portion of the source line.
+ * Function name:  parse_expression
+ * Function Description:  Parses a b-expression from the source line into
+ *                        postfix instructions.  Operators wait on the operator
+ *                        stack until one of lower precedence, a right
+ *                        parenthesis, or the end of the expression is found.
+ *                        The grammar is:
+ *                        <b-expression> ::= <b-term> [<orop> <b-term>]*
+ *                        <b-term> ::= <expression> [<andop> <expression>]*
+ *                        <expression> ::= <term> [<addop> <term>]*
+ *                        <term> ::= <signed factor> [<mulop> <signed factor>]*
+ *                        <signed factor> ::= [<addop>] <factor>
+ *                        <factor> ::= (<b-expression>) | <symbol> |
+ *                                     <lc symbol> | <character> | <number>
  * Parameters:
+ * pContext - Pointer to the assembler context.
  * pExpressionInfo - Pointer to the expression information structure.
  * cppSourceLine - Pointer to a character pointer which is the current position
  *                 within the source line.
  * Returns:  Zero for success and a negative value if an error occurs.
 ------------------------------------------------------------------------------*/
-static int get_term(ExpressionParseInfo* pExpressionInfo, char** cppSourceLine)
+static int parse_expression(AssemblerContext* pContext, ExpressionParseInfo* pExpressionInfo, char** cppSourceLine)
 {
-    char cMulOp;
-
     int iFunctionReturnValue;
 
-    //Get the first signed factor.
-    iFunctionReturnValue = get_signed_factor(pExpressionInfo, cppSourceLine);
-    if(iFunctionReturnValue != EXIT_SUCCESS)
-        return iFunctionReturnValue;
+    uint8_t iOpcode;
+    uint8_t bIsNegated;
+
+    //Initialize variables.
+    pContext->m_expression.m_iNumberOfOperators = 0;
 
-    //Now check for mulops.  Loop as long as they continue.
-    while(**cppSourceLine == '*' || **cppSourceLine == '/')
+    while(TRUE)
     {
-        //Save the current mulop.
-        cMulOp = **cppSourceLine;
+        //Check for the sign of the signed factor.
+        bIsNegated = FALSE;
+        if(**cppSourceLine == '+')
+        {
+            //It is a positive signed factor.  Increment past the '+' character.
+            inc_chr_pointer(cppSourceLine);
+        }
+        else if(**cppSourceLine == '-')
+        {
+            //It is a negative signed factor.  Increment past the '-' character.
+            bIsNegated = TRUE;
+            inc_chr_pointer(cppSourceLine);
+        }
 
-        //Put the current value in the right operand unto the stack.
-        iFunctionReturnValue = push_number_stack(pExpressionInfo);
-        if(iFunctionReturnValue != EXIT_SUCCESS)
-            return iFunctionReturnValue;
+        if(**cppSourceLine == '(')
+        {
+            //It is a left parenthesis.  It waits on the operator stack, along
+            //with the sign, until its right parenthesis is found.  Increment
+            //past it then get the b-expression inside of it.
+            iFunctionReturnValue = push_operator(pContext, (bIsNegated == TRUE) ? NegatedLeftParenthesisOp : LeftParenthesisOp, 0);
+            if(iFunctionReturnValue != EXIT_SUCCESS)
+                return iFunctionReturnValue;
+
+            pExpressionInfo->m_iOpenParentheses++;
+            inc_chr_pointer(cppSourceLine);
+            continue;
+        }
 
-        //The current number was placed in storage.  Now point to the next
-        //character and get the next signed factor.
-        inc_chr_pointer(cppSourceLine);
-        iFunctionReturnValue = get_signed_factor(pExpressionInfo, cppSourceLine);
+        //Get the factor.
+        iFunctionReturnValue = get_factor(pContext, pExpressionInfo, cppSourceLine);
         if(iFunctionReturnValue != EXIT_SUCCESS)
             return iFunctionReturnValue;
 
-        //Next signed factor retrieved into right operand.  Put the current
-        //number on the stack into the left operand.
-        iFunctionReturnValue = pop_number_stack(pExpressionInfo);
-        if(iFunctionReturnValue != EXIT_SUCCESS)
-            return iFunctionReturnValue;
+        //If it is a negative factor make it so.
+        if(bIsNegated == TRUE)
+        {
+            iFunctionReturnValue = emit_op(pContext, NegateOp, 0, 0);
+            if(iFunctionReturnValue != EXIT_SUCCESS)
+                return iFunctionReturnValue;
+        }
 
-        //Do work based on the mulop.
-        if(cMulOp == '*')
-            pExpressionInfo->m_iRightOperand = pExpressionInfo->m_iLeftOperand * pExpressionInfo->m_iRightOperand;
-        else
-            pExpressionInfo->m_iRightOperand = pExpressionInfo->m_iLeftOperand / pExpressionInfo->m_iRightOperand;
+        //After a factor comes an operator, the right parenthesis of any open
+        //left parenthesis, or the end of the expression.
+        while(TRUE)
+        {
+            iOpcode = get_binary_operator(**cppSourceLine);
+            if(iOpcode != ConstantOp)
+            {
+                //All operators are left associative so any waiting operator of
+                //the same or higher precedence is done first.
+                iFunctionReturnValue = pop_operators(pContext, s_iaOperatorPrecedence[iOpcode]);
+                if(iFunctionReturnValue != EXIT_SUCCESS)
+                    return iFunctionReturnValue;
+
+                //Save the operator and where it is.  Then point to the next
+                //character and get the next signed factor.
+                iFunctionReturnValue = push_operator(pContext, iOpcode, (uint32_t)(*cppSourceLine - pExpressionInfo->m_cpStartOfExpression));
+                if(iFunctionReturnValue != EXIT_SUCCESS)
+                    return iFunctionReturnValue;
+
+                inc_chr_pointer(cppSourceLine);
+                break;
+            }
+
+            //Not an operator.  If no parenthesis is open this is the end of the
+            //expression so do the operators that are left.
+            if(pExpressionInfo->m_iOpenParentheses == 0)
+                return pop_operators(pContext, LOWEST_OPERATOR_PRECEDENCE);
+
+            //Check for an ending right parenthesis.
+            if(**cppSourceLine != ')')
+            {
+                //It is not a right parenthesis, this is an error.
+                return -RightParenthesisExpected;
+            }
+
+            //It is a right parenthesis.  Finish the b-expression inside the
+            //parentheses and take the left parenthesis off the stack.
+            iFunctionReturnValue = pop_operators(pContext, LOWEST_OPERATOR_PRECEDENCE);
+            if(iFunctionReturnValue != EXIT_SUCCESS)
+                return iFunctionReturnValue;
+
+            pContext->m_expression.m_iNumberOfOperators--;
+            pExpressionInfo->m_iOpenParentheses--;
+            if(pContext->m_expression.m_pOperatorStack[pContext->m_expression.m_iNumberOfOperators].m_iOpcode == NegatedLeftParenthesisOp)
+            {
+                iFunctionReturnValue = emit_op(pContext, NegateOp, 0, 0);
+                if(iFunctionReturnValue != EXIT_SUCCESS)
+                    return iFunctionReturnValue;
+            }
+
+            //Increment past the right parenthesis.
+            inc_chr_pointer(cppSourceLine);
+        }
     }
+}
 
-    return EXIT_SUCCESS;
+/*------------------------------------------------------------------------------
+ * Function name:  get_binary_operator
+ * Function Description:  Gets the opcode for a binary operator character.
+ * Parameters:
+ * cCharacter - The character to check.
+ * Returns:  The opcode of the operator or ConstantOp if the character isn't a
+ *           binary operator.
+------------------------------------------------------------------------------*/
+static uint8_t get_binary_operator(char cCharacter)
+{
+    switch(cCharacter)
+    {
+        case '|' :
+            return OrOp;
+        case '&' :
+            return AndOp;
+        case '+' :
+            return AddOp;
+        case '-' :
+            return SubtractOp;
+        case '*' :
+            return MultiplyOp;
+        case '/' :
+            return DivideOp;
+        default :
+            return ConstantOp;
+    }
 }
 
 /*------------------------------------------------------------------------------
- * Function name:  get_signed_factor
- * Function Description:  Parses the signed factor portion of the source line.
+ * Function name:  push_operator
+ * Function Description:  Pushes an operator, or left parenthesis, onto the
+ *                        operator stack.  The stack grows as needed.
  * Parameters:
- * pExpressionInfo - Pointer to the expression information structure.
- * cppSourceLine - Pointer to a character pointer which is the current position
- *                 within the source line.
+ * pContext - Pointer to the assembler context.
+ * iOpcode - The opcode of the operator.
+ * iPosition - The offset from the start of the expression of the operator.
  * Returns:  Zero for success and a negative value if an error occurs.
 ------------------------------------------------------------------------------*/
-static int get_signed_factor(ExpressionParseInfo* pExpressionInfo, char** cppSourceLine)
+static int push_operator(AssemblerContext* pContext, uint8_t iOpcode, uint32_t iPosition)
 {
-    int iFunctionReturnValue;
+    ExpressionOp* pNewOperatorStack;
 
-    if(**cppSourceLine == '+')
-    {
-        //It is a positive signed factor.  Increment past the '+' character and
-        //then get the factor.
-        inc_chr_pointer(cppSourceLine);
-        iFunctionReturnValue = get_factor(pExpressionInfo, cppSourceLine);
-        if(iFunctionReturnValue != EXIT_SUCCESS)
-            return iFunctionReturnValue;
-    }
-    else if(**cppSourceLine == '-')
+    if(pContext->m_expression.m_iNumberOfOperators == pContext->m_expression.m_iOperatorStackCapacity)
     {
-        //It is a negative signed factor.  Increment past the '-' character and
-        //then get the factor.
-        inc_chr_pointer(cppSourceLine);
-        iFunctionReturnValue = get_factor(pExpressionInfo, cppSourceLine);
-        if(iFunctionReturnValue != EXIT_SUCCESS)
-            return iFunctionReturnValue;
+        pContext->m_expression.m_iOperatorStackCapacity = (pContext->m_expression.m_iOperatorStackCapacity == 0) ? OPERATOR_STACK_INITIAL_CAPACITY : pContext->m_expression.m_iOperatorStackCapacity * 2;
+        pNewOperatorStack = realloc(pContext->m_expression.m_pOperatorStack, pContext->m_expression.m_iOperatorStackCapacity * sizeof(ExpressionOp));
+        if(pNewOperatorStack == NULL)
+            return -MallocReturnedNull;
 
-        //Since it is a negative factor make it so.
-        pExpressionInfo->m_iRightOperand = 0 - pExpressionInfo->m_iRightOperand;
+        pContext->m_expression.m_pOperatorStack = pNewOperatorStack;
     }
-    else
+
+    pContext->m_expression.m_pOperatorStack[pContext->m_expression.m_iNumberOfOperators].m_iOpcode = iOpcode;
+    pContext->m_expression.m_pOperatorStack[pContext->m_expression.m_iNumberOfOperators].m_iValue = 0;
+    pContext->m_expression.m_pOperatorStack[pContext->m_expression.m_iNumberOfOperators].m_iPosition = iPosition;
+    pContext->m_expression.m_iNumberOfOperators++;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  pop_operators
+ * Function Description:  Pops operators off the operator stack into the postfix
+ *                        instructions as long as they have at least the given
+ *                        precedence.  Stops at a left parenthesis.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * iPrecedence - The lowest precedence to pop.
+ * Returns:  Zero for success and a negative value if an error occurs.
+------------------------------------------------------------------------------*/
+static int pop_operators(AssemblerContext* pContext, uint8_t iPrecedence)
+{
+    int iFunctionReturnValue;
+
+    while(pContext->m_expression.m_iNumberOfOperators != 0 && s_iaOperatorPrecedence[pContext->m_expression.m_pOperatorStack[pContext->m_expression.m_iNumberOfOperators - 1].m_iOpcode] >= iPrecedence)
     {
-        //No signed character found so just get the factor.
-        iFunctionReturnValue = get_factor(pExpressionInfo, cppSourceLine);
+        pContext->m_expression.m_iNumberOfOperators--;
+        iFunctionReturnValue = emit_op(pContext, pContext->m_expression.m_pOperatorStack[pContext->m_expression.m_iNumberOfOperators].m_iOpcode, 0, pContext->m_expression.m_pOperatorStack[pContext->m_expression.m_iNumberOfOperators].m_iPosition);
         if(iFunctionReturnValue != EXIT_SUCCESS)
             return iFunctionReturnValue;
     }
@@ -465,63 +1890,37 @@ static int get_signed_factor(ExpressionParseInfo* pExpressionInfo, char** cppSou
 
 /*------------------------------------------------------------------------------
  * Function name:  get_factor
- * Function Description:  Parses the factor portion of the source line.
+ * Function Description:  Parses a factor other than a parenthesized
+ *                        b-expression from the source line.
  * Parameters:
+ * pContext - Pointer to the assembler context.
  * pExpressionInfo - Pointer to the expression information structure.
  * cppSourceLine - Pointer to a character pointer which is the current position
  *                 within the source line.
  * Returns:  Zero for success and a negative value if an error occurs.
 ------------------------------------------------------------------------------*/
-static int get_factor(ExpressionParseInfo* pExpressionInfo, char** cppSourceLine)
+static int get_factor(AssemblerContext* pContext, ExpressionParseInfo* pExpressionInfo, char** cppSourceLine)
 {
     char caSymbol[MAX_SYMBOL_SIZE + NULL_TERMINATING_BYTE_LENGTH];
 
     int iFunctionReturnValue;
+    int iCharacter;
 
-    BSTreeNode* pNode;
-
-    //(<b-expression>) | <symbol> | <lc symbol> | <number>
-
-    if(**cppSourceLine == '(')
-    {
-        //It is a left parenthesis.  Increment past it then get the b-expression
-        //inside of it.
-        inc_chr_pointer(cppSourceLine);
-        iFunctionReturnValue = get_b_expression(pExpressionInfo, cppSourceLine);
-        if(iFunctionReturnValue != EXIT_SUCCESS)
-            return iFunctionReturnValue;
+    //<symbol> | <lc symbol> | <character> | <number>
 
-        //The b-expression was retrieved.  Check for an ending right parenthesis.
-        if(**cppSourceLine == ')')
-        {
-            //It is a right parenthesis.  Increment past it.
-            inc_chr_pointer(cppSourceLine);
-        }
-        else
-        {
-            //It is not a right parenthesis, this is an error.
-            return -RightParenthesisExpected;
-        }
-    }
-    else if(isalpha(**cppSourceLine) != 0)
+    if(isalpha(**cppSourceLine) != 0)
     {
         //Try and get a symbol.
         iFunctionReturnValue = get_symbol(cppSourceLine, caSymbol);
         if(iFunctionReturnValue != EXIT_SUCCESS)
             return iFunctionReturnValue;
 
-        //Successfully parsed a symbol.  Search for the symbol.
-        pNode = bstree_search(get_symbol_table_root(), caSymbol, bstree_key_compare);
-        if(pNode != NULL)
-        {
-            //The symbol is known so save the value.
-            pExpressionInfo->m_iRightOperand = (int)*((uint32_t*)(pNode->m_vpDataElement));
-        }
-        else
-        {
-            //The symbol is not known.
-            return -UnknownSymbolError;
-        }
+        //Successfully parsed a symbol.  It is looked up when the expression is
+        //evaluated.
+        pExpressionInfo->m_bHasReferences = TRUE;
+        iFunctionReturnValue = emit_symbol_op(pContext, caSymbol, (uint32_t)(*cppSourceLine - pExpressionInfo->m_cpStartOfExpression));
+        if(iFunctionReturnValue != EXIT_SUCCESS)
+            return iFunctionReturnValue;
 
         //If we are pointing at a white space then increment past it.
         if(isspace(**cppSourceLine) != 0)
@@ -529,9 +1928,13 @@ static int get_factor(ExpressionParseInfo* pExpressionInfo, char** cppSourceLine
     }
     else if(**cppSourceLine == '.')
     {
-        //Location counter symbol.  Save the current value of the location
-        //counter.
-        pExpressionInfo->m_iRightOperand = (int)get_location_counter_value();
+        //Location counter symbol.  Its value is taken when the expression is
+        //evaluated.
+        pExpressionInfo->m_bHasReferences = TRUE;
+        pExpressionInfo->m_bHasLocationCounter = TRUE;
+        iFunctionReturnValue = emit_op(pContext, LocationCounterOp, 0, 0);
+        if(iFunctionReturnValue != EXIT_SUCCESS)
+            return iFunctionReturnValue;
 
         //Increment past the character.
         inc_chr_pointer(cppSourceLine);
@@ -550,8 +1953,8 @@ static int get_factor(ExpressionParseInfo* pExpressionInfo, char** cppSourceLine
             (*cppSourceLine)++;
 
             //Check if the next character is a supported escape character.
-            pExpressionInfo->m_iRightOperand = get_esc_character(**cppSourceLine);
-            if(pExpressionInfo->m_iRightOperand == 0)
+            iCharacter = get_esc_character(**cppSourceLine);
+            if(iCharacter == 0)
                 return -InvalidCharacterSyntaxError;
 
             //If we are here then we had a valid escape character.  Skip past it.
@@ -561,19 +1964,23 @@ static int get_factor(ExpressionParseInfo* pExpressionInfo, char** cppSourceLine
         {
             //We found a character literal.  Store its integer value and skip
             //past it.
-            pExpressionInfo->m_iRightOperand = (int)(**cppSourceLine);
+            iCharacter = (int)(**cppSourceLine);
             inc_chr_pointer(cppSourceLine);
         }
         else
         {
             return -InvalidCharacterSyntaxError;
         }
+
+        iFunctionReturnValue = emit_op(pContext, ConstantOp, iCharacter, 0);
+        if(iFunctionReturnValue != EXIT_SUCCESS)
+            return iFunctionReturnValue;
     }
     else
     {
-        //Not a left parenthesis, symbol, or location counter symbol so try and
-        //get a number.
-        iFunctionReturnValue = get_number(pExpressionInfo, cppSourceLine);
+        //Not a symbol, location counter symbol, or character so try and get a
+        //number.
+        iFunctionReturnValue = get_number(pContext, pExpressionInfo, cppSourceLine);
         if(iFunctionReturnValue != EXIT_SUCCESS)
             return iFunctionReturnValue;
 
@@ -590,53 +1997,44 @@ static int get_factor(ExpressionParseInfo* pExpressionInfo, char** cppSourceLine
  * Function name:  get_number
  * Function Description:  Processes a number from the source file line.
  * Parameters:
+ * pContext - Pointer to the assembler context.
  * pExpressionInfo - Pointer to the expression information structure.
  * cppSourceLine - Pointer to a character pointer which is the current position
  *                 within the source line.
  * Returns:  Zero for success and negative number for failure.
 ------------------------------------------------------------------------------*/
-static int get_number(ExpressionParseInfo* pExpressionInfo, char** cppSourceLine)
+static int get_number(AssemblerContext* pContext, ExpressionParseInfo* pExpressionInfo, char** cppSourceLine)
 {
-    if(**cppSourceLine == '%' || strncmp(*cppSourceLine, "0B", 2) == 0)
+    char* cpStartOfNumber = *cppSourceLine;
+    uint64_t iValue;
+    int iFunctionReturnValue;
+
+    if(**cppSourceLine == '%' || (**cppSourceLine == '0' && *(*cppSourceLine + 1) == 'B'))
     {
         //Binary number prefix found.  Skip past the prefix.
         *cppSourceLine = (**cppSourceLine == '%') ? *cppSourceLine + 1 : *cppSourceLine + 2;
 
         //The next character must be a binary digit or this is an error.
-        if(**cppSourceLine != '0' && **cppSourceLine != '1')
+        if((uint8_t)(**cppSourceLine - '0') > 1)
             return -InvalidCharacterSyntaxError;
 
-        //Convert the number.
-        pExpressionInfo->m_iRightOperand = 0;
-        while(**cppSourceLine == '0' || **cppSourceLine == '1')
-        {
-            pExpressionInfo->m_iRightOperand <<= 1;
-            if(**cppSourceLine == '1')
-                pExpressionInfo->m_iRightOperand |= 1;
-
-            (*cppSourceLine)++;
-        }
+        iFunctionReturnValue = get_binary_number(cppSourceLine, &iValue);
     }
-    else if(**cppSourceLine == '$' || strncmp(*cppSourceLine, "0X", 2) == 0)
+    else if(**cppSourceLine == '$' || (**cppSourceLine == '0' && *(*cppSourceLine + 1) == 'X'))
     {
-        //Hexadecimal number prefix found.  Skip past the prefix and convert the
-        //number.
+        //Hexadecimal number prefix found.  Skip past the prefix.
         *cppSourceLine = (**cppSourceLine == '$') ? *cppSourceLine + 1 : *cppSourceLine + 2;
 
         //The next character must be a hexadecimal character or this is an error.
-        if(isdigit(**cppSourceLine) != 0 || (**cppSourceLine >= 'A' && **cppSourceLine <= 'F'))
-        {
-            pExpressionInfo->m_iRightOperand = strtol(*cppSourceLine, cppSourceLine, 16);
-        }
-        else
-        {
+        if((uint8_t)(**cppSourceLine - '0') > 9 && (uint8_t)(**cppSourceLine - 'A') > 5)
             return -InvalidCharacterSyntaxError;
-        }
+
+        iFunctionReturnValue = get_hexadecimal_number(cppSourceLine, &iValue);
     }
-    else if(isdigit(**cppSourceLine) != 0)
+    else if((uint8_t)(**cppSourceLine - '0') <= 9)
     {
         //Decimal number prefix found.
-        pExpressionInfo->m_iRightOperand = strtol(*cppSourceLine, cppSourceLine, 10);
+        iFunctionReturnValue = get_decimal_number(cppSourceLine, &iValue);
     }
     else
     {
@@ -644,57 +2042,224 @@ static int get_number(ExpressionParseInfo* pExpressionInfo, char** cppSourceLine
         return -InvalidCharacterSyntaxError;
     }
 
+    //A number that does not fit in an int is reported at the start of the
+    //number rather than being silently truncated.
+    if(iFunctionReturnValue < 0 || iValue > INT_MAX)
+    {
+        *cppSourceLine = cpStartOfNumber;
+        return -NumberOverflowError;
+    }
+
+    return emit_op(pContext, ConstantOp, (int)iValue, 0);
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  get_binary_number
+ * Function Description:  Converts the run of binary digits at the current
+ *                        position.  Full blocks of eight digits are gathered
+ *                        into a byte with a single multiply.
+ * Parameters:
+ * cppSourceLine - Pointer to a character pointer which is the current position
+ *                 within the source line.
+ * ipValue - A pointer to where to store the converted value.
+ * Returns:  Zero for success and a negative value if the number has too many
+ *           digits.
+------------------------------------------------------------------------------*/
+static int get_binary_number(char** cppSourceLine, uint64_t* ipValue)
+{
+    char* cpEndOfNumber;
+    uint32_t iNumberOfDigits;
+    uint64_t iBlock;
+    uint64_t iValue = 0;
+
+    //Leading zeros do not add to the size of the number.
+    while(**cppSourceLine == '0')
+        (*cppSourceLine)++;
+
+    //Find the end of the digits so that no block is read past the number.
+    cpEndOfNumber = *cppSourceLine;
+    while((uint8_t)(*cpEndOfNumber - '0') <= 1)
+        cpEndOfNumber++;
+
+    iNumberOfDigits = cpEndOfNumber - *cppSourceLine;
+    if(iNumberOfDigits > MAX_BINARY_DIGITS)
+    {
+        *cppSourceLine = cpEndOfNumber;
+        return -NumberOverflowError;
+    }
+
+    while(iNumberOfDigits >= SWAR_BLOCK_SIZE)
+    {
+        //Each byte is now a 0 or 1.  The multiply moves the first digit to the
+        //most significant bit of the top byte, the second digit to the next
+        //bit down and so on.
+        iBlock = load_swar_block(*cppSourceLine) - SWAR_ASCII_ZEROS;
+        iValue = (iValue << 8) | ((iBlock * 0x8040201008040201ULL) >> 56);
+
+        *cppSourceLine += SWAR_BLOCK_SIZE;
+        iNumberOfDigits -= SWAR_BLOCK_SIZE;
+    }
+
+    while(iNumberOfDigits != 0)
+    {
+        iValue = (iValue << 1) | (uint64_t)(**cppSourceLine - '0');
+        (*cppSourceLine)++;
+        iNumberOfDigits--;
+    }
+
+    *ipValue = iValue;
+
     return EXIT_SUCCESS;
 }
 
 /*------------------------------------------------------------------------------
- * Function name:  push_number_stack
- * Function Description:  Pushes the current value of the right operand onto the
- *                        number stack.
+ * Function name:  get_hexadecimal_number
+ * Function Description:  Converts the run of hexadecimal digits at the current
+ *                        position.  Full blocks of eight digits are converted
+ *                        to nibbles and packed together without a per-digit
+ *                        loop.
  * Parameters:
- * pExpressionInfo - Pointer to the expression information structure.
- * Returns:  Zero for success and a negative value if an error occurs.
+ * cppSourceLine - Pointer to a character pointer which is the current position
+ *                 within the source line.
+ * ipValue - A pointer to where to store the converted value.
+ * Returns:  Zero for success and a negative value if the number has too many
+ *           digits.
 ------------------------------------------------------------------------------*/
-static int push_number_stack(ExpressionParseInfo* pExpressionInfo)
+static int get_hexadecimal_number(char** cppSourceLine, uint64_t* ipValue)
 {
-    //Make sure there is room on the stack.
-    if(pExpressionInfo->m_iNumberStackIndex != 0)
+    char* cpEndOfNumber;
+    uint32_t iNumberOfDigits;
+    uint64_t iBlock;
+    uint64_t iValue = 0;
+    uint8_t iDigit;
+
+    //Leading zeros do not add to the size of the number.
+    while(**cppSourceLine == '0')
+        (*cppSourceLine)++;
+
+    //Find the end of the digits so that no block is read past the number.
+    cpEndOfNumber = *cppSourceLine;
+    while((uint8_t)(*cpEndOfNumber - '0') <= 9 || (uint8_t)(*cpEndOfNumber - 'A') <= 5)
+        cpEndOfNumber++;
+
+    iNumberOfDigits = cpEndOfNumber - *cppSourceLine;
+    if(iNumberOfDigits > MAX_HEXADECIMAL_DIGITS)
     {
-        pExpressionInfo->m_iNumberStackIndex--;
-        pExpressionInfo->m_iNumberStack[pExpressionInfo->m_iNumberStackIndex] = pExpressionInfo->m_iRightOperand;
+        *cppSourceLine = cpEndOfNumber;
+        return -NumberOverflowError;
     }
-    else
+
+    while(iNumberOfDigits >= SWAR_BLOCK_SIZE)
+    {
+        //'0' to '9' keep their low nibble and 'A' to 'F' have bit 6 set, so
+        //adding nine to those gives their value.
+        iBlock = load_swar_block(*cppSourceLine);
+        iBlock = (iBlock & SWAR_LOW_NIBBLES) + (((iBlock & SWAR_LETTER_BITS) >> 6) * 9);
+
+        //Pack the nibbles.  The first digit is in the lowest byte so each step
+        //moves the lower half of a lane up above the upper half.
+        iBlock = ((iBlock & 0x00FF00FF00FF00FFULL) << 4) | ((iBlock >> 8) & 0x00FF00FF00FF00FFULL);
+        iBlock = ((iBlock & 0x0000FFFF0000FFFFULL) << 8) | ((iBlock >> 16) & 0x0000FFFF0000FFFFULL);
+        iBlock = ((iBlock & 0x00000000FFFFFFFFULL) << 16) | (iBlock >> 32);
+
+        iValue = (iValue << 32) | iBlock;
+
+        *cppSourceLine += SWAR_BLOCK_SIZE;
+        iNumberOfDigits -= SWAR_BLOCK_SIZE;
+    }
+
+    while(iNumberOfDigits != 0)
     {
-        return -NumberStackFull;
+        iDigit = (uint8_t)**cppSourceLine;
+        iValue = (iValue << 4) | (uint64_t)((iDigit & 0x0F) + ((iDigit & 0x40) >> 6) * 9);
+        (*cppSourceLine)++;
+        iNumberOfDigits--;
     }
 
+    *ipValue = iValue;
+
     return EXIT_SUCCESS;
 }
 
 /*------------------------------------------------------------------------------
- * Function name:  pop_number_stack
- * Function Description:  Pops the current value from the stack and places it
- *                        into the left operand.
+ * Function name:  get_decimal_number
+ * Function Description:  Converts the run of decimal digits at the current
+ *                        position.  Full blocks of eight digits are combined
+ *                        in pairs, then fours, then eights within one 64-bit
+ *                        word.
  * Parameters:
- * pExpressionInfo - Pointer to the expression information structure.
- * Returns:  Zero for success and a negative value if an error occurs.
+ * cppSourceLine - Pointer to a character pointer which is the current position
+ *                 within the source line.
+ * ipValue - A pointer to where to store the converted value.
+ * Returns:  Zero for success and a negative value if the number has too many
+ *           digits.
 ------------------------------------------------------------------------------*/
-static int pop_number_stack(ExpressionParseInfo* pExpressionInfo)
+static int get_decimal_number(char** cppSourceLine, uint64_t* ipValue)
 {
-    //Make sure there is a number on the stack.
-    if(pExpressionInfo->m_iNumberStackIndex != NUMBER_STACK_MAX)
+    char* cpEndOfNumber;
+    uint32_t iNumberOfDigits;
+    uint64_t iBlock;
+    uint64_t iValue = 0;
+
+    //Leading zeros do not add to the size of the number.
+    while(**cppSourceLine == '0')
+        (*cppSourceLine)++;
+
+    //Find the end of the digits so that no block is read past the number.
+    cpEndOfNumber = *cppSourceLine;
+    while((uint8_t)(*cpEndOfNumber - '0') <= 9)
+        cpEndOfNumber++;
+
+    iNumberOfDigits = cpEndOfNumber - *cppSourceLine;
+    if(iNumberOfDigits > MAX_DECIMAL_DIGITS)
     {
-        pExpressionInfo->m_iLeftOperand = pExpressionInfo->m_iNumberStack[pExpressionInfo->m_iNumberStackIndex];
-        pExpressionInfo->m_iNumberStackIndex++;
+        *cppSourceLine = cpEndOfNumber;
+        return -NumberOverflowError;
     }
-    else
+
+    while(iNumberOfDigits >= SWAR_BLOCK_SIZE)
+    {
+        iBlock = load_swar_block(*cppSourceLine) - SWAR_ASCII_ZEROS;
+        iBlock = (iBlock * 10) + (iBlock >> 8);
+        iBlock = (((iBlock & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+                  (((iBlock >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+
+        iValue = (iValue * 100000000) + iBlock;
+
+        *cppSourceLine += SWAR_BLOCK_SIZE;
+        iNumberOfDigits -= SWAR_BLOCK_SIZE;
+    }
+
+    while(iNumberOfDigits != 0)
     {
-        return -NumberStackEmpty;
+        iValue = (iValue * 10) + (uint64_t)(**cppSourceLine - '0');
+        (*cppSourceLine)++;
+        iNumberOfDigits--;
     }
 
+    *ipValue = iValue;
+
     return EXIT_SUCCESS;
 }
 
+/*------------------------------------------------------------------------------
+ * Function name:  load_swar_block
+ * Function Description:  Loads eight characters of the source line into one
+ *                        64-bit word.  Windows targets are little-endian so
+ *                        the first character ends up in the lowest byte.
+ * Parameters:
+ * cpBlock - Pointer to the first of the eight characters.
+ * Returns:  The eight characters as a 64-bit word.
+------------------------------------------------------------------------------*/
+static uint64_t load_swar_block(const char* cpBlock)
+{
+    uint64_t iBlock;
+
+    memcpy(&iBlock, cpBlock, sizeof(iBlock));
+
+    return iBlock;
+}
+
 /*------------------------------------------------------------------------------
  * Function name:  inc_chr_pointer
  * Function Description:  Increments past the current character and skips all
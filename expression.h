@@ -38,25 +38,196 @@
 
 //------------------------------------------------------------------------------
 //Defines
-#define NUMBER_STACK_MAX    (50)
+#define EXPRESSION_OPS_INITIAL_CAPACITY         (1024)
+#define EXPRESSION_NAMES_INITIAL_SIZE           (4096)
+#define COMPILED_EXPRESSIONS_INITIAL_CAPACITY   (256)
+#define OPERATOR_STACK_INITIAL_CAPACITY         (64)
+#define NUMBER_STACK_INITIAL_CAPACITY           (64)
+#define RESOLVE_STACK_INITIAL_CAPACITY          (64)
+#define EXPRESSION_MEMOS_INITIAL_CAPACITY       (256)
+#define EXPRESSION_MEMO_TEXT_INITIAL_SIZE       (4096)
+#define SYMBOL_REFERENCES_INITIAL_CAPACITY      (256)
+
+#define LOWEST_OPERATOR_PRECEDENCE              (1)
+
+#define SWAR_BLOCK_SIZE         (8)
+#define MAX_BINARY_DIGITS       (31)
+#define MAX_HEXADECIMAL_DIGITS  (8)
+#define MAX_DECIMAL_DIGITS      (10)
+
+#define SWAR_ASCII_ZEROS        (0x3030303030303030ULL)
+#define SWAR_LOW_NIBBLES        (0x0F0F0F0F0F0F0F0FULL)
+#define SWAR_LETTER_BITS        (0x4040404040404040ULL)
 
 //------------------------------------------------------------------------------
 //Enumerations
-//None
+enum ExpressionOpcodes
+{
+    ConstantOp = 0,
+    SymbolOp,
+    LocationCounterOp,
+    NegateOp,
+    AddOp,
+    SubtractOp,
+    MultiplyOp,
+    DivideOp,
+    AndOp,
+    OrOp,
+    LeftParenthesisOp,          //Only used on the operator stack while
+    NegatedLeftParenthesisOp    //compiling.
+};
+
+enum SymbolStates
+{
+    SymbolResolved = 0,
+    SymbolUnresolved,
+    SymbolResolving
+};
 
 //------------------------------------------------------------------------------
 //Structures
 typedef struct tagExpressionParseInfo
 {
-    int m_iRightOperand;
-    int m_iLeftOperand;
-    int m_iNumberStack[NUMBER_STACK_MAX];
-    uint32_t m_iNumberStackIndex;
+    char* m_cpStartOfExpression;
+    uint32_t m_iOpenParentheses;
+    uint8_t m_bHasReferences;
+    uint8_t m_bHasLocationCounter;
 } ExpressionParseInfo;
 
+//One postfix instruction.  The value is the number for a constant and the
+//offset of the name in the symbol name pool for a symbol.  The position is the
+//offset from the start of the expression to show if the instruction fails.
+typedef struct tagExpressionOp
+{
+    int m_iValue;
+    uint32_t m_iPosition;
+    uint8_t m_iOpcode;
+} ExpressionOp;
+
+//An expression compiled into postfix instructions.  The length is how much of
+//the source line the expression takes up.  If it didn't compile the error is
+//kept so it can be reported when the expression is used.  An expression without
+//any symbols or location counter is folded into its value and has no
+//instructions.  The memo is one more than the index of the value shared by all
+//expressions with the same text, or zero if there isn't one.
+typedef struct tagCompiledExpression
+{
+    uint32_t m_iSourceLineNumber;
+    uint32_t m_iFirstOp;
+    uint32_t m_iNumberOfOps;
+    uint32_t m_iLength;
+    uint32_t m_iNumberStackDepth;
+    uint32_t m_iMemo;
+    int m_iError;
+    int m_iValue;
+    uint8_t m_bIsConstant;
+} CompiledExpression;
+
+//The value of an expression that doesn't use the location counter, shared by
+//every copy of the same expression text.  The text is kept without white
+//spaces.  The value is filled in the first time one is evaluated during pass
+//two.
+typedef struct tagExpressionMemo
+{
+    uint64_t m_iHash;
+    uint32_t m_iTextOffset;
+    uint32_t m_iTextLength;
+    int m_iValue;
+    uint8_t m_bIsValid;
+} ExpressionMemo;
+
+//The data element of a symbol table node.  An EQU whose expression refers to a
+//symbol that isn't known yet keeps the index of its compiled expression, and the
+//location counter at the EQU, so its value can be worked out when it is needed.
+typedef struct tagSymbolInfo
+{
+    uint32_t m_iValue;
+    uint32_t m_iLocationCounter;
+    uint32_t m_iExpression;
+    uint8_t m_iState;
+} SymbolInfo;
+
+//A symbol referred to by expressions.  There is one for each different name and
+//a symbol instruction holds its index.  The symbol information is looked up the
+//first time it is needed.  After pass one the symbol table is complete so a name
+//that still isn't found is marked as unknown.
+typedef struct tagSymbolReference
+{
+    SymbolInfo* m_pSymbolInfo;
+    uint64_t m_iHash;
+    uint32_t m_iNameOffset;
+    uint8_t m_bIsUnknown;
+} SymbolReference;
+
+//Everything the expression evaluator keeps while assembling one source file:
+//the compiled expressions, the symbols they reference, the work stacks and
+//the memo of repeated operand expressions.  A shared context uses the compiled
+//expressions of another one, only its work stacks and memos are its own.  A
+//detached context compiles lines without knowing the lines before them, so it
+//can only give the value of an expression that is constant.
+typedef struct tagExpressionContext
+{
+    ExpressionOp* m_pOps;
+    uint32_t m_iNumberOfOps;
+    uint32_t m_iOpsCapacity;
+
+    char* m_cpSymbolNames;
+    uint32_t m_iSymbolNamesUsed;
+    uint32_t m_iSymbolNamesSize;
+
+    SymbolReference* m_pSymbolReferences;
+    uint32_t m_iNumberOfSymbolReferences;
+    uint32_t m_iSymbolReferencesCapacity;
+    uint32_t* m_ipSymbolReferenceSlots;
+    uint32_t m_iNumberOfSymbolReferenceSlots;
+
+    CompiledExpression* m_pCompiledExpressions;
+    uint32_t m_iNumberOfCompiledExpressions;
+    uint32_t m_iCompiledExpressionsCapacity;
+    uint32_t m_iCompiledExpressionIndex;
+
+    ExpressionOp* m_pOperatorStack;
+    uint32_t m_iNumberOfOperators;
+    uint32_t m_iOperatorStackCapacity;
+
+    int* m_ipNumberStack;
+    uint32_t m_iNumberStackCapacity;
+
+    SymbolInfo** m_ppResolveStack;
+    uint32_t m_iResolveStackCapacity;
+
+    ExpressionMemo* m_pMemos;
+    uint32_t m_iNumberOfMemos;
+    uint32_t m_iMemosCapacity;
+    uint32_t* m_ipMemoSlots;
+    uint32_t m_iNumberOfMemoSlots;
+    char* m_cpMemoText;
+    uint32_t m_iMemoTextUsed;
+    uint32_t m_iMemoTextSize;
+    uint32_t m_iMemoHits;
+    uint32_t m_iMemoMisses;
+
+    uint8_t m_bIsShared;
+    uint8_t m_bIsDetached;
+} ExpressionContext;
+
 //------------------------------------------------------------------------------
 //Prototypes
-int do_expression(char** cppSourceLine, int* ipValue);
+int do_expression(AssemblerContext* pContext, char** cppSourceLine, int* ipValue);
+int compile_expression(AssemblerContext* pContext, char* cpSourceLine);
+int do_symbol_expression(AssemblerContext* pContext, char** cppSourceLine, SymbolInfo* pSymbolInfo);
+void reset_compiled_expressions(AssemblerContext* pContext);
+void rewind_compiled_expressions(AssemblerContext* pContext);
+uint32_t get_number_of_compiled_expressions(AssemblerContext* pContext);
+int evaluate_compiled_expression(AssemblerContext* pContext, uint32_t iExpression, uint32_t iLocationCounter, int* ipValue);
+int resolve_equ_symbol(AssemblerContext* pContext, SymbolInfo* pSymbolInfo);
+int share_compiled_expressions(AssemblerContext* pContext, AssemblerContext* pOwnerContext);
+void free_shared_expression_memory(AssemblerContext* pContext);
+void free_expression_memory(AssemblerContext* pContext);
+uint32_t get_expression_memo_hits(AssemblerContext* pContext);
+uint32_t get_expression_memo_misses(AssemblerContext* pContext);
+void add_expression_memo_counts(AssemblerContext* pContext, AssemblerContext* pSharedContext);
+int append_compiled_expressions(AssemblerContext* pContext, AssemblerContext* pOtherContext, uint32_t iLineNumberOffset);
 int get_symbol(char** cppSourceLine, char* cpSymbol);
 int get_esc_character(char cEscCharacter);
 
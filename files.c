@@ -47,6 +47,9 @@
 #ifndef _STDLIB_H
 #include <stdlib.h>
 #endif
+#ifndef _STRING_H
+#include <string.h>
+#endif
 #ifndef _LIMITS_H
 #include <limits.h>
 #endif
@@ -63,6 +66,9 @@
 #ifndef ___ARGUMENTS_H___
 #include "arguments.h"
 #endif
+#ifndef ___CONTEXT_H___
+#include "context.h"
+#endif
 #ifndef ___LOG_H___
 #include "log.h"
 #endif
@@ -78,43 +84,49 @@
 
 //------------------------------------------------------------------------------
 //Static Data
-static FILE* s_pSourceFile = NULL;
-static FILE* s_pListingFile = NULL;
-static FILE* s_pBinaryFile = NULL;
+//None
 
 //------------------------------------------------------------------------------
 //Static Prototypes
-#if _POSIX_C_SOURCE < 200809L
-static ssize_t getline(char** cppBuffer, size_t* ipBufferSize, FILE* pFileStream);
-static ssize_t getdelim(char** cppBuffer, size_t* ipBufferSize, int iDelimiter, FILE* pFileStream);
-#endif
+static ssize_t fill_source_buffer(AssemblerContext* pContext);
+static void build_output_file_name(AssemblerContext* pContext, const char* cpExtension, uint8_t bIsTemporary, char* cpFileName, size_t iSize);
+static void replace_output_file(AssemblerContext* pContext, FILE* pFile, const char* cpExtension);
 
 //==============================================================================
 //Functions
 /*------------------------------------------------------------------------------
  * Function name:  open_source_file
  * Function Description:  Opens the source file for reading.
- * Parameters:  None.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
  * Returns:  Zero for success and negative number for failure.
 ------------------------------------------------------------------------------*/
-int open_source_file(void)
+int open_source_file(AssemblerContext* pContext)
 {
     char caSourceFile[PATH_MAX + FILENAME_MAX + NULL_TERMINATING_BYTE_LENGTH];
 
     //Make sure the file isn't already open.
-    if(s_pSourceFile != NULL)
+    if(pContext->m_files.m_pSourceFile != NULL || pContext->m_files.m_bIsSourceMemoryOpen == TRUE)
     {
         print_error(__func__, FileAlreadyOpen);
         return -FileAlreadyOpen;
     }
 
+    //A source in memory is read from where it is.
+    if(pContext->m_files.m_cpSourceMemory != NULL)
+    {
+        pContext->m_files.m_iSourceMemoryPosition = 0;
+        pContext->m_files.m_bIsSourceMemoryOpen = TRUE;
+        return EXIT_SUCCESS;
+    }
+
     //The file is not yet open.  Create the full path and file name string.
-    strncpy(caSourceFile, get_assembly_source_file_path(), sizeof(caSourceFile));
-    strcat(caSourceFile, get_assembly_source_full_file_name());
+    strncpy(caSourceFile, get_assembly_source_file_path(pContext), sizeof(caSourceFile));
+    strcat(caSourceFile, get_assembly_source_full_file_name(pContext));
 
     //Open the file.
-    s_pSourceFile = fopen(caSourceFile, "rb");
-    if(s_pSourceFile == NULL)
+    pContext->m_files.m_pSourceFile = fopen(caSourceFile, "rb");
+    if(pContext->m_files.m_pSourceFile == NULL)
     {
         print_error(__func__, FileOpenError);
         return -FileOpenError;
@@ -125,29 +137,38 @@ int open_source_file(void)
 
 /*------------------------------------------------------------------------------
  * Function name:  open_listing_file
- * Function Description:  Opens the listing file for writing.
- * Parameters:  None.
+ * Function Description:  Opens the listing file for writing.  It is written
+ *                        under a temporary name and takes the place of the old
+ *                        listing file when it is closed.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
  * Returns:  Zero for success and non-zero for failure.
 ------------------------------------------------------------------------------*/
-int open_listing_file(void)
+int open_listing_file(AssemblerContext* pContext)
 {
-    char caListingFile[PATH_MAX + FILENAME_MAX + NULL_TERMINATING_BYTE_LENGTH];
+    char caListingFile[PATH_MAX + FILENAME_MAX + sizeof(TEMPORARY_FILE_EXTENSION)];
 
     //Make sure the file isn't already open.
-    if(s_pListingFile != NULL)
+    if(pContext->m_files.m_pListingFile != NULL || pContext->m_files.m_bIsListingMemoryOpen == TRUE)
     {
         print_error(__func__, FileAlreadyOpen);
         return -FileAlreadyOpen;
     }
 
+    //A listing in memory starts out empty, the same as a new file.
+    if(pContext->m_files.m_pListingMemory != NULL)
+    {
+        pContext->m_files.m_pListingMemory->m_iLength = 0;
+        pContext->m_files.m_bIsListingMemoryOpen = TRUE;
+        return reserve_memory_buffer(pContext->m_files.m_pListingMemory, 0);
+    }
+
     //The file is not yet open.  Create the full path and file name string.
-    strncpy(caListingFile, get_assembly_source_file_path(), sizeof(caListingFile));
-    strcat(caListingFile, get_assembly_source_base_file_name());
-    strcat(caListingFile, LISTING_FILE_EXTENSION);
+    build_output_file_name(pContext, LISTING_FILE_EXTENSION, TRUE, caListingFile, sizeof(caListingFile));
 
     //Open the file.
-    s_pListingFile = fopen(caListingFile, "wb");
-    if(s_pListingFile == NULL)
+    pContext->m_files.m_pListingFile = fopen(caListingFile, "wb");
+    if(pContext->m_files.m_pListingFile == NULL)
     {
         print_error(__func__, FileOpenError);
         return -FileOpenError;
@@ -158,29 +179,38 @@ int open_listing_file(void)
 
 /*------------------------------------------------------------------------------
  * Function name:  open_binary_file
- * Function Description:  Opens the binary object file for writing.
- * Parameters:  None.
+ * Function Description:  Opens the binary object file for writing.  It is
+ *                        written under a temporary name and takes the place of
+ *                        the old binary file when it is closed.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
  * Returns:  Zero for success and non-zero for failure.
 ------------------------------------------------------------------------------*/
-int open_binary_file(void)
+int open_binary_file(AssemblerContext* pContext)
 {
-    char caBinaryFile[PATH_MAX + FILENAME_MAX + NULL_TERMINATING_BYTE_LENGTH];
+    char caBinaryFile[PATH_MAX + FILENAME_MAX + sizeof(TEMPORARY_FILE_EXTENSION)];
 
     //Make sure the file isn't already open.
-    if(s_pBinaryFile != NULL)
+    if(pContext->m_files.m_pBinaryFile != NULL || pContext->m_files.m_bIsBinaryMemoryOpen == TRUE)
     {
         print_error(__func__, FileAlreadyOpen);
         return -FileAlreadyOpen;
     }
 
+    //A binary in memory starts out empty, the same as a new file.
+    if(pContext->m_files.m_pBinaryMemory != NULL)
+    {
+        pContext->m_files.m_pBinaryMemory->m_iLength = 0;
+        pContext->m_files.m_bIsBinaryMemoryOpen = TRUE;
+        return reserve_memory_buffer(pContext->m_files.m_pBinaryMemory, 0);
+    }
+
     //The file is not yet open.  Create the full path and file name string.
-    strncpy(caBinaryFile, get_assembly_source_file_path(), sizeof(caBinaryFile));
-    strcat(caBinaryFile, get_assembly_source_base_file_name());
-    strcat(caBinaryFile, BINARY_FILE_EXTENSION);
+    build_output_file_name(pContext, BINARY_FILE_EXTENSION, TRUE, caBinaryFile, sizeof(caBinaryFile));
 
     //Open the file.
-    s_pBinaryFile = fopen(caBinaryFile, "wb");
-    if(s_pBinaryFile == NULL)
+    pContext->m_files.m_pBinaryFile = fopen(caBinaryFile, "wb");
+    if(pContext->m_files.m_pBinaryFile == NULL)
     {
         print_error(__func__, FileOpenError);
         return -FileOpenError;
@@ -192,113 +222,268 @@ int open_binary_file(void)
 /*------------------------------------------------------------------------------
  * Function name:  reset_source_file
  * Function Description:  Resets the open source file back to the beginning.
- * Parameters:  None.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  Zero for success and non-zero for failure.
+------------------------------------------------------------------------------*/
+int reset_source_file(AssemblerContext* pContext)
+{
+    return seek_source_file(pContext, 0);
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  seek_source_file
+ * Function Description:  Moves the open source file to the start of a line so
+ *                        that the next line read is the one there.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * iFileOffset - The offset of the line from the beginning of the file, as given
+ *               by get_source_line_file_offset().
  * Returns:  Zero for success and non-zero for failure.
 ------------------------------------------------------------------------------*/
-int reset_source_file(void)
+int seek_source_file(AssemblerContext* pContext, size_t iFileOffset)
 {
     //Make sure the source file is opened.
-    if(s_pSourceFile == NULL)
+    if(pContext->m_files.m_pSourceFile == NULL && pContext->m_files.m_bIsSourceMemoryOpen == FALSE)
     {
         print_error(__func__, FileNotOpen);
         return -FileNotOpen;
     }
 
-    //The file open so reset the current file position back to the beginning of
-    //the file.
-    if(fseek(s_pSourceFile, 0, SEEK_SET) != EXIT_SUCCESS)
+    //The file open so move the current file position to the line.
+    if(pContext->m_files.m_bIsSourceMemoryOpen == TRUE)
+    {
+        pContext->m_files.m_iSourceMemoryPosition = bmc_min(iFileOffset, pContext->m_files.m_iSourceMemoryLength);
+    }
+    else if(fseek(pContext->m_files.m_pSourceFile, (long)iFileOffset, SEEK_SET) != EXIT_SUCCESS)
     {
         print_error(__func__, ResetFileError);
         return -ResetFileError;
     }
 
+    //Throw away whatever is left in the input buffer.  The buffer itself is kept
+    //for the next pass.
+    pContext->m_files.m_iSourceBufferUsed = 0;
+    pContext->m_files.m_iSourceLineStart = 0;
+    pContext->m_files.m_iSourceScanPosition = 0;
+    pContext->m_files.m_iSourceBufferFileOffset = iFileOffset;
+    pContext->m_files.m_bIsCharacterSaved = FALSE;
+    pContext->m_files.m_bIsSourceEndOfFile = FALSE;
+
     return EXIT_SUCCESS;
 }
 
 /*------------------------------------------------------------------------------
  * Function name:  read_line_from_source_file
- * Function Description:  Reads a line of text from the source file.  Before
- *                        calling, you should place in *cppBuffer the address of
- *                        a buffer *ipBufferSize bytes long, allocated with
- *                        malloc.  If this buffer is long enough to hold the
- *                        line, the text is stored in this buffer.  Otherwise,
- *                        the buffer will be made bigger using realloc, storing
- *                        the new buffer address back in *cppBuffer and the
- *                        increased size back in *ipBufferSize.  If you set
- *                        *cppBuffer to a NULL pointer, and *ipBufferSize to
- *                        zero, before the call, then the initial buffer will be
- *                        allocated for you by calling malloc.
+ * Function Description:  Reads a line of text from the source file.  The source
+ *                        file is read in large blocks into an input buffer and
+ *                        the line is handed back in place without being copied.
+ *                        The character following the line is swapped out for a
+ *                        NULL terminating byte and put back on the next call, so
+ *                        the line is only valid until the next call to this
+ *                        function or reset_source_file().
  * Parameters:
- * cppBuffer - Address of a char* allocated with malloc where the line text is to
- *             be stored.  May be NULL in which case a buffer will be allocated
- *             using malloc.
- * ipBufferSize - A pointer to the size of the passed buffer.  If NULL is passed
- *                for *cppBuffer set the buffer size to zero and a buffer will be
- *                allocated using malloc.
+ * pContext - Pointer to the assembler context.
+ * cppLine - Address of a char* which is set to the start of the line.
  * Returns:  When successful, it returns the number of characters read (including
  *           the newline, but not including the terminating NULL).  If end of
  *           file is reached without any bytes read zero is returned.  If an error
  *           occurs a negative number is returned.
 ------------------------------------------------------------------------------*/
-ssize_t read_line_from_source_file(char** cppBuffer, size_t* ipBufferSize)
+ssize_t read_line_from_source_file(AssemblerContext* pContext, char** cppLine)
 {
+    char* cpNewline;
+
     ssize_t iFunctionReturnValue;
 
+    size_t iEndOfLine;
+
     //Make sure the file is open.
-    if(s_pSourceFile == NULL)
+    if(pContext->m_files.m_pSourceFile == NULL && pContext->m_files.m_bIsSourceMemoryOpen == FALSE)
     {
         print_error(__func__, FileNotOpen);
         return -FileNotOpen;
     }
 
-    //The file is open so read a line of text from the stream.
-    iFunctionReturnValue = getline(cppBuffer, ipBufferSize, s_pSourceFile);
-    if(iFunctionReturnValue != -1)
+    //Put back the character that was replaced by the NULL terminating byte of
+    //the previous line.
+    if(pContext->m_files.m_bIsCharacterSaved == TRUE)
     {
-        //If EOF is reached before a newline character then getline() doesn't
-        //NULL terminate the string so check if we need to do so here.
-        if(feof(s_pSourceFile) != 0)
-            (*cppBuffer)[iFunctionReturnValue] = '\0';
-
-        //A good line read was done so return the amount of characters read.
-        return iFunctionReturnValue;
+        pContext->m_files.m_cpSourceBuffer[pContext->m_files.m_iSavedCharacterPosition] = pContext->m_files.m_cSavedCharacter;
+        pContext->m_files.m_bIsCharacterSaved = FALSE;
     }
-    else
+
+    //Look for the end of the line in what is already buffered.  If it isn't
+    //there then read more of the file, picking up the search where it left off.
+    while(TRUE)
     {
-        //We got a negative one which means an error occurred or EOF was reached.
-        //Check for EOF and return the proper value.
-        if(feof(s_pSourceFile) != 0)
+        cpNewline = NULL;
+        if(pContext->m_files.m_iSourceScanPosition < pContext->m_files.m_iSourceBufferUsed)
+            cpNewline = memchr(pContext->m_files.m_cpSourceBuffer + pContext->m_files.m_iSourceScanPosition, '\n', pContext->m_files.m_iSourceBufferUsed - pContext->m_files.m_iSourceScanPosition);
+
+        if(cpNewline != NULL)
         {
-            //EOF.
-            return 0;
+            iEndOfLine = cpNewline - pContext->m_files.m_cpSourceBuffer + 1;
+            break;
         }
-        else
+
+        pContext->m_files.m_iSourceScanPosition = pContext->m_files.m_iSourceBufferUsed;
+        if(pContext->m_files.m_bIsSourceEndOfFile == TRUE)
         {
-            //Error.
-            print_error(__func__, GetlineError);
-            return -GetlineError;
+            //No more data.  Whatever is left is the last line and it has no
+            //newline.
+            if(pContext->m_files.m_iSourceLineStart == pContext->m_files.m_iSourceBufferUsed)
+                return 0;
+
+            iEndOfLine = pContext->m_files.m_iSourceBufferUsed;
+            break;
         }
+
+        iFunctionReturnValue = fill_source_buffer(pContext);
+        if(iFunctionReturnValue < 0)
+            return iFunctionReturnValue;
     }
+
+    //Hand back the line and NULL terminate it.  The input buffer always has one
+    //byte more than its size so there is room for the terminator even when the
+    //line ends at the very end of the buffered data.
+    *cppLine = pContext->m_files.m_cpSourceBuffer + pContext->m_files.m_iSourceLineStart;
+    iFunctionReturnValue = iEndOfLine - pContext->m_files.m_iSourceLineStart;
+
+    pContext->m_files.m_cSavedCharacter = pContext->m_files.m_cpSourceBuffer[iEndOfLine];
+    pContext->m_files.m_iSavedCharacterPosition = iEndOfLine;
+    pContext->m_files.m_bIsCharacterSaved = TRUE;
+    pContext->m_files.m_cpSourceBuffer[iEndOfLine] = '\0';
+
+    pContext->m_files.m_iSourceLineFileOffset = pContext->m_files.m_iSourceBufferFileOffset + pContext->m_files.m_iSourceLineStart;
+    pContext->m_files.m_iSourceLineStart = iEndOfLine;
+    pContext->m_files.m_iSourceScanPosition = iEndOfLine;
+
+    return iFunctionReturnValue;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  get_source_line_file_offset
+ * Function Description:  Getter function for where the last line read starts in
+ *                        the source file.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  The offset of the line from the beginning of the file.
+------------------------------------------------------------------------------*/
+size_t get_source_line_file_offset(AssemblerContext* pContext)
+{
+    return pContext->m_files.m_iSourceLineFileOffset;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  get_source_file_size
+ * Function Description:  Gets the size of the open source file.  The file is
+ *                        left where it was so the next line read isn't changed.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * ipFileSize - Pointer to where to store the number of bytes in the file.
+ * Returns:  Zero for success and non-zero for failure.
+------------------------------------------------------------------------------*/
+int get_source_file_size(AssemblerContext* pContext, size_t* ipFileSize)
+{
+    long iFilePosition;
+    long iFileSize;
+
+    //Make sure the source file is opened.
+    if(pContext->m_files.m_pSourceFile == NULL && pContext->m_files.m_bIsSourceMemoryOpen == FALSE)
+    {
+        print_error(__func__, FileNotOpen);
+        return -FileNotOpen;
+    }
+
+    if(pContext->m_files.m_bIsSourceMemoryOpen == TRUE)
+    {
+        *ipFileSize = pContext->m_files.m_iSourceMemoryLength;
+        return EXIT_SUCCESS;
+    }
+
+    //Go to the end of the file to find its size and then back again.
+    iFilePosition = ftell(pContext->m_files.m_pSourceFile);
+    if(iFilePosition < 0 || fseek(pContext->m_files.m_pSourceFile, 0, SEEK_END) != EXIT_SUCCESS)
+    {
+        print_error(__func__, ResetFileError);
+        return -ResetFileError;
+    }
+
+    iFileSize = ftell(pContext->m_files.m_pSourceFile);
+    if(iFileSize < 0 || fseek(pContext->m_files.m_pSourceFile, iFilePosition, SEEK_SET) != EXIT_SUCCESS)
+    {
+        print_error(__func__, ResetFileError);
+        return -ResetFileError;
+    }
+
+    *ipFileSize = (size_t)iFileSize;
+
+    return EXIT_SUCCESS;
 }
 
 /*------------------------------------------------------------------------------
  * Function name:  write_line_to_listing_file
  * Function Description:  Writes a passed string to the listing file.
  * Parameters:
+ * pContext - Pointer to the assembler context.
  * cpString - The text to write the the listing file.
  * Returns:  Zero for success and non-zero for failure.
 ------------------------------------------------------------------------------*/
-int write_line_to_listing_file(char* cpString)
+int write_line_to_listing_file(AssemblerContext* pContext, char* cpString)
 {
+    int iReturnValue;
+
     //Make sure the file is open.
-    if(s_pListingFile == NULL)
+    if(pContext->m_files.m_pListingFile == NULL && pContext->m_files.m_bIsListingMemoryOpen == FALSE)
     {
         print_error(__func__, FileNotOpen);
         return -FileNotOpen;
     }
 
     //The file is open so write the line.
-    if(fprintf(s_pListingFile, "%s\r\n", cpString) <= 0)
+    if(pContext->m_files.m_bIsListingMemoryOpen == TRUE)
+    {
+        iReturnValue = append_to_memory_buffer(pContext->m_files.m_pListingMemory, cpString, strlen(cpString));
+        if(iReturnValue != EXIT_SUCCESS)
+            return iReturnValue;
+
+        return append_to_memory_buffer(pContext->m_files.m_pListingMemory, "\r\n", 2);
+    }
+
+    if(fprintf(pContext->m_files.m_pListingFile, "%s\r\n", cpString) <= 0)
+    {
+        print_error(__func__, FileWriteError);
+        return -FileWriteError;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  write_text_to_listing_file
+ * Function Description:  Writes text that already has its line endings to the
+ *                        listing file.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * cpText - The text to write to the listing file.
+ * iLength - The number of characters in the text.
+ * Returns:  Zero for success and non-zero for failure.
+------------------------------------------------------------------------------*/
+int write_text_to_listing_file(AssemblerContext* pContext, const char* cpText, size_t iLength)
+{
+    //Make sure the file is open.
+    if(pContext->m_files.m_pListingFile == NULL && pContext->m_files.m_bIsListingMemoryOpen == FALSE)
+    {
+        print_error(__func__, FileNotOpen);
+        return -FileNotOpen;
+    }
+
+    //The file is open so write the text.
+    if(pContext->m_files.m_bIsListingMemoryOpen == TRUE)
+        return append_to_memory_buffer(pContext->m_files.m_pListingMemory, cpText, iLength);
+
+    if(iLength != 0 && fwrite(cpText, 1, iLength, pContext->m_files.m_pListingFile) != iLength)
     {
         print_error(__func__, FileWriteError);
         return -FileWriteError;
@@ -311,23 +496,48 @@ int write_line_to_listing_file(char* cpString)
  * Function name:  write_data_to_binary_file
  * Function Description:  Writes data to the binary object file.
  * Parameters:
+ * pContext - Pointer to the assembler context.
  * ipData - Pointer to the data to the written.
  * iLength - The amount of data bytes to write.
  * Returns:  Zero for success and non-zero for failure.
 ------------------------------------------------------------------------------*/
-int write_data_to_binary_file(int16_t* ipData, size_t iLength)
+int write_data_to_binary_file(AssemblerContext* pContext, int16_t* ipData, size_t iLength)
 {
+    int iReturnValue;
+
+    MemoryBuffer* pBinary;
+
     //Make sure the file is open.
-    if(s_pBinaryFile == NULL)
+    if(pContext->m_files.m_pBinaryFile == NULL && pContext->m_files.m_bIsBinaryMemoryOpen == FALSE)
     {
         print_error(__func__, FileNotOpen);
         return -FileNotOpen;
     }
 
+    //The data bytes are written to memory the same way fputc() writes them.
+    if(pContext->m_files.m_bIsBinaryMemoryOpen == TRUE)
+    {
+        pBinary = pContext->m_files.m_pBinaryMemory;
+        iReturnValue = reserve_memory_buffer(pBinary, pBinary->m_iLength + iLength);
+        if(iReturnValue != EXIT_SUCCESS)
+            return iReturnValue;
+
+        while(iLength != 0)
+        {
+            pBinary->m_cpData[pBinary->m_iLength++] = (char)(uint8_t)*ipData;
+            ipData++;
+            iLength--;
+        }
+
+        pBinary->m_cpData[pBinary->m_iLength] = '\0';
+
+        return EXIT_SUCCESS;
+    }
+
     //The file is open.  Write all the data bytes.
     while(iLength != 0)
     {
-        if(fputc(*ipData, s_pBinaryFile) == EOF)
+        if(fputc(*ipData, pContext->m_files.m_pBinaryFile) == EOF)
         {
             //EOF is returned when an error occurs.
             print_error(__func__, FileWriteError);
@@ -345,182 +555,286 @@ int write_data_to_binary_file(int16_t* ipData, size_t iLength)
 
 /*------------------------------------------------------------------------------
  * Function name:  close_all_files
- * Function Description:  Closes all open files.
- * Parameters:  None.
+ * Function Description:  Closes all open files so the next source file can be
+ *                        opened.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
  * Returns:  None.
 ------------------------------------------------------------------------------*/
-void close_all_files(void)
+void close_all_files(AssemblerContext* pContext)
 {
-    if(s_pSourceFile != NULL)
-        fclose(s_pSourceFile);
-    if(s_pListingFile != NULL)
-        fclose(s_pListingFile);
-    if(s_pBinaryFile != NULL)
-        fclose(s_pBinaryFile);
+    if(pContext->m_files.m_pSourceFile != NULL)
+        fclose(pContext->m_files.m_pSourceFile);
+    if(pContext->m_files.m_cpSourceBuffer != NULL)
+        free(pContext->m_files.m_cpSourceBuffer);
+    if(pContext->m_files.m_pListingFile != NULL)
+        replace_output_file(pContext, pContext->m_files.m_pListingFile, LISTING_FILE_EXTENSION);
+    if(pContext->m_files.m_pBinaryFile != NULL)
+        replace_output_file(pContext, pContext->m_files.m_pBinaryFile, BINARY_FILE_EXTENSION);
+
+    pContext->m_files.m_pSourceFile = NULL;
+    pContext->m_files.m_pListingFile = NULL;
+    pContext->m_files.m_pBinaryFile = NULL;
+    pContext->m_files.m_cpSourceBuffer = NULL;
+    pContext->m_files.m_iSourceBufferSize = 0;
+    pContext->m_files.m_bIsSourceMemoryOpen = FALSE;
+    pContext->m_files.m_bIsListingMemoryOpen = FALSE;
+    pContext->m_files.m_bIsBinaryMemoryOpen = FALSE;
 }
 
-//#ifndef HAVE_GETLINE
-#if _POSIX_C_SOURCE < 200809L
 /*------------------------------------------------------------------------------
- * Function name:  getline
- * Function Description:  Reads an entire line from pFileStream, storing the text
- *                        (including the newline and a terminating NULL
- *                        character) in a buffer and storing the buffer address
- *                        in *cppBuffer.  Before calling getline, you should
- *                        place in *cppBuffer the address of a buffer
- *                        *ipBufferSize bytes long, allocated with malloc.  If
- *                        this buffer is long enough to hold the line, getline
- *                        stores the line in this buffer.  Otherwise, getline
- *                        makes the buffer bigger using realloc, storing the new
- *                        buffer address back in *cppBuffer and the increased
- *                        size back in *ipBufferSize.  If you set *ccpBuffer to a
- *                        NULL pointer, and *ipBufferSize to zero, before the
- *                        call, then getline allocates the initial buffer for you
- *                        by calling malloc.  In either case, when getline
- *                        returns, *cppBuffer is a char* which points to the text
- *                        of the line.
+ * Function name:  use_memory_files
+ * Function Description:  Has the assembly read its source from memory and write
+ *                        its listing and binary to memory buffers instead of
+ *                        files.  Nothing is read from or written to disk.
  * Parameters:
- * cppBuffer - Address of a char* allocated with malloc where the line text is to
- *             be stored.  May be NULL in which case getline will allocate the
- *             buffer using malloc.
- * ipBufferSize - A pointer to the size of the passed buffer.  If NULL is passed
- *                for *cppBuffer set the buffer size to zero and getline will
- *                allocate the buffer using malloc.
- * pFileStream - Pointer to the file stream on which to do the read.
- * Returns:  When successful, it returns the number of characters read (including
- *           the newline, but not including the terminating NULL).  This value
- *           enables you to distinguish NULL characters that are part of the line
- *           from the NULL character inserted as a terminator.  If an error
- *           occurs or end of file is reached without any bytes read, -1 is
- *           returned.
+ * pContext - Pointer to the assembler context.
+ * cpSource - Pointer to the source text.  It isn't changed and has to be kept
+ *            until the assembly is done.
+ * iSourceLength - The number of characters in the source text.
+ * pListing - Pointer to the buffer the listing is written to.
+ * pBinary - Pointer to the buffer the binary is written to.
+ * Returns:  None.
 ------------------------------------------------------------------------------*/
-static ssize_t getline(char** cppBuffer, size_t* ipBufferSize, FILE* pFileStream)
+void use_memory_files(AssemblerContext* pContext, const char* cpSource, size_t iSourceLength, MemoryBuffer* pListing, MemoryBuffer* pBinary)
 {
-    return getdelim(cppBuffer, ipBufferSize, '\n', pFileStream);
+    pContext->m_files.m_cpSourceMemory = (cpSource != NULL) ? cpSource : "";
+    pContext->m_files.m_iSourceMemoryLength = (cpSource != NULL) ? iSourceLength : 0;
+    pContext->m_files.m_pListingMemory = pListing;
+    pContext->m_files.m_pBinaryMemory = pBinary;
 }
 
 /*------------------------------------------------------------------------------
- * Function name:  getdelim
- * Function Description:  Reads text from pFileStream, storing the text
- *                        (including the delimiting character iDelimiter and a
- *                        terminating NULL character) in a buffer and storing the
- *                        buffer address in *cppBuffer.  Before calling getdelim,
- *                        you should place in *cppBuffer the address of a buffer
- *                        *ipBufferSize bytes long, allocated with malloc.  If
- *                        this buffer is long enough to hold the line, getdelim
- *                        stores the line in this buffer.  Otherwise, getdelim
- *                        makes the buffer bigger using realloc, storing the new
- *                        buffer address back in *cppBuffer and the increased
- *                        size back in *ipBufferSize.  If you set *ccpBuffer to a
- *                        NULL pointer, and *ipBufferSize to zero, before the
- *                        call, then getdelim allocates the initial buffer for
- *                        you by calling malloc.  In either case, when getdelim
- *                        returns, *cppBuffer is a char* which points to the text
- *                        of the line.
+ * Function name:  share_memory_files
+ * Function Description:  Gives an assembler context whose files were cleared the
+ *                        source in memory of another, so it reads the same
+ *                        source the other one does.  A context that uses files
+ *                        on disk has nothing to share.
  * Parameters:
- * cppBuffer - Address of a char* allocated with malloc where the line text is to
- *             be stored.  May be NULL in which case getdelim will allocate the
- *             buffer using malloc.
- * ipBufferSize - A pointer to the size of the passed buffer.  If NULL is passed
- *                for *cppBuffer set the buffer size to zero and getdelim will
- *                allocate the buffer using malloc.
- * iDelimiter - The delimiting character on which to stop the read.
- * pFileStream - Pointer to the file stream on which to do the read.
- * Returns:  When successful, it returns the number of characters read (including
- *           the delimiting character iDelimiter, but not including the
- *           terminating NULL).  This value enables you to distinguish NULL
- *           characters that are part of the line from the NULL character
- *           inserted as a terminator.  If an error occurs or end of file is
- *           reached without any bytes read, -1 is returned.
+ * pContext - Pointer to the assembler context to give the source to.
+ * pSharedContext - Pointer to the assembler context to share the source of.
+ * Returns:  None.
 ------------------------------------------------------------------------------*/
-static ssize_t getdelim(char** cppBuffer, size_t* ipBufferSize, int iDelimiter, FILE* pFileStream)
+void share_memory_files(AssemblerContext* pContext, AssemblerContext* pSharedContext)
 {
-    char* cpBufferPosition;
-    char* cpBufferEnd;
-    char* cpNewBuffer;
+    pContext->m_files.m_cpSourceMemory = pSharedContext->m_files.m_cpSourceMemory;
+    pContext->m_files.m_iSourceMemoryLength = pSharedContext->m_files.m_iSourceMemoryLength;
+}
 
-    int iCharacter;
+/*------------------------------------------------------------------------------
+ * Function name:  reserve_memory_buffer
+ * Function Description:  Makes sure a memory buffer has room for a length of
+ *                        data and its NULL terminating byte.  The size is doubled
+ *                        until there is room.
+ * Parameters:
+ * pBuffer - Pointer to the memory buffer.
+ * iLength - The length of data the buffer has to hold.
+ * Returns:  Zero for success and a negative number for failure.
+------------------------------------------------------------------------------*/
+int reserve_memory_buffer(MemoryBuffer* pBuffer, size_t iLength)
+{
+    char* cpNewData;
 
-    ssize_t iReturnValue;
-    ssize_t iNumCharactersSoFar;
+    size_t iNewSize;
 
-    size_t iNewBufferSize;
+    if(pBuffer->m_cpData != NULL && iLength < pBuffer->m_iSize)
+        return EXIT_SUCCESS;
+
+    iNewSize = (pBuffer->m_iSize == 0) ? MEMORY_BUFFER_INITIAL_SIZE : pBuffer->m_iSize;
+    while(iLength >= iNewSize)
+        iNewSize *= 2;
 
-    //If a NULL was passed for the buffer or the buffer size is zero then
-    //allocate a buffer using the standard buffer size.
-    if(*cppBuffer == NULL || *ipBufferSize == 0)
+    cpNewData = realloc(pBuffer->m_cpData, iNewSize);
+    if(cpNewData == NULL)
     {
-        *ipBufferSize = BUFSIZ;
-        if((*cppBuffer = malloc(*ipBufferSize)) == NULL)
-            return -1;
+        print_error(__func__, MallocReturnedNull);
+        return -MallocReturnedNull;
     }
 
-    //We have a buffer to which to write text.  Start the position at the
-    //beginning of the buffer and mark where the end of the buffer size based on
-    //the size of the buffer.
-    cpBufferPosition = *cppBuffer;
-    cpBufferEnd = *cppBuffer + *ipBufferSize;
+    //A new buffer is empty.
+    if(pBuffer->m_cpData == NULL)
+        cpNewData[0] = '\0';
 
-    //We will exit this loop when one of the following conditions is met:
-    //1.  End of file is reached.
-    //2.  An error occurs while reading from the stream.
-    //3.  The delimiting character is reached.
-    //4.  An error occurs while trying to expand the buffer size.
-    //Initially set the return value as an error occurred.
-    iReturnValue = -1;
-    while(TRUE)
+    pBuffer->m_cpData = cpNewData;
+    pBuffer->m_iSize = iNewSize;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  append_to_memory_buffer
+ * Function Description:  Adds data to the end of a memory buffer.
+ * Parameters:
+ * pBuffer - Pointer to the memory buffer.
+ * vpData - Pointer to the data to add.
+ * iLength - The number of bytes to add.
+ * Returns:  Zero for success and a negative number for failure.
+------------------------------------------------------------------------------*/
+int append_to_memory_buffer(MemoryBuffer* pBuffer, const void* vpData, size_t iLength)
+{
+    int iReturnValue;
+
+    iReturnValue = reserve_memory_buffer(pBuffer, pBuffer->m_iLength + iLength);
+    if(iReturnValue != EXIT_SUCCESS)
+        return iReturnValue;
+
+    memcpy(pBuffer->m_cpData + pBuffer->m_iLength, vpData, iLength);
+    pBuffer->m_iLength += iLength;
+    pBuffer->m_cpData[pBuffer->m_iLength] = '\0';
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  free_memory_buffer
+ * Function Description:  Frees the memory of a memory buffer and leaves it
+ *                        empty.
+ * Parameters:
+ * pBuffer - Pointer to the memory buffer.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+void free_memory_buffer(MemoryBuffer* pBuffer)
+{
+    if(pBuffer->m_cpData != NULL)
+        free(pBuffer->m_cpData);
+
+    pBuffer->m_cpData = NULL;
+    pBuffer->m_iLength = 0;
+    pBuffer->m_iSize = 0;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  fill_source_buffer
+ * Function Description:  Reads the next block of the source file into the input
+ *                        buffer.  The partial line at the end of the buffer is
+ *                        first moved to the front so the read can fill the rest.
+ *                        The buffer is only made bigger when a single line does
+ *                        not fit in it.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  The number of bytes read for success, zero at end of file, and a
+ *           negative number for failure.
+------------------------------------------------------------------------------*/
+static ssize_t fill_source_buffer(AssemblerContext* pContext)
+{
+    char* cpNewBuffer;
+
+    size_t iCarryOverLength;
+    size_t iNewBufferSize;
+    size_t iBytesRead;
+
+    //Allocate the input buffer the first time through.  One extra byte is
+    //allocated for the NULL terminating byte of the last line.
+    if(pContext->m_files.m_cpSourceBuffer == NULL)
     {
-        //Get a character from the stream.  If EOF is returned then either the
-        //end of the file was reached for an error occurred.  In that case create
-        //the return value and break from the while() loop.
-        iCharacter = fgetc(pFileStream);
-        if(iCharacter == EOF)
+        pContext->m_files.m_cpSourceBuffer = malloc(SOURCE_FILE_BUFFER_SIZE + NULL_TERMINATING_BYTE_LENGTH);
+        if(pContext->m_files.m_cpSourceBuffer == NULL)
         {
-            if(feof(pFileStream) != 0 && cpBufferPosition != *cppBuffer)
-                iReturnValue = cpBufferPosition - *cppBuffer;
-            break;
+            print_error(__func__, MallocReturnedNull);
+            return -MallocReturnedNull;
         }
 
-        //Character was successfully read.  Store it in the buffer at the current
-        //position and then increment the position.
-        *cpBufferPosition = iCharacter;
-        cpBufferPosition++;
+        pContext->m_files.m_iSourceBufferSize = SOURCE_FILE_BUFFER_SIZE;
+    }
+
+    //Move the start of the line that runs off the end of the buffer to the front
+    //of the buffer.
+    if(pContext->m_files.m_iSourceLineStart != 0)
+    {
+        iCarryOverLength = pContext->m_files.m_iSourceBufferUsed - pContext->m_files.m_iSourceLineStart;
+        memmove(pContext->m_files.m_cpSourceBuffer, pContext->m_files.m_cpSourceBuffer + pContext->m_files.m_iSourceLineStart, iCarryOverLength);
+        pContext->m_files.m_iSourceBufferFileOffset += pContext->m_files.m_iSourceLineStart;
+        pContext->m_files.m_iSourceBufferUsed = iCarryOverLength;
+        pContext->m_files.m_iSourceScanPosition -= pContext->m_files.m_iSourceLineStart;
+        pContext->m_files.m_iSourceLineStart = 0;
+    }
 
-        //Check if the character was the delimiter and if so place a NULL
-        //terminating byte at the end of the text, calculate the return value,
-        //and break from the while() loop.
-        if(iCharacter == iDelimiter)
+    //If the buffer is still full then the line is longer than the buffer.
+    //Double the size of the buffer.
+    if(pContext->m_files.m_iSourceBufferUsed == pContext->m_files.m_iSourceBufferSize)
+    {
+        iNewBufferSize = pContext->m_files.m_iSourceBufferSize * 2;
+        cpNewBuffer = realloc(pContext->m_files.m_cpSourceBuffer, iNewBufferSize + NULL_TERMINATING_BYTE_LENGTH);
+        if(cpNewBuffer == NULL)
         {
-            *cpBufferPosition = '\0';
-            iReturnValue = cpBufferPosition - *cppBuffer;
-            break;
+            print_error(__func__, MallocReturnedNull);
+            return -MallocReturnedNull;
         }
 
-        //The character was not the delimiting character and there is more text
-        //to read.  If we are near the limit of the passed buffer then the buffer
-        //size needs to be expanded.  Add two to the current position, one for
-        //the delimiting character and one for the NULL terminating byte.
-        if((cpBufferPosition + 2) >= cpBufferEnd)
+        pContext->m_files.m_cpSourceBuffer = cpNewBuffer;
+        pContext->m_files.m_iSourceBufferSize = iNewBufferSize;
+    }
+
+    //Read as much as will fit.
+    if(pContext->m_files.m_bIsSourceMemoryOpen == TRUE)
+    {
+        iBytesRead = bmc_min(pContext->m_files.m_iSourceBufferSize - pContext->m_files.m_iSourceBufferUsed, pContext->m_files.m_iSourceMemoryLength - pContext->m_files.m_iSourceMemoryPosition);
+        memcpy(pContext->m_files.m_cpSourceBuffer + pContext->m_files.m_iSourceBufferUsed, pContext->m_files.m_cpSourceMemory + pContext->m_files.m_iSourceMemoryPosition, iBytesRead);
+        pContext->m_files.m_iSourceMemoryPosition += iBytesRead;
+    }
+    else
+    {
+        iBytesRead = fread(pContext->m_files.m_cpSourceBuffer + pContext->m_files.m_iSourceBufferUsed, 1, pContext->m_files.m_iSourceBufferSize - pContext->m_files.m_iSourceBufferUsed, pContext->m_files.m_pSourceFile);
+        if(iBytesRead == 0 && ferror(pContext->m_files.m_pSourceFile) != 0)
         {
-            //Double the buffer size.
-            iNewBufferSize = *ipBufferSize * 2;
-
-            //Make note of how many characters are stored in the buffer so far.
-            iNumCharactersSoFar = cpBufferPosition - *cppBuffer;
-
-            //Expand the buffer size
-            if((cpNewBuffer = realloc(*cppBuffer, iNewBufferSize)) == NULL)
-                break;
-
-            //Buffer expanded, store the new information about the expanded
-            //buffer.
-            *cppBuffer = cpNewBuffer;
-            *ipBufferSize = iNewBufferSize;
-            cpBufferEnd = cpNewBuffer + iNewBufferSize;
-            cpBufferPosition = cpNewBuffer + iNumCharactersSoFar;
+            print_error(__func__, GetlineError);
+            return -GetlineError;
         }
     }
 
-    return iReturnValue;
+    if(iBytesRead == 0)
+        pContext->m_files.m_bIsSourceEndOfFile = TRUE;
+
+    pContext->m_files.m_iSourceBufferUsed += iBytesRead;
+
+    return (ssize_t)iBytesRead;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  build_output_file_name
+ * Function Description:  Creates the path and file name of the listing or
+ *                        binary file, which is the base name of the source file
+ *                        with the extension in the directory of the source file.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * cpExtension - The extension of the file.
+ * bIsTemporary - TRUE for the name the file is written under until it is
+ *                closed.
+ * cpFileName - Where to store the path and file name.
+ * iSize - The size of cpFileName.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void build_output_file_name(AssemblerContext* pContext, const char* cpExtension, uint8_t bIsTemporary, char* cpFileName, size_t iSize)
+{
+    snprintf(cpFileName, iSize, "%s%s%s%s", get_assembly_source_file_path(pContext), get_assembly_source_base_file_name(pContext), cpExtension, (bIsTemporary == TRUE) ? TEMPORARY_FILE_EXTENSION : "");
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  replace_output_file
+ * Function Description:  Closes a listing or binary file and moves it from its
+ *                        temporary name over the old file in one step, so the
+ *                        old file is never seen half written.  If the file had
+ *                        a write error, or can't be closed or moved, the old
+ *                        file is left as it was.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * pFile - The open file.
+ * cpExtension - The extension of the file.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void replace_output_file(AssemblerContext* pContext, FILE* pFile, const char* cpExtension)
+{
+    char caTemporaryFile[PATH_MAX + FILENAME_MAX + sizeof(TEMPORARY_FILE_EXTENSION)];
+    char caOutputFile[PATH_MAX + FILENAME_MAX + NULL_TERMINATING_BYTE_LENGTH];
+
+    uint8_t bIsWritten;
+
+    bIsWritten = (ferror(pFile) == 0) ? TRUE : FALSE;
+    if(fclose(pFile) != 0)
+        bIsWritten = FALSE;
+
+    build_output_file_name(pContext, cpExtension, TRUE, caTemporaryFile, sizeof(caTemporaryFile));
+    build_output_file_name(pContext, cpExtension, FALSE, caOutputFile, sizeof(caOutputFile));
+    if(bIsWritten == FALSE || MoveFileExA(caTemporaryFile, caOutputFile, MOVEFILE_REPLACE_EXISTING) == 0)
+        remove(caTemporaryFile);
 }
-#endif
@@ -40,6 +40,11 @@
 //Defines
 #define LISTING_FILE_EXTENSION          ".lst"
 #define BINARY_FILE_EXTENSION           ".bin"
+#define TEMPORARY_FILE_EXTENSION        ".tmp"
+
+#define SOURCE_FILE_BUFFER_SIZE         (65536)
+
+#define MEMORY_BUFFER_INITIAL_SIZE      (4096)
 
 #define LISTING_FILE_TITLE              "NANOCORE ASSEMBLER"
 
@@ -48,7 +53,7 @@
 #define LISTING_FILE_LINE_FIELD_LENGTH                  (7)
 #define LISTING_FILE_LC_MAX_CHARACTERS                  (4)
 #define LISTING_FILE_LC_FIELD_LENGTH                    (6)
-#define LISTING_FILE_OBJECT_CODE_MAX_CHARACTERS         (8)
+#define LISTING_FILE_OBJECT_CODE_MAX_CHARACTERS         (9)
 #define LISTING_FILE_OBJECT_CODE_FIELD_LENGTH           (10)
 #define LISTING_FILE_OBJECT_CODE_BYTE_MAX_CHARACTERS    (3)
 #define LISTING_FILE_OBJECT_CODE_BYTES_PER_FIELD        (3)
@@ -59,17 +64,57 @@
 
 //------------------------------------------------------------------------------
 //Structures
-//None
+//The open files of one assembly and the buffer the source file is read
+//through.  The file offsets are where the first byte of the input buffer and
+//the last line read are in the source file.  An assembly from memory reads its
+//source from the caller's memory and writes its listing and binary to memory
+//buffers, the open flags stand in for the files.
+typedef struct tagFilesContext
+{
+    FILE* m_pSourceFile;
+    FILE* m_pListingFile;
+    FILE* m_pBinaryFile;
+
+    char* m_cpSourceBuffer;
+    size_t m_iSourceBufferSize;
+    size_t m_iSourceBufferUsed;
+    size_t m_iSourceLineStart;
+    size_t m_iSourceScanPosition;
+    size_t m_iSavedCharacterPosition;
+    size_t m_iSourceBufferFileOffset;
+    size_t m_iSourceLineFileOffset;
+    char m_cSavedCharacter;
+    uint8_t m_bIsCharacterSaved;
+    uint8_t m_bIsSourceEndOfFile;
+
+    const char* m_cpSourceMemory;
+    size_t m_iSourceMemoryLength;
+    size_t m_iSourceMemoryPosition;
+    MemoryBuffer* m_pListingMemory;
+    MemoryBuffer* m_pBinaryMemory;
+    uint8_t m_bIsSourceMemoryOpen;
+    uint8_t m_bIsListingMemoryOpen;
+    uint8_t m_bIsBinaryMemoryOpen;
+} FilesContext;
 
 //------------------------------------------------------------------------------
 //Prototypes
-int open_source_file(void);
-int open_listing_file(void);
-int open_binary_file(void);
-int reset_source_file(void);
-ssize_t read_line_from_source_file(char** cppBuffer, size_t* ipBufferSize);
-int write_line_to_listing_file(char* cpString);
-int write_data_to_binary_file(int16_t* ipData, size_t iLength);
-void close_all_files(void);
+int open_source_file(AssemblerContext* pContext);
+int open_listing_file(AssemblerContext* pContext);
+int open_binary_file(AssemblerContext* pContext);
+int reset_source_file(AssemblerContext* pContext);
+int seek_source_file(AssemblerContext* pContext, size_t iFileOffset);
+ssize_t read_line_from_source_file(AssemblerContext* pContext, char** cppLine);
+size_t get_source_line_file_offset(AssemblerContext* pContext);
+int get_source_file_size(AssemblerContext* pContext, size_t* ipFileSize);
+int write_line_to_listing_file(AssemblerContext* pContext, char* cpString);
+int write_text_to_listing_file(AssemblerContext* pContext, const char* cpText, size_t iLength);
+int write_data_to_binary_file(AssemblerContext* pContext, int16_t* ipData, size_t iLength);
+void close_all_files(AssemblerContext* pContext);
+void use_memory_files(AssemblerContext* pContext, const char* cpSource, size_t iSourceLength, MemoryBuffer* pListing, MemoryBuffer* pBinary);
+void share_memory_files(AssemblerContext* pContext, AssemblerContext* pSharedContext);
+int reserve_memory_buffer(MemoryBuffer* pBuffer, size_t iLength);
+int append_to_memory_buffer(MemoryBuffer* pBuffer, const void* vpData, size_t iLength);
+void free_memory_buffer(MemoryBuffer* pBuffer);
 
 #endif /*___FILES_H___*/
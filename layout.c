@@ -0,0 +1,645 @@
+/*
+ ********************************************************************************
+ ** Copyright (C) 2026 Donald J. Bartley <djbcoffee@gmail.com>
+ **
+ ** This source file may be used and distributed without restriction provided
+ ** that this copyright statement is not removed from the file and that any
+ ** derivative work contains the original copyright notice and the associated
+ ** disclaimer.
+ **
+ ** This source file is free software; you can redistribute it and/or modify it
+ ** under the terms of the GNU General Public License as published by the Free
+ ** Software Foundation; either version 2 of the License, or (at your option) any
+ ** later version.
+ **
+ ** This source file is distributed in the hope that it will be useful, but
+ ** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along with
+ ** this source file.  If not, see <http://www.gnu.org/licenses/> or write to the
+ ** Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ ** 02110-1301, USA.
+ ********************************************************************************
+ ** File: nanocore-as/src/layout.c
+ **
+ ** Description:
+ ** This translation (compilation) unit contains the layout engine.  When an
+ ** instruction's size depends on the value of its operand, the addresses of the
+ ** labels after it depend on that size.  Pass one records the statements that
+ ** set symbols, move the location counter, or can change size, and the layout
+ ** engine goes over those records until the sizes and symbol values settle.
+ ********************************************************************************
+ ** Version 1.0.0
+ ********************************************************************************
+ */
+
+//System #includes
+#ifndef _WINDOWS_H
+#include <windows.h>
+#endif
+#ifndef _STDIO_H
+#include <stdio.h>
+#endif
+#ifndef _STDINT_H
+#include <stdint.h>
+#endif
+#ifndef _STDLIB_H
+#include <stdlib.h>
+#endif
+
+//Project-wide #includes
+#ifndef ___UNIVERSAL_H___
+#include "universal.h"
+#endif
+
+//Project #includes
+#ifndef ___ARGUMENTS_H___
+#include "arguments.h"
+#endif
+#ifndef ___BSTREE_H___
+#include "bstree.h"
+#endif
+#ifndef ___CONTEXT_H___
+#include "context.h"
+#endif
+#ifndef ___EXPRESSION_H___
+#include "expression.h"
+#endif
+#ifndef ___LEXER_H___
+#include "lexer.h"
+#endif
+#ifndef ___LOG_H___
+#include "log.h"
+#endif
+
+//Reflective #includes
+#ifndef ___LAYOUT_H___
+#include "layout.h"
+#endif
+
+//------------------------------------------------------------------------------
+//Global Data
+//None
+
+//------------------------------------------------------------------------------
+//Static Data
+//None
+
+//------------------------------------------------------------------------------
+//Static Prototypes
+static int add_layout_record(AssemblerContext* pContext, uint8_t iKind, uint32_t iLocationCounter);
+static uint8_t run_layout_iteration(AssemblerContext* pContext);
+static void show_unsettled_lines(AssemblerContext* pContext);
+
+//==============================================================================
+//Functions
+/*------------------------------------------------------------------------------
+ * Function name:  reset_layout
+ * Function Description:  Throws away all layout records.  Used before pass one.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+void reset_layout(AssemblerContext* pContext)
+{
+    pContext->m_layout.m_iNumberOfLayoutRecords = 0;
+    pContext->m_layout.m_iLayoutRecordIndex = 0;
+    pContext->m_layout.m_iEndOfLastRecord = 0;
+    pContext->m_layout.m_iNumberOfDirectPageRecords = 0;
+    pContext->m_layout.m_iLayoutIterations = 0;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  add_layout_label
+ * Function Description:  Records a label found during pass one.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * pSymbolInfo - Pointer to the label's symbol information.
+ * iLocationCounter - The location counter at the label.
+ * Returns:  Zero for success and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+int add_layout_label(AssemblerContext* pContext, SymbolInfo* pSymbolInfo, uint32_t iLocationCounter)
+{
+    int iFunctionReturnValue;
+
+    iFunctionReturnValue = add_layout_record(pContext, LabelLayoutRecord, iLocationCounter);
+    if(iFunctionReturnValue != EXIT_SUCCESS)
+        return iFunctionReturnValue;
+
+    pContext->m_layout.m_pLayoutRecords[pContext->m_layout.m_iNumberOfLayoutRecords - 1].m_pSymbolInfo = pSymbolInfo;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  add_layout_equ
+ * Function Description:  Records an EQU directive found during pass one.  The
+ *                        symbol information holds the index of its compiled
+ *                        expression.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * pSymbolInfo - Pointer to the EQU symbol's information.
+ * iLocationCounter - The location counter at the EQU directive.
+ * Returns:  Zero for success and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+int add_layout_equ(AssemblerContext* pContext, SymbolInfo* pSymbolInfo, uint32_t iLocationCounter)
+{
+    int iFunctionReturnValue;
+
+    iFunctionReturnValue = add_layout_record(pContext, EquLayoutRecord, iLocationCounter);
+    if(iFunctionReturnValue != EXIT_SUCCESS)
+        return iFunctionReturnValue;
+
+    pContext->m_layout.m_pLayoutRecords[pContext->m_layout.m_iNumberOfLayoutRecords - 1].m_pSymbolInfo = pSymbolInfo;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  add_layout_org
+ * Function Description:  Records an ORG directive found during pass one.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * iExpression - The index of the ORG directive's compiled expression.
+ * iLocationCounter - The location counter before the ORG directive.
+ * iNewLocationCounter - The location counter pass one moved to.
+ * Returns:  Zero for success and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+int add_layout_org(AssemblerContext* pContext, uint32_t iExpression, uint32_t iLocationCounter, uint32_t iNewLocationCounter)
+{
+    int iFunctionReturnValue;
+
+    iFunctionReturnValue = add_layout_record(pContext, OrgLayoutRecord, iLocationCounter);
+    if(iFunctionReturnValue != EXIT_SUCCESS)
+        return iFunctionReturnValue;
+
+    pContext->m_layout.m_pLayoutRecords[pContext->m_layout.m_iNumberOfLayoutRecords - 1].m_iExpression = iExpression;
+    pContext->m_layout.m_iEndOfLastRecord = iNewLocationCounter;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  add_layout_space
+ * Function Description:  Records a DS or FILL directive found during pass one.
+ *                        The number of bytes may depend on labels.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * iExpression - The index of the directive's compiled count expression.
+ * iLocationCounter - The location counter at the directive.
+ * iCount - The number of bytes pass one gave the directive.
+ * Returns:  Zero for success and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+int add_layout_space(AssemblerContext* pContext, uint32_t iExpression, uint32_t iLocationCounter, uint32_t iCount)
+{
+    int iFunctionReturnValue;
+
+    iFunctionReturnValue = add_layout_record(pContext, SpaceLayoutRecord, iLocationCounter);
+    if(iFunctionReturnValue != EXIT_SUCCESS)
+        return iFunctionReturnValue;
+
+    pContext->m_layout.m_pLayoutRecords[pContext->m_layout.m_iNumberOfLayoutRecords - 1].m_iExpression = iExpression;
+    pContext->m_layout.m_iEndOfLastRecord = iLocationCounter + iCount;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  add_layout_direct_page
+ * Function Description:  Records an instruction that can use either its direct
+ *                        page or absolute form.  Pass one gives it the absolute
+ *                        form.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * iSourceLineNumber - The source line of the instruction.
+ * iExpression - The index of the operand's compiled expression.
+ * iLocationCounter - The location counter at the instruction.
+ * iShortLength - The length of the direct page form.
+ * iLongLength - The length of the absolute form.
+ * Returns:  Zero for success and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+int add_layout_direct_page(AssemblerContext* pContext, uint32_t iSourceLineNumber, uint32_t iExpression, uint32_t iLocationCounter, uint8_t iShortLength, uint8_t iLongLength)
+{
+    int iFunctionReturnValue;
+
+    LayoutRecord* pRecord;
+
+    iFunctionReturnValue = add_layout_record(pContext, DirectPageLayoutRecord, iLocationCounter);
+    if(iFunctionReturnValue != EXIT_SUCCESS)
+        return iFunctionReturnValue;
+
+    pRecord = &pContext->m_layout.m_pLayoutRecords[pContext->m_layout.m_iNumberOfLayoutRecords - 1];
+    pRecord->m_iSourceLineNumber = iSourceLineNumber;
+    pRecord->m_iExpression = iExpression;
+    pRecord->m_iShortLength = iShortLength;
+    pRecord->m_iLongLength = iLongLength;
+
+    pContext->m_layout.m_iEndOfLastRecord = iLocationCounter + iLongLength;
+    pContext->m_layout.m_iNumberOfDirectPageRecords++;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  append_layout_records
+ * Function Description:  Adds the layout records of another context to the end
+ *                        of the layout records.  The other context counted the
+ *                        location counter from zero until its first ORG
+ *                        directive, so the records and labels in front of it
+ *                        are moved up to where the other context really
+ *                        started.
+ * Parameters:
+ * pContext - Pointer to the assembler context to add to.
+ * pOtherContext - Pointer to the assembler context with the records.
+ * iLineNumberOffset - The number of source lines in front of the first line of
+ *                     the other context.
+ * iExpressionOffset - The number of compiled expressions in front of those of
+ *                     the other context.
+ * iLocationCounter - The location counter the other context started at.
+ * Returns:  Zero for success and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+int append_layout_records(AssemblerContext* pContext, AssemblerContext* pOtherContext, uint32_t iLineNumberOffset, uint32_t iExpressionOffset, uint32_t iLocationCounter)
+{
+    uint8_t bIsRelative;
+
+    uint32_t iNumberOfLayoutRecords;
+    uint32_t iRecord;
+
+    LayoutRecord* pNewLayoutRecords;
+    LayoutRecord* pRecord;
+
+    SymbolInfo* pSymbolInfo;
+
+    if(pOtherContext->m_layout.m_iNumberOfLayoutRecords == 0)
+        return EXIT_SUCCESS;
+
+    //Make room for all of the records at once.
+    iNumberOfLayoutRecords = pContext->m_layout.m_iNumberOfLayoutRecords + pOtherContext->m_layout.m_iNumberOfLayoutRecords;
+    if(iNumberOfLayoutRecords > pContext->m_layout.m_iLayoutRecordsCapacity)
+    {
+        while(iNumberOfLayoutRecords > pContext->m_layout.m_iLayoutRecordsCapacity)
+            pContext->m_layout.m_iLayoutRecordsCapacity = (pContext->m_layout.m_iLayoutRecordsCapacity == 0) ? LAYOUT_RECORDS_INITIAL_CAPACITY : pContext->m_layout.m_iLayoutRecordsCapacity * 2;
+
+        pNewLayoutRecords = realloc(pContext->m_layout.m_pLayoutRecords, pContext->m_layout.m_iLayoutRecordsCapacity * sizeof(LayoutRecord));
+        if(pNewLayoutRecords == NULL)
+        {
+            print_error(__func__, MallocReturnedNull);
+            return -MallocReturnedNull;
+        }
+
+        pContext->m_layout.m_pLayoutRecords = pNewLayoutRecords;
+    }
+
+    bIsRelative = TRUE;
+    for(iRecord = 0; iRecord < pOtherContext->m_layout.m_iNumberOfLayoutRecords; iRecord++)
+    {
+        pRecord = &pContext->m_layout.m_pLayoutRecords[pContext->m_layout.m_iNumberOfLayoutRecords + iRecord];
+        *pRecord = pOtherContext->m_layout.m_pLayoutRecords[iRecord];
+
+        //The gap of the first record was from location counter zero.
+        if(iRecord == 0)
+            pRecord->m_iGap = iLocationCounter + pRecord->m_iGap - pContext->m_layout.m_iEndOfLastRecord;
+
+        pSymbolInfo = pRecord->m_pSymbolInfo;
+        switch(pRecord->m_iKind)
+        {
+            case LabelLayoutRecord :
+                if(bIsRelative == TRUE)
+                {
+                    pSymbolInfo->m_iValue += iLocationCounter;
+                    pSymbolInfo->m_iLocationCounter += iLocationCounter;
+                }
+                break;
+            case EquLayoutRecord :
+                pSymbolInfo->m_iExpression += iExpressionOffset;
+                if(bIsRelative == TRUE)
+                    pSymbolInfo->m_iLocationCounter += iLocationCounter;
+                break;
+            case OrgLayoutRecord :
+                pRecord->m_iExpression += iExpressionOffset;
+                bIsRelative = FALSE;
+                break;
+            case SpaceLayoutRecord :
+                pRecord->m_iExpression += iExpressionOffset;
+                break;
+            case DirectPageLayoutRecord :
+                pRecord->m_iExpression += iExpressionOffset;
+                pRecord->m_iSourceLineNumber += iLineNumberOffset;
+                pContext->m_layout.m_iNumberOfDirectPageRecords++;
+                break;
+            default :
+                break;
+        }
+    }
+
+    pContext->m_layout.m_iNumberOfLayoutRecords = iNumberOfLayoutRecords;
+    pContext->m_layout.m_iEndOfLastRecord = pOtherContext->m_layout.m_iEndOfLastRecord + ((bIsRelative == TRUE) ? iLocationCounter : 0);
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  do_layout
+ * Function Description:  Goes over the layout records until no instruction
+ *                        changes size and no symbol changes value.  The symbol
+ *                        table is left with the settled values.  Nothing needs
+ *                        to be done if no instruction can change size.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  Zero for success and a negative number if the layout doesn't settle.
+------------------------------------------------------------------------------*/
+int do_layout(AssemblerContext* pContext)
+{
+    if(pContext->m_layout.m_iNumberOfDirectPageRecords == 0)
+        return EXIT_SUCCESS;
+
+    for(pContext->m_layout.m_iLayoutIterations = 1; pContext->m_layout.m_iLayoutIterations <= LAYOUT_MAX_ITERATIONS; pContext->m_layout.m_iLayoutIterations++)
+    {
+        if(run_layout_iteration(pContext) == FALSE)
+            return EXIT_SUCCESS;
+    }
+
+    //The sizes keep changing.  Show which instructions changed on the last
+    //time through, they are the ones going back and forth.
+    pContext->m_layout.m_iLayoutIterations = LAYOUT_MAX_ITERATIONS;
+    print_error(__func__, LayoutNotSettledError);
+    show_unsettled_lines(pContext);
+
+    return -LayoutNotSettledError;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  rewind_layout
+ * Function Description:  Goes back to the first layout record.  Used before
+ *                        pass two.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+void rewind_layout(AssemblerContext* pContext)
+{
+    pContext->m_layout.m_iLayoutRecordIndex = 0;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  resolve_layout_symbols
+ * Function Description:  Works out the value of every EQU symbol the layout
+ *                        left unresolved so that pass two only has to read the
+ *                        symbols.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  Zero for success and a negative number if a symbol can't be
+ *           resolved.
+------------------------------------------------------------------------------*/
+int resolve_layout_symbols(AssemblerContext* pContext)
+{
+    int iFunctionReturnValue;
+
+    uint32_t iRecord;
+
+    LayoutRecord* pRecord;
+
+    for(iRecord = 0; iRecord < pContext->m_layout.m_iNumberOfLayoutRecords; iRecord++)
+    {
+        pRecord = &pContext->m_layout.m_pLayoutRecords[iRecord];
+        if(pRecord->m_iKind == EquLayoutRecord && pRecord->m_pSymbolInfo->m_iState != SymbolResolved)
+        {
+            iFunctionReturnValue = resolve_equ_symbol(pContext, pRecord->m_pSymbolInfo);
+            if(iFunctionReturnValue != EXIT_SUCCESS)
+                return iFunctionReturnValue;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  is_direct_page_line
+ * Function Description:  Checks if the layout chose the direct page form for
+ *                        the instruction on a source line.  Lines are read in
+ *                        order so the records are walked along with them.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * iSourceLineNumber - The source line of the instruction.
+ * Returns:  TRUE if the direct page form is used, otherwise FALSE.
+------------------------------------------------------------------------------*/
+uint8_t is_direct_page_line(AssemblerContext* pContext, uint32_t iSourceLineNumber)
+{
+    LayoutRecord* pRecord;
+
+    while(pContext->m_layout.m_iLayoutRecordIndex < pContext->m_layout.m_iNumberOfLayoutRecords)
+    {
+        pRecord = &pContext->m_layout.m_pLayoutRecords[pContext->m_layout.m_iLayoutRecordIndex];
+        if(pRecord->m_iKind == DirectPageLayoutRecord)
+        {
+            if(pRecord->m_iSourceLineNumber > iSourceLineNumber)
+                break;
+
+            if(pRecord->m_iSourceLineNumber == iSourceLineNumber)
+            {
+                pContext->m_layout.m_iLayoutRecordIndex++;
+                return pRecord->m_bIsDirectPage;
+            }
+        }
+
+        pContext->m_layout.m_iLayoutRecordIndex++;
+    }
+
+    return FALSE;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  get_layout_iterations
+ * Function Description:  Getter function for the number of times the layout
+ *                        records were gone over.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  The number of iterations.
+------------------------------------------------------------------------------*/
+uint32_t get_layout_iterations(AssemblerContext* pContext)
+{
+    return pContext->m_layout.m_iLayoutIterations;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  free_layout_memory
+ * Function Description:  Frees all allocated memory used by the layout engine.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+void free_layout_memory(AssemblerContext* pContext)
+{
+    if(pContext->m_layout.m_pLayoutRecords != NULL)
+        free(pContext->m_layout.m_pLayoutRecords);
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  add_layout_record
+ * Function Description:  Adds a layout record to the end of the list.  The gap
+ *                        is worked out from where the last record ended.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * iKind - The kind of record.
+ * iLocationCounter - The location counter at the record's statement.
+ * Returns:  Zero for success and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+static int add_layout_record(AssemblerContext* pContext, uint8_t iKind, uint32_t iLocationCounter)
+{
+    LayoutRecord* pNewLayoutRecords;
+    LayoutRecord* pRecord;
+
+    if(pContext->m_layout.m_iNumberOfLayoutRecords == pContext->m_layout.m_iLayoutRecordsCapacity)
+    {
+        pContext->m_layout.m_iLayoutRecordsCapacity = (pContext->m_layout.m_iLayoutRecordsCapacity == 0) ? LAYOUT_RECORDS_INITIAL_CAPACITY : pContext->m_layout.m_iLayoutRecordsCapacity * 2;
+        pNewLayoutRecords = realloc(pContext->m_layout.m_pLayoutRecords, pContext->m_layout.m_iLayoutRecordsCapacity * sizeof(LayoutRecord));
+        if(pNewLayoutRecords == NULL)
+        {
+            print_error(__func__, MallocReturnedNull);
+            return -MallocReturnedNull;
+        }
+
+        pContext->m_layout.m_pLayoutRecords = pNewLayoutRecords;
+    }
+
+    pRecord = &pContext->m_layout.m_pLayoutRecords[pContext->m_layout.m_iNumberOfLayoutRecords];
+    pRecord->m_pSymbolInfo = NULL;
+    pRecord->m_iGap = iLocationCounter - pContext->m_layout.m_iEndOfLastRecord;
+    pRecord->m_iSourceLineNumber = 0;
+    pRecord->m_iExpression = 0;
+    pRecord->m_iKind = iKind;
+    pRecord->m_iShortLength = 0;
+    pRecord->m_iLongLength = 0;
+    pRecord->m_bIsDirectPage = FALSE;
+    pRecord->m_bHasChanged = FALSE;
+    pContext->m_layout.m_iNumberOfLayoutRecords++;
+
+    pContext->m_layout.m_iEndOfLastRecord = iLocationCounter;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  run_layout_iteration
+ * Function Description:  Goes over the layout records once, giving each label
+ *                        and EQU symbol its value and each instruction that can
+ *                        change size the form its operand allows.  Symbols
+ *                        further on still have the values from the last time
+ *                        through.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  TRUE if anything changed, otherwise FALSE.
+------------------------------------------------------------------------------*/
+static uint8_t run_layout_iteration(AssemblerContext* pContext)
+{
+    int iValue;
+
+    uint8_t bHasChanged;
+    uint8_t bIsDirectPage;
+    uint8_t iState;
+
+    uint32_t iLocationCounter;
+    uint32_t iRecord;
+
+    LayoutRecord* pRecord;
+
+    SymbolInfo* pSymbolInfo;
+
+    bHasChanged = FALSE;
+    iLocationCounter = 0;
+    for(iRecord = 0; iRecord < pContext->m_layout.m_iNumberOfLayoutRecords; iRecord++)
+    {
+        pRecord = &pContext->m_layout.m_pLayoutRecords[iRecord];
+        pRecord->m_bHasChanged = FALSE;
+        iLocationCounter += pRecord->m_iGap;
+
+        switch(pRecord->m_iKind)
+        {
+            case LabelLayoutRecord :
+                pSymbolInfo = pRecord->m_pSymbolInfo;
+                if(pSymbolInfo->m_iValue != iLocationCounter)
+                {
+                    pSymbolInfo->m_iValue = iLocationCounter;
+                    pSymbolInfo->m_iLocationCounter = iLocationCounter;
+                    pRecord->m_bHasChanged = TRUE;
+                }
+                break;
+            case EquLayoutRecord :
+                //An EQU that can't be resolved yet is left for pass two.
+                pSymbolInfo = pRecord->m_pSymbolInfo;
+                pSymbolInfo->m_iLocationCounter = iLocationCounter;
+                if(evaluate_compiled_expression(pContext, pSymbolInfo->m_iExpression, iLocationCounter, &iValue) == EXIT_SUCCESS)
+                {
+                    iState = SymbolResolved;
+                }
+                else
+                {
+                    iValue = 0;
+                    iState = SymbolUnresolved;
+                }
+
+                if(pSymbolInfo->m_iValue != (uint32_t)iValue || pSymbolInfo->m_iState != iState)
+                {
+                    pSymbolInfo->m_iValue = (uint32_t)iValue;
+                    pSymbolInfo->m_iState = iState;
+                    pRecord->m_bHasChanged = TRUE;
+                }
+                break;
+            case OrgLayoutRecord :
+                //An ORG that now moves backwards is reported in pass two.
+                if(evaluate_compiled_expression(pContext, pRecord->m_iExpression, iLocationCounter, &iValue) == EXIT_SUCCESS && iValue >= 0 && iValue < MAX_PROGRAM_MEMORY)
+                    iLocationCounter = (uint32_t)iValue;
+                break;
+            case SpaceLayoutRecord :
+                //A count that is now out of range is reported in pass two.
+                if(evaluate_compiled_expression(pContext, pRecord->m_iExpression, iLocationCounter, &iValue) == EXIT_SUCCESS && iValue >= 0 && (uint32_t)iValue <= MAX_PROGRAM_MEMORY - iLocationCounter)
+                    iLocationCounter += (uint32_t)iValue;
+                break;
+            case DirectPageLayoutRecord :
+                bIsDirectPage = FALSE;
+                if(evaluate_compiled_expression(pContext, pRecord->m_iExpression, iLocationCounter, &iValue) == EXIT_SUCCESS && iValue >= 0 && ((uint32_t)iValue >> 8) == get_direct_page(pContext))
+                    bIsDirectPage = TRUE;
+
+                if(pRecord->m_bIsDirectPage != bIsDirectPage)
+                {
+                    pRecord->m_bIsDirectPage = bIsDirectPage;
+                    pRecord->m_bHasChanged = TRUE;
+                }
+
+                iLocationCounter += (bIsDirectPage == TRUE) ? pRecord->m_iShortLength : pRecord->m_iLongLength;
+                break;
+            default :
+                break;
+        }
+
+        if(pRecord->m_bHasChanged == TRUE)
+            bHasChanged = TRUE;
+    }
+
+    return bHasChanged;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  show_unsettled_lines
+ * Function Description:  Prints the source lines of the instructions that
+ *                        changed size the last time the layout records were
+ *                        gone over.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void show_unsettled_lines(AssemblerContext* pContext)
+{
+    uint32_t iRecord;
+
+    LayoutRecord* pRecord;
+
+    for(iRecord = 0; iRecord < pContext->m_layout.m_iNumberOfLayoutRecords; iRecord++)
+    {
+        pRecord = &pContext->m_layout.m_pLayoutRecords[iRecord];
+        if(pRecord->m_iKind == DirectPageLayoutRecord && pRecord->m_bHasChanged == TRUE)
+            print_message("Line %u:  instruction keeps changing between %u and %u bytes.\n", pRecord->m_iSourceLineNumber, pRecord->m_iShortLength, pRecord->m_iLongLength);
+    }
+}
@@ -0,0 +1,100 @@
+/*
+ ********************************************************************************
+ ** Copyright (C) 2026 Donald J. Bartley <djbcoffee@gmail.com>
+ **
+ ** This source file may be used and distributed without restriction provided
+ ** that this copyright statement is not removed from the file and that any
+ ** derivative work contains the original copyright notice and the associated
+ ** disclaimer.
+ **
+ ** This source file is free software; you can redistribute it and/or modify it
+ ** under the terms of the GNU General Public License as published by the Free
+ ** Software Foundation; either version 2 of the License, or (at your option) any
+ ** later version.
+ **
+ ** This source file is distributed in the hope that it will be useful, but
+ ** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along with
+ ** this source file.  If not, see <http://www.gnu.org/licenses/> or write to the
+ ** Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ ** 02110-1301, USA.
+ ********************************************************************************
+ ** File: nanocore-as/src/layout.h
+ **
+ ** Description:
+ ** Header file that goes with layout.c
+ ********************************************************************************
+ ** Version 1.0.0
+ ********************************************************************************
+ */
+
+#ifndef ___LAYOUT_H___
+#define ___LAYOUT_H___
+
+//------------------------------------------------------------------------------
+//Defines
+#define LAYOUT_RECORDS_INITIAL_CAPACITY (1024)
+#define LAYOUT_MAX_ITERATIONS           (16)
+
+//------------------------------------------------------------------------------
+//Enumerations
+enum LayoutRecordKinds
+{
+    LabelLayoutRecord = 0,
+    EquLayoutRecord,
+    OrgLayoutRecord,
+    SpaceLayoutRecord,
+    DirectPageLayoutRecord
+};
+
+//------------------------------------------------------------------------------
+//Structures
+//A statement from pass one that either sets a symbol, moves the location
+//counter, or can change size.  The gap is how many bytes pass one placed between
+//the end of the previous record and this one, which don't change size.
+typedef struct tagLayoutRecord
+{
+    SymbolInfo* m_pSymbolInfo;
+    uint32_t m_iGap;
+    uint32_t m_iSourceLineNumber;
+    uint32_t m_iExpression;
+    uint8_t m_iKind;
+    uint8_t m_iShortLength;
+    uint8_t m_iLongLength;
+    uint8_t m_bIsDirectPage;
+    uint8_t m_bHasChanged;
+} LayoutRecord;
+
+//The layout records of one assembly.
+typedef struct tagLayoutContext
+{
+    LayoutRecord* m_pLayoutRecords;
+    uint32_t m_iNumberOfLayoutRecords;
+    uint32_t m_iLayoutRecordsCapacity;
+    uint32_t m_iLayoutRecordIndex;
+
+    uint32_t m_iEndOfLastRecord;
+    uint32_t m_iNumberOfDirectPageRecords;
+    uint32_t m_iLayoutIterations;
+} LayoutContext;
+
+//------------------------------------------------------------------------------
+//Prototypes
+void reset_layout(AssemblerContext* pContext);
+int add_layout_label(AssemblerContext* pContext, SymbolInfo* pSymbolInfo, uint32_t iLocationCounter);
+int add_layout_equ(AssemblerContext* pContext, SymbolInfo* pSymbolInfo, uint32_t iLocationCounter);
+int add_layout_org(AssemblerContext* pContext, uint32_t iExpression, uint32_t iLocationCounter, uint32_t iNewLocationCounter);
+int add_layout_space(AssemblerContext* pContext, uint32_t iExpression, uint32_t iLocationCounter, uint32_t iCount);
+int add_layout_direct_page(AssemblerContext* pContext, uint32_t iSourceLineNumber, uint32_t iExpression, uint32_t iLocationCounter, uint8_t iShortLength, uint8_t iLongLength);
+int append_layout_records(AssemblerContext* pContext, AssemblerContext* pOtherContext, uint32_t iLineNumberOffset, uint32_t iExpressionOffset, uint32_t iLocationCounter);
+int do_layout(AssemblerContext* pContext);
+void rewind_layout(AssemblerContext* pContext);
+int resolve_layout_symbols(AssemblerContext* pContext);
+uint8_t is_direct_page_line(AssemblerContext* pContext, uint32_t iSourceLineNumber);
+uint32_t get_layout_iterations(AssemblerContext* pContext);
+void free_layout_memory(AssemblerContext* pContext);
+
+#endif /*___LAYOUT_H___*/
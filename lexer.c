@@ -66,12 +66,21 @@
 #ifndef ___BSTREE_H___
 #include "bstree.h"
 #endif
+#ifndef ___CONTEXT_H___
+#include "context.h"
+#endif
 #ifndef ___EXPRESSION_H___
 #include "expression.h"
 #endif
 #ifndef ___FILES_H___
 #include "files.h"
 #endif
+#ifndef ___LAYOUT_H___
+#include "layout.h"
+#endif
+#ifndef ___LISTING_H___
+#include "listing.h"
+#endif
 #ifndef ___LOG_H___
 #include "log.h"
 #endif
@@ -87,20 +96,15 @@
 
 //------------------------------------------------------------------------------
 //Static Data
-static char* s_cpSourceLine = NULL;
-
-static uint32_t s_iStatementSymbolFieldLength;
-
-static LexerInfo s_lexerInfo;
-
-static BSTreeNode* s_pSymbolTableRoot = NULL;
-
 static const DirectiveInfo s_aDirectiveTable[] =
 {
     {ByteDirective, BYTE_DIRECTIVE_TEXT},
+    {DsDirective, DS_DIRECTIVE_TEXT},
     {EndDirective, END_DIRECTIVE_TEXT},
     {EquDirective, EQU_DIRECTIVE_TEXT},
-    {OrgDirective, ORG_DIRECTIVE_TEXT}
+    {FillDirective, FILL_DIRECTIVE_TEXT},
+    {OrgDirective, ORG_DIRECTIVE_TEXT},
+    {WordDirective, WORD_DIRECTIVE_TEXT}
 };
 
 static const OpcodeInfo s_aAddOpcodeInfo[NUMBER_OF_ADD_TYPES] =
@@ -246,28 +250,53 @@ static const InstructionInfo s_aInstructionTable[] =
 
 //------------------------------------------------------------------------------
 //Static Prototypes
-static int parse_source_line(void);
-static int lexical_scan_source_line(void);
-static int label_lexer(void);
-static int statement_lexer(void);
+static int parse_source_line(AssemblerContext* pContext);
+static int lexical_scan_source_line(AssemblerContext* pContext);
+static int label_lexer(AssemblerContext* pContext);
+static int statement_lexer(AssemblerContext* pContext);
 static int search_directive_table(const char* cpDirective);
 static int search_instruction_table(const char* cpMnemonic);
-static int do_byte_directive(char* cpCurrentStatementPosition);
-static int do_end_directive(char* cpCurrentStatementPosition);
-static int do_equ_directive(char* cpCurrentStatementPosition, char* cpSymbol);
-static int do_org_directive(char* cpCurrentStatementPosition);
-static void show_line_error(uint32_t iSourceLineErrorIndex);
-static void print_symbol_to_table(BSTreeNode* pNode);
+static int find_direct_page_type(AssemblerContext* pContext, uint32_t iInstructionIndex);
+static int do_byte_directive(AssemblerContext* pContext, char* cpCurrentStatementPosition);
+static int decode_string_literal(AssemblerContext* pContext, char** cppCurrentStatementPosition, StringLiteral* pStringLiteral);
+static int store_string_literal(AssemblerContext* pContext, const StringLiteral* pStringLiteral);
+static const StringLiteral* find_string_literal(AssemblerContext* pContext, uint32_t iTextOffset);
+static int do_ds_directive(AssemblerContext* pContext, char* cpCurrentStatementPosition);
+static int do_end_directive(AssemblerContext* pContext, char* cpCurrentStatementPosition);
+static int do_equ_directive(AssemblerContext* pContext, char* cpCurrentStatementPosition, char* cpSymbol);
+static int do_fill_directive(AssemblerContext* pContext, char* cpCurrentStatementPosition);
+static int do_org_directive(AssemblerContext* pContext, char* cpCurrentStatementPosition);
+static int do_word_directive(AssemblerContext* pContext, char* cpCurrentStatementPosition);
+static int do_count_expression(AssemblerContext* pContext, char** cppCurrentStatementPosition, uint32_t* ipCount);
+static void measure_display_character(AssemblerContext* pContext, uint32_t iIndex);
+static int add_line_to_listing(AssemblerContext* pContext, uint32_t iLocationCounter, uint8_t bHasObjectCode);
+static int record_line_error(AssemblerContext* pContext, int iError);
+static void show_line_error(AssemblerContext* pContext, uint32_t iSourceLineErrorIndex);
+static int store_label_line(AssemblerContext* pContext, SymbolInfo* pSymbolInfo);
+static void reset_pass_one(AssemblerContext* pContext);
+static int do_pass_one_chunks(AssemblerContext* pContext);
+static int create_pass_one_chunk(AssemblerContext* pContext, PassOneChunk* pChunk, size_t iStartFileOffset, size_t iEndFileOffset);
+static void free_pass_one_chunk(PassOneChunk* pChunk);
+static DWORD WINAPI pass_one_chunk_thread(LPVOID vpChunk);
+static int assemble_pass_one_chunk(AssemblerContext* pContext, size_t iStartFileOffset, size_t iEndFileOffset, volatile LONG* ipIsChunkFailed);
+static int merge_pass_one_chunk(AssemblerContext* pContext, AssemblerContext* pChunkContext);
+static int do_pass_two_chunks(AssemblerContext* pContext, uint32_t iNumberOfSourceLines);
+static int create_pass_two_chunk(AssemblerContext* pContext, PassTwoChunk* pChunk, uint32_t iStartSourceLineNumber, size_t iFileOffset, uint32_t iStartLocationCounter);
+static void free_pass_two_chunk(PassTwoChunk* pChunk);
+static DWORD WINAPI pass_two_chunk_thread(LPVOID vpChunk);
+static int assemble_pass_two_chunk(AssemblerContext* pContext, uint32_t iEndSourceLineNumber);
+static void print_symbol_to_table(BSTreeNode* pNode, void* vpWalkData);
 
 //==============================================================================
 //Functions
 /*------------------------------------------------------------------------------
  * Function name:  do_assembly
  * Function Description:  Performs a two-pass assembly on the source file.
- * Parameters:  None.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
  * Returns:  Zero for success and negative number for failure.
 ------------------------------------------------------------------------------*/
-int do_assembly(void)
+int do_assembly(AssemblerContext* pContext)
 {
     char caText[LISTING_FILE_MAX_COLUMNS + NULL_TERMINATING_BYTE_LENGTH];
     char caTimeString[30];
@@ -277,73 +306,76 @@ int do_assembly(void)
 
     uint32_t iVersionStringField;
     uint32_t iDateTimeField;
-    uint32_t iCounter;
     uint32_t iFirstCodeByteLocation;
+    uint32_t iLineLocationCounter;
+    uint32_t iPassErrorCount;
+    uint32_t iNumberOfSourceLines;
 
     ssize_t iReadSourceFileReturnValue;
 
-    size_t iSourceLineBufferSize;
     size_t iFileNameLength;
     size_t iVersionStringLength;
 
     time_t currentTime;
 
-    struct tm* pLocalTime;
-
-    //Initialize variables.
-    iSourceLineBufferSize = 0;
-
-    //Clear out the lexer information structure.
-    memset(&s_lexerInfo, 0, sizeof(s_lexerInfo));
+    struct tm localTime;
 
-    //Initialize program memory storage to -1.  When it comes time to write the
-    //binary file we will be able to easily determine where the first byte of
-    //code starts.
-    for(iCounter = 0; iCounter < MAX_PROGRAM_MEMORY; iCounter++)
-        s_lexerInfo.m_iaProgramMemory[iCounter] = -1;
+    //Nothing is left from the last source file.
+    reset_pass_one(pContext);
+    iNumberOfSourceLines = 0;
 
     //Open the source file and check for success.
-    iReturnValue = open_source_file();
+    iReturnValue = open_source_file(pContext);
     if(iReturnValue != EXIT_SUCCESS)
         return iReturnValue;
 
     //This is a two pass assembler.
-    for(s_lexerInfo.m_iPass = PassOne; s_lexerInfo.m_iPass <= PassTwo; s_lexerInfo.m_iPass++)
+    for(pContext->m_lexer.m_lexerInfo.m_iPass = PassOne; pContext->m_lexer.m_lexerInfo.m_iPass <= PassTwo; pContext->m_lexer.m_lexerInfo.m_iPass++)
     {
         //Before starting the pass reset all variables.
-        s_lexerInfo.m_iSourceLineNumber = 0;
-        s_lexerInfo.m_iLocationCounter = 0;
+        pContext->m_lexer.m_lexerInfo.m_iSourceLineNumber = 0;
+        pContext->m_lexer.m_lexerInfo.m_iLocationCounter = 0;
+        pContext->m_lexer.m_iFailedLineIndex = 0;
+        pContext->m_lexer.m_iStringLiteralIndex = 0;
+        pContext->m_lexer.m_bIsLocationCounterUnknown = FALSE;
+        iPassErrorCount = pContext->m_lexer.m_iErrorCount;
 
         //Reset the source file and check for success.
-        iReturnValue = reset_source_file();
+        iReturnValue = reset_source_file(pContext);
         if(iReturnValue != EXIT_SUCCESS)
             return iReturnValue;
 
         //If this is pass two then open the listing file if the listing table is
         //enabled.
-        if(s_lexerInfo.m_iPass == PassTwo)
+        if(pContext->m_lexer.m_lexerInfo.m_iPass == PassTwo)
         {
-            if(is_listing_file_enabled() == TRUE)
+            rewind_compiled_expressions(pContext);
+            rewind_layout(pContext);
+            reset_listing(pContext);
+
+            if(is_listing_file_enabled(pContext) == TRUE)
             {
-                iReturnValue = open_listing_file();
+                iReturnValue = open_listing_file(pContext);
                 if(iReturnValue != EXIT_SUCCESS)
                     return iReturnValue;
 
                 //Listing file opened successfully so write the title.
                 snprintf(caText, sizeof(caText), "%*s", LISTING_FILE_MAX_COLUMNS / 2 + ((sizeof(LISTING_FILE_TITLE) - NULL_TERMINATING_BYTE_LENGTH) / 2), LISTING_FILE_TITLE);
-                iReturnValue = write_line_to_listing_file(caText);
+                iReturnValue = write_line_to_listing_file(pContext, caText);
                 if(iReturnValue != EXIT_SUCCESS)
                     return iReturnValue;
 
                 //Write the information line which contains the file name,
                 //program version, and date/time of assembly.  First get the
                 //current date and time, convert to local time, and then format.
+                //localtime_s() fills in our own structure rather than a shared
+                //one so another assembly thread can't change it.
                 currentTime = time(NULL);
-                pLocalTime = localtime(&currentTime);
-                strftime(caTimeString, sizeof(caTimeString), "%a %b %d %H:%M:%S %Y", pLocalTime);
+                localtime_s(&localTime, &currentTime);
+                strftime(caTimeString, sizeof(caTimeString), "%a %b %d %H:%M:%S %Y", &localTime);
 
                 //Get the sizes of the necessary strings.
-                iFileNameLength = strlen(get_assembly_source_full_file_name());
+                iFileNameLength = strlen(get_assembly_source_full_file_name(pContext));
                 iVersionStringLength = sizeof(VERSION) - NULL_TERMINATING_BYTE_LENGTH;
 
                 //Calculate the field sizes.
@@ -351,123 +383,212 @@ int do_assembly(void)
                 iDateTimeField = LISTING_FILE_MAX_COLUMNS - iFileNameLength - iVersionStringField;
 
                 //Write the information to the listing file.
-                snprintf(caText, sizeof(caText), "%s%*s%*s", get_assembly_source_full_file_name(), iVersionStringField, VERSION, iDateTimeField, caTimeString);
-                iReturnValue = write_line_to_listing_file(caText);
+                snprintf(caText, sizeof(caText), "%s%*s%*s", get_assembly_source_full_file_name(pContext), iVersionStringField, VERSION, iDateTimeField, caTimeString);
+                iReturnValue = write_line_to_listing_file(pContext, caText);
                 if(iReturnValue != EXIT_SUCCESS)
                     return iReturnValue;
 
                 //Write the header.
                 snprintf(caText, sizeof(caText), "\r\n%-*s%-*s%-*s", LISTING_FILE_LINE_FIELD_LENGTH, "", LISTING_FILE_LC_FIELD_LENGTH, "", LISTING_FILE_OBJECT_CODE_FIELD_LENGTH, "OBJECT");
-                iReturnValue = write_line_to_listing_file(caText);
+                iReturnValue = write_line_to_listing_file(pContext, caText);
                 if(iReturnValue != EXIT_SUCCESS)
                     return iReturnValue;
 
                 snprintf(caText, sizeof(caText), "%-*s%-*s%-*s%s", LISTING_FILE_LINE_FIELD_LENGTH, "LINE#", LISTING_FILE_LC_FIELD_LENGTH, "LOC", LISTING_FILE_OBJECT_CODE_FIELD_LENGTH, "CODE", "LINE");
-                iReturnValue = write_line_to_listing_file(caText);
+                iReturnValue = write_line_to_listing_file(pContext, caText);
                 if(iReturnValue != EXIT_SUCCESS)
                     return iReturnValue;
 
                 memset(caText, '-', sizeof(caText));
                 caText[LISTING_FILE_MAX_COLUMNS] = '\0';
-                iReturnValue = write_line_to_listing_file(caText);
+                iReturnValue = write_line_to_listing_file(pContext, caText);
                 if(iReturnValue != EXIT_SUCCESS)
                     return iReturnValue;
             }
         }
 
+        //A long source file has pass one split into chunks of the file, and if
+        //there were no errors in pass one then pass two is split into chunks of
+        //lines.  The chunks are done at the same time.  If that can't be done
+        //the lines are assembled one at a time below.
+        iReadSourceFileReturnValue = 1;
+        if(pContext->m_lexer.m_lexerInfo.m_iPass == PassOne)
+        {
+            iReturnValue = do_pass_one_chunks(pContext);
+            if(iReturnValue < EXIT_SUCCESS)
+                return iReturnValue;
+            else if(iReturnValue == PASS_ONE_CHUNKS_SUCCESS)
+                iReadSourceFileReturnValue = 0;
+        }
+        else if(pContext->m_lexer.m_iErrorCount == 0)
+        {
+            iReturnValue = do_pass_two_chunks(pContext, iNumberOfSourceLines);
+            if(iReturnValue < EXIT_SUCCESS)
+                return iReturnValue;
+            else if(iReturnValue == PASS_TWO_CHUNKS_SUCCESS)
+                iReadSourceFileReturnValue = 0;
+        }
+
         //Loop through all the lines in the source file until either an error
         //occurs or the end of the file is reached.
-        do
+        iReturnValue = EXIT_SUCCESS;
+        while(iReadSourceFileReturnValue > 0)
         {
             //Read a line from the source file.  Check the return value for the
             //next course of action.  Any value greater than zero indicates a
             //line was read, a negative value indicates an error, and a value of
             //zero means that the end of the file has been reached in which case
-            //we will exit from the do-while() loop and do the next pass.
-            s_lexerInfo.m_iSourceLineNumber++;
-            iReadSourceFileReturnValue = read_line_from_source_file(&s_cpSourceLine, &iSourceLineBufferSize);
+            //we will exit from the while() loop and do the next pass.
+            pContext->m_lexer.m_lexerInfo.m_iSourceLineNumber++;
+            iReadSourceFileReturnValue = read_line_from_source_file(pContext, &pContext->m_lexer.m_cpSourceLine);
             if(iReadSourceFileReturnValue > 0)
             {
                 //We have a line of text.  Save off the number of characters in
                 //the line.
-                s_lexerInfo.m_iSourceLineLength = (uint32_t)iReadSourceFileReturnValue;
+                pContext->m_lexer.m_lexerInfo.m_iSourceLineLength = (uint32_t)iReadSourceFileReturnValue;
+
+                //A line that had an error in pass one has already been reported
+                //so skip it in pass two.
+                if(pContext->m_lexer.m_iFailedLineIndex < pContext->m_lexer.m_iFailedLineCount && pContext->m_lexer.m_ipFailedLines[pContext->m_lexer.m_iFailedLineIndex] == pContext->m_lexer.m_lexerInfo.m_iSourceLineNumber)
+                {
+                    pContext->m_lexer.m_iFailedLineIndex++;
+                    continue;
+                }
 
                 //This line needs can be parsed and lexical scanned.  Check the
-                //return value.  If an error occurs then exit.  If an END
-                //directive was found, which means we have reached the end of the
-                //source file regardless of how many lines are left to read,
-                //break out of the do/while() loop to start the next pass.
-                iFunctionReturnValue = parse_source_line();
+                //return value.  If an error occurs then record it and either
+                //carry on with the next line or exit.  If an END directive was
+                //found, which means we have reached the end of the source file
+                //regardless of how many lines are left to read, break out of the
+                //do/while() loop to start the next pass.
+                iLineLocationCounter = pContext->m_lexer.m_lexerInfo.m_iLocationCounter;
+                iFunctionReturnValue = parse_source_line(pContext);
                 if(iFunctionReturnValue < EXIT_SUCCESS)
-                    return iFunctionReturnValue;
+                {
+                    iFunctionReturnValue = record_line_error(pContext, iFunctionReturnValue);
+                    if(iFunctionReturnValue < EXIT_SUCCESS)
+                    {
+                        iReturnValue = iFunctionReturnValue;
+                        break;
+                    }
+
+                    //Undo anything the line did to the location counter in pass
+                    //one.  Pass two skips the line so both passes agree on the
+                    //addresses of the lines that follow.
+                    if(pContext->m_lexer.m_lexerInfo.m_iPass == PassOne)
+                        pContext->m_lexer.m_lexerInfo.m_iLocationCounter = iLineLocationCounter;
+
+                    continue;
+                }
                 else if(iFunctionReturnValue == END_DIRECTIVE_SUCCESS)
+                {
                     break;
+                }
 
                 //The source line was parsed and lexical scan successfully
                 //performed.  Check the location counter and check if it is over
                 //the maximum allowed.
-                if(s_lexerInfo.m_iLocationCounter > MAX_PROGRAM_MEMORY)
+                if(pContext->m_lexer.m_lexerInfo.m_iLocationCounter > MAX_PROGRAM_MEMORY)
                 {
                     print_error(__func__, ExceededProgramMemoryError);
-                    show_line_error(s_lexerInfo.m_cpStatementMnemonicStart - s_cpSourceLine);
-                    return -ExceededProgramMemoryError;
+                    show_line_error(pContext, pContext->m_lexer.m_lexerInfo.m_cpStatementMnemonicStart - pContext->m_lexer.m_cpSourceLine);
+                    iReturnValue = -ExceededProgramMemoryError;
+                    break;
                 }
             }
             else if(iReadSourceFileReturnValue < 0)
             {
                 //An error occurred, return the error code.
-                return (int)iReadSourceFileReturnValue;
+                iReturnValue = (int)iReadSourceFileReturnValue;
             }
-        } while(iReadSourceFileReturnValue > 0);
+        }
+
+        //The lines pass two recorded are formatted and written to the listing
+        //file, even if the pass was stopped by an error.
+        if(pContext->m_lexer.m_lexerInfo.m_iPass == PassTwo && is_listing_file_enabled(pContext) == TRUE)
+        {
+            iFunctionReturnValue = write_listing_lines(pContext, pContext->m_lexer.m_lexerInfo.m_iLargestSymbolLength, pContext->m_lexer.m_lexerInfo.m_iLargestOperandLength);
+            if(iReturnValue == EXIT_SUCCESS)
+                iReturnValue = iFunctionReturnValue;
+        }
+
+        if(iReturnValue != EXIT_SUCCESS)
+            return iReturnValue;
+
+        iPassErrorCount = pContext->m_lexer.m_iErrorCount - iPassErrorCount;
+        if(pContext->m_lexer.m_lexerInfo.m_iPass == PassOne)
+            iNumberOfSourceLines = pContext->m_lexer.m_lexerInfo.m_iSourceLineNumber;
+
+        //Pass one gave every instruction that can change size its absolute
+        //form.  Settle the sizes, and the symbol values that depend on them,
+        //before pass two.  This is only done when pass one had no errors.
+        if(pContext->m_lexer.m_lexerInfo.m_iPass == PassOne && iPassErrorCount == 0)
+        {
+            iReturnValue = do_layout(pContext);
+            if(iReturnValue != EXIT_SUCCESS)
+                return iReturnValue;
+        }
+
+        if(iPassErrorCount == 0)
+            print_message("Pass %u completed successfully.\n", pContext->m_lexer.m_lexerInfo.m_iPass);
+        else
+            print_message("Pass %u completed with %u error(s).\n", pContext->m_lexer.m_lexerInfo.m_iPass, iPassErrorCount);
+    }
 
-        printf("Pass %u completed successfully.\n", s_lexerInfo.m_iPass);
+    if(is_statistics_enabled(pContext) == TRUE)
+    {
+        print_message("Expression cache: %u hit(s), %u miss(es).\n", get_expression_memo_hits(pContext), get_expression_memo_misses(pContext));
+        print_message("Layout: %u iteration(s).\n", get_layout_iterations(pContext));
     }
 
     //If we are here both passes were successful.  Finish out the listing file by
     //adding the symbol table after the program listing if there are symbols,
     //the symbol table is enabled, and the listing file is enabled.
-    if(s_lexerInfo.m_iLargestSymbolLength != 0 && is_symbol_table_enabled() == TRUE && is_listing_file_enabled() == TRUE)
+    if(pContext->m_lexer.m_lexerInfo.m_iLargestSymbolLength != 0 && is_symbol_table_enabled(pContext) == TRUE && is_listing_file_enabled(pContext) == TRUE)
     {
         //Set the field length to the largest symbol plus 2 for for white spaces
         //between the symbol and the value.  Check the largest symbol against the
         //word "SYMBOL" which is 6 characters.
-        s_iStatementSymbolFieldLength = bmc_max(s_lexerInfo.m_iLargestSymbolLength, sizeof("SYMBOL") - NULL_TERMINATING_BYTE_LENGTH) + 2;
+        pContext->m_lexer.m_iStatementSymbolFieldLength = bmc_max(pContext->m_lexer.m_lexerInfo.m_iLargestSymbolLength, sizeof("SYMBOL") - NULL_TERMINATING_BYTE_LENGTH) + 2;
 
         //Write the header.
-        snprintf(caText, sizeof(caText), "\r\n%-*s%s", s_iStatementSymbolFieldLength, "SYMBOL", "VALUE");
-        iReturnValue = write_line_to_listing_file(caText);
+        snprintf(caText, sizeof(caText), "\r\n%-*s%s", pContext->m_lexer.m_iStatementSymbolFieldLength, "SYMBOL", "VALUE");
+        iReturnValue = write_line_to_listing_file(pContext, caText);
         if(iReturnValue != EXIT_SUCCESS)
             return iReturnValue;
 
         memset(caText, '-', sizeof(caText));
         caText[LISTING_FILE_MAX_COLUMNS] = '\0';
-        iReturnValue = write_line_to_listing_file(caText);
+        iReturnValue = write_line_to_listing_file(pContext, caText);
         if(iReturnValue != EXIT_SUCCESS)
             return iReturnValue;
 
         //Header written.  Print the symbol table in ascending order.
-        bstree_in_order_walk(s_pSymbolTableRoot, print_symbol_to_table);
+        bstree_in_order_walk(pContext->m_lexer.m_pSymbolTableRoot, print_symbol_to_table, pContext);
+    }
+
+    //A binary file is not written if any errors were found.
+    if(pContext->m_lexer.m_iErrorCount != 0)
+    {
+        print_message("%u error(s) found, binary file not written.\n", pContext->m_lexer.m_iErrorCount);
+        return pContext->m_lexer.m_iFirstError;
     }
 
     //Open the binary file and check for success.
-    iReturnValue = open_binary_file();
+    iReturnValue = open_binary_file(pContext);
     if(iReturnValue != EXIT_SUCCESS)
         return iReturnValue;
 
     //Binary file opened successfully.  Find the first byte of code in the
     //program memory.
-    for(iFirstCodeByteLocation = 0; iFirstCodeByteLocation < MAX_PROGRAM_MEMORY; iFirstCodeByteLocation++)
-    {
-        if(s_lexerInfo.m_iaProgramMemory[iFirstCodeByteLocation] != -1)
-            break;
-    }
+    iFirstCodeByteLocation = get_first_code_byte_location(pContext);
 
     //If we didn't make it all the way to the end of the program memory then
     //there is binary data to write.
     if(iFirstCodeByteLocation < MAX_PROGRAM_MEMORY)
     {
         //Write all the data in program memory.
-        iReturnValue = write_data_to_binary_file(&s_lexerInfo.m_iaProgramMemory[iFirstCodeByteLocation], s_lexerInfo.m_iLocationCounter - iFirstCodeByteLocation);
+        iReturnValue = write_data_to_binary_file(pContext, &pContext->m_lexer.m_lexerInfo.m_iaProgramMemory[iFirstCodeByteLocation], pContext->m_lexer.m_lexerInfo.m_iLocationCounter - iFirstCodeByteLocation);
         if(iReturnValue != EXIT_SUCCESS)
             return iReturnValue;
     }
@@ -478,54 +599,129 @@ int do_assembly(void)
 /*------------------------------------------------------------------------------
  * Function name:  free_lexer_memory
  * Function Description:  Frees all allocated memory used by the parser.
- * Parameters:  None.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
  * Returns:  None.
 ------------------------------------------------------------------------------*/
-void free_lexer_memory(void)
+void free_lexer_memory(AssemblerContext* pContext)
 {
-    if(s_cpSourceLine != NULL)
-        free(s_cpSourceLine);
+    if(pContext->m_lexer.m_ipFailedLines != NULL)
+        free(pContext->m_lexer.m_ipFailedLines);
+
+    if(pContext->m_lexer.m_pStringLiterals != NULL)
+        free(pContext->m_lexer.m_pStringLiterals);
+
+    if(pContext->m_lexer.m_ipStringPayloads != NULL)
+        free(pContext->m_lexer.m_ipStringPayloads);
+
+    if(pContext->m_lexer.m_pLabelLines != NULL)
+        free(pContext->m_lexer.m_pLabelLines);
 
-    while(s_pSymbolTableRoot != NULL)
-        bstree_delete(&s_pSymbolTableRoot, s_pSymbolTableRoot);
+    while(pContext->m_lexer.m_pSymbolTableRoot != NULL)
+        bstree_delete(&pContext->m_lexer.m_pSymbolTableRoot, pContext->m_lexer.m_pSymbolTableRoot);
 }
 
 /*------------------------------------------------------------------------------
  * Function name:  get_location_counter_value
  * Function Description:  Getter function for the location counter.
- * Parameters:  None.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
  * Returns:  The current value of the location counter.
 ------------------------------------------------------------------------------*/
-uint32_t get_location_counter_value(void)
+uint32_t get_location_counter_value(AssemblerContext* pContext)
+{
+    return pContext->m_lexer.m_lexerInfo.m_iLocationCounter;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  get_current_pass
+ * Function Description:  Getter function for the current pass.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  The pass the assembler is on.
+------------------------------------------------------------------------------*/
+uint8_t get_current_pass(AssemblerContext* pContext)
+{
+    return pContext->m_lexer.m_lexerInfo.m_iPass;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  get_source_line_number
+ * Function Description:  Getter function for the source line number.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  The line number of the source line being assembled.
+------------------------------------------------------------------------------*/
+uint32_t get_source_line_number(AssemblerContext* pContext)
+{
+    return pContext->m_lexer.m_lexerInfo.m_iSourceLineNumber;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  get_error_count
+ * Function Description:  Getter function for the number of errors found.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  The number of errors found in both passes.
+------------------------------------------------------------------------------*/
+uint32_t get_error_count(AssemblerContext* pContext)
+{
+    return pContext->m_lexer.m_iErrorCount;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  get_first_code_byte_location
+ * Function Description:  Finds the first byte of code in the program memory,
+ *                        which is where the binary file starts.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  The location of the first byte of code, or MAX_PROGRAM_MEMORY if
+ *           there is no code.
+------------------------------------------------------------------------------*/
+uint32_t get_first_code_byte_location(AssemblerContext* pContext)
 {
-    return s_lexerInfo.m_iLocationCounter;
+    uint32_t iLocation;
+
+    for(iLocation = 0; iLocation < MAX_PROGRAM_MEMORY; iLocation++)
+    {
+        if(pContext->m_lexer.m_lexerInfo.m_iaProgramMemory[iLocation] != -1)
+            break;
+    }
+
+    return iLocation;
 }
 
 /*------------------------------------------------------------------------------
  * Function name:  get_symbol_table_root
  * Function Description:  Getter function for the symbol table root.
- * Parameters:  None.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
  * Returns:  A pointer to the symbol table root.
 ------------------------------------------------------------------------------*/
-BSTreeNode* get_symbol_table_root(void)
+BSTreeNode* get_symbol_table_root(AssemblerContext* pContext)
 {
-    return s_pSymbolTableRoot;
+    return pContext->m_lexer.m_pSymbolTableRoot;
 }
 
 /*------------------------------------------------------------------------------
  * Function name:  parse_source_line
  * Function Description:  Parses a source file line.
- * Parameters:  None
+ * Parameters:
+ * pContext - Pointer to the assembler context.
  * Returns:  Zero for success and continue, END_DIRECTIVE_SUCCESS for success and
  *           END directive was reached, and a negative number if an error occurs.
 ------------------------------------------------------------------------------*/
-static int parse_source_line(void)
+static int parse_source_line(AssemblerContext* pContext)
 {
+    uint8_t bIsDisplayLengthNeeded;
+    uint8_t bFoundColon;
+
     uint32_t iIndex;
+    uint32_t iLabelDisplayLength;
 
     //Initialize variables.
-    s_lexerInfo.m_cpStartOfLabel = NULL;
-    s_lexerInfo.m_cpEndOfComment = NULL;
+    pContext->m_lexer.m_lexerInfo.m_cpStartOfLabel = NULL;
+    pContext->m_lexer.m_lexerInfo.m_cpEndOfComment = NULL;
 
     //First we want a common letter case.  Convert all letters to upper case with
     //the exception of:
@@ -534,32 +730,32 @@ static int parse_source_line(void)
     //Continue converting to either the first ';' character (not after a single
     //quote and not within double quotes) or EOL.
     iIndex = 0;
-    while(s_cpSourceLine[iIndex] != ';' && iIndex < s_lexerInfo.m_iSourceLineLength)
+    while(pContext->m_lexer.m_cpSourceLine[iIndex] != ';' && iIndex < pContext->m_lexer.m_lexerInfo.m_iSourceLineLength)
     {
-        if(s_cpSourceLine[iIndex] == '\'')
+        if(pContext->m_lexer.m_cpSourceLine[iIndex] == '\'')
         {
             //We reached a single quote.  Skip it and the character immediately
             //following.
             iIndex += 2;
         }
-        else if(s_cpSourceLine[iIndex] == '"')
+        else if(pContext->m_lexer.m_cpSourceLine[iIndex] == '"')
         {
             //We reached a double quote, skip over it.
             iIndex++;
 
             //Loop until the next double quote, or EOL, is reached.
-            while(s_cpSourceLine[iIndex] != '"' && iIndex < s_lexerInfo.m_iSourceLineLength)
+            while(pContext->m_lexer.m_cpSourceLine[iIndex] != '"' && iIndex < pContext->m_lexer.m_lexerInfo.m_iSourceLineLength)
             {
                 //There can be escaped characters in a string and those need to
                 //be converted to upper case.  These characters are preceded by
                 //a backslash character.
-                if(s_cpSourceLine[iIndex] == '\\')
+                if(pContext->m_lexer.m_cpSourceLine[iIndex] == '\\')
                 {
                     //Backslash character found.  Skip past it.
                     iIndex++;
 
                     //Convert the following character and then skip past.
-                    s_cpSourceLine[iIndex] = toupper(s_cpSourceLine[iIndex]);
+                    pContext->m_lexer.m_cpSourceLine[iIndex] = toupper(pContext->m_lexer.m_cpSourceLine[iIndex]);
                     iIndex++;
                 }
                 else
@@ -570,95 +766,146 @@ static int parse_source_line(void)
             }
 
             //If we are pointing at a double quote then skip over it.
-            if(s_cpSourceLine[iIndex] == '"')
+            if(pContext->m_lexer.m_cpSourceLine[iIndex] == '"')
                 iIndex++;
         }
         else
         {
             //Neither a single quote or double quote so do conversion.
-            s_cpSourceLine[iIndex] = toupper(s_cpSourceLine[iIndex]);
+            pContext->m_lexer.m_cpSourceLine[iIndex] = toupper(pContext->m_lexer.m_cpSourceLine[iIndex]);
             iIndex++;
         }
     }
 
     //Convert tabs to spaces up to the EOL.
-    for(iIndex = 0; iIndex < s_lexerInfo.m_iSourceLineLength; iIndex++)
+    for(iIndex = 0; iIndex < pContext->m_lexer.m_lexerInfo.m_iSourceLineLength; iIndex++)
     {
-        if(s_cpSourceLine[iIndex] == '\t')
-            s_cpSourceLine[iIndex] = ' ';
+        if(pContext->m_lexer.m_cpSourceLine[iIndex] == '\t')
+            pContext->m_lexer.m_cpSourceLine[iIndex] = ' ';
     }
 
+    //The listing file needs to know how wide the operand field is before pass
+    //two starts printing.  That width is measured here, during pass one, as a
+    //by-product of the walk that looks for the comment.  It isn't needed at all
+    //when the listing file is disabled.
+    bIsDisplayLengthNeeded = (pContext->m_lexer.m_lexerInfo.m_iPass == PassOne && is_listing_file_enabled(pContext) == TRUE) ? TRUE : FALSE;
+    bFoundColon = FALSE;
+    pContext->m_lexer.m_lexerInfo.m_bWithinDoubleQuote = FALSE;
+    pContext->m_lexer.m_lexerInfo.m_iDisplayLength = 0;
+    pContext->m_lexer.m_lexerInfo.m_iStatementDisplayLength = 0;
+    iLabelDisplayLength = 0;
+
     //A line is defined as:
     //<line> ::= [<label>] [<statement>] [<comment>] <eol>
     //First lets check for an optional comment by looking for the first
     //occurrence of a ';' character that does not immediately follow a single
     //quote or is not within double quotes.
     iIndex = 0;
-    while(iIndex < s_lexerInfo.m_iSourceLineLength)
+    while(iIndex < pContext->m_lexer.m_lexerInfo.m_iSourceLineLength)
     {
-        if(s_cpSourceLine[iIndex] == '\'')
+        if(pContext->m_lexer.m_cpSourceLine[iIndex] == '\'')
         {
             //We reached a single quote.  Skip it and the character immediately
             //following.
+            if(bIsDisplayLengthNeeded == TRUE)
+            {
+                measure_display_character(pContext, iIndex);
+                if((iIndex + 1) < pContext->m_lexer.m_lexerInfo.m_iSourceLineLength)
+                    measure_display_character(pContext, iIndex + 1);
+            }
+
             iIndex += 2;
         }
-        else if(s_cpSourceLine[iIndex] == '"')
+        else if(pContext->m_lexer.m_cpSourceLine[iIndex] == '"')
         {
             //We reached a double quote, skip over it.
+            if(bIsDisplayLengthNeeded == TRUE)
+                measure_display_character(pContext, iIndex);
+
             iIndex++;
 
             //Loop until the next double quote, or EOL, is reached.
-            while(s_cpSourceLine[iIndex] != '"' && iIndex < s_lexerInfo.m_iSourceLineLength)
-                    iIndex++;
+            while(pContext->m_lexer.m_cpSourceLine[iIndex] != '"' && iIndex < pContext->m_lexer.m_lexerInfo.m_iSourceLineLength)
+            {
+                if(bIsDisplayLengthNeeded == TRUE)
+                    measure_display_character(pContext, iIndex);
+
+                iIndex++;
+            }
 
             //If we are pointing at a double quote then skip over it.
-            if(s_cpSourceLine[iIndex] == '"')
+            if(pContext->m_lexer.m_cpSourceLine[iIndex] == '"')
+            {
+                if(bIsDisplayLengthNeeded == TRUE)
+                    measure_display_character(pContext, iIndex);
+
                 iIndex++;
+            }
         }
         else
         {
             //Neither a single quote or double quote.  If it is a ';' character
             //than break from the while loop.  Otherwise skip past the character.
-            if(s_cpSourceLine[iIndex] == ';')
+            if(pContext->m_lexer.m_cpSourceLine[iIndex] == ';')
                 break;
 
+            if(bIsDisplayLengthNeeded == TRUE)
+            {
+                measure_display_character(pContext, iIndex);
+
+                //The first ':' character found here is the end of the label, the
+                //same one the label search below will find.  Everything measured
+                //so far belongs to the label so remember how much that was.
+                if(pContext->m_lexer.m_cpSourceLine[iIndex] == ':' && bFoundColon == FALSE)
+                {
+                    bFoundColon = TRUE;
+                    iLabelDisplayLength = pContext->m_lexer.m_lexerInfo.m_iDisplayLength;
+                    pContext->m_lexer.m_lexerInfo.m_bWithinDoubleQuote = FALSE;
+                }
+            }
+
             iIndex++;
         }
     }
 
+    //Remove the label from the measured display length so that only the
+    //statement section remains.
+    if(bIsDisplayLengthNeeded == TRUE)
+        pContext->m_lexer.m_lexerInfo.m_iStatementDisplayLength = (pContext->m_lexer.m_lexerInfo.m_iStatementDisplayLength > iLabelDisplayLength) ? pContext->m_lexer.m_lexerInfo.m_iStatementDisplayLength - iLabelDisplayLength : 0;
+
     //We are out of the while() loop.  If we didn't make it to EOL then we found
     //a comment.
-    s_lexerInfo.m_cpStartOfComment = (iIndex < s_lexerInfo.m_iSourceLineLength) ? s_cpSourceLine + iIndex : NULL;
-    if(s_lexerInfo.m_cpStartOfComment != NULL)
-        s_lexerInfo.m_cpEndOfComment = s_cpSourceLine + s_lexerInfo.m_iSourceLineLength - 1;
+    pContext->m_lexer.m_lexerInfo.m_cpStartOfComment = (iIndex < pContext->m_lexer.m_lexerInfo.m_iSourceLineLength) ? pContext->m_lexer.m_cpSourceLine + iIndex : NULL;
+    if(pContext->m_lexer.m_lexerInfo.m_cpStartOfComment != NULL)
+        pContext->m_lexer.m_lexerInfo.m_cpEndOfComment = pContext->m_lexer.m_cpSourceLine + pContext->m_lexer.m_lexerInfo.m_iSourceLineLength - 1;
 
     //Check if we have a comment that starts at the beginning of the line.
-    if(s_lexerInfo.m_cpStartOfComment != s_cpSourceLine)
+    if(pContext->m_lexer.m_lexerInfo.m_cpStartOfComment != pContext->m_lexer.m_cpSourceLine)
     {
         //We do not have a comment that starts at the beginning of the line so
         //there is more line to parse.  Next let's check for an optional label by
         //looking for the first occurrence of a ':' character that does not
         //immediately follow a single quote or is not within double quotes.
         iIndex = 0;
-        while(iIndex < s_lexerInfo.m_iSourceLineLength)
+        while(iIndex < pContext->m_lexer.m_lexerInfo.m_iSourceLineLength)
         {
-            if(s_cpSourceLine[iIndex] == '\'')
+            if(pContext->m_lexer.m_cpSourceLine[iIndex] == '\'')
             {
                 //We reached a single quote.  Skip it and the character
                 //immediately following.
                 iIndex += 2;
             }
-            else if(s_cpSourceLine[iIndex] == '"')
+            else if(pContext->m_lexer.m_cpSourceLine[iIndex] == '"')
             {
                 //We reached a double quote, skip over it.
                 iIndex++;
 
                 //Loop until the next double quote, or EOL, is reached.
-                while(s_cpSourceLine[iIndex] != '"' && iIndex < s_lexerInfo.m_iSourceLineLength)
+                while(pContext->m_lexer.m_cpSourceLine[iIndex] != '"' && iIndex < pContext->m_lexer.m_lexerInfo.m_iSourceLineLength)
                         iIndex++;
 
                 //If we are pointing at a double quote then skip over it.
-                if(s_cpSourceLine[iIndex] == '"')
+                if(pContext->m_lexer.m_cpSourceLine[iIndex] == '"')
                     iIndex++;
             }
             else
@@ -666,7 +913,7 @@ static int parse_source_line(void)
                 //Neither a single quote or double quote.  If it is a ':'
                 //character than break from the while loop.  Otherwise skip past
                 //the character.
-                if(s_cpSourceLine[iIndex] == ':')
+                if(pContext->m_lexer.m_cpSourceLine[iIndex] == ':')
                     break;
 
                 iIndex++;
@@ -675,21 +922,21 @@ static int parse_source_line(void)
 
         //We are out of the while() loop.  If we didn't make it to EOL then we found
         //a label.
-        s_lexerInfo.m_cpEndOfLabel = (iIndex < s_lexerInfo.m_iSourceLineLength) ? s_cpSourceLine + iIndex : NULL;
-        if(s_lexerInfo.m_cpEndOfLabel != NULL)
+        pContext->m_lexer.m_lexerInfo.m_cpEndOfLabel = (iIndex < pContext->m_lexer.m_lexerInfo.m_iSourceLineLength) ? pContext->m_lexer.m_cpSourceLine + iIndex : NULL;
+        if(pContext->m_lexer.m_lexerInfo.m_cpEndOfLabel != NULL)
         {
             //A ':' character was found.  If the ':' is within the comment then
             //it isn't a label.
-            if(s_lexerInfo.m_cpStartOfComment != NULL && s_lexerInfo.m_cpEndOfLabel > s_lexerInfo.m_cpStartOfComment)
+            if(pContext->m_lexer.m_lexerInfo.m_cpStartOfComment != NULL && pContext->m_lexer.m_lexerInfo.m_cpEndOfLabel > pContext->m_lexer.m_lexerInfo.m_cpStartOfComment)
             {
                 //The ':' is within the comment so there is no label.
-                s_lexerInfo.m_cpEndOfLabel = NULL;
+                pContext->m_lexer.m_lexerInfo.m_cpEndOfLabel = NULL;
             }
             else
             {
                 //The ':' is not within the comment.  The start of the label will
                 //be the start of the line.
-                s_lexerInfo.m_cpStartOfLabel = s_cpSourceLine;
+                pContext->m_lexer.m_lexerInfo.m_cpStartOfLabel = pContext->m_lexer.m_cpSourceLine;
             }
         }
 
@@ -703,393 +950,226 @@ static int parse_source_line(void)
         //    beginning of the line to the start of the comment.
         //4.  If there is a label and there is a comment then the statement
         //    starts just after the label and ends just before the comment.
-        if(s_lexerInfo.m_cpStartOfLabel == NULL && s_lexerInfo.m_cpStartOfComment == NULL)
+        if(pContext->m_lexer.m_lexerInfo.m_cpStartOfLabel == NULL && pContext->m_lexer.m_lexerInfo.m_cpStartOfComment == NULL)
         {
-            s_lexerInfo.m_cpStartOfStatement = s_cpSourceLine;
-            s_lexerInfo.m_cpEndOfStatement = s_cpSourceLine + s_lexerInfo.m_iSourceLineLength - 1;
+            pContext->m_lexer.m_lexerInfo.m_cpStartOfStatement = pContext->m_lexer.m_cpSourceLine;
+            pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement = pContext->m_lexer.m_cpSourceLine + pContext->m_lexer.m_lexerInfo.m_iSourceLineLength - 1;
         }
-        else if(s_lexerInfo.m_cpStartOfLabel != NULL && s_lexerInfo.m_cpStartOfComment == NULL)
+        else if(pContext->m_lexer.m_lexerInfo.m_cpStartOfLabel != NULL && pContext->m_lexer.m_lexerInfo.m_cpStartOfComment == NULL)
         {
-            s_lexerInfo.m_cpStartOfStatement = s_lexerInfo.m_cpEndOfLabel + 1;
-            s_lexerInfo.m_cpEndOfStatement = s_cpSourceLine + s_lexerInfo.m_iSourceLineLength - 1;
+            pContext->m_lexer.m_lexerInfo.m_cpStartOfStatement = pContext->m_lexer.m_lexerInfo.m_cpEndOfLabel + 1;
+            pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement = pContext->m_lexer.m_cpSourceLine + pContext->m_lexer.m_lexerInfo.m_iSourceLineLength - 1;
         }
-        else if(s_lexerInfo.m_cpStartOfLabel == NULL && s_lexerInfo.m_cpStartOfComment != NULL)
+        else if(pContext->m_lexer.m_lexerInfo.m_cpStartOfLabel == NULL && pContext->m_lexer.m_lexerInfo.m_cpStartOfComment != NULL)
         {
-            s_lexerInfo.m_cpStartOfStatement = s_cpSourceLine;
-            s_lexerInfo.m_cpEndOfStatement = s_lexerInfo.m_cpStartOfComment - 1;
+            pContext->m_lexer.m_lexerInfo.m_cpStartOfStatement = pContext->m_lexer.m_cpSourceLine;
+            pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement = pContext->m_lexer.m_lexerInfo.m_cpStartOfComment - 1;
         }
         else
         {
-            s_lexerInfo.m_cpStartOfStatement = s_lexerInfo.m_cpEndOfLabel + 1;
-            s_lexerInfo.m_cpEndOfStatement = s_lexerInfo.m_cpStartOfComment - 1;
+            pContext->m_lexer.m_lexerInfo.m_cpStartOfStatement = pContext->m_lexer.m_lexerInfo.m_cpEndOfLabel + 1;
+            pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement = pContext->m_lexer.m_lexerInfo.m_cpStartOfComment - 1;
         }
     }
     else
     {
         //The comment starts at the beginning of the line so there is no more
         //line to parse.
-        s_lexerInfo.m_cpEndOfLabel = NULL;
-        s_lexerInfo.m_cpStartOfStatement = NULL;
-        s_lexerInfo.m_cpEndOfStatement = NULL;
+        pContext->m_lexer.m_lexerInfo.m_cpEndOfLabel = NULL;
+        pContext->m_lexer.m_lexerInfo.m_cpStartOfStatement = NULL;
+        pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement = NULL;
     }
 
     //At this point the line has been broken into optional label, statement, and
     //comment sections.  Eliminate leading white spaces of the label section.
-    if(s_lexerInfo.m_cpStartOfLabel != NULL)
+    if(pContext->m_lexer.m_lexerInfo.m_cpStartOfLabel != NULL)
     {
         //Loop until the end of the label section is reached or a non-whitespace
         //character has been found.
-        while(s_lexerInfo.m_cpStartOfLabel <= s_lexerInfo.m_cpEndOfLabel && isspace(*s_lexerInfo.m_cpStartOfLabel) != 0)
-            s_lexerInfo.m_cpStartOfLabel++;
+        while(pContext->m_lexer.m_lexerInfo.m_cpStartOfLabel <= pContext->m_lexer.m_lexerInfo.m_cpEndOfLabel && isspace(*pContext->m_lexer.m_lexerInfo.m_cpStartOfLabel) != 0)
+            pContext->m_lexer.m_lexerInfo.m_cpStartOfLabel++;
 
         //We are out of the while() loop.  If the start of the section overcame
         //the end of the section then the section contained all white spaces.
-        if(s_lexerInfo.m_cpStartOfLabel <= s_lexerInfo.m_cpEndOfLabel)
+        if(pContext->m_lexer.m_lexerInfo.m_cpStartOfLabel <= pContext->m_lexer.m_lexerInfo.m_cpEndOfLabel)
         {
             //Check if the label exceeds the maximum size.
-            if((s_lexerInfo.m_cpEndOfLabel - s_lexerInfo.m_cpStartOfLabel) > MAX_SYMBOL_SIZE)
+            if((pContext->m_lexer.m_lexerInfo.m_cpEndOfLabel - pContext->m_lexer.m_lexerInfo.m_cpStartOfLabel) > MAX_SYMBOL_SIZE)
             {
                 print_error(__func__, SymbolLengthExceedsMaximumError);
-                show_line_error(s_lexerInfo.m_cpStartOfLabel - s_cpSourceLine);
+                show_line_error(pContext, pContext->m_lexer.m_lexerInfo.m_cpStartOfLabel - pContext->m_lexer.m_cpSourceLine);
                 return -SymbolLengthExceedsMaximumError;
             }
         }
         else
         {
             //The label was all white spaces.
-            s_lexerInfo.m_cpStartOfLabel = NULL;
-            s_lexerInfo.m_cpEndOfLabel = NULL;
+            pContext->m_lexer.m_lexerInfo.m_cpStartOfLabel = NULL;
+            pContext->m_lexer.m_lexerInfo.m_cpEndOfLabel = NULL;
         }
     }
 
     //Eliminate leading and trailing white spaces of the statement section.
-    if(s_lexerInfo.m_cpStartOfStatement != NULL)
+    if(pContext->m_lexer.m_lexerInfo.m_cpStartOfStatement != NULL)
     {
         //First do leading white spaces.  Loop until the end of the statement
         //section is reached or a non- whitespace character has been found.
-        while(s_lexerInfo.m_cpStartOfStatement <= s_lexerInfo.m_cpEndOfStatement && isspace(*s_lexerInfo.m_cpStartOfStatement) != 0)
-            s_lexerInfo.m_cpStartOfStatement++;
+        while(pContext->m_lexer.m_lexerInfo.m_cpStartOfStatement <= pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement && isspace(*pContext->m_lexer.m_lexerInfo.m_cpStartOfStatement) != 0)
+            pContext->m_lexer.m_lexerInfo.m_cpStartOfStatement++;
 
         //We are out of the while() loop.  Check if we still have a statement
         //section to check for trailing white spaces.
-        if(s_lexerInfo.m_cpStartOfStatement <= s_lexerInfo.m_cpEndOfStatement)
+        if(pContext->m_lexer.m_lexerInfo.m_cpStartOfStatement <= pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement)
         {
             //We are still in the statement section so we can check for trailing
             //white spaces.
-            while(isspace(*s_lexerInfo.m_cpEndOfStatement) != 0)
-                s_lexerInfo.m_cpEndOfStatement--;
+            while(isspace(*pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement) != 0)
+                pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement--;
         }
         else
         {
             //The statement section contained all white spaces.
-            s_lexerInfo.m_cpStartOfStatement = NULL;
-            s_lexerInfo.m_cpEndOfStatement = NULL;
+            pContext->m_lexer.m_lexerInfo.m_cpStartOfStatement = NULL;
+            pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement = NULL;
         }
     }
 
     //Eliminate trailing white spaces of the comment section.
-    if(s_lexerInfo.m_cpStartOfComment != NULL)
+    if(pContext->m_lexer.m_lexerInfo.m_cpStartOfComment != NULL)
     {
-        while(isspace(*s_lexerInfo.m_cpEndOfComment) != 0)
-            s_lexerInfo.m_cpEndOfComment--;
+        while(isspace(*pContext->m_lexer.m_lexerInfo.m_cpEndOfComment) != 0)
+            pContext->m_lexer.m_lexerInfo.m_cpEndOfComment--;
     }
 
     //The line has been parsed so now we can perform a lexical scan.
-    return lexical_scan_source_line();
+    return lexical_scan_source_line(pContext);
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  add_line_to_listing
+ * Function Description:  Records the current, just assembled, source line for
+ *                        the listing file.  The line is formatted once pass two
+ *                        is done.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * iLocationCounter - The location counter at the start of the line.
+ * bHasObjectCode - TRUE if the bytes the location counter moved over are the
+ *                  object code of the line.
+ * Returns:  Zero for success and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+static int add_line_to_listing(AssemblerContext* pContext, uint32_t iLocationCounter, uint8_t bHasObjectCode)
+{
+    char* acpSpan[NumberOfListingSpans];
+
+    uint32_t iSpan;
+    uint32_t iEndLocationCounter;
+
+    ListingLine listingLine;
+
+    //Same order as the ListingSpans enumeration.
+    acpSpan[StartOfLabelSpan] = pContext->m_lexer.m_lexerInfo.m_cpStartOfLabel;
+    acpSpan[StartOfStatementSpan] = pContext->m_lexer.m_lexerInfo.m_cpStartOfStatement;
+    acpSpan[EndOfStatementSpan] = pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement;
+    acpSpan[StartOfCommentSpan] = pContext->m_lexer.m_lexerInfo.m_cpStartOfComment;
+    acpSpan[EndOfCommentSpan] = pContext->m_lexer.m_lexerInfo.m_cpEndOfComment;
+    acpSpan[StatementSymbolStartSpan] = pContext->m_lexer.m_lexerInfo.m_cpStatementSymbolStart;
+    acpSpan[StatementSymbolEndSpan] = pContext->m_lexer.m_lexerInfo.m_cpStatementSymbolEnd;
+    acpSpan[StatementMnemonicStartSpan] = pContext->m_lexer.m_lexerInfo.m_cpStatementMnemonicStart;
+    acpSpan[StatementMnemonicEndSpan] = pContext->m_lexer.m_lexerInfo.m_cpStatementMnemonicEnd;
+    acpSpan[StatementExpressionStartSpan] = pContext->m_lexer.m_lexerInfo.m_cpStatementExpresionStart;
+
+    //Offsets are stored one higher so that zero can mean the span isn't there.
+    for(iSpan = 0; iSpan < NumberOfListingSpans; iSpan++)
+        listingLine.m_iaSpanOffset[iSpan] = (acpSpan[iSpan] != NULL) ? (uint32_t)(acpSpan[iSpan] - pContext->m_lexer.m_cpSourceLine) + 1 : 0;
+
+    //A line that ran past the end of program memory is reported after this so
+    //only the bytes that are in program memory are kept.
+    iEndLocationCounter = bmc_min(pContext->m_lexer.m_lexerInfo.m_iLocationCounter, (uint32_t)MAX_PROGRAM_MEMORY);
+
+    listingLine.m_iSourceLineNumber = pContext->m_lexer.m_lexerInfo.m_iSourceLineNumber;
+    listingLine.m_iLocationCounter = iLocationCounter;
+    listingLine.m_iTextLength = pContext->m_lexer.m_lexerInfo.m_iSourceLineLength;
+    listingLine.m_iObjectCodeLength = (bHasObjectCode == TRUE && iEndLocationCounter > iLocationCounter) ? iEndLocationCounter - iLocationCounter : 0;
+
+    return add_listing_line(pContext, &listingLine, pContext->m_lexer.m_cpSourceLine, (listingLine.m_iObjectCodeLength != 0) ? &pContext->m_lexer.m_lexerInfo.m_iaProgramMemory[iLocationCounter] : NULL);
 }
 
 /*------------------------------------------------------------------------------
  * Function name:  lexical_scan_source_line
  * Function Description:  Performs a lexical scan of a parsed source file line.
- * Parameters:  None
+ * Parameters:
+ * pContext - Pointer to the assembler context.
  * Returns:  Zero for success and continue, END_DIRECTIVE_SUCCESS for success and
  *           END directive was reached, and a negative number if an error occurs.
 ------------------------------------------------------------------------------*/
-static int lexical_scan_source_line(void)
+static int lexical_scan_source_line(AssemblerContext* pContext)
 {
-    char caListing[LISTING_FILE_MAX_COLUMNS + NULL_TERMINATING_BYTE_LENGTH];
-    char caLineNumber[LISTING_FILE_LINE_MAX_DIGITS + NULL_TERMINATING_BYTE_LENGTH];
-    char caLocationCounter[LISTING_FILE_LC_MAX_CHARACTERS + NULL_TERMINATING_BYTE_LENGTH];
-    char caObjectCodeByte[LISTING_FILE_OBJECT_CODE_BYTE_MAX_CHARACTERS + NULL_TERMINATING_BYTE_LENGTH];
-    char caObjectCode[LISTING_FILE_OBJECT_CODE_MAX_CHARACTERS + NULL_TERMINATING_BYTE_LENGTH];
-    char caSource[LISTING_FILE_MAX_COLUMNS + NULL_TERMINATING_BYTE_LENGTH];
-
-    uint8_t bWithinDoubleQuote;
-
     int iLexerScanReturnValue;
     int iFunctionReturnValue;
 
     uint32_t iPreviousLocationCounter;
-    uint32_t iStatementSymbolFieldLength;
-    uint32_t iStatementMnemonicFieldLength;
     uint32_t iCounter;
 
-    size_t iLength;
-
     //Assume success and continue.
     iLexerScanReturnValue = EXIT_SUCCESS;
 
     //Initialize variables.
-    s_lexerInfo.m_cpStatementSymbolStart = NULL;
-    s_lexerInfo.m_cpStatementSymbolEnd = NULL;
-    s_lexerInfo.m_cpStatementMnemonicStart = NULL;
-    s_lexerInfo.m_cpStatementMnemonicEnd = NULL;
-    s_lexerInfo.m_cpStatementExpresionStart = NULL;
+    pContext->m_lexer.m_lexerInfo.m_cpStatementSymbolStart = NULL;
+    pContext->m_lexer.m_lexerInfo.m_cpStatementSymbolEnd = NULL;
+    pContext->m_lexer.m_lexerInfo.m_cpStatementMnemonicStart = NULL;
+    pContext->m_lexer.m_lexerInfo.m_cpStatementMnemonicEnd = NULL;
+    pContext->m_lexer.m_lexerInfo.m_cpStatementExpresionStart = NULL;
 
     //Save off the current location counter.
-    iPreviousLocationCounter = s_lexerInfo.m_iLocationCounter;
+    iPreviousLocationCounter = pContext->m_lexer.m_lexerInfo.m_iLocationCounter;
 
     //If the line has a label section then it needs to be evaluated.
-    if(s_lexerInfo.m_cpStartOfLabel != NULL)
+    if(pContext->m_lexer.m_lexerInfo.m_cpStartOfLabel != NULL)
     {
-        iLexerScanReturnValue = label_lexer();
+        iLexerScanReturnValue = label_lexer(pContext);
         if(iLexerScanReturnValue != EXIT_SUCCESS)
             return iLexerScanReturnValue;
+
+        //The label may have put the location counter back in step after an
+        //error so save it off again.
+        iPreviousLocationCounter = pContext->m_lexer.m_lexerInfo.m_iLocationCounter;
     }
 
     //If there is a statement section then it needs to be evaluated.
-    if(s_lexerInfo.m_cpStartOfStatement != NULL)
+    if(pContext->m_lexer.m_lexerInfo.m_cpStartOfStatement != NULL)
     {
-        iLexerScanReturnValue = statement_lexer();
+        iLexerScanReturnValue = statement_lexer(pContext);
         if(iLexerScanReturnValue < EXIT_SUCCESS)
             return iLexerScanReturnValue;
 
-        //Check if this is pass one and there are operands.
-        if(s_lexerInfo.m_iPass == PassOne && s_lexerInfo.m_cpStatementExpresionStart != NULL)
+        //Check if this is pass one, the listing file is enabled, and there are
+        //operands.
+        if(pContext->m_lexer.m_lexerInfo.m_iPass == PassOne && is_listing_file_enabled(pContext) == TRUE && pContext->m_lexer.m_lexerInfo.m_cpStatementExpresionStart != NULL)
         {
-            //We need to count the number of characters in the operand field,
-            //excluding white spaces that are not within double quotes.
-            bWithinDoubleQuote = FALSE;
-            iCounter = 0;
-            while(s_lexerInfo.m_cpStatementExpresionStart <= s_lexerInfo.m_cpEndOfStatement)
-            {
-                if(bWithinDoubleQuote == FALSE)
-                {
-                    if(isspace(*s_lexerInfo.m_cpStatementExpresionStart) == 0)
-                        iCounter++;
-
-                    if(*s_lexerInfo.m_cpStatementExpresionStart == '"' && *(s_lexerInfo.m_cpStatementExpresionStart - 1) != '\\')
-                        bWithinDoubleQuote = TRUE;
-                }
-                else
-                {
-                    iCounter++;
-
-                    if(*s_lexerInfo.m_cpStatementExpresionStart == '"' && *(s_lexerInfo.m_cpStatementExpresionStart - 1) != '\\')
-                        bWithinDoubleQuote = FALSE;
-                }
-
-                (s_lexerInfo.m_cpStatementExpresionStart)++;
-            }
+            //The parser already measured the display length of the statement
+            //section.  Everything in front of the operands is the mnemonic, and
+            //for an EQU directive the symbol, none of which contain white spaces
+            //so their lengths can simply be taken away.
+            iCounter = pContext->m_lexer.m_lexerInfo.m_iStatementDisplayLength - (uint32_t)(pContext->m_lexer.m_lexerInfo.m_cpStatementMnemonicEnd - pContext->m_lexer.m_lexerInfo.m_cpStatementMnemonicStart + 1);
+            if(pContext->m_lexer.m_lexerInfo.m_cpStatementSymbolStart != NULL && pContext->m_lexer.m_lexerInfo.m_cpStatementSymbolStart >= pContext->m_lexer.m_lexerInfo.m_cpStartOfStatement)
+                iCounter -= (uint32_t)(pContext->m_lexer.m_lexerInfo.m_cpStatementSymbolEnd - pContext->m_lexer.m_lexerInfo.m_cpStatementSymbolStart + 1);
 
             //Add one more for a white space after the operands.
             iCounter++;
 
             //Check if this is the largest operand field so far.
-            s_lexerInfo.m_iLargestOperandLength = bmc_max(iCounter, s_lexerInfo.m_iLargestOperandLength);
+            pContext->m_lexer.m_lexerInfo.m_iLargestOperandLength = bmc_max(iCounter, pContext->m_lexer.m_lexerInfo.m_iLargestOperandLength);
         }
     }
 
-    //If this is pass two write the line to the listing file.
-    if(s_lexerInfo.m_iPass == PassTwo)
+    //If this is pass two record the line for the listing file if the listing
+    //file is enabled.  The ORG and DS directives change the location counter
+    //but do not produce any object code.
+    if(pContext->m_lexer.m_lexerInfo.m_iPass == PassTwo && is_listing_file_enabled(pContext) == TRUE)
     {
-        //Create the line number field.
-        snprintf(caLineNumber, sizeof(caLineNumber), "%0*u", LISTING_FILE_LINE_MAX_DIGITS, s_lexerInfo.m_iSourceLineNumber);
-
-        //Create the location counter field.
-        snprintf(caLocationCounter, sizeof(caLocationCounter), "%0*X", LISTING_FILE_LC_MAX_CHARACTERS, iPreviousLocationCounter);
-
-        //If there is object code then fill in the object code field.  There is
-        //one exception to this and that is the ORG directive.  The ORG directive
-        //will change the location counter but does not produce any object code.
-        caObjectCode[0] = '\0';
-        if(s_lexerInfo.m_iLocationCounter != iPreviousLocationCounter && iLexerScanReturnValue != ORG_DIRECTIVE_SUCCESS)
-        {
-            //The location counter changed and it wasn't the ORG directive so we
-            //have object code.  Up to three bytes can fit in the object code
-            //field.
-            for(iCounter = 0; iCounter < LISTING_FILE_OBJECT_CODE_BYTES_PER_FIELD && s_lexerInfo.m_iLocationCounter != iPreviousLocationCounter; iCounter++)
-            {
-                snprintf(caObjectCodeByte, sizeof(caObjectCodeByte), "%02X ", (uint8_t)(s_lexerInfo.m_iaProgramMemory[iPreviousLocationCounter]));
-                strcat(caObjectCode, caObjectCodeByte);
-                iPreviousLocationCounter++;
-            }
-        }
-
-        //Create the source field.
-        caSource[0] = '\0';
-        if(s_lexerInfo.m_cpStartOfLabel != NULL || s_lexerInfo.m_cpStartOfStatement != NULL || s_lexerInfo.m_cpStartOfComment != NULL)
-        {
-            //There is something to put in the source field.  Check for comment
-            //only.
-            if(s_lexerInfo.m_cpStartOfLabel == NULL && s_lexerInfo.m_cpStartOfStatement == NULL && s_lexerInfo.m_cpStartOfComment != NULL)
-            {
-                //The source file only contains a comment.  Start it at the
-                //beginning of the field.  Put a NULL terminator after the
-                //comment and copy the whole comment.
-                *(s_lexerInfo.m_cpEndOfComment + 1) = '\0';
-                snprintf(caSource, sizeof(caSource), "%s", s_lexerInfo.m_cpStartOfComment);
-            }
-            else
-            {
-                //There is more to the line then just a comment.  If we have
-                //symbols then set the field length to the size of the largest
-                //symbol and add two for the ':' character after labels and a
-                //whitespace.
-                iStatementSymbolFieldLength = (s_lexerInfo.m_iLargestSymbolLength == 0) ? 0 : s_lexerInfo.m_iLargestSymbolLength + 2;
-
-                //The statement mnemonic field length is the length of the
-                //largest mnemonic plus one for a whitespace.
-                iStatementMnemonicFieldLength = MAX_DIR_MNEMONIC_SIZE + 1;
-
-                //Place NULL terminators after the symbol and mnemonic if they
-                //exist on the line.
-                if(s_lexerInfo.m_cpStatementSymbolStart != NULL)
-                    *(s_lexerInfo.m_cpStatementSymbolEnd + 1) = '\0';
-                if(s_lexerInfo.m_cpStatementMnemonicStart != NULL)
-                    *(s_lexerInfo.m_cpStatementMnemonicEnd + 1) = '\0';
-
-                //Assemble the source line with the symbol and mnemonic.
-                snprintf(caSource, sizeof(caSource), "%-*s%-*s", iStatementSymbolFieldLength, (s_lexerInfo.m_cpStatementSymbolStart == NULL) ? "" : s_lexerInfo.m_cpStatementSymbolStart, iStatementMnemonicFieldLength, (s_lexerInfo.m_cpStatementMnemonicStart == NULL) ? "" : s_lexerInfo.m_cpStatementMnemonicStart);
-
-                //Check if there are operands.
-                if(s_lexerInfo.m_cpStatementExpresionStart != NULL)
-                {
-                    //Add all operand text without white spaces, except those
-                    //within double quotes.  Loop until the operand field has
-                    //been filled or we run out of space in the string.
-                    bWithinDoubleQuote = FALSE;
-                    iCounter = 0;
-                    iLength = strlen(caSource);
-                    while(iCounter < s_lexerInfo.m_iLargestOperandLength && (iLength + iCounter) < (sizeof(caSource) - NULL_TERMINATING_BYTE_LENGTH))
-                    {
-                        //We have filled the entire operand field and there is
-                        //still space in the string.  Check if we have more
-                        //operand characters.
-                        if(s_lexerInfo.m_cpStatementExpresionStart <= s_lexerInfo.m_cpEndOfStatement)
-                        {
-                            //There are more operand characters.  Don't add white
-                            //spaces unless they are in double quotes.
-                            if(bWithinDoubleQuote == FALSE)
-                            {
-                                if(isspace(*s_lexerInfo.m_cpStatementExpresionStart) == 0)
-                                {
-                                    strncat(caSource, s_lexerInfo.m_cpStatementExpresionStart, 1);
-                                    iCounter++;
-                                }
-
-                                if(*s_lexerInfo.m_cpStatementExpresionStart == '"' && *(s_lexerInfo.m_cpStatementExpresionStart - 1) != '\\')
-                                    bWithinDoubleQuote = TRUE;
-                            }
-                            else
-                            {
-                                strncat(caSource, s_lexerInfo.m_cpStatementExpresionStart, 1);
-                                iCounter++;
-
-                                if(*s_lexerInfo.m_cpStatementExpresionStart == '"' && *(s_lexerInfo.m_cpStatementExpresionStart - 1) != '\\')
-                                    bWithinDoubleQuote = FALSE;
-                            }
-
-                            (s_lexerInfo.m_cpStatementExpresionStart)++;
-                        }
-                        else
-                        {
-                            //No more operand characters left so fill the field
-                            //with white spaces.
-                            strncat(caSource, " ", 1);
-                            iCounter++;
-                        }
-                    }
-                }
-                else if(s_lexerInfo.m_cpStatementExpresionStart == NULL && s_lexerInfo.m_cpStartOfComment != NULL)
-                {
-                    //There are no operands but there is a comment on the line.
-                    //We need to fill the operand field with spaces to align the
-                    //comment text at the start of the comment field.  Loop until
-                    //all the field has been filled or we run out of room in the
-                    //string.
-                    iCounter = 0;
-                    iLength = strlen(caSource);
-                    while(iCounter < s_lexerInfo.m_iLargestOperandLength && (iLength + iCounter) < (sizeof(caSource) - NULL_TERMINATING_BYTE_LENGTH))
-                    {
-                        strncat(caSource, " ", 1);
-                        iCounter++;
-                    }
-                }
-
-                //Check if there is a comment at the end of the line.
-                if(s_lexerInfo.m_cpStartOfComment != NULL)
-                {
-                    //Calculate how much of it will fit in the remaining space of
-                    //the string.
-                    iCounter = bmc_min((sizeof(caSource) - NULL_TERMINATING_BYTE_LENGTH) - strlen(caSource), (size_t)(s_lexerInfo.m_cpEndOfComment - s_lexerInfo.m_cpStartOfComment + 1));
-                    strncat(caSource, s_lexerInfo.m_cpStartOfComment, iCounter);
-                }
-            }
-        }
-
-        //Assemble the listing line.
-        snprintf(caListing, sizeof(caListing), "%-*s%-*s%-*s%s", LISTING_FILE_LINE_FIELD_LENGTH, caLineNumber, LISTING_FILE_LC_FIELD_LENGTH, caLocationCounter, LISTING_FILE_OBJECT_CODE_FIELD_LENGTH, caObjectCode, caSource);
-
-        //Remove any unneeded trailing white spaces from the listing line.
-        iLength = strlen(caListing);
-        iLength--;
-        while(isspace(caListing[iLength]) != 0)
-        {
-            caListing[iLength] = '\0';
-            iLength--;
-        }
-
-        //Print the listing line to the listing file if the listing table is
-        //enabled.
-        if(is_listing_file_enabled() == TRUE)
-        {
-            iFunctionReturnValue = write_line_to_listing_file(caListing);
-            if(iFunctionReturnValue != EXIT_SUCCESS)
-                return iFunctionReturnValue;
-        }
-
-        //Check if there is still more object code.  This can happen with the
-        //BYTE directive and a list of numbers greater than four.
-        if(s_lexerInfo.m_iLocationCounter != iPreviousLocationCounter && iLexerScanReturnValue != ORG_DIRECTIVE_SUCCESS)
-        {
-            while(s_lexerInfo.m_iLocationCounter != iPreviousLocationCounter)
-            {
-                //Create the location counter field.
-                snprintf(caLocationCounter, sizeof(caLocationCounter), "%0*X", LISTING_FILE_LC_MAX_CHARACTERS, iPreviousLocationCounter);
-
-                //Up to three bytes can fit in the object code field.
-                caObjectCode[0] = '\0';
-                for(iCounter = 0; iCounter < LISTING_FILE_OBJECT_CODE_BYTES_PER_FIELD && s_lexerInfo.m_iLocationCounter != iPreviousLocationCounter; iCounter++)
-                {
-                    snprintf(caObjectCodeByte, sizeof(caObjectCodeByte), "%02X ", (uint8_t)(s_lexerInfo.m_iaProgramMemory[iPreviousLocationCounter]));
-                    strcat(caObjectCode, caObjectCodeByte);
-                    iPreviousLocationCounter++;
-                }
-
-                //Assemble the listing line with only the line, location counter, and
-                //object code fields.
-                snprintf(caListing, sizeof(caListing), "%-*s%-*s%-*s", LISTING_FILE_LINE_FIELD_LENGTH, caLineNumber, LISTING_FILE_LC_FIELD_LENGTH, caLocationCounter, LISTING_FILE_OBJECT_CODE_FIELD_LENGTH, caObjectCode);
-
-                //Remove any unneeded trailing white spaces from the listing line.
-                iLength = strlen(caListing);
-                iLength--;
-                while(isspace(caListing[iLength]) != 0)
-                {
-                    caListing[iLength] = '\0';
-                    iLength--;
-                }
-
-                //Print the listing line to the listing file if the listing table
-                //is enabled.
-                if(is_listing_file_enabled() == TRUE)
-                {
-                    iFunctionReturnValue = write_line_to_listing_file(caListing);
-                    if(iFunctionReturnValue != EXIT_SUCCESS)
-                        return iFunctionReturnValue;
-                }
-            }
-        }
+        iFunctionReturnValue = add_line_to_listing(pContext, iPreviousLocationCounter, (iLexerScanReturnValue != ORG_DIRECTIVE_SUCCESS && iLexerScanReturnValue != DS_DIRECTIVE_SUCCESS) ? TRUE : FALSE);
+        if(iFunctionReturnValue != EXIT_SUCCESS)
+            return iFunctionReturnValue;
     }
 
     return (iLexerScanReturnValue == END_DIRECTIVE_SUCCESS) ? END_DIRECTIVE_SUCCESS : EXIT_SUCCESS;
@@ -1099,10 +1179,11 @@ static int lexical_scan_source_line(void)
  * Function name:  label_lexer
  * Function Description:  Performs a lexical scan of the label portion of the
  *                        source file line.
- * Parameters:  None.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
  * Returns:  Zero for success and a negative number if an error occurs.
 ------------------------------------------------------------------------------*/
-static int label_lexer(void)
+static int label_lexer(AssemblerContext* pContext)
 {
     char caSymbol[MAX_SYMBOL_SIZE + NULL_TERMINATING_BYTE_LENGTH];
     char* cpSourceLineCurrentPosition;
@@ -1111,13 +1192,15 @@ static int label_lexer(void)
 
     BSTreeNode* pNode;
 
+    SymbolInfo* pSymbolInfo;
+
     //The start pointer points to the first character of the label.
-    cpSourceLineCurrentPosition = s_lexerInfo.m_cpStartOfLabel;
+    cpSourceLineCurrentPosition = pContext->m_lexer.m_lexerInfo.m_cpStartOfLabel;
     iFunctionReturnValue = get_symbol(&cpSourceLineCurrentPosition, caSymbol);
     if(iFunctionReturnValue != EXIT_SUCCESS)
     {
         print_error(__func__, (uint8_t)(-iFunctionReturnValue));
-        show_line_error(cpSourceLineCurrentPosition - s_cpSourceLine);
+        show_line_error(pContext, cpSourceLineCurrentPosition - pContext->m_lexer.m_cpSourceLine);
         return iFunctionReturnValue;
     }
 
@@ -1126,27 +1209,27 @@ static int label_lexer(void)
     {
         //Invalid character in label.
         print_error(__func__, InvalidCharacterSyntaxError);
-        show_line_error(cpSourceLineCurrentPosition - s_cpSourceLine);
+        show_line_error(pContext, cpSourceLineCurrentPosition - pContext->m_lexer.m_cpSourceLine);
         return -InvalidCharacterSyntaxError;
     }
 
     //If we are here then the label syntax is valid.  We only care about storing
     //it in the symbol table during pass one.
-    if(s_lexerInfo.m_iPass == PassOne)
+    if(pContext->m_lexer.m_lexerInfo.m_iPass == PassOne)
     {
         //This is pass one.  Check for duplicate symbol.
-        pNode = bstree_search(s_pSymbolTableRoot, caSymbol, bstree_key_compare);
+        pNode = bstree_search(pContext->m_lexer.m_pSymbolTableRoot, caSymbol, bstree_key_compare);
         if(pNode != NULL)
         {
             //The label is a duplicate.  Print the error and return the proper
             //error value.
             print_error(__func__, DuplicateSymbolError);
-            show_line_error(s_lexerInfo.m_cpStartOfLabel - s_cpSourceLine);
+            show_line_error(pContext, pContext->m_lexer.m_lexerInfo.m_cpStartOfLabel - pContext->m_lexer.m_cpSourceLine);
             return -DuplicateSymbolError;
         }
 
         //The label is unique so it can be inserted into the symbol tree.
-        pNode = bstree_insert(&s_pSymbolTableRoot, caSymbol, strlen(caSymbol) + NULL_TERMINATING_BYTE_LENGTH, bstree_key_compare);
+        pNode = bstree_insert(&pContext->m_lexer.m_pSymbolTableRoot, caSymbol, strlen(caSymbol) + NULL_TERMINATING_BYTE_LENGTH, bstree_key_compare);
         if(pNode == NULL)
         {
             print_error(__func__, MallocReturnedNull);
@@ -1155,8 +1238,8 @@ static int label_lexer(void)
 
         //Insert was successful.  We need to add the value of this label.  The
         //node includes a void pointer to a data element which can be anything.
-        //We will use it an unsigned int pointer.
-        pNode->m_vpDataElement = malloc(sizeof(uint32_t));
+        //We will use it as a symbol information pointer.
+        pNode->m_vpDataElement = malloc(sizeof(SymbolInfo));
         if(pNode->m_vpDataElement == NULL)
         {
             print_error(__func__, MallocReturnedNull);
@@ -1165,16 +1248,42 @@ static int label_lexer(void)
 
         //Memory allocated successfully.  Store the current location counter as
         //the value.
-        *(uint32_t*)(pNode->m_vpDataElement) = s_lexerInfo.m_iLocationCounter;
+        pSymbolInfo = (SymbolInfo*)(pNode->m_vpDataElement);
+        pSymbolInfo->m_iValue = pContext->m_lexer.m_lexerInfo.m_iLocationCounter;
+        pSymbolInfo->m_iLocationCounter = pContext->m_lexer.m_lexerInfo.m_iLocationCounter;
+        pSymbolInfo->m_iExpression = 0;
+        pSymbolInfo->m_iState = SymbolResolved;
+
+        //The layout may move the label.
+        iFunctionReturnValue = add_layout_label(pContext, pSymbolInfo, pContext->m_lexer.m_lexerInfo.m_iLocationCounter);
+        if(iFunctionReturnValue != EXIT_SUCCESS)
+            return iFunctionReturnValue;
+
+        //Pass two can be split into chunks at this line.
+        iFunctionReturnValue = store_label_line(pContext, pSymbolInfo);
+        if(iFunctionReturnValue != EXIT_SUCCESS)
+            return iFunctionReturnValue;
 
         //Check if the length of this symbol is larger then the current longest
         //symbol.
-        s_lexerInfo.m_iLargestSymbolLength = bmc_max(strlen(caSymbol), s_lexerInfo.m_iLargestSymbolLength);
+        pContext->m_lexer.m_lexerInfo.m_iLargestSymbolLength = bmc_max(strlen(caSymbol), pContext->m_lexer.m_lexerInfo.m_iLargestSymbolLength);
+    }
+    else if(pContext->m_lexer.m_bIsLocationCounterUnknown == TRUE)
+    {
+        //A line failed earlier in pass two so the location counter may no
+        //longer match pass one.  The value this label was given in pass one puts
+        //it back in step.
+        pNode = bstree_search(pContext->m_lexer.m_pSymbolTableRoot, caSymbol, bstree_key_compare);
+        if(pNode != NULL)
+        {
+            pContext->m_lexer.m_lexerInfo.m_iLocationCounter = ((SymbolInfo*)(pNode->m_vpDataElement))->m_iValue;
+            pContext->m_lexer.m_bIsLocationCounterUnknown = FALSE;
+        }
     }
 
     //Mark the start and end of this symbol.
-    s_lexerInfo.m_cpStatementSymbolStart = s_lexerInfo.m_cpStartOfLabel;
-    s_lexerInfo.m_cpStatementSymbolEnd = cpSourceLineCurrentPosition;
+    pContext->m_lexer.m_lexerInfo.m_cpStatementSymbolStart = pContext->m_lexer.m_lexerInfo.m_cpStartOfLabel;
+    pContext->m_lexer.m_lexerInfo.m_cpStatementSymbolEnd = cpSourceLineCurrentPosition;
 
     return EXIT_SUCCESS;
 }
@@ -1183,11 +1292,12 @@ static int label_lexer(void)
  * Function name:  statement_lexer
  * Function Description:  Performs a lexical scan of the statement portion of the
  *                        source file line.
- * Parameters:  None.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
  * Returns:  A positive value for a successful directive, zero for a successful
  *           instruction, and a negative number if an error occurs.
 ------------------------------------------------------------------------------*/
-static int statement_lexer(void)
+static int statement_lexer(AssemblerContext* pContext)
 {
     char caText[MAX_SYMBOL_SIZE + NULL_TERMINATING_BYTE_LENGTH];
     char* cpSourceLineCurrentPosition;
@@ -1204,6 +1314,13 @@ static int statement_lexer(void)
     ExpressionInfo aOperands[MAX_OPERANDS];
 
     int iFunctionReturnValue;
+    int iDirectPageIndex;
+
+    uint32_t iDirectPageExpression;
+
+    //Initialize variables.
+    iDirectPageIndex = -1;
+    iDirectPageExpression = 0;
 
     //The start pointer points to the first character of the statement and the
     //end pointer points to the last character of the statement.  A statement is
@@ -1212,37 +1329,37 @@ static int statement_lexer(void)
     //A directive can start with either a symbol or directive name and an
     //instruction begins with a mnemonic.  We need to get the length first.  Loop
     //until either the first whitespace or the end of the statement is reached.
-    for(cpSourceLineCurrentPosition = s_lexerInfo.m_cpStartOfStatement; isspace(*cpSourceLineCurrentPosition) == 0 && cpSourceLineCurrentPosition <= s_lexerInfo.m_cpEndOfStatement; cpSourceLineCurrentPosition++)
+    for(cpSourceLineCurrentPosition = pContext->m_lexer.m_lexerInfo.m_cpStartOfStatement; isspace(*cpSourceLineCurrentPosition) == 0 && cpSourceLineCurrentPosition <= pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement; cpSourceLineCurrentPosition++)
         ;
 
     //We are out of the for() loop.  If the size is greater than the maximum size
     //of a symbol, which is larger than either a directive name or mnemonic, this
     //is an error.
-    if((cpSourceLineCurrentPosition - s_lexerInfo.m_cpStartOfStatement) > MAX_SYMBOL_SIZE)
+    if((cpSourceLineCurrentPosition - pContext->m_lexer.m_lexerInfo.m_cpStartOfStatement) > MAX_SYMBOL_SIZE)
     {
         print_error(__func__, SymbolLengthExceedsMaximumError);
-        show_line_error(s_lexerInfo.m_cpStartOfLabel - s_cpSourceLine);
+        show_line_error(pContext, pContext->m_lexer.m_lexerInfo.m_cpStartOfLabel - pContext->m_lexer.m_cpSourceLine);
         return -SymbolLengthExceedsMaximumError;
     }
 
     //The size is correct for a symbol, directive name, or mnemonic.  Since
     //directive names and mnemonics must start with a letter and contain only
     //letters and numbers we can use the get_symbol() function.
-    cpSourceLineCurrentPosition = s_lexerInfo.m_cpStartOfStatement;
+    cpSourceLineCurrentPosition = pContext->m_lexer.m_lexerInfo.m_cpStartOfStatement;
     iFunctionReturnValue = get_symbol(&cpSourceLineCurrentPosition, caText);
     if(iFunctionReturnValue != EXIT_SUCCESS)
     {
         print_error(__func__, (uint8_t)(-iFunctionReturnValue));
-        show_line_error(cpSourceLineCurrentPosition - s_cpSourceLine);
+        show_line_error(pContext, cpSourceLineCurrentPosition - pContext->m_lexer.m_cpSourceLine);
         return iFunctionReturnValue;
     }
 
     //We should either be pointing at a whitespace or the end of the statement
     //section.
-    if(*cpSourceLineCurrentPosition != ' ' && cpSourceLineCurrentPosition <= s_lexerInfo.m_cpEndOfStatement)
+    if(*cpSourceLineCurrentPosition != ' ' && cpSourceLineCurrentPosition <= pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement)
     {
         print_error(__func__, InvalidCharacterSyntaxError);
-        show_line_error(cpSourceLineCurrentPosition - s_cpSourceLine);
+        show_line_error(pContext, cpSourceLineCurrentPosition - pContext->m_lexer.m_cpSourceLine);
         return -InvalidCharacterSyntaxError;
     }
 
@@ -1251,24 +1368,36 @@ static int statement_lexer(void)
     {
         //It is a directive.  Do work based on the directive  Mark the start and
         //end of this directive mnemonic.
-        s_lexerInfo.m_cpStatementMnemonicStart = s_lexerInfo.m_cpStartOfStatement;
-        s_lexerInfo.m_cpStatementMnemonicEnd = cpSourceLineCurrentPosition - 1;
+        pContext->m_lexer.m_lexerInfo.m_cpStatementMnemonicStart = pContext->m_lexer.m_lexerInfo.m_cpStartOfStatement;
+        pContext->m_lexer.m_lexerInfo.m_cpStatementMnemonicEnd = cpSourceLineCurrentPosition - 1;
 
         //Do work based on the directive.
         switch(s_aDirectiveTable[(uint32_t)iFunctionReturnValue].m_iIndex)
         {
             case ByteDirective :
-                iFunctionReturnValue = do_byte_directive(cpSourceLineCurrentPosition);
+                iFunctionReturnValue = do_byte_directive(pContext, cpSourceLineCurrentPosition);
                 return (iFunctionReturnValue == EXIT_SUCCESS) ? BYTE_DIRECTIVE_SUCCESS : iFunctionReturnValue;
                 break;
+            case DsDirective :
+                iFunctionReturnValue = do_ds_directive(pContext, cpSourceLineCurrentPosition);
+                return (iFunctionReturnValue == EXIT_SUCCESS) ? DS_DIRECTIVE_SUCCESS : iFunctionReturnValue;
+                break;
             case EndDirective :
-                iFunctionReturnValue = do_end_directive(cpSourceLineCurrentPosition);
+                iFunctionReturnValue = do_end_directive(pContext, cpSourceLineCurrentPosition);
                 return (iFunctionReturnValue == EXIT_SUCCESS) ? END_DIRECTIVE_SUCCESS : iFunctionReturnValue;
                 break;
+            case FillDirective :
+                iFunctionReturnValue = do_fill_directive(pContext, cpSourceLineCurrentPosition);
+                return (iFunctionReturnValue == EXIT_SUCCESS) ? FILL_DIRECTIVE_SUCCESS : iFunctionReturnValue;
+                break;
             case OrgDirective :
-                iFunctionReturnValue = do_org_directive(cpSourceLineCurrentPosition);
+                iFunctionReturnValue = do_org_directive(pContext, cpSourceLineCurrentPosition);
                 return (iFunctionReturnValue == EXIT_SUCCESS) ? ORG_DIRECTIVE_SUCCESS : iFunctionReturnValue;
                 break;
+            case WordDirective :
+                iFunctionReturnValue = do_word_directive(pContext, cpSourceLineCurrentPosition);
+                return (iFunctionReturnValue == EXIT_SUCCESS) ? WORD_DIRECTIVE_SUCCESS : iFunctionReturnValue;
+                break;
             default :
                 //Should never get here but put in for good programming practice.
                 break;
@@ -1280,8 +1409,8 @@ static int statement_lexer(void)
         iInstructionIndex = (uint32_t)iFunctionReturnValue;
 
         //Mark the start and end of this instruction mnemonic.
-        s_lexerInfo.m_cpStatementMnemonicStart = s_lexerInfo.m_cpStartOfStatement;
-        s_lexerInfo.m_cpStatementMnemonicEnd = cpSourceLineCurrentPosition - 1;
+        pContext->m_lexer.m_lexerInfo.m_cpStatementMnemonicStart = pContext->m_lexer.m_lexerInfo.m_cpStartOfStatement;
+        pContext->m_lexer.m_lexerInfo.m_cpStatementMnemonicEnd = cpSourceLineCurrentPosition - 1;
 
         //Check if this instruction has operands.  If an instruction doesn't
         //have operands then it will only have one type (implied) so start by
@@ -1290,7 +1419,7 @@ static int statement_lexer(void)
         if(s_aInstructionTable[iInstructionIndex].m_pOpcodeInfo[0].m_iNumberOfOperands == 0)
         {
             //There are no operands.  We should be past the end of the statement.
-            if(cpSourceLineCurrentPosition <= s_lexerInfo.m_cpEndOfStatement)
+            if(cpSourceLineCurrentPosition <= pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement)
             {
                 //We are not at the end of the statement.  Increment to the next
                 //non-white space and set the error there.
@@ -1298,17 +1427,17 @@ static int statement_lexer(void)
                     cpSourceLineCurrentPosition++;
 
                 print_error(__func__, EndOfStatementExpectedError);
-                show_line_error(cpSourceLineCurrentPosition - s_cpSourceLine);
+                show_line_error(pContext, cpSourceLineCurrentPosition - pContext->m_lexer.m_cpSourceLine);
                 return -EndOfStatementExpectedError;
             }
 
             //There is nothing after the instruction.  If this is pass two we
             //need to write the opcode to program memory before incrementing the
             //location counter.
-            if(s_lexerInfo.m_iPass == PassTwo)
-                s_lexerInfo.m_iaProgramMemory[s_lexerInfo.m_iLocationCounter] = (int16_t)(s_aInstructionTable[iInstructionIndex].m_pOpcodeInfo[0].m_iOpCode);
+            if(pContext->m_lexer.m_lexerInfo.m_iPass == PassTwo)
+                pContext->m_lexer.m_lexerInfo.m_iaProgramMemory[pContext->m_lexer.m_lexerInfo.m_iLocationCounter] = (int16_t)(s_aInstructionTable[iInstructionIndex].m_pOpcodeInfo[0].m_iOpCode);
 
-            s_lexerInfo.m_iLocationCounter++;
+            pContext->m_lexer.m_lexerInfo.m_iLocationCounter++;
         }
         else
         {
@@ -1318,7 +1447,7 @@ static int statement_lexer(void)
             iState = CheckForExpression;
 
             //Loop until the last character of the statement is used.
-            while(cpSourceLineCurrentPosition <= s_lexerInfo.m_cpEndOfStatement)
+            while(cpSourceLineCurrentPosition <= pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement)
             {
                 //Do work based on state.
                 switch(iState)
@@ -1328,7 +1457,7 @@ static int statement_lexer(void)
                         if(iProvidedOperands == MAX_OPERANDS)
                         {
                             print_error(__func__, TooManyOperandsSyntaxError);
-                            show_line_error(cpSourceLineCurrentPosition - s_cpSourceLine);
+                            show_line_error(pContext, cpSourceLineCurrentPosition - pContext->m_lexer.m_cpSourceLine);
                             return -TooManyOperandsSyntaxError;
                         }
 
@@ -1341,8 +1470,8 @@ static int statement_lexer(void)
 
                             //If we haven't yet marked the start of the
                             //expression section then do it now.
-                            if(s_lexerInfo.m_cpStatementExpresionStart == NULL)
-                                s_lexerInfo.m_cpStatementExpresionStart = cpSourceLineCurrentPosition;
+                            if(pContext->m_lexer.m_lexerInfo.m_cpStatementExpresionStart == NULL)
+                                pContext->m_lexer.m_lexerInfo.m_cpStatementExpresionStart = cpSourceLineCurrentPosition;
 
                             //Get address mode type.
                             if(*cpSourceLineCurrentPosition == '#')
@@ -1377,7 +1506,7 @@ static int statement_lexer(void)
                                 //parenthesis.  If a right parenthesis ends the
                                 //statement and a left parenthesis starts it then
                                 //we can assume it is a direct page indirect.
-                                cpTemp = s_lexerInfo.m_cpEndOfStatement;
+                                cpTemp = pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement;
                                 while(isspace(*cpTemp) != 0)
                                     cpTemp--;
                                 if(*cpTemp == ')')
@@ -1407,13 +1536,29 @@ static int statement_lexer(void)
                                 iType = Absolute;
                             }
 
+                            //An absolute operand may be able to use the
+                            //direct page form instead.
+                            iDirectPageIndex = (iType == Absolute) ? find_direct_page_type(pContext, iInstructionIndex) : -1;
+
                             //If this is pass one we don't need to parse the expression.
-                            if(s_lexerInfo.m_iPass == PassOne)
+                            if(pContext->m_lexer.m_lexerInfo.m_iPass == PassOne)
                             {
                                 //This is pass one so we can skip the expression.
                                 //Set the value as zero.
                                 aOperands[iProvidedOperands].m_iValue = 0;
 
+                                //Compile the expression now so pass two doesn't
+                                //have to parse it.  The layout uses it to
+                                //choose the direct page form.
+                                iFunctionReturnValue = compile_expression(pContext, cpSourceLineCurrentPosition);
+                                if(iFunctionReturnValue != EXIT_SUCCESS)
+                                {
+                                    print_error(__func__, (uint8_t)(-iFunctionReturnValue));
+                                    return iFunctionReturnValue;
+                                }
+
+                                iDirectPageExpression = get_number_of_compiled_expressions(pContext) - 1;
+
                                 //Check if there is comma, which is not
                                 //immediately preceded by a single quote, which
                                 //indicates another operand.
@@ -1445,14 +1590,14 @@ static int statement_lexer(void)
                                 {
                                     //No comma found so move to the NULL
                                     //terminating byte at the end of the line.
-                                    cpSourceLineCurrentPosition = s_lexerInfo.m_cpEndOfStatement + 1;
+                                    cpSourceLineCurrentPosition = pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement + 1;
                                 }
                             }
                             else
                             {
                                 //This is pass two so do a full evaluation of the
                                 //expression.
-                                iFunctionReturnValue = do_expression(&cpSourceLineCurrentPosition, &(aOperands[iProvidedOperands].m_iValue));
+                                iFunctionReturnValue = do_expression(pContext, &cpSourceLineCurrentPosition, &(aOperands[iProvidedOperands].m_iValue));
                                 if(iFunctionReturnValue != EXIT_SUCCESS)
                                 {
                                     //There was an error parsing the expression.
@@ -1471,7 +1616,7 @@ static int statement_lexer(void)
                                     }
 
                                     print_error(__func__, (uint8_t)(-iFunctionReturnValue));
-                                    show_line_error(cpSourceLineCurrentPosition - s_cpSourceLine);
+                                    show_line_error(pContext, cpSourceLineCurrentPosition - pContext->m_lexer.m_cpSourceLine);
                                     return iFunctionReturnValue;
                                 }
 
@@ -1505,7 +1650,7 @@ static int statement_lexer(void)
                                         }
 
                                         print_error(__func__, RightBracketExpected);
-                                        show_line_error(cpSourceLineCurrentPosition - s_cpSourceLine);
+                                        show_line_error(pContext, cpSourceLineCurrentPosition - pContext->m_lexer.m_cpSourceLine);
                                         return -RightBracketExpected;
                                     }
                                 }
@@ -1536,7 +1681,7 @@ static int statement_lexer(void)
                                         }
 
                                         print_error(__func__, RightParenthesisExpected);
-                                        show_line_error(cpSourceLineCurrentPosition - s_cpSourceLine);
+                                        show_line_error(pContext, cpSourceLineCurrentPosition - pContext->m_lexer.m_cpSourceLine);
                                         return -RightParenthesisExpected;
                                     }
                                 }
@@ -1547,7 +1692,7 @@ static int statement_lexer(void)
                             if(aOperands[iProvidedOperands].m_iValue < 0)
                             {
                                 print_error(__func__, InvalidValueError);
-                                show_line_error(aOperands[iProvidedOperands].m_cpStart - s_cpSourceLine);
+                                show_line_error(pContext, aOperands[iProvidedOperands].m_cpStart - pContext->m_lexer.m_cpSourceLine);
                                 return -InvalidValueError;
                             }
 
@@ -1585,7 +1730,7 @@ static int statement_lexer(void)
                             //Neither a white space nor a comma.  This is an
                             //error.
                             print_error(__func__, EndOfStatementExpectedError);
-                            show_line_error(cpSourceLineCurrentPosition - s_cpSourceLine);
+                            show_line_error(pContext, cpSourceLineCurrentPosition - pContext->m_lexer.m_cpSourceLine);
                             return -EndOfStatementExpectedError;
                         }
                         break;
@@ -1603,7 +1748,7 @@ static int statement_lexer(void)
             if(iState != CheckForComma)
             {
                 print_error(__func__, UnexpectedEndOfStatementSyntaxError);
-                show_line_error(cpSourceLineCurrentPosition - s_cpSourceLine);
+                show_line_error(pContext, cpSourceLineCurrentPosition - pContext->m_lexer.m_cpSourceLine);
                 return -UnexpectedEndOfStatementSyntaxError;
             }
 
@@ -1631,7 +1776,7 @@ static int statement_lexer(void)
                     //The addressing mode type provided is not supported by this
                     //instruction.
                     print_error(__func__, TypeNotSupported);
-                    show_line_error(s_lexerInfo.m_cpStatementMnemonicStart - s_cpSourceLine);
+                    show_line_error(pContext, pContext->m_lexer.m_lexerInfo.m_cpStatementMnemonicStart - pContext->m_lexer.m_cpSourceLine);
                     return -TypeNotSupported;
                 }
                 else
@@ -1640,7 +1785,7 @@ static int statement_lexer(void)
                     //point at the mnemonic.  If at least one operand was provided
                     //point at the start of the operands.
                     print_error(__func__, IncorrectNumberOfOperandsError);
-                    show_line_error((iProvidedOperands == 0) ? s_lexerInfo.m_cpStatementMnemonicStart - s_cpSourceLine : s_lexerInfo.m_cpStatementExpresionStart - s_cpSourceLine);
+                    show_line_error(pContext, (iProvidedOperands == 0) ? pContext->m_lexer.m_lexerInfo.m_cpStatementMnemonicStart - pContext->m_lexer.m_cpSourceLine : pContext->m_lexer.m_lexerInfo.m_cpStatementExpresionStart - pContext->m_lexer.m_cpSourceLine);
                     return -IncorrectNumberOfOperandsError;
                 }
             }
@@ -1649,12 +1794,36 @@ static int statement_lexer(void)
             //location counter by the number of bytes the instruction takes.
             //Otherwise, we need to check the operands for proper values and
             //store the instruction bytes.
-            if(s_lexerInfo.m_iPass == PassOne)
+            if(pContext->m_lexer.m_lexerInfo.m_iPass == PassOne)
             {
-                s_lexerInfo.m_iLocationCounter += s_aInstructionTable[iInstructionIndex].m_pOpcodeInfo[iOpcodeInfoIndex].m_iLength;
+                //The absolute form is used for now.  The layout chooses the
+                //direct page form once the operand's value is known.
+                if(iDirectPageIndex >= 0)
+                {
+                    iFunctionReturnValue = add_layout_direct_page(pContext, pContext->m_lexer.m_lexerInfo.m_iSourceLineNumber, iDirectPageExpression, pContext->m_lexer.m_lexerInfo.m_iLocationCounter, s_aInstructionTable[iInstructionIndex].m_pOpcodeInfo[iDirectPageIndex].m_iLength, s_aInstructionTable[iInstructionIndex].m_pOpcodeInfo[iOpcodeInfoIndex].m_iLength);
+                    if(iFunctionReturnValue != EXIT_SUCCESS)
+                        return iFunctionReturnValue;
+                }
+
+                pContext->m_lexer.m_lexerInfo.m_iLocationCounter += s_aInstructionTable[iInstructionIndex].m_pOpcodeInfo[iOpcodeInfoIndex].m_iLength;
             }
             else
             {
+                //Use the direct page form if the layout chose it.  The operand
+                //is then the offset within the direct page.
+                if(iDirectPageIndex >= 0 && is_direct_page_line(pContext, pContext->m_lexer.m_lexerInfo.m_iSourceLineNumber) == TRUE)
+                {
+                    if(((uint32_t)aOperands[0].m_iValue >> 8) != get_direct_page(pContext))
+                    {
+                        print_error(__func__, InvalidValueError);
+                        show_line_error(pContext, aOperands[0].m_cpStart - pContext->m_lexer.m_cpSourceLine);
+                        return -InvalidValueError;
+                    }
+
+                    aOperands[0].m_iValue &= 0xFF;
+                    iOpcodeInfoIndex = (uint32_t)iDirectPageIndex;
+                }
+
                 //Do work based on the type.
                 switch(s_aInstructionTable[iInstructionIndex].m_pOpcodeInfo[iOpcodeInfoIndex].m_iType)
                 {
@@ -1667,18 +1836,18 @@ static int statement_lexer(void)
                         if(aOperands[0].m_iValue > 255)
                         {
                             print_error(__func__, InvalidValueError);
-                            show_line_error(aOperands[0].m_cpStart - s_cpSourceLine);
+                            show_line_error(pContext, aOperands[0].m_cpStart - pContext->m_lexer.m_cpSourceLine);
                             return -InvalidValueError;
                         }
 
                         //The operand value is valid.  Write the opcode to
                         //program memory.
-                        s_lexerInfo.m_iaProgramMemory[s_lexerInfo.m_iLocationCounter] = (int16_t)(s_aInstructionTable[iInstructionIndex].m_pOpcodeInfo[iOpcodeInfoIndex].m_iOpCode);
-                        s_lexerInfo.m_iLocationCounter++;
+                        pContext->m_lexer.m_lexerInfo.m_iaProgramMemory[pContext->m_lexer.m_lexerInfo.m_iLocationCounter] = (int16_t)(s_aInstructionTable[iInstructionIndex].m_pOpcodeInfo[iOpcodeInfoIndex].m_iOpCode);
+                        pContext->m_lexer.m_lexerInfo.m_iLocationCounter++;
 
                         //Write the operand to program memory.
-                        s_lexerInfo.m_iaProgramMemory[s_lexerInfo.m_iLocationCounter] = (int16_t)(aOperands[0].m_iValue);
-                        s_lexerInfo.m_iLocationCounter++;
+                        pContext->m_lexer.m_lexerInfo.m_iaProgramMemory[pContext->m_lexer.m_lexerInfo.m_iLocationCounter] = (int16_t)(aOperands[0].m_iValue);
+                        pContext->m_lexer.m_lexerInfo.m_iLocationCounter++;
                         break;
                     case DirectPageIndirect :
                     case Absolute :
@@ -1689,24 +1858,24 @@ static int statement_lexer(void)
                         if(aOperands[0].m_iValue > 65535)
                         {
                             print_error(__func__, InvalidValueError);
-                            show_line_error(aOperands[0].m_cpStart - s_cpSourceLine);
+                            show_line_error(pContext, aOperands[0].m_cpStart - pContext->m_lexer.m_cpSourceLine);
                             return -InvalidValueError;
                         }
 
                         //The operand value is valid.  Write the opcode to
                         //program memory.
-                        s_lexerInfo.m_iaProgramMemory[s_lexerInfo.m_iLocationCounter] = (int16_t)(s_aInstructionTable[iInstructionIndex].m_pOpcodeInfo[iOpcodeInfoIndex].m_iOpCode);
-                        s_lexerInfo.m_iLocationCounter++;
+                        pContext->m_lexer.m_lexerInfo.m_iaProgramMemory[pContext->m_lexer.m_lexerInfo.m_iLocationCounter] = (int16_t)(s_aInstructionTable[iInstructionIndex].m_pOpcodeInfo[iOpcodeInfoIndex].m_iOpCode);
+                        pContext->m_lexer.m_lexerInfo.m_iLocationCounter++;
 
                         //Write the least significant byte of the operand to
                         //program memory.
-                        s_lexerInfo.m_iaProgramMemory[s_lexerInfo.m_iLocationCounter] = (int16_t)(aOperands[0].m_iValue);
-                        s_lexerInfo.m_iLocationCounter++;
+                        pContext->m_lexer.m_lexerInfo.m_iaProgramMemory[pContext->m_lexer.m_lexerInfo.m_iLocationCounter] = (int16_t)(aOperands[0].m_iValue);
+                        pContext->m_lexer.m_lexerInfo.m_iLocationCounter++;
 
                         //Write the most significant byte of the operand to
                         //program memory.
-                        s_lexerInfo.m_iaProgramMemory[s_lexerInfo.m_iLocationCounter] = (int16_t)(aOperands[0].m_iValue >> 8);
-                        s_lexerInfo.m_iLocationCounter++;
+                        pContext->m_lexer.m_lexerInfo.m_iaProgramMemory[pContext->m_lexer.m_lexerInfo.m_iLocationCounter] = (int16_t)(aOperands[0].m_iValue >> 8);
+                        pContext->m_lexer.m_lexerInfo.m_iLocationCounter++;
                         break;
                     default :
                         //Should never get here but put in for good programming practice.
@@ -1719,8 +1888,8 @@ static int statement_lexer(void)
     {
         //It is neither a directive nor mnemonic so we assume it is a symbol.
         //Mark the start and end of this symbol.
-        s_lexerInfo.m_cpStatementSymbolStart = s_lexerInfo.m_cpStartOfStatement;
-        s_lexerInfo.m_cpStatementSymbolEnd = cpSourceLineCurrentPosition - 1;
+        pContext->m_lexer.m_lexerInfo.m_cpStatementSymbolStart = pContext->m_lexer.m_lexerInfo.m_cpStartOfStatement;
+        pContext->m_lexer.m_lexerInfo.m_cpStatementSymbolEnd = cpSourceLineCurrentPosition - 1;
 
         //We should have an EQU directive name following the symbol.  Skip all
         //white spaces.
@@ -1731,18 +1900,18 @@ static int statement_lexer(void)
         if(strncmp(cpSourceLineCurrentPosition, EQU_DIRECTIVE_TEXT, sizeof(EQU_DIRECTIVE_TEXT) - NULL_TERMINATING_BYTE_LENGTH) != 0)
         {
             print_error(__func__, ExpectedEquAfterSymbolSyntaxError);
-            show_line_error(cpSourceLineCurrentPosition - s_cpSourceLine);
+            show_line_error(pContext, cpSourceLineCurrentPosition - pContext->m_lexer.m_cpSourceLine);
             return -ExpectedEquAfterSymbolSyntaxError;
         }
 
         //Found EQU after the symbol.  Mark the start and end of this directive
         //mnemonic and then increment past EQU.
-        s_lexerInfo.m_cpStatementMnemonicStart = cpSourceLineCurrentPosition;
-        s_lexerInfo.m_cpStatementMnemonicEnd = cpSourceLineCurrentPosition + (sizeof(EQU_DIRECTIVE_TEXT) - NULL_TERMINATING_BYTE_LENGTH) - 1;
+        pContext->m_lexer.m_lexerInfo.m_cpStatementMnemonicStart = cpSourceLineCurrentPosition;
+        pContext->m_lexer.m_lexerInfo.m_cpStatementMnemonicEnd = cpSourceLineCurrentPosition + (sizeof(EQU_DIRECTIVE_TEXT) - NULL_TERMINATING_BYTE_LENGTH) - 1;
         cpSourceLineCurrentPosition += (sizeof(EQU_DIRECTIVE_TEXT) - NULL_TERMINATING_BYTE_LENGTH);
 
         //Execute the EQU directive.
-        iFunctionReturnValue = do_equ_directive(cpSourceLineCurrentPosition, caText);
+        iFunctionReturnValue = do_equ_directive(pContext, cpSourceLineCurrentPosition, caText);
         return (iFunctionReturnValue == EXIT_SUCCESS) ? EQU_DIRECTIVE_SUCCESS : iFunctionReturnValue;
     }
 
@@ -1791,16 +1960,52 @@ static int search_instruction_table(const char* cpMnemonic)
     return -1;
 }
 
+/*------------------------------------------------------------------------------
+ * Function name:  find_direct_page_type
+ * Function Description:  Finds the direct page form of an instruction for use
+ *                        in place of its absolute form.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * iInstructionIndex - The index into the instruction table.
+ * Returns:  The index into the instruction's opcode information, or -1 if the
+ *           direct page option isn't enabled or the instruction has no absolute
+ *           and direct page forms.
+------------------------------------------------------------------------------*/
+static int find_direct_page_type(AssemblerContext* pContext, uint32_t iInstructionIndex)
+{
+    int iDirectPageIndex;
+
+    uint8_t bFoundAbsolute;
+
+    uint32_t iIndex;
+
+    if(is_direct_page_enabled(pContext) == FALSE)
+        return -1;
+
+    iDirectPageIndex = -1;
+    bFoundAbsolute = FALSE;
+    for(iIndex = 0; iIndex < s_aInstructionTable[iInstructionIndex].m_iNumberOfTypes; iIndex++)
+    {
+        if(s_aInstructionTable[iInstructionIndex].m_pOpcodeInfo[iIndex].m_iType == DirectPage)
+            iDirectPageIndex = (int)iIndex;
+        else if(s_aInstructionTable[iInstructionIndex].m_pOpcodeInfo[iIndex].m_iType == Absolute)
+            bFoundAbsolute = TRUE;
+    }
+
+    return (bFoundAbsolute == TRUE) ? iDirectPageIndex : -1;
+}
+
 /*------------------------------------------------------------------------------
  * Function name:  do_byte_directive
  * Function Description:  Attempts to parse out the number(s) following the BYTE
  *                        directive.
  * Parameters:
+ * pContext - Pointer to the assembler context.
  * cpCurrentStatementPosition - Character pointer to the current position within
  *                              the statement section.
  * Returns:  Zero for success and negative number for failure.
 ------------------------------------------------------------------------------*/
-static int do_byte_directive(char* cpCurrentStatementPosition)
+static int do_byte_directive(AssemblerContext* pContext, char* cpCurrentStatementPosition)
 {
     uint8_t iState;
 
@@ -1810,11 +2015,14 @@ static int do_byte_directive(char* cpCurrentStatementPosition)
 
     ExpressionInfo expressionInfo;
 
+    StringLiteral stringLiteral;
+    const StringLiteral* pStringLiteral;
+
     //Initialize state.
     iState = CheckForExpression;
 
     //Loop until the last character of the statement is used.
-    while(cpCurrentStatementPosition <= s_lexerInfo.m_cpEndOfStatement)
+    while(cpCurrentStatementPosition <= pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement)
     {
         //Do work based on state.
         switch(iState)
@@ -1829,24 +2037,36 @@ static int do_byte_directive(char* cpCurrentStatementPosition)
 
                 //If we haven't yet marked the start of the expression section
                 //then do it now.
-                if(s_lexerInfo.m_cpStatementExpresionStart == NULL)
-                    s_lexerInfo.m_cpStatementExpresionStart = cpCurrentStatementPosition;
+                if(pContext->m_lexer.m_lexerInfo.m_cpStatementExpresionStart == NULL)
+                    pContext->m_lexer.m_lexerInfo.m_cpStatementExpresionStart = cpCurrentStatementPosition;
 
                 //If this is pass one we don't need to parse the expression.
-                if(s_lexerInfo.m_iPass == PassOne)
+                if(pContext->m_lexer.m_lexerInfo.m_iPass == PassOne)
                 {
                     //This is pass one so we can skip the expression.  Set the
                     //value as zero.
                     expressionInfo.m_iValue = 0;
 
-                    //Assume there is only one byte.  If a literal string is
-                    //detected we will get a new byte count.
-                    iCounter = 1;
-
-                    //Check if there is comma which indicates another expression.
-                    //Care must be taken as a comma may be part of a literal
+                    //Compile an expression now so pass two doesn't have to
+                    //parse it.  A literal string has nothing to compile.
+                    if(*cpCurrentStatementPosition != '"')
+                    {
+                        iFunctionReturnValue = compile_expression(pContext, cpCurrentStatementPosition);
+                        if(iFunctionReturnValue != EXIT_SUCCESS)
+                        {
+                            print_error(__func__, (uint8_t)(-iFunctionReturnValue));
+                            return iFunctionReturnValue;
+                        }
+                    }
+
+                    //Assume there is only one byte.  If a literal string is
+                    //detected we will get a new byte count.
+                    iCounter = 1;
+
+                    //Check if there is comma which indicates another expression.
+                    //Care must be taken as a comma may be part of a literal
                     //character or literal string.
-                    while(*cpCurrentStatementPosition != ',' && cpCurrentStatementPosition <= s_lexerInfo.m_cpEndOfStatement)
+                    while(*cpCurrentStatementPosition != ',' && cpCurrentStatementPosition <= pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement)
                     {
                         if(*cpCurrentStatementPosition == '\'')
                         {
@@ -1856,40 +2076,18 @@ static int do_byte_directive(char* cpCurrentStatementPosition)
                         }
                         else if(*cpCurrentStatementPosition == '"')
                         {
-                            //We reached a double quote, skip over it.
-                            cpCurrentStatementPosition++;
-
-                            //Loop until the next double quote, or end of
-                            //statement, is reached.  Increment the counter for
-                            //each character as each character takes up a byte in
-                            //memory.
-                            iCounter = 0;
-                            while(*cpCurrentStatementPosition != '"' && cpCurrentStatementPosition <= s_lexerInfo.m_cpEndOfStatement)
-                            {
-                                //There can be escaped characters in a string and those need to
-                                //be treated as a single byte.  These characters are preceded by
-                                //a backslash character.
-                                if(*cpCurrentStatementPosition == '\\')
-                                {
-                                    //Backslash character found.  Skip past it
-                                    //and the character immediately following.
-                                    cpCurrentStatementPosition += 2;
-
-                                    //Count as a single byte.
-                                    iCounter++;
-                                }
-                                else
-                                {
-                                    //Not a backslash so skip past the character
-                                    //and count it as one byte.
-                                    cpCurrentStatementPosition++;
-                                    iCounter++;
-                                }
-                            }
-
-                            //If we are pointing at a double quote then skip over it.
-                            if(*cpCurrentStatementPosition == '"')
-                                cpCurrentStatementPosition++;
+                            //We reached a double quote.  Decode the literal
+                            //string now so pass two only has to copy it.  Each
+                            //character takes up a byte in memory.
+                            iFunctionReturnValue = decode_string_literal(pContext, &cpCurrentStatementPosition, &stringLiteral);
+                            if(iFunctionReturnValue != EXIT_SUCCESS)
+                                return iFunctionReturnValue;
+
+                            iFunctionReturnValue = store_string_literal(pContext, &stringLiteral);
+                            if(iFunctionReturnValue != EXIT_SUCCESS)
+                                return iFunctionReturnValue;
+
+                            iCounter = stringLiteral.m_iNumberOfBytes;
                         }
                         else
                         {
@@ -1903,7 +2101,7 @@ static int do_byte_directive(char* cpCurrentStatementPosition)
                     }
 
                     //Increment the location counter to the next byte.
-                    s_lexerInfo.m_iLocationCounter += iCounter;
+                    pContext->m_lexer.m_lexerInfo.m_iLocationCounter += iCounter;
 
                     //Switch state to checking for a comma.
                     iState = CheckForComma;
@@ -1915,11 +2113,11 @@ static int do_byte_directive(char* cpCurrentStatementPosition)
                     if(*cpCurrentStatementPosition != '"')
                     {
                         //It is an expression.
-                        iFunctionReturnValue = do_expression(&cpCurrentStatementPosition, &(expressionInfo.m_iValue));
+                        iFunctionReturnValue = do_expression(pContext, &cpCurrentStatementPosition, &(expressionInfo.m_iValue));
                         if(iFunctionReturnValue != EXIT_SUCCESS)
                         {
                             print_error(__func__, (uint8_t)(-iFunctionReturnValue));
-                            show_line_error(cpCurrentStatementPosition - s_cpSourceLine);
+                            show_line_error(pContext, cpCurrentStatementPosition - pContext->m_lexer.m_cpSourceLine);
                             return iFunctionReturnValue;
                         }
 
@@ -1927,65 +2125,47 @@ static int do_byte_directive(char* cpCurrentStatementPosition)
                         if(expressionInfo.m_iValue < 0 || expressionInfo.m_iValue > 255)
                         {
                             print_error(__func__, InvalidValueError);
-                            show_line_error(cpCurrentStatementPosition - s_cpSourceLine);
+                            show_line_error(pContext, cpCurrentStatementPosition - pContext->m_lexer.m_cpSourceLine);
                             return -InvalidValueError;
                         }
 
                         //Number value is valid, store it at the current location.
-                        s_lexerInfo.m_iaProgramMemory[s_lexerInfo.m_iLocationCounter] = (int16_t)(expressionInfo.m_iValue);
+                        pContext->m_lexer.m_lexerInfo.m_iaProgramMemory[pContext->m_lexer.m_lexerInfo.m_iLocationCounter] = (int16_t)(expressionInfo.m_iValue);
 
                         //Increment the location counter to the next byte.
-                        s_lexerInfo.m_iLocationCounter++;
+                        pContext->m_lexer.m_lexerInfo.m_iLocationCounter++;
                     }
                     else
                     {
-                        //It is a literal string.  Skip over the double quote.
-                        cpCurrentStatementPosition++;
-
-                        //Loop until the next double quote, or end of statement,
-                        //is reached.  Store the value of each character.
-                        while(*cpCurrentStatementPosition != '"' && cpCurrentStatementPosition <= s_lexerInfo.m_cpEndOfStatement)
+                        //It is a literal string.  Use the one decoded during
+                        //pass one, or decode it now if there isn't one.
+                        pStringLiteral = find_string_literal(pContext, cpCurrentStatementPosition - pContext->m_lexer.m_cpSourceLine);
+                        if(pStringLiteral == NULL)
                         {
-                            //If we are pointing a a backslash then we have to
-                            //process a special character.
-                            if(*cpCurrentStatementPosition == '\\')
-                            {
-                                //It is a special character.  Skip past the
-                                //backslash character.
-                                cpCurrentStatementPosition++;
-
-                                //Get the value for the escaped character.
-                                s_lexerInfo.m_iaProgramMemory[s_lexerInfo.m_iLocationCounter] = (int16_t)get_esc_character(*cpCurrentStatementPosition);
-                                if(s_lexerInfo.m_iaProgramMemory[s_lexerInfo.m_iLocationCounter] == 0)
-                                {
-                                    print_error(__func__, InvalidCharacterSyntaxError);
-                                    show_line_error(cpCurrentStatementPosition - s_cpSourceLine);
-                                    return -InvalidCharacterSyntaxError;
-                                }
-
-                                //Increment the location counter to the next byte.
-                                s_lexerInfo.m_iLocationCounter++;
-
-                                //Increment past the escaped character.
-                                cpCurrentStatementPosition++;
-                            }
-                            else
-                            {
-                                //Not a special character so just process the
-                                //character as is.
-                                s_lexerInfo.m_iaProgramMemory[s_lexerInfo.m_iLocationCounter] = (int16_t)(*cpCurrentStatementPosition);
+                            iFunctionReturnValue = decode_string_literal(pContext, &cpCurrentStatementPosition, &stringLiteral);
+                            if(iFunctionReturnValue != EXIT_SUCCESS)
+                                return iFunctionReturnValue;
 
-                                //Increment the location counter to the next byte.
-                                s_lexerInfo.m_iLocationCounter++;
+                            pStringLiteral = &stringLiteral;
+                        }
+                        else
+                        {
+                            cpCurrentStatementPosition += pStringLiteral->m_iTextLength;
+                        }
 
-                                //Increment past the character.
-                                cpCurrentStatementPosition++;
-                            }
+                        //Store the characters.  When there is a bad escaped
+                        //character the ones before it are stored.
+                        memcpy(&pContext->m_lexer.m_lexerInfo.m_iaProgramMemory[pContext->m_lexer.m_lexerInfo.m_iLocationCounter], &pContext->m_lexer.m_ipStringPayloads[pStringLiteral->m_iPayloadOffset], pStringLiteral->m_iPayloadLength * sizeof(int16_t));
+                        if(pStringLiteral->m_iError != EXIT_SUCCESS)
+                        {
+                            pContext->m_lexer.m_lexerInfo.m_iLocationCounter += pStringLiteral->m_iPayloadLength - 1;
+                            print_error(__func__, (uint8_t)(-pStringLiteral->m_iError));
+                            show_line_error(pContext, pStringLiteral->m_iErrorOffset);
+                            return pStringLiteral->m_iError;
                         }
 
-                        //If we are pointing at a double quote then skip over it.
-                        if(*cpCurrentStatementPosition == '"')
-                            cpCurrentStatementPosition++;
+                        //Increment the location counter past the characters.
+                        pContext->m_lexer.m_lexerInfo.m_iLocationCounter += pStringLiteral->m_iNumberOfBytes;
                     }
 
                     //Switch state to checking for a comma.
@@ -2007,7 +2187,7 @@ static int do_byte_directive(char* cpCurrentStatementPosition)
                 else
                 {
                     print_error(__func__, EndOfStatementExpectedError);
-                    show_line_error(cpCurrentStatementPosition - s_cpSourceLine);
+                    show_line_error(pContext, cpCurrentStatementPosition - pContext->m_lexer.m_cpSourceLine);
                     return -EndOfStatementExpectedError;
                 }
                 break;
@@ -2029,31 +2209,229 @@ static int do_byte_directive(char* cpCurrentStatementPosition)
     else
     {
         print_error(__func__, UnexpectedEndOfStatementSyntaxError);
-        show_line_error(cpCurrentStatementPosition - s_cpSourceLine);
+        show_line_error(pContext, cpCurrentStatementPosition - pContext->m_lexer.m_cpSourceLine);
         return -UnexpectedEndOfStatementSyntaxError;
     }
 }
 
+/*------------------------------------------------------------------------------
+ * Function name:  decode_string_literal
+ * Function Description:  Decodes a literal string into the string payloads.
+ *                        Escaped characters are turned into their values.  A
+ *                        bad escaped character is kept as an error to report
+ *                        when the string is stored, the characters after it are
+ *                        still counted but not decoded.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * cppCurrentStatementPosition - Pointer to a character pointer which is the
+ *                               opening double quote.  On return it is past the
+ *                               closing double quote.
+ * pStringLiteral - Pointer to where to store the information about the string.
+ * Returns:  Zero for success and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+static int decode_string_literal(AssemblerContext* pContext, char** cppCurrentStatementPosition, StringLiteral* pStringLiteral)
+{
+    char* cpPosition;
+
+    int16_t* ipNewStringPayloads;
+    int16_t iCharacter;
+
+    uint32_t iLength;
+
+    //Make room for every character up to the end of the statement, which is the
+    //most the string can decode to.
+    cpPosition = *cppCurrentStatementPosition;
+    iLength = (uint32_t)(pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement - cpPosition) + 1;
+    if(pContext->m_lexer.m_iStringPayloadsSize + iLength > pContext->m_lexer.m_iStringPayloadsCapacity)
+    {
+        if(pContext->m_lexer.m_iStringPayloadsCapacity == 0)
+            pContext->m_lexer.m_iStringPayloadsCapacity = STRING_PAYLOADS_INITIAL_SIZE;
+
+        while(pContext->m_lexer.m_iStringPayloadsSize + iLength > pContext->m_lexer.m_iStringPayloadsCapacity)
+            pContext->m_lexer.m_iStringPayloadsCapacity *= 2;
+
+        ipNewStringPayloads = realloc(pContext->m_lexer.m_ipStringPayloads, pContext->m_lexer.m_iStringPayloadsCapacity * sizeof(int16_t));
+        if(ipNewStringPayloads == NULL)
+        {
+            print_error(__func__, MallocReturnedNull);
+            return -MallocReturnedNull;
+        }
+
+        pContext->m_lexer.m_ipStringPayloads = ipNewStringPayloads;
+    }
+
+    pStringLiteral->m_iSourceLineNumber = pContext->m_lexer.m_lexerInfo.m_iSourceLineNumber;
+    pStringLiteral->m_iTextOffset = (uint32_t)(cpPosition - pContext->m_lexer.m_cpSourceLine);
+    pStringLiteral->m_iPayloadOffset = pContext->m_lexer.m_iStringPayloadsSize;
+    pStringLiteral->m_iPayloadLength = 0;
+    pStringLiteral->m_iNumberOfBytes = 0;
+    pStringLiteral->m_iErrorOffset = 0;
+    pStringLiteral->m_iError = EXIT_SUCCESS;
+
+    //Skip over the double quote.  Loop until the next double quote, or end of
+    //statement, is reached.
+    cpPosition++;
+    while(*cpPosition != '"' && cpPosition <= pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement)
+    {
+        //If we are pointing a a backslash then we have to process a special
+        //character.
+        if(*cpPosition == '\\')
+        {
+            cpPosition++;
+            iCharacter = (int16_t)get_esc_character(*cpPosition);
+            if(iCharacter == 0 && pStringLiteral->m_iError == EXIT_SUCCESS)
+            {
+                //The value stored in its place is zero.
+                pContext->m_lexer.m_ipStringPayloads[pContext->m_lexer.m_iStringPayloadsSize + pStringLiteral->m_iPayloadLength] = 0;
+                pStringLiteral->m_iPayloadLength++;
+                pStringLiteral->m_iErrorOffset = (uint32_t)(cpPosition - pContext->m_lexer.m_cpSourceLine);
+                pStringLiteral->m_iError = -InvalidCharacterSyntaxError;
+            }
+        }
+        else
+        {
+            iCharacter = (int16_t)(*cpPosition);
+        }
+
+        if(pStringLiteral->m_iError == EXIT_SUCCESS)
+        {
+            pContext->m_lexer.m_ipStringPayloads[pContext->m_lexer.m_iStringPayloadsSize + pStringLiteral->m_iPayloadLength] = iCharacter;
+            pStringLiteral->m_iPayloadLength++;
+        }
+
+        pStringLiteral->m_iNumberOfBytes++;
+        cpPosition++;
+    }
+
+    //If we are pointing at a double quote then skip over it.
+    if(*cpPosition == '"')
+        cpPosition++;
+
+    pStringLiteral->m_iTextLength = (uint32_t)(cpPosition - *cppCurrentStatementPosition);
+    pContext->m_lexer.m_iStringPayloadsSize += pStringLiteral->m_iPayloadLength;
+    *cppCurrentStatementPosition = cpPosition;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  store_string_literal
+ * Function Description:  Adds a literal string decoded during pass one to the
+ *                        end of the list so pass two can find it.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * pStringLiteral - Pointer to the information about the string.
+ * Returns:  Zero for success and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+static int store_string_literal(AssemblerContext* pContext, const StringLiteral* pStringLiteral)
+{
+    StringLiteral* pNewStringLiterals;
+
+    if(pContext->m_lexer.m_iNumberOfStringLiterals == pContext->m_lexer.m_iStringLiteralsCapacity)
+    {
+        pContext->m_lexer.m_iStringLiteralsCapacity = (pContext->m_lexer.m_iStringLiteralsCapacity == 0) ? STRING_LITERALS_INITIAL_CAPACITY : pContext->m_lexer.m_iStringLiteralsCapacity * 2;
+        pNewStringLiterals = realloc(pContext->m_lexer.m_pStringLiterals, pContext->m_lexer.m_iStringLiteralsCapacity * sizeof(StringLiteral));
+        if(pNewStringLiterals == NULL)
+        {
+            print_error(__func__, MallocReturnedNull);
+            return -MallocReturnedNull;
+        }
+
+        pContext->m_lexer.m_pStringLiterals = pNewStringLiterals;
+    }
+
+    pContext->m_lexer.m_pStringLiterals[pContext->m_lexer.m_iNumberOfStringLiterals] = *pStringLiteral;
+    pContext->m_lexer.m_iNumberOfStringLiterals++;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  find_string_literal
+ * Function Description:  Finds the literal string decoded during pass one that
+ *                        starts at a position on the current source line.  Lines
+ *                        are read in order so the list is walked along with
+ *                        them.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * iTextOffset - The offset of the opening double quote within the source line.
+ * Returns:  Pointer to the information about the string, or NULL if there isn't
+ *           one.
+------------------------------------------------------------------------------*/
+static const StringLiteral* find_string_literal(AssemblerContext* pContext, uint32_t iTextOffset)
+{
+    const StringLiteral* pStringLiteral;
+
+    while(pContext->m_lexer.m_iStringLiteralIndex < pContext->m_lexer.m_iNumberOfStringLiterals)
+    {
+        pStringLiteral = &pContext->m_lexer.m_pStringLiterals[pContext->m_lexer.m_iStringLiteralIndex];
+        if(pStringLiteral->m_iSourceLineNumber > pContext->m_lexer.m_lexerInfo.m_iSourceLineNumber || (pStringLiteral->m_iSourceLineNumber == pContext->m_lexer.m_lexerInfo.m_iSourceLineNumber && pStringLiteral->m_iTextOffset > iTextOffset))
+            break;
+
+        pContext->m_lexer.m_iStringLiteralIndex++;
+        if(pStringLiteral->m_iSourceLineNumber == pContext->m_lexer.m_lexerInfo.m_iSourceLineNumber && pStringLiteral->m_iTextOffset == iTextOffset)
+            return pStringLiteral;
+    }
+
+    return NULL;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  do_ds_directive
+ * Function Description:  Executes the DS directive.  The location counter is
+ *                        moved past the number of bytes given without storing
+ *                        anything in them.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * cpCurrentStatementPosition - Character pointer to the current position within
+ *                              the statement section.
+ * Returns:  Zero for success and negative number for failure.
+------------------------------------------------------------------------------*/
+static int do_ds_directive(AssemblerContext* pContext, char* cpCurrentStatementPosition)
+{
+    int iFunctionReturnValue;
+
+    uint32_t iCount;
+
+    iFunctionReturnValue = do_count_expression(pContext, &cpCurrentStatementPosition, &iCount);
+    if(iFunctionReturnValue != EXIT_SUCCESS)
+        return iFunctionReturnValue;
+
+    //The count must be the last thing in the statement.
+    if(*cpCurrentStatementPosition != '\0' && *cpCurrentStatementPosition != ';')
+    {
+        print_error(__func__, EndOfStatementExpectedError);
+        show_line_error(pContext, cpCurrentStatementPosition - pContext->m_lexer.m_cpSourceLine);
+        return -EndOfStatementExpectedError;
+    }
+
+    //Reserve the bytes.
+    pContext->m_lexer.m_lexerInfo.m_iLocationCounter += iCount;
+
+    return EXIT_SUCCESS;
+}
+
 /*------------------------------------------------------------------------------
  * Function name:  do_end_directive
  * Function Description:  Executes the END directive.
  * Parameters:
+ * pContext - Pointer to the assembler context.
  * cpCurrentStatementPosition - Character pointer to the current position within
  *                              the statement section.
  * Returns:  Zero for success and negative number for failure.
 ------------------------------------------------------------------------------*/
-static int do_end_directive(char* cpCurrentStatementPosition)
+static int do_end_directive(AssemblerContext* pContext, char* cpCurrentStatementPosition)
 {
     //The END directive must be alone on the line, no label, but a comment is
     //allowed.
-    if(s_lexerInfo.m_cpStartOfLabel != NULL)
+    if(pContext->m_lexer.m_lexerInfo.m_cpStartOfLabel != NULL)
     {
         //There is a label on the line.
         print_error(__func__, EndDirectiveNotAloneError);
-        show_line_error(s_lexerInfo.m_cpStartOfLabel - s_cpSourceLine);
+        show_line_error(pContext, pContext->m_lexer.m_lexerInfo.m_cpStartOfLabel - pContext->m_lexer.m_cpSourceLine);
         return -EndDirectiveNotAloneError;
     }
-    else if((s_lexerInfo.m_cpEndOfStatement + 1) != cpCurrentStatementPosition)
+    else if((pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement + 1) != cpCurrentStatementPosition)
     {
         //There is more after the END directive.  We would be pointing at a white
         //space at the moment.  Increment to the next non-white space.
@@ -2061,7 +2439,7 @@ static int do_end_directive(char* cpCurrentStatementPosition)
             cpCurrentStatementPosition++;
 
         print_error(__func__, EndOfStatementExpectedError);
-        show_line_error(cpCurrentStatementPosition - s_cpSourceLine);
+        show_line_error(pContext, cpCurrentStatementPosition - pContext->m_lexer.m_cpSourceLine);
         return -EndOfStatementExpectedError;
     }
     else
@@ -2076,12 +2454,13 @@ static int do_end_directive(char* cpCurrentStatementPosition)
  * Function Description:  Attempts to parse out the number following the EQU
  *                        directive.
  * Parameters:
+ * pContext - Pointer to the assembler context.
  * cpCurrentStatementPosition - Character pointer to the current position within
  *                              the statement section.
  * cpSymbol - Character pointer to the symbol that precedes the EQU directive.
  * Returns:  Zero for success and negative number for failure.
 ------------------------------------------------------------------------------*/
-static int do_equ_directive(char* cpCurrentStatementPosition, char* cpSymbol)
+static int do_equ_directive(AssemblerContext* pContext, char* cpCurrentStatementPosition, char* cpSymbol)
 {
     int iFunctionReturnValue;
 
@@ -2089,12 +2468,15 @@ static int do_equ_directive(char* cpCurrentStatementPosition, char* cpSymbol)
 
     BSTreeNode* pNode;
 
+    SymbolInfo symbolInfo;
+    SymbolInfo* pSymbolInfo;
+
     //We need an expression after EQU.  If we are beyond the end of statement
     //then this is an error.
-    if(cpCurrentStatementPosition > s_lexerInfo.m_cpEndOfStatement)
+    if(cpCurrentStatementPosition > pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement)
     {
         print_error(__func__, UnexpectedEndOfStatementSyntaxError);
-        show_line_error(cpCurrentStatementPosition - s_cpSourceLine);
+        show_line_error(pContext, cpCurrentStatementPosition - pContext->m_lexer.m_cpSourceLine);
         return -UnexpectedEndOfStatementSyntaxError;
     }
 
@@ -2106,14 +2488,26 @@ static int do_equ_directive(char* cpCurrentStatementPosition, char* cpSymbol)
     expressionInfo.m_cpStart = cpCurrentStatementPosition;
 
     //If we haven't yet marked the start of the expression then do it now.
-    if(s_lexerInfo.m_cpStatementExpresionStart == NULL)
-        s_lexerInfo.m_cpStatementExpresionStart = cpCurrentStatementPosition;
+    if(pContext->m_lexer.m_lexerInfo.m_cpStatementExpresionStart == NULL)
+        pContext->m_lexer.m_lexerInfo.m_cpStatementExpresionStart = cpCurrentStatementPosition;
+
+    //During pass one the symbol information is filled in here and copied into
+    //the symbol table.  During pass two the one in the symbol table is used so
+    //its value can be resolved.
+    pSymbolInfo = &symbolInfo;
+    symbolInfo.m_iState = SymbolUnresolved;
+    if(pContext->m_lexer.m_lexerInfo.m_iPass == PassTwo)
+    {
+        pNode = bstree_search(pContext->m_lexer.m_pSymbolTableRoot, cpSymbol, bstree_key_compare);
+        if(pNode != NULL)
+            pSymbolInfo = (SymbolInfo*)(pNode->m_vpDataElement);
+    }
 
-    iFunctionReturnValue = do_expression(&cpCurrentStatementPosition, &(expressionInfo.m_iValue));
+    iFunctionReturnValue = do_symbol_expression(pContext, &cpCurrentStatementPosition, pSymbolInfo);
     if(iFunctionReturnValue != EXIT_SUCCESS)
     {
         print_error(__func__, (uint8_t)(-iFunctionReturnValue));
-        show_line_error(cpCurrentStatementPosition - s_cpSourceLine);
+        show_line_error(pContext, cpCurrentStatementPosition - pContext->m_lexer.m_cpSourceLine);
         return iFunctionReturnValue;
     }
 
@@ -2122,31 +2516,32 @@ static int do_equ_directive(char* cpCurrentStatementPosition, char* cpSymbol)
     //section.  Anything else is an error.
     if(*cpCurrentStatementPosition == '\0' || *cpCurrentStatementPosition == ';')
     {
-        //The number must be positive.
-        if(expressionInfo.m_iValue < 0)
+        //The number must be positive.  A symbol that isn't resolved yet is
+        //checked during pass two.
+        if(pSymbolInfo->m_iState == SymbolResolved && (int)pSymbolInfo->m_iValue < 0)
         {
             print_error(__func__, InvalidValueError);
-            show_line_error(expressionInfo.m_cpStart - s_cpSourceLine);
+            show_line_error(pContext, expressionInfo.m_cpStart - pContext->m_lexer.m_cpSourceLine);
             return -InvalidValueError;
         }
 
         //We have the number.  We only care about storing it in the symbol table
         //during pass one.
-        if(s_lexerInfo.m_iPass == PassOne)
+        if(pContext->m_lexer.m_lexerInfo.m_iPass == PassOne)
         {
             //First check for duplicate symbol.
-            pNode = bstree_search(s_pSymbolTableRoot, cpSymbol, bstree_key_compare);
+            pNode = bstree_search(pContext->m_lexer.m_pSymbolTableRoot, cpSymbol, bstree_key_compare);
             if(pNode != NULL)
             {
                 //The symbol is a duplicate.  Print the error and return the
                 //proper error value.
                 print_error(__func__, DuplicateSymbolError);
-                show_line_error(s_lexerInfo.m_cpStartOfStatement - s_cpSourceLine);
+                show_line_error(pContext, pContext->m_lexer.m_lexerInfo.m_cpStartOfStatement - pContext->m_lexer.m_cpSourceLine);
                 return -DuplicateSymbolError;
             }
 
             //The symbol is unique so it can be inserted into the symbol tree.
-            pNode = bstree_insert(&s_pSymbolTableRoot, cpSymbol, strlen(cpSymbol) + NULL_TERMINATING_BYTE_LENGTH, bstree_key_compare);
+            pNode = bstree_insert(&pContext->m_lexer.m_pSymbolTableRoot, cpSymbol, strlen(cpSymbol) + NULL_TERMINATING_BYTE_LENGTH, bstree_key_compare);
             if(pNode == NULL)
             {
                 print_error(__func__, MallocReturnedNull);
@@ -2155,30 +2550,137 @@ static int do_equ_directive(char* cpCurrentStatementPosition, char* cpSymbol)
 
             //Insert was successful.  We need to add the value of this symbol.
             //The node includes a void pointer to a data element which can be
-            //anything.  We will use it an unsigned int pointer.
-            pNode->m_vpDataElement = malloc(sizeof(uint32_t));
+            //anything.  We will use it as a symbol information pointer.
+            pNode->m_vpDataElement = malloc(sizeof(SymbolInfo));
             if(pNode->m_vpDataElement == NULL)
             {
                 print_error(__func__, MallocReturnedNull);
                 return -MallocReturnedNull;
             }
 
-            //Memory allocated successfully.  Store the number as the value.
-            *(uint32_t*)(pNode->m_vpDataElement) = (uint32_t)(expressionInfo.m_iValue);
+            //Memory allocated successfully.  Store the value, or what is needed
+            //to resolve it later.
+            *(SymbolInfo*)(pNode->m_vpDataElement) = symbolInfo;
+
+            //The layout works the value out again if labels move.
+            iFunctionReturnValue = add_layout_equ(pContext, (SymbolInfo*)(pNode->m_vpDataElement), pContext->m_lexer.m_lexerInfo.m_iLocationCounter);
+            if(iFunctionReturnValue != EXIT_SUCCESS)
+                return iFunctionReturnValue;
 
             //Check if the length of this symbol is larger then the current
             //longest symbol.
-            s_lexerInfo.m_iLargestSymbolLength = bmc_max(strlen(cpSymbol), s_lexerInfo.m_iLargestSymbolLength);
+            pContext->m_lexer.m_lexerInfo.m_iLargestSymbolLength = bmc_max(strlen(cpSymbol), pContext->m_lexer.m_lexerInfo.m_iLargestSymbolLength);
         }
     }
     else
     {
         //There is more.
         print_error(__func__, EndOfStatementExpectedError);
-        show_line_error(cpCurrentStatementPosition - s_cpSourceLine);
+        show_line_error(pContext, cpCurrentStatementPosition - pContext->m_lexer.m_cpSourceLine);
+        return -EndOfStatementExpectedError;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  do_fill_directive
+ * Function Description:  Executes the FILL directive.  The number of bytes given
+ *                        by the first expression are all stored with the value
+ *                        of the second expression.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * cpCurrentStatementPosition - Character pointer to the current position within
+ *                              the statement section.
+ * Returns:  Zero for success and negative number for failure.
+------------------------------------------------------------------------------*/
+static int do_fill_directive(AssemblerContext* pContext, char* cpCurrentStatementPosition)
+{
+    int iFunctionReturnValue;
+
+    uint32_t iCount;
+    uint32_t iCounter;
+
+    int16_t* ipProgramMemory;
+
+    ExpressionInfo expressionInfo;
+
+    iFunctionReturnValue = do_count_expression(pContext, &cpCurrentStatementPosition, &iCount);
+    if(iFunctionReturnValue != EXIT_SUCCESS)
+        return iFunctionReturnValue;
+
+    //The count must be followed by a comma and the value.
+    while(isspace(*cpCurrentStatementPosition) != 0)
+        cpCurrentStatementPosition++;
+
+    if(*cpCurrentStatementPosition == '\0' || *cpCurrentStatementPosition == ';')
+    {
+        print_error(__func__, UnexpectedEndOfStatementSyntaxError);
+        show_line_error(pContext, cpCurrentStatementPosition - pContext->m_lexer.m_cpSourceLine);
+        return -UnexpectedEndOfStatementSyntaxError;
+    }
+    else if(*cpCurrentStatementPosition != ',')
+    {
+        print_error(__func__, EndOfStatementExpectedError);
+        show_line_error(pContext, cpCurrentStatementPosition - pContext->m_lexer.m_cpSourceLine);
+        return -EndOfStatementExpectedError;
+    }
+
+    cpCurrentStatementPosition++;
+    while(isspace(*cpCurrentStatementPosition) != 0)
+        cpCurrentStatementPosition++;
+
+    //This should be the start of the value.
+    expressionInfo.m_cpStart = cpCurrentStatementPosition;
+
+    //If this is pass one the value isn't needed yet.  Compile it now so pass two
+    //doesn't have to parse it.
+    if(pContext->m_lexer.m_lexerInfo.m_iPass == PassOne)
+    {
+        iFunctionReturnValue = compile_expression(pContext, cpCurrentStatementPosition);
+        if(iFunctionReturnValue != EXIT_SUCCESS)
+        {
+            print_error(__func__, (uint8_t)(-iFunctionReturnValue));
+            return iFunctionReturnValue;
+        }
+
+        pContext->m_lexer.m_lexerInfo.m_iLocationCounter += iCount;
+        return EXIT_SUCCESS;
+    }
+
+    //This is pass two so do a full evaluation.
+    iFunctionReturnValue = do_expression(pContext, &cpCurrentStatementPosition, &(expressionInfo.m_iValue));
+    if(iFunctionReturnValue != EXIT_SUCCESS)
+    {
+        print_error(__func__, (uint8_t)(-iFunctionReturnValue));
+        show_line_error(pContext, cpCurrentStatementPosition - pContext->m_lexer.m_cpSourceLine);
+        return iFunctionReturnValue;
+    }
+
+    //The value must be the last thing in the statement.
+    if(*cpCurrentStatementPosition != '\0' && *cpCurrentStatementPosition != ';')
+    {
+        print_error(__func__, EndOfStatementExpectedError);
+        show_line_error(pContext, cpCurrentStatementPosition - pContext->m_lexer.m_cpSourceLine);
         return -EndOfStatementExpectedError;
     }
 
+    //Number retrieved, check that it is a byte.
+    if(expressionInfo.m_iValue < 0 || expressionInfo.m_iValue > 255)
+    {
+        print_error(__func__, InvalidValueError);
+        show_line_error(pContext, expressionInfo.m_cpStart - pContext->m_lexer.m_cpSourceLine);
+        return -InvalidValueError;
+    }
+
+    //Store the value in every byte.  The count was checked against the program
+    //memory in pass one.
+    ipProgramMemory = &pContext->m_lexer.m_lexerInfo.m_iaProgramMemory[pContext->m_lexer.m_lexerInfo.m_iLocationCounter];
+    for(iCounter = 0; iCounter < iCount; iCounter++)
+        ipProgramMemory[iCounter] = (int16_t)(expressionInfo.m_iValue);
+
+    pContext->m_lexer.m_lexerInfo.m_iLocationCounter += iCount;
+
     return EXIT_SUCCESS;
 }
 
@@ -2187,11 +2689,12 @@ static int do_equ_directive(char* cpCurrentStatementPosition, char* cpSymbol)
  * Function Description:  Attempts to parse out the number following the ORG
  *                        directive.
  * Parameters:
+ * pContext - Pointer to the assembler context.
  * cpCurrentStatementPosition - Character pointer to the current position within
  *                              the statement section.
  * Returns:  Zero for success and negative number for failure.
 ------------------------------------------------------------------------------*/
-static int do_org_directive(char* cpCurrentStatementPosition)
+static int do_org_directive(AssemblerContext* pContext, char* cpCurrentStatementPosition)
 {
     int iFunctionReturnValue;
 
@@ -2199,10 +2702,10 @@ static int do_org_directive(char* cpCurrentStatementPosition)
 
     //We need an expression after ORG.  If we are beyond the end of statement
     //then this is an error.
-    if(cpCurrentStatementPosition > s_lexerInfo.m_cpEndOfStatement)
+    if(cpCurrentStatementPosition > pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement)
     {
         print_error(__func__, UnexpectedEndOfStatementSyntaxError);
-        show_line_error(cpCurrentStatementPosition - s_cpSourceLine);
+        show_line_error(pContext, cpCurrentStatementPosition - pContext->m_lexer.m_cpSourceLine);
         return -UnexpectedEndOfStatementSyntaxError;
     }
 
@@ -2215,14 +2718,14 @@ static int do_org_directive(char* cpCurrentStatementPosition)
     expressionInfo.m_cpStart = cpCurrentStatementPosition;
 
     //If we haven't yet marked the start of the expression then do it now.
-    if(s_lexerInfo.m_cpStatementExpresionStart == NULL)
-        s_lexerInfo.m_cpStatementExpresionStart = cpCurrentStatementPosition;
+    if(pContext->m_lexer.m_lexerInfo.m_cpStatementExpresionStart == NULL)
+        pContext->m_lexer.m_lexerInfo.m_cpStatementExpresionStart = cpCurrentStatementPosition;
 
-    iFunctionReturnValue = do_expression(&cpCurrentStatementPosition, &(expressionInfo.m_iValue));
+    iFunctionReturnValue = do_expression(pContext, &cpCurrentStatementPosition, &(expressionInfo.m_iValue));
     if(iFunctionReturnValue != EXIT_SUCCESS)
     {
         print_error(__func__, (uint8_t)(-iFunctionReturnValue));
-        show_line_error(cpCurrentStatementPosition - s_cpSourceLine);
+        show_line_error(pContext, cpCurrentStatementPosition - pContext->m_lexer.m_cpSourceLine);
         return iFunctionReturnValue;
     }
 
@@ -2235,27 +2738,43 @@ static int do_org_directive(char* cpCurrentStatementPosition)
         if(expressionInfo.m_iValue < 0 || expressionInfo.m_iValue >= MAX_PROGRAM_MEMORY)
         {
             print_error(__func__, InvalidValueError);
-            show_line_error(expressionInfo.m_cpStart - s_cpSourceLine);
+            show_line_error(pContext, expressionInfo.m_cpStart - pContext->m_lexer.m_cpSourceLine);
             return -InvalidValueError;
         }
 
         //The value is within program memory.  Check if the location counter will
         //be moved backwards.
-        if((uint32_t)(expressionInfo.m_iValue) < s_lexerInfo.m_iLocationCounter)
+        if((uint32_t)(expressionInfo.m_iValue) < pContext->m_lexer.m_lexerInfo.m_iLocationCounter)
         {
             print_error(__func__, LocationCounterBackwards);
-            show_line_error(expressionInfo.m_cpStart - s_cpSourceLine);
+            show_line_error(pContext, expressionInfo.m_cpStart - pContext->m_lexer.m_cpSourceLine);
             return -LocationCounterBackwards;
         }
 
-        //Value is valid, update the location counter.
-        s_lexerInfo.m_iLocationCounter = (uint32_t)(expressionInfo.m_iValue);
+        //Value is valid.  The layout moves the location counter the same way.
+        //A pass one chunk knows where it is from its first ORG on.
+        if(pContext->m_lexer.m_lexerInfo.m_iPass == PassOne)
+        {
+            iFunctionReturnValue = add_layout_org(pContext, get_number_of_compiled_expressions(pContext) - 1, pContext->m_lexer.m_lexerInfo.m_iLocationCounter, (uint32_t)(expressionInfo.m_iValue));
+            if(iFunctionReturnValue != EXIT_SUCCESS)
+                return iFunctionReturnValue;
+
+            if(pContext->m_lexer.m_bIsLocationCounterRelative == TRUE)
+            {
+                pContext->m_lexer.m_iLocationCounterBeforeOrg = pContext->m_lexer.m_lexerInfo.m_iLocationCounter;
+                pContext->m_lexer.m_iLocationCounterAfterOrg = (uint32_t)(expressionInfo.m_iValue);
+                pContext->m_lexer.m_bIsLocationCounterRelative = FALSE;
+            }
+        }
+
+        //Update the location counter.
+        pContext->m_lexer.m_lexerInfo.m_iLocationCounter = (uint32_t)(expressionInfo.m_iValue);
     }
     else
     {
         //There is more.
         print_error(__func__, EndOfStatementExpectedError);
-        show_line_error(cpCurrentStatementPosition - s_cpSourceLine);
+        show_line_error(pContext, cpCurrentStatementPosition - pContext->m_lexer.m_cpSourceLine);
         return -EndOfStatementExpectedError;
     }
 
@@ -2263,38 +2782,1188 @@ static int do_org_directive(char* cpCurrentStatementPosition)
 }
 
 /*------------------------------------------------------------------------------
- * Function name:  show_line_error
- * Function Description:  Prints information about where an error occurred in a
- *                        source file line.
+ * Function name:  do_word_directive
+ * Function Description:  Attempts to parse out the number(s) following the WORD
+ *                        directive.  Each is stored in two bytes, low byte
+ *                        first, the same as an absolute operand.
  * Parameters:
- * iSourceLineErrorIndex - The index into the source line where the error
- *                         occurred.
- * Returns:  None.
+ * pContext - Pointer to the assembler context.
+ * cpCurrentStatementPosition - Character pointer to the current position within
+ *                              the statement section.
+ * Returns:  Zero for success and negative number for failure.
 ------------------------------------------------------------------------------*/
-static void show_line_error(uint32_t iSourceLineErrorIndex)
+static int do_word_directive(AssemblerContext* pContext, char* cpCurrentStatementPosition)
 {
-    printf("Line %u:\n", s_lexerInfo.m_iSourceLineNumber);
-    printf("%s", s_cpSourceLine);
-    printf( "%*s\n", iSourceLineErrorIndex + 1, "^" );
-}
+    uint8_t iState;
 
-/*------------------------------------------------------------------------------
- * Function name:  print_symbol_to_table
- * Function Description:  Prints symbol information to the symbol table in the
- *                        listing file.
- * Parameters:
- * pNode - Pointer to the node from which to print the symbol name and value.
- * Returns:  None.
-------------------------------------------------------------------------------*/
-static void print_symbol_to_table(BSTreeNode* pNode)
-{
-    char caText[LISTING_FILE_MAX_COLUMNS + NULL_TERMINATING_BYTE_LENGTH];
+    int iFunctionReturnValue;
+
+    ExpressionInfo expressionInfo;
+
+    //Initialize state.
+    iState = CheckForExpression;
+
+    //Loop until the last character of the statement is used.
+    while(cpCurrentStatementPosition <= pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement)
+    {
+        //Do work based on state.
+        switch(iState)
+        {
+            case CheckForExpression :
+                //Get the expression.  First eliminate leading white spaces.
+                while(isspace(*cpCurrentStatementPosition) != 0)
+                    cpCurrentStatementPosition++;
+
+                //We are pointing at the first character of the expression.
+                expressionInfo.m_cpStart = cpCurrentStatementPosition;
+
+                //If we haven't yet marked the start of the expression section
+                //then do it now.
+                if(pContext->m_lexer.m_lexerInfo.m_cpStatementExpresionStart == NULL)
+                    pContext->m_lexer.m_lexerInfo.m_cpStatementExpresionStart = cpCurrentStatementPosition;
+
+                //If this is pass one we don't need the value of the expression.
+                if(pContext->m_lexer.m_lexerInfo.m_iPass == PassOne)
+                {
+                    //Compile the expression now so pass two doesn't have to
+                    //parse it.
+                    iFunctionReturnValue = compile_expression(pContext, cpCurrentStatementPosition);
+                    if(iFunctionReturnValue != EXIT_SUCCESS)
+                    {
+                        print_error(__func__, (uint8_t)(-iFunctionReturnValue));
+                        return iFunctionReturnValue;
+                    }
+
+                    //Skip to the comma which indicates another expression.  Care
+                    //must be taken as a comma may be a literal character.
+                    while(*cpCurrentStatementPosition != ',' && cpCurrentStatementPosition <= pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement)
+                    {
+                        if(*cpCurrentStatementPosition == '\'')
+                            cpCurrentStatementPosition += 2;
+                        else
+                            cpCurrentStatementPosition++;
+                    }
+
+                    //Increment the location counter past the word.
+                    pContext->m_lexer.m_lexerInfo.m_iLocationCounter += 2;
+                }
+                else
+                {
+                    //This is pass two so do a full evaluation.
+                    iFunctionReturnValue = do_expression(pContext, &cpCurrentStatementPosition, &(expressionInfo.m_iValue));
+                    if(iFunctionReturnValue != EXIT_SUCCESS)
+                    {
+                        print_error(__func__, (uint8_t)(-iFunctionReturnValue));
+                        show_line_error(pContext, cpCurrentStatementPosition - pContext->m_lexer.m_cpSourceLine);
+                        return iFunctionReturnValue;
+                    }
+
+                    //Number retrieved, check that it fits in a word.
+                    if(expressionInfo.m_iValue < 0 || expressionInfo.m_iValue > 0xFFFF)
+                    {
+                        print_error(__func__, InvalidValueError);
+                        show_line_error(pContext, cpCurrentStatementPosition - pContext->m_lexer.m_cpSourceLine);
+                        return -InvalidValueError;
+                    }
+
+                    //Number value is valid, store it at the current location low
+                    //byte first.
+                    pContext->m_lexer.m_lexerInfo.m_iaProgramMemory[pContext->m_lexer.m_lexerInfo.m_iLocationCounter] = (int16_t)(expressionInfo.m_iValue & 0xFF);
+                    pContext->m_lexer.m_lexerInfo.m_iaProgramMemory[pContext->m_lexer.m_lexerInfo.m_iLocationCounter + 1] = (int16_t)((expressionInfo.m_iValue >> 8) & 0xFF);
+
+                    //Increment the location counter past the word.
+                    pContext->m_lexer.m_lexerInfo.m_iLocationCounter += 2;
+                }
+
+                //Switch state to checking for a comma.
+                iState = CheckForComma;
+                break;
+            case CheckForComma :
+                //We are checking a a comma.  If we are at a white space
+                //then skip it.  Otherwise it must be a comma.
+                if(isspace(*cpCurrentStatementPosition) != 0)
+                {
+                    cpCurrentStatementPosition++;
+                }
+                else if(*cpCurrentStatementPosition == ',')
+                {
+                    iState = CheckForExpression;
+                    cpCurrentStatementPosition++;
+                }
+                else
+                {
+                    print_error(__func__, EndOfStatementExpectedError);
+                    show_line_error(pContext, cpCurrentStatementPosition - pContext->m_lexer.m_cpSourceLine);
+                    return -EndOfStatementExpectedError;
+                }
+                break;
+            default :
+                //Should never get here but put in for good programming practice.
+                break;
+        }
+    }
+
+    //We are out of the while() loop so we are done with the statement section.
+    //If the state is looking for a comma this is success.  Anything else is an
+    //error.
+    if(iState == CheckForComma)
+    {
+        return EXIT_SUCCESS;
+    }
+    else
+    {
+        print_error(__func__, UnexpectedEndOfStatementSyntaxError);
+        show_line_error(pContext, cpCurrentStatementPosition - pContext->m_lexer.m_cpSourceLine);
+        return -UnexpectedEndOfStatementSyntaxError;
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  do_count_expression
+ * Function Description:  Gets the number of bytes for the DS and FILL
+ *                        directives.  The count changes the location counter so
+ *                        it must be known during pass one.  During pass one the
+ *                        layout is told about it in case it depends on labels.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * cppCurrentStatementPosition - Pointer to a character pointer which is the
+ *                               current position within the statement section.
+ *                               On return it is past the expression.
+ * ipCount - Pointer to where to store the count.
+ * Returns:  Zero for success and negative number for failure.
+------------------------------------------------------------------------------*/
+static int do_count_expression(AssemblerContext* pContext, char** cppCurrentStatementPosition, uint32_t* ipCount)
+{
+    int iFunctionReturnValue;
+
+    ExpressionInfo expressionInfo;
+
+    //We need an expression after the directive.  If we are beyond the end of
+    //statement then this is an error.
+    if(*cppCurrentStatementPosition > pContext->m_lexer.m_lexerInfo.m_cpEndOfStatement)
+    {
+        print_error(__func__, UnexpectedEndOfStatementSyntaxError);
+        show_line_error(pContext, *cppCurrentStatementPosition - pContext->m_lexer.m_cpSourceLine);
+        return -UnexpectedEndOfStatementSyntaxError;
+    }
+
+    //There is something beyond the directive.  Eliminate leading white spaces.
+    while(isspace(**cppCurrentStatementPosition) != 0)
+        (*cppCurrentStatementPosition)++;
+
+    //This should be the start of an expression.
+    expressionInfo.m_cpStart = *cppCurrentStatementPosition;
+
+    //If we haven't yet marked the start of the expression then do it now.
+    if(pContext->m_lexer.m_lexerInfo.m_cpStatementExpresionStart == NULL)
+        pContext->m_lexer.m_lexerInfo.m_cpStatementExpresionStart = *cppCurrentStatementPosition;
+
+    iFunctionReturnValue = do_expression(pContext, cppCurrentStatementPosition, &(expressionInfo.m_iValue));
+    if(iFunctionReturnValue != EXIT_SUCCESS)
+    {
+        print_error(__func__, (uint8_t)(-iFunctionReturnValue));
+        show_line_error(pContext, *cppCurrentStatementPosition - pContext->m_lexer.m_cpSourceLine);
+        return iFunctionReturnValue;
+    }
+
+    //We have the number, check that it fits within the program memory.
+    if(expressionInfo.m_iValue < 0 || (uint32_t)(expressionInfo.m_iValue) > MAX_PROGRAM_MEMORY - pContext->m_lexer.m_lexerInfo.m_iLocationCounter)
+    {
+        print_error(__func__, InvalidValueError);
+        show_line_error(pContext, expressionInfo.m_cpStart - pContext->m_lexer.m_cpSourceLine);
+        return -InvalidValueError;
+    }
+
+    if(pContext->m_lexer.m_lexerInfo.m_iPass == PassOne)
+    {
+        iFunctionReturnValue = add_layout_space(pContext, get_number_of_compiled_expressions(pContext) - 1, pContext->m_lexer.m_lexerInfo.m_iLocationCounter, (uint32_t)(expressionInfo.m_iValue));
+        if(iFunctionReturnValue != EXIT_SUCCESS)
+            return iFunctionReturnValue;
+    }
+
+    *ipCount = (uint32_t)(expressionInfo.m_iValue);
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  measure_display_character
+ * Function Description:  Adds a source line character to the display length of
+ *                        the line as it will appear in the listing file.  White
+ *                        spaces are not displayed unless they are within double
+ *                        quotes.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * iIndex - The index into the source line of the character to measure.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void measure_display_character(AssemblerContext* pContext, uint32_t iIndex)
+{
+    uint8_t bIsEndOfQuote;
+
+    //A double quote starts or ends a quote unless it is escaped by a backslash.
+    bIsEndOfQuote = (pContext->m_lexer.m_cpSourceLine[iIndex] == '"' && (iIndex == 0 || pContext->m_lexer.m_cpSourceLine[iIndex - 1] != '\\')) ? TRUE : FALSE;
+
+    if(pContext->m_lexer.m_lexerInfo.m_bWithinDoubleQuote == FALSE)
+    {
+        if(isspace(pContext->m_lexer.m_cpSourceLine[iIndex]) == 0)
+            pContext->m_lexer.m_lexerInfo.m_iDisplayLength++;
+
+        if(bIsEndOfQuote == TRUE)
+            pContext->m_lexer.m_lexerInfo.m_bWithinDoubleQuote = TRUE;
+    }
+    else
+    {
+        pContext->m_lexer.m_lexerInfo.m_iDisplayLength++;
+
+        if(bIsEndOfQuote == TRUE)
+            pContext->m_lexer.m_lexerInfo.m_bWithinDoubleQuote = FALSE;
+    }
+
+    //Trailing white spaces are not part of the statement so only a non-white
+    //space character moves the end of the statement.
+    if(isspace(pContext->m_lexer.m_cpSourceLine[iIndex]) == 0)
+        pContext->m_lexer.m_lexerInfo.m_iStatementDisplayLength = pContext->m_lexer.m_lexerInfo.m_iDisplayLength;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  record_line_error
+ * Function Description:  Records an error found on the current source line.
+ *                        File and memory errors, or reaching the maximum number
+ *                        of errors allowed, stop the assembly.  Otherwise the
+ *                        line number is remembered during pass one so that pass
+ *                        two can skip the line, and the assembly carries on.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * iError - The negative error number returned for the line.
+ * Returns:  Zero to carry on with the next line and a negative number to stop.
+------------------------------------------------------------------------------*/
+static int record_line_error(AssemblerContext* pContext, int iError)
+{
+    uint32_t* ipNewFailedLines;
+
+    //These errors leave nothing to carry on with.
+    switch(-iError)
+    {
+        case MallocReturnedNull:
+        case FileAlreadyOpen:
+        case FileOpenError:
+        case FileNotOpen:
+        case GetlineError:
+        case ResetFileError:
+        case FileWriteError:
+            return iError;
+        default:
+            break;
+    }
+
+    pContext->m_lexer.m_iErrorCount++;
+    if(pContext->m_lexer.m_iErrorCount == 1)
+        pContext->m_lexer.m_iFirstError = iError;
+
+    //Check if the maximum number of errors has been reached.  Zero means there is
+    //no maximum.
+    if(get_max_errors(pContext) != 0 && pContext->m_lexer.m_iErrorCount >= get_max_errors(pContext))
+    {
+        if(get_max_errors(pContext) > 1)
+            print_message("Maximum of %u errors reached, assembly stopped.\n", get_max_errors(pContext));
+
+        return pContext->m_lexer.m_iFirstError;
+    }
+
+    //Lines are read in order so the list of failed lines stays sorted.  In
+    //pass two the line was given a length in pass one that is now unknown, so
+    //the location counter is unknown until the next label.
+    if(pContext->m_lexer.m_lexerInfo.m_iPass == PassTwo)
+    {
+        pContext->m_lexer.m_bIsLocationCounterUnknown = TRUE;
+    }
+    else
+    {
+        if(pContext->m_lexer.m_iFailedLineCount == pContext->m_lexer.m_iFailedLineCapacity)
+        {
+            pContext->m_lexer.m_iFailedLineCapacity = (pContext->m_lexer.m_iFailedLineCapacity == 0) ? FAILED_LINES_INITIAL_CAPACITY : pContext->m_lexer.m_iFailedLineCapacity * 2;
+            ipNewFailedLines = realloc(pContext->m_lexer.m_ipFailedLines, pContext->m_lexer.m_iFailedLineCapacity * sizeof(uint32_t));
+            if(ipNewFailedLines == NULL)
+            {
+                print_error(__func__, MallocReturnedNull);
+                return -MallocReturnedNull;
+            }
+
+            pContext->m_lexer.m_ipFailedLines = ipNewFailedLines;
+        }
+
+        pContext->m_lexer.m_ipFailedLines[pContext->m_lexer.m_iFailedLineCount] = pContext->m_lexer.m_lexerInfo.m_iSourceLineNumber;
+        pContext->m_lexer.m_iFailedLineCount++;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  show_line_error
+ * Function Description:  Prints information about where an error occurred in a
+ *                        source file line.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * iSourceLineErrorIndex - The index into the source line where the error
+ *                         occurred.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void show_line_error(AssemblerContext* pContext, uint32_t iSourceLineErrorIndex)
+{
+    //The line goes with an error message so it isn't shown if those aren't.
+    if(is_error_output_muted() == TRUE)
+        return;
+
+    print_message("Line %u:\n", pContext->m_lexer.m_lexerInfo.m_iSourceLineNumber);
+    print_message("%s", pContext->m_lexer.m_cpSourceLine);
+    print_message( "%*s\n", iSourceLineErrorIndex + 1, "^" );
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  store_label_line
+ * Function Description:  Adds the current source line, which has a label, to
+ *                        the end of the list of label lines.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * pSymbolInfo - Pointer to the label's symbol information.
+ * Returns:  Zero for success and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+static int store_label_line(AssemblerContext* pContext, SymbolInfo* pSymbolInfo)
+{
+    LabelLine* pNewLabelLines;
+
+    if(pContext->m_lexer.m_iNumberOfLabelLines == pContext->m_lexer.m_iLabelLinesCapacity)
+    {
+        pContext->m_lexer.m_iLabelLinesCapacity = (pContext->m_lexer.m_iLabelLinesCapacity == 0) ? LABEL_LINES_INITIAL_CAPACITY : pContext->m_lexer.m_iLabelLinesCapacity * 2;
+        pNewLabelLines = realloc(pContext->m_lexer.m_pLabelLines, pContext->m_lexer.m_iLabelLinesCapacity * sizeof(LabelLine));
+        if(pNewLabelLines == NULL)
+        {
+            print_error(__func__, MallocReturnedNull);
+            return -MallocReturnedNull;
+        }
+
+        pContext->m_lexer.m_pLabelLines = pNewLabelLines;
+    }
+
+    pContext->m_lexer.m_pLabelLines[pContext->m_lexer.m_iNumberOfLabelLines].m_iSourceLineNumber = pContext->m_lexer.m_lexerInfo.m_iSourceLineNumber;
+    pContext->m_lexer.m_pLabelLines[pContext->m_lexer.m_iNumberOfLabelLines].m_iFileOffset = get_source_line_file_offset(pContext);
+    pContext->m_lexer.m_pLabelLines[pContext->m_lexer.m_iNumberOfLabelLines].m_pSymbolInfo = pSymbolInfo;
+    pContext->m_lexer.m_iNumberOfLabelLines++;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  reset_pass_one
+ * Function Description:  Throws away everything pass one has found so it can be
+ *                        started from the top of the source file.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void reset_pass_one(AssemblerContext* pContext)
+{
+    uint32_t iCounter;
+
+    //Clear out the lexer information structure and any symbols left from the
+    //last source file.
+    memset(&pContext->m_lexer.m_lexerInfo, 0, sizeof(pContext->m_lexer.m_lexerInfo));
+    while(pContext->m_lexer.m_pSymbolTableRoot != NULL)
+        bstree_delete(&pContext->m_lexer.m_pSymbolTableRoot, pContext->m_lexer.m_pSymbolTableRoot);
+
+    //No errors have been found yet.
+    pContext->m_lexer.m_iErrorCount = 0;
+    pContext->m_lexer.m_iFirstError = EXIT_SUCCESS;
+    pContext->m_lexer.m_iFailedLineCount = 0;
+    pContext->m_lexer.m_iNumberOfStringLiterals = 0;
+    pContext->m_lexer.m_iStringPayloadsSize = 0;
+    pContext->m_lexer.m_iNumberOfLabelLines = 0;
+
+    //Initialize program memory storage to -1.  When it comes time to write the
+    //binary file we will be able to easily determine where the first byte of
+    //code starts.
+    for(iCounter = 0; iCounter < MAX_PROGRAM_MEMORY; iCounter++)
+        pContext->m_lexer.m_lexerInfo.m_iaProgramMemory[iCounter] = -1;
+
+    //Expressions are compiled during pass one and used again in pass two.
+    reset_compiled_expressions(pContext);
+    reset_layout(pContext);
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  do_pass_one_chunks
+ * Function Description:  Splits a large source file into chunks of about the
+ *                        same number of bytes and does pass one of each chunk
+ *                        with a thread of its own.  Each chunk counts its lines
+ *                        and location counter from zero.  The chunks are then
+ *                        put together in source order, each one starting where
+ *                        the one before it ended.  A chunk stops at its first
+ *                        error without showing it, and a chunk after the first
+ *                        one stops at an expression it can't work out on its
+ *                        own.  If any chunk stopped, defines a symbol an
+ *                        earlier chunk did, or has an ORG directive that turns
+ *                        out to move the location counter backwards, pass one
+ *                        is left to be done a line at a time.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  PASS_ONE_CHUNKS_SUCCESS if pass one was done by the chunks, zero if
+ *           it still has to be done a line at a time, and a negative number if
+ *           an error occurs.
+------------------------------------------------------------------------------*/
+static int do_pass_one_chunks(AssemblerContext* pContext)
+{
+    int iReturnValue;
+
+    uint8_t bIsEndFound;
+
+    uint32_t iNumberOfChunks;
+    uint32_t iNumberOfUsedChunks;
+    uint32_t iChunk;
+
+    size_t iFileSize;
+
+    volatile LONG iIsChunkFailed;
+
+    SYSTEM_INFO systemInfo;
+
+    PassOneChunk* pChunks;
+
+    //Each chunk needs enough of the file to be worth a thread, and there is no
+    //point in more chunks than processors.
+    iReturnValue = get_source_file_size(pContext, &iFileSize);
+    if(iReturnValue != EXIT_SUCCESS)
+        return iReturnValue;
+
+    GetSystemInfo(&systemInfo);
+    iNumberOfChunks = (uint32_t)bmc_min(iFileSize / PASS_ONE_CHUNK_MIN_BYTES, (size_t)systemInfo.dwNumberOfProcessors);
+    iNumberOfChunks = bmc_min(iNumberOfChunks, (uint32_t)PASS_ONE_MAX_CHUNKS);
+    if(iNumberOfChunks < 2)
+        return EXIT_SUCCESS;
+
+    pChunks = calloc(iNumberOfChunks, sizeof(PassOneChunk));
+    if(pChunks == NULL)
+    {
+        print_error(__func__, MallocReturnedNull);
+        return -MallocReturnedNull;
+    }
+
+    iReturnValue = EXIT_SUCCESS;
+    iIsChunkFailed = FALSE;
+    for(iChunk = 0; iChunk < iNumberOfChunks && iReturnValue == EXIT_SUCCESS; iChunk++)
+    {
+        pChunks[iChunk].m_ipIsChunkFailed = &iIsChunkFailed;
+        iReturnValue = create_pass_one_chunk(pContext, &pChunks[iChunk], (size_t)(((uint64_t)iFileSize * iChunk) / iNumberOfChunks), (size_t)(((uint64_t)iFileSize * (iChunk + 1)) / iNumberOfChunks));
+    }
+
+    //Start a thread for each chunk and wait for all of them to finish.  If a
+    //thread can't be started the chunks count as failed.
+    for(iChunk = 0; iChunk < iNumberOfChunks && iReturnValue == EXIT_SUCCESS; iChunk++)
+    {
+        pChunks[iChunk].m_hThread = CreateThread(NULL, 0, pass_one_chunk_thread, &pChunks[iChunk], 0, NULL);
+        if(pChunks[iChunk].m_hThread == NULL)
+            iReturnValue = EXIT_FAILURE;
+    }
+
+    for(iChunk = 0; iChunk < iNumberOfChunks; iChunk++)
+    {
+        if(pChunks[iChunk].m_hThread != NULL)
+        {
+            WaitForSingleObject(pChunks[iChunk].m_hThread, INFINITE);
+            CloseHandle(pChunks[iChunk].m_hThread);
+        }
+    }
+
+    //The lines after an END directive aren't part of the assembly, so neither
+    //are the chunks after it.  Any other chunk that failed means pass one has
+    //to be done a line at a time, which is known before anything is merged.
+    bIsEndFound = FALSE;
+    for(iChunk = 0; iChunk < iNumberOfChunks && iReturnValue == EXIT_SUCCESS && bIsEndFound == FALSE; iChunk++)
+    {
+        if(pChunks[iChunk].m_iReturnValue < EXIT_SUCCESS)
+            iReturnValue = EXIT_FAILURE;
+        else if(pChunks[iChunk].m_iReturnValue == END_DIRECTIVE_SUCCESS)
+            bIsEndFound = TRUE;
+    }
+
+    //Put the chunks together in source order.
+    iNumberOfUsedChunks = iChunk;
+    for(iChunk = 0; iChunk < iNumberOfUsedChunks && iReturnValue == EXIT_SUCCESS; iChunk++)
+        iReturnValue = merge_pass_one_chunk(pContext, pChunks[iChunk].m_pContext);
+
+    for(iChunk = 0; iChunk < iNumberOfChunks; iChunk++)
+        free_pass_one_chunk(&pChunks[iChunk]);
+
+    free(pChunks);
+
+    //A failed chunk only means the lines have to be done one at a time.
+    if(iReturnValue == EXIT_FAILURE)
+    {
+        reset_pass_one(pContext);
+        pContext->m_lexer.m_lexerInfo.m_iPass = PassOne;
+        return EXIT_SUCCESS;
+    }
+    else if(iReturnValue != EXIT_SUCCESS)
+    {
+        return iReturnValue;
+    }
+
+    //Reading to the end of the file counts one more line, the same as the line
+    //at a time loop.
+    if(bIsEndFound == FALSE)
+        pContext->m_lexer.m_lexerInfo.m_iSourceLineNumber++;
+
+    return PASS_ONE_CHUNKS_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  create_pass_one_chunk
+ * Function Description:  Creates the context of a pass one chunk.  It is a copy
+ *                        of the assembly's context with nothing found yet and
+ *                        its own source file, symbol table, expressions, and
+ *                        layout.  Only the first chunk knows what is in front
+ *                        of it, the expressions of the others are detached.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * pChunk - Pointer to the chunk.
+ * iStartFileOffset - The offset from the beginning of the source file that the
+ *                    chunk starts at.
+ * iEndFileOffset - The offset from the beginning of the source file that the
+ *                  next chunk starts at.
+ * Returns:  Zero for success and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+static int create_pass_one_chunk(AssemblerContext* pContext, PassOneChunk* pChunk, size_t iStartFileOffset, size_t iEndFileOffset)
+{
+    int iReturnValue;
+
+    AssemblerContext* pChunkContext;
+
+    pChunkContext = malloc(sizeof(AssemblerContext));
+    if(pChunkContext == NULL)
+    {
+        print_error(__func__, MallocReturnedNull);
+        return -MallocReturnedNull;
+    }
+
+    memcpy(pChunkContext, pContext, sizeof(AssemblerContext));
+    memset(&pChunkContext->m_files, 0, sizeof(pChunkContext->m_files));
+    share_memory_files(pChunkContext, pContext);
+    memset(&pChunkContext->m_expression, 0, sizeof(pChunkContext->m_expression));
+    memset(&pChunkContext->m_layout, 0, sizeof(pChunkContext->m_layout));
+    memset(&pChunkContext->m_listing, 0, sizeof(pChunkContext->m_listing));
+    pChunkContext->m_lexer.m_pSymbolTableRoot = NULL;
+    pChunkContext->m_lexer.m_ipFailedLines = NULL;
+    pChunkContext->m_lexer.m_iFailedLineCapacity = 0;
+    pChunkContext->m_lexer.m_pStringLiterals = NULL;
+    pChunkContext->m_lexer.m_iStringLiteralsCapacity = 0;
+    pChunkContext->m_lexer.m_ipStringPayloads = NULL;
+    pChunkContext->m_lexer.m_iStringPayloadsCapacity = 0;
+    pChunkContext->m_lexer.m_pLabelLines = NULL;
+    pChunkContext->m_lexer.m_iLabelLinesCapacity = 0;
+    pChunk->m_pContext = pChunkContext;
+    pChunk->m_iStartFileOffset = iStartFileOffset;
+    pChunk->m_iEndFileOffset = iEndFileOffset;
+
+    pChunkContext->m_lexer.m_bIsLocationCounterRelative = TRUE;
+    pChunkContext->m_expression.m_bIsDetached = (iStartFileOffset != 0) ? TRUE : FALSE;
+
+    iReturnValue = open_source_file(pChunkContext);
+    if(iReturnValue != EXIT_SUCCESS)
+        return iReturnValue;
+
+    //A chunk after the first starts with the end of the line before it, which
+    //may be nothing more than the end of line character.
+    if(iStartFileOffset != 0)
+    {
+        iReturnValue = seek_source_file(pChunkContext, iStartFileOffset - 1);
+        if(iReturnValue != EXIT_SUCCESS)
+            return iReturnValue;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  free_pass_one_chunk
+ * Function Description:  Frees the context of a pass one chunk and everything
+ *                        it found that wasn't moved to the assembly's context.
+ * Parameters:
+ * pChunk - Pointer to the chunk.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void free_pass_one_chunk(PassOneChunk* pChunk)
+{
+    if(pChunk->m_pContext == NULL)
+        return;
+
+    close_all_files(pChunk->m_pContext);
+    free_expression_memory(pChunk->m_pContext);
+    free_layout_memory(pChunk->m_pContext);
+    free_lexer_memory(pChunk->m_pContext);
+    free(pChunk->m_pContext);
+    pChunk->m_pContext = NULL;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  pass_one_chunk_thread
+ * Function Description:  The thread function for a pass one chunk.  Errors are
+ *                        not printed by the thread, pass one shows them when it
+ *                        is done again a line at a time.
+ * Parameters:
+ * vpChunk - Pointer to the chunk.
+ * Returns:  Zero.  The chunk's return value is left in the chunk.
+------------------------------------------------------------------------------*/
+static DWORD WINAPI pass_one_chunk_thread(LPVOID vpChunk)
+{
+    PassOneChunk* pChunk = (PassOneChunk*)vpChunk;
+
+    mute_error_output(TRUE);
+    pChunk->m_iReturnValue = assemble_pass_one_chunk(pChunk->m_pContext, pChunk->m_iStartFileOffset, pChunk->m_iEndFileOffset, pChunk->m_ipIsChunkFailed);
+    if(pChunk->m_iReturnValue < EXIT_SUCCESS)
+        InterlockedExchange(pChunk->m_ipIsChunkFailed, TRUE);
+
+    return 0;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  assemble_pass_one_chunk
+ * Function Description:  Does pass one of the lines of a pass one chunk.
+ *                        Unlike the line at a time loop in do_assembly() the
+ *                        first error stops the chunk, and so does another
+ *                        chunk failing.
+ * Parameters:
+ * pContext - Pointer to the chunk's assembler context.
+ * iStartFileOffset - The offset from the beginning of the source file that the
+ *                    chunk starts at.
+ * iEndFileOffset - The offset from the beginning of the source file that the
+ *                  next chunk starts at.
+ * ipIsChunkFailed - Pointer to the flag that is set when a chunk fails.
+ * Returns:  Zero for success, END_DIRECTIVE_SUCCESS if an END directive was
+ *           reached, PASS_ONE_CHUNK_STOPPED if another chunk failed, and a
+ *           negative number if an error occurs.
+------------------------------------------------------------------------------*/
+static int assemble_pass_one_chunk(AssemblerContext* pContext, size_t iStartFileOffset, size_t iEndFileOffset, volatile LONG* ipIsChunkFailed)
+{
+    int iFunctionReturnValue;
+
+    size_t iFileOffset;
+
+    ssize_t iReadSourceFileReturnValue;
+
+    //The rest of the line the chunk starts in belongs to the chunk before it.
+    iFileOffset = iStartFileOffset;
+    if(iStartFileOffset != 0)
+    {
+        iReadSourceFileReturnValue = read_line_from_source_file(pContext, &pContext->m_lexer.m_cpSourceLine);
+        if(iReadSourceFileReturnValue <= 0)
+            return (int)iReadSourceFileReturnValue;
+
+        iFileOffset = get_source_line_file_offset(pContext) + (size_t)iReadSourceFileReturnValue;
+    }
+
+    while(iFileOffset < iEndFileOffset)
+    {
+        if(InterlockedCompareExchange(ipIsChunkFailed, FALSE, FALSE) == TRUE)
+            return PASS_ONE_CHUNK_STOPPED;
+
+        iReadSourceFileReturnValue = read_line_from_source_file(pContext, &pContext->m_lexer.m_cpSourceLine);
+        if(iReadSourceFileReturnValue <= 0)
+            return (int)iReadSourceFileReturnValue;
+
+        pContext->m_lexer.m_lexerInfo.m_iSourceLineNumber++;
+        pContext->m_lexer.m_lexerInfo.m_iSourceLineLength = (uint32_t)iReadSourceFileReturnValue;
+        iFileOffset = get_source_line_file_offset(pContext) + (size_t)iReadSourceFileReturnValue;
+
+        iFunctionReturnValue = parse_source_line(pContext);
+        if(iFunctionReturnValue < EXIT_SUCCESS || iFunctionReturnValue == END_DIRECTIVE_SUCCESS)
+            return iFunctionReturnValue;
+
+        if(pContext->m_lexer.m_lexerInfo.m_iLocationCounter > MAX_PROGRAM_MEMORY)
+            return -ExceededProgramMemoryError;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  merge_pass_one_chunk
+ * Function Description:  Adds what a pass one chunk found to the assembly's
+ *                        context, as if its lines had come right after the
+ *                        lines already done.  The symbols are moved rather
+ *                        than copied so the layout records and label lines
+ *                        of the chunk still point at them.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * pChunkContext - Pointer to the chunk's assembler context.
+ * Returns:  Zero for success, EXIT_FAILURE if the chunk can't be put after the
+ *           lines already done, and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+static int merge_pass_one_chunk(AssemblerContext* pContext, AssemblerContext* pChunkContext)
+{
+    int iReturnValue;
+
+    uint32_t iLineNumberOffset;
+    uint32_t iStartLocationCounter;
+    uint32_t iEndLocationCounter;
+    uint32_t iPayloadOffset;
+    uint32_t iNumberOfItems;
+    uint32_t i;
+
+    StringLiteral* pNewStringLiterals;
+
+    int16_t* ipNewStringPayloads;
+
+    LabelLine* pNewLabelLines;
+
+    BSTreeNode* pNode;
+    BSTreeNode* pChunkNode;
+
+    iLineNumberOffset = pContext->m_lexer.m_lexerInfo.m_iSourceLineNumber;
+    iStartLocationCounter = pContext->m_lexer.m_lexerInfo.m_iLocationCounter;
+
+    //Until its first ORG directive the chunk's location counter is relative to
+    //where it starts.  That ORG can't be behind where the chunk really was.
+    if(pChunkContext->m_lexer.m_bIsLocationCounterRelative == TRUE)
+        iEndLocationCounter = iStartLocationCounter + pChunkContext->m_lexer.m_lexerInfo.m_iLocationCounter;
+    else if(iStartLocationCounter + pChunkContext->m_lexer.m_iLocationCounterBeforeOrg > pChunkContext->m_lexer.m_iLocationCounterAfterOrg)
+        return EXIT_FAILURE;
+    else
+        iEndLocationCounter = pChunkContext->m_lexer.m_lexerInfo.m_iLocationCounter;
+
+    if(iEndLocationCounter > MAX_PROGRAM_MEMORY)
+        return EXIT_FAILURE;
+
+    //Move the symbols to the symbol table.  One that is already there was
+    //defined by an earlier chunk.  The first chunk's symbol table simply
+    //becomes the symbol table.
+    if(pContext->m_lexer.m_pSymbolTableRoot == NULL)
+    {
+        pContext->m_lexer.m_pSymbolTableRoot = pChunkContext->m_lexer.m_pSymbolTableRoot;
+        pChunkContext->m_lexer.m_pSymbolTableRoot = NULL;
+    }
+
+    while(pChunkContext->m_lexer.m_pSymbolTableRoot != NULL)
+    {
+        pChunkNode = pChunkContext->m_lexer.m_pSymbolTableRoot;
+        if(bstree_search(pContext->m_lexer.m_pSymbolTableRoot, pChunkNode->m_vpKey, bstree_key_compare) != NULL)
+            return EXIT_FAILURE;
+
+        pNode = bstree_insert(&pContext->m_lexer.m_pSymbolTableRoot, pChunkNode->m_vpKey, strlen((char*)(pChunkNode->m_vpKey)) + NULL_TERMINATING_BYTE_LENGTH, bstree_key_compare);
+        if(pNode == NULL)
+        {
+            print_error(__func__, MallocReturnedNull);
+            return -MallocReturnedNull;
+        }
+
+        pNode->m_vpDataElement = pChunkNode->m_vpDataElement;
+        pChunkNode->m_vpDataElement = NULL;
+        bstree_delete(&pChunkContext->m_lexer.m_pSymbolTableRoot, pChunkNode);
+    }
+
+    //The layout records refer to the compiled expressions by index so they go
+    //first.
+    iReturnValue = append_layout_records(pContext, pChunkContext, iLineNumberOffset, get_number_of_compiled_expressions(pContext), iStartLocationCounter);
+    if(iReturnValue != EXIT_SUCCESS)
+        return iReturnValue;
+
+    iReturnValue = append_compiled_expressions(pContext, pChunkContext, iLineNumberOffset);
+    if(iReturnValue != EXIT_SUCCESS)
+    {
+        print_error(__func__, MallocReturnedNull);
+        return iReturnValue;
+    }
+
+    add_expression_memo_counts(pContext, pChunkContext);
+
+    //The string literals have their payloads put after the ones already here.
+    iPayloadOffset = pContext->m_lexer.m_iStringPayloadsSize;
+    if(iPayloadOffset + pChunkContext->m_lexer.m_iStringPayloadsSize > pContext->m_lexer.m_iStringPayloadsCapacity)
+    {
+        if(pContext->m_lexer.m_iStringPayloadsCapacity == 0)
+            pContext->m_lexer.m_iStringPayloadsCapacity = STRING_PAYLOADS_INITIAL_SIZE;
+
+        while(iPayloadOffset + pChunkContext->m_lexer.m_iStringPayloadsSize > pContext->m_lexer.m_iStringPayloadsCapacity)
+            pContext->m_lexer.m_iStringPayloadsCapacity *= 2;
+
+        ipNewStringPayloads = realloc(pContext->m_lexer.m_ipStringPayloads, pContext->m_lexer.m_iStringPayloadsCapacity * sizeof(int16_t));
+        if(ipNewStringPayloads == NULL)
+        {
+            print_error(__func__, MallocReturnedNull);
+            return -MallocReturnedNull;
+        }
+
+        pContext->m_lexer.m_ipStringPayloads = ipNewStringPayloads;
+    }
+
+    if(pChunkContext->m_lexer.m_iStringPayloadsSize != 0)
+        memcpy(&pContext->m_lexer.m_ipStringPayloads[iPayloadOffset], pChunkContext->m_lexer.m_ipStringPayloads, pChunkContext->m_lexer.m_iStringPayloadsSize * sizeof(int16_t));
+
+    pContext->m_lexer.m_iStringPayloadsSize += pChunkContext->m_lexer.m_iStringPayloadsSize;
+
+    iNumberOfItems = pContext->m_lexer.m_iNumberOfStringLiterals + pChunkContext->m_lexer.m_iNumberOfStringLiterals;
+    if(iNumberOfItems > pContext->m_lexer.m_iStringLiteralsCapacity)
+    {
+        while(iNumberOfItems > pContext->m_lexer.m_iStringLiteralsCapacity)
+            pContext->m_lexer.m_iStringLiteralsCapacity = (pContext->m_lexer.m_iStringLiteralsCapacity == 0) ? STRING_LITERALS_INITIAL_CAPACITY : pContext->m_lexer.m_iStringLiteralsCapacity * 2;
+
+        pNewStringLiterals = realloc(pContext->m_lexer.m_pStringLiterals, pContext->m_lexer.m_iStringLiteralsCapacity * sizeof(StringLiteral));
+        if(pNewStringLiterals == NULL)
+        {
+            print_error(__func__, MallocReturnedNull);
+            return -MallocReturnedNull;
+        }
+
+        pContext->m_lexer.m_pStringLiterals = pNewStringLiterals;
+    }
+
+    for(i = 0; i < pChunkContext->m_lexer.m_iNumberOfStringLiterals; i++)
+    {
+        pContext->m_lexer.m_pStringLiterals[pContext->m_lexer.m_iNumberOfStringLiterals] = pChunkContext->m_lexer.m_pStringLiterals[i];
+        pContext->m_lexer.m_pStringLiterals[pContext->m_lexer.m_iNumberOfStringLiterals].m_iSourceLineNumber += iLineNumberOffset;
+        pContext->m_lexer.m_pStringLiterals[pContext->m_lexer.m_iNumberOfStringLiterals].m_iPayloadOffset += iPayloadOffset;
+        pContext->m_lexer.m_iNumberOfStringLiterals++;
+    }
+
+    //The label lines already have the file offsets of their lines.
+    iNumberOfItems = pContext->m_lexer.m_iNumberOfLabelLines + pChunkContext->m_lexer.m_iNumberOfLabelLines;
+    if(iNumberOfItems > pContext->m_lexer.m_iLabelLinesCapacity)
+    {
+        while(iNumberOfItems > pContext->m_lexer.m_iLabelLinesCapacity)
+            pContext->m_lexer.m_iLabelLinesCapacity = (pContext->m_lexer.m_iLabelLinesCapacity == 0) ? LABEL_LINES_INITIAL_CAPACITY : pContext->m_lexer.m_iLabelLinesCapacity * 2;
+
+        pNewLabelLines = realloc(pContext->m_lexer.m_pLabelLines, pContext->m_lexer.m_iLabelLinesCapacity * sizeof(LabelLine));
+        if(pNewLabelLines == NULL)
+        {
+            print_error(__func__, MallocReturnedNull);
+            return -MallocReturnedNull;
+        }
+
+        pContext->m_lexer.m_pLabelLines = pNewLabelLines;
+    }
+
+    for(i = 0; i < pChunkContext->m_lexer.m_iNumberOfLabelLines; i++)
+    {
+        pContext->m_lexer.m_pLabelLines[pContext->m_lexer.m_iNumberOfLabelLines] = pChunkContext->m_lexer.m_pLabelLines[i];
+        pContext->m_lexer.m_pLabelLines[pContext->m_lexer.m_iNumberOfLabelLines].m_iSourceLineNumber += iLineNumberOffset;
+        pContext->m_lexer.m_iNumberOfLabelLines++;
+    }
+
+    pContext->m_lexer.m_lexerInfo.m_iLargestSymbolLength = bmc_max(pContext->m_lexer.m_lexerInfo.m_iLargestSymbolLength, pChunkContext->m_lexer.m_lexerInfo.m_iLargestSymbolLength);
+    pContext->m_lexer.m_lexerInfo.m_iLargestOperandLength = bmc_max(pContext->m_lexer.m_lexerInfo.m_iLargestOperandLength, pChunkContext->m_lexer.m_lexerInfo.m_iLargestOperandLength);
+
+    //The chunk's lines are now done.
+    pContext->m_lexer.m_lexerInfo.m_iSourceLineNumber = iLineNumberOffset + pChunkContext->m_lexer.m_lexerInfo.m_iSourceLineNumber;
+    pContext->m_lexer.m_lexerInfo.m_iLocationCounter = iEndLocationCounter;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  do_pass_two_chunks
+ * Function Description:  Splits pass two into chunks of source lines that start
+ *                        at label lines and assembles each chunk with a thread
+ *                        of its own.  The listing lines of each chunk are
+ *                        added to those of the assembly in source order.
+ *                        A chunk stops at its first error without showing it
+ *                        and then pass two is left to be done a line at a time,
+ *                        which shows the errors as usual.  The same is done if
+ *                        a chunk doesn't end at the location counter the next
+ *                        one starts at.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * iNumberOfSourceLines - The number of lines pass one read.
+ * Returns:  PASS_TWO_CHUNKS_SUCCESS if pass two was done by the chunks, zero if
+ *           it still has to be done a line at a time, and a negative number if
+ *           an error occurs.
+------------------------------------------------------------------------------*/
+static int do_pass_two_chunks(AssemblerContext* pContext, uint32_t iNumberOfSourceLines)
+{
+    int iReturnValue;
+
+    uint32_t iNumberOfChunks;
+    uint32_t iChunk;
+    uint32_t iLabelLine;
+    uint32_t iSourceLineNumber;
+    uint32_t iAddress;
+
+    SYSTEM_INFO systemInfo;
+
+    LabelLine* pLabelLine;
+
+    PassTwoChunk* pChunks;
+
+    AssemblerContext* pChunkContext;
+
+    //Each chunk needs enough lines to be worth a thread, and there is no point
+    //in more chunks than processors.
+    GetSystemInfo(&systemInfo);
+    iNumberOfChunks = bmc_min(iNumberOfSourceLines / PASS_TWO_CHUNK_MIN_LINES, (uint32_t)systemInfo.dwNumberOfProcessors);
+    iNumberOfChunks = bmc_min(iNumberOfChunks, (uint32_t)PASS_TWO_MAX_CHUNKS);
+    if(iNumberOfChunks < 2 || pContext->m_lexer.m_iNumberOfLabelLines == 0)
+        return EXIT_SUCCESS;
+
+    //The chunks share the symbol table so every symbol gets its value first.
+    //If one can't then pass two will show the error.
+    if(resolve_layout_symbols(pContext) != EXIT_SUCCESS)
+        return EXIT_SUCCESS;
+
+    pChunks = calloc(iNumberOfChunks, sizeof(PassTwoChunk));
+    if(pChunks == NULL)
+    {
+        print_error(__func__, MallocReturnedNull);
+        return -MallocReturnedNull;
+    }
+
+    //The first chunk starts at the top of the file.  Each of the others starts
+    //at the first label line at or after its share of the lines.
+    iReturnValue = create_pass_two_chunk(pContext, &pChunks[0], 1, 0, 0);
+    iLabelLine = 0;
+    for(iChunk = 1; iChunk < iNumberOfChunks && iReturnValue == EXIT_SUCCESS; iChunk++)
+    {
+        iSourceLineNumber = (uint32_t)(((uint64_t)iNumberOfSourceLines * iChunk) / iNumberOfChunks);
+        while(iLabelLine < pContext->m_lexer.m_iNumberOfLabelLines && pContext->m_lexer.m_pLabelLines[iLabelLine].m_iSourceLineNumber < iSourceLineNumber)
+            iLabelLine++;
+
+        if(iLabelLine == pContext->m_lexer.m_iNumberOfLabelLines)
+            break;
+
+        pLabelLine = &pContext->m_lexer.m_pLabelLines[iLabelLine];
+        pChunks[iChunk - 1].m_iEndSourceLineNumber = pLabelLine->m_iSourceLineNumber;
+        iReturnValue = create_pass_two_chunk(pContext, &pChunks[iChunk], pLabelLine->m_iSourceLineNumber, pLabelLine->m_iFileOffset, pLabelLine->m_pSymbolInfo->m_iValue);
+        iLabelLine++;
+    }
+
+    iNumberOfChunks = iChunk;
+    if(iReturnValue == EXIT_SUCCESS && iNumberOfChunks < 2)
+        iReturnValue = EXIT_FAILURE;
+
+    //Start a thread for each chunk and wait for all of them to finish.  If a
+    //thread can't be started the chunks count as failed.
+    for(iChunk = 0; iChunk < iNumberOfChunks && iReturnValue == EXIT_SUCCESS; iChunk++)
+    {
+        pChunks[iChunk].m_hThread = CreateThread(NULL, 0, pass_two_chunk_thread, &pChunks[iChunk], 0, NULL);
+        if(pChunks[iChunk].m_hThread == NULL)
+            iReturnValue = EXIT_FAILURE;
+    }
+
+    for(iChunk = 0; iChunk < iNumberOfChunks; iChunk++)
+    {
+        if(pChunks[iChunk].m_hThread != NULL)
+        {
+            WaitForSingleObject(pChunks[iChunk].m_hThread, INFINITE);
+            CloseHandle(pChunks[iChunk].m_hThread);
+        }
+    }
+
+    //Every chunk has to have assembled all of its lines without an error and
+    //ended at the location counter the next chunk starts at.  Only the last
+    //chunk can end with an END directive.
+    for(iChunk = 0; iChunk < iNumberOfChunks && iReturnValue == EXIT_SUCCESS; iChunk++)
+    {
+        pChunkContext = pChunks[iChunk].m_pContext;
+        if(pChunks[iChunk].m_iReturnValue < EXIT_SUCCESS)
+            iReturnValue = EXIT_FAILURE;
+        else if(iChunk < iNumberOfChunks - 1 && (pChunks[iChunk].m_iReturnValue == END_DIRECTIVE_SUCCESS || pChunkContext->m_lexer.m_lexerInfo.m_iLocationCounter != pChunks[iChunk + 1].m_iStartLocationCounter))
+            iReturnValue = EXIT_FAILURE;
+    }
+
+    //Put the chunks together in source order.  A chunk only stored the bytes
+    //of its own lines in its copy of the program memory, later chunks are put
+    //on top of earlier ones just as an ORG back over earlier lines would.
+    for(iChunk = 0; iChunk < iNumberOfChunks && iReturnValue == EXIT_SUCCESS; iChunk++)
+    {
+        pChunkContext = pChunks[iChunk].m_pContext;
+        iReturnValue = append_listing_lines(pContext, pChunkContext);
+        if(iReturnValue != EXIT_SUCCESS)
+            break;
+
+        for(iAddress = 0; iAddress < MAX_PROGRAM_MEMORY; iAddress++)
+        {
+            if(pChunkContext->m_lexer.m_lexerInfo.m_iaProgramMemory[iAddress] != -1)
+                pContext->m_lexer.m_lexerInfo.m_iaProgramMemory[iAddress] = pChunkContext->m_lexer.m_lexerInfo.m_iaProgramMemory[iAddress];
+        }
+
+        add_expression_memo_counts(pContext, pChunkContext);
+        pContext->m_lexer.m_lexerInfo.m_iSourceLineNumber = pChunkContext->m_lexer.m_lexerInfo.m_iSourceLineNumber;
+        pContext->m_lexer.m_lexerInfo.m_iLocationCounter = pChunkContext->m_lexer.m_lexerInfo.m_iLocationCounter;
+    }
+
+    for(iChunk = 0; iChunk < iNumberOfChunks; iChunk++)
+        free_pass_two_chunk(&pChunks[iChunk]);
+
+    free(pChunks);
+
+    //A failed chunk only means the lines have to be done one at a time.
+    if(iReturnValue == EXIT_FAILURE)
+        return EXIT_SUCCESS;
+    else if(iReturnValue != EXIT_SUCCESS)
+        return iReturnValue;
+
+    return PASS_TWO_CHUNKS_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  create_pass_two_chunk
+ * Function Description:  Creates the context of a pass two chunk.  It is a copy
+ *                        of the assembly's context with its own source file,
+ *                        listing lines, program memory, and expression work
+ *                        space.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * pChunk - Pointer to the chunk.
+ * iStartSourceLineNumber - The first line of the chunk.
+ * iFileOffset - The offset of the first line from the beginning of the source
+ *               file.
+ * iStartLocationCounter - The location counter at the first line.
+ * Returns:  Zero for success and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+static int create_pass_two_chunk(AssemblerContext* pContext, PassTwoChunk* pChunk, uint32_t iStartSourceLineNumber, size_t iFileOffset, uint32_t iStartLocationCounter)
+{
+    int iReturnValue;
+
+    AssemblerContext* pChunkContext;
+
+    pChunkContext = malloc(sizeof(AssemblerContext));
+    if(pChunkContext == NULL)
+    {
+        print_error(__func__, MallocReturnedNull);
+        return -MallocReturnedNull;
+    }
+
+    memcpy(pChunkContext, pContext, sizeof(AssemblerContext));
+    memset(&pChunkContext->m_files, 0, sizeof(pChunkContext->m_files));
+    share_memory_files(pChunkContext, pContext);
+    memset(&pChunkContext->m_listing, 0, sizeof(pChunkContext->m_listing));
+    pChunk->m_pContext = pChunkContext;
+
+    iReturnValue = share_compiled_expressions(pChunkContext, pContext);
+    if(iReturnValue != EXIT_SUCCESS)
+    {
+        print_error(__func__, MallocReturnedNull);
+        return iReturnValue;
+    }
+
+    //The line number is counted up as each line is read.
+    pChunkContext->m_lexer.m_lexerInfo.m_iSourceLineNumber = iStartSourceLineNumber - 1;
+    pChunkContext->m_lexer.m_lexerInfo.m_iLocationCounter = iStartLocationCounter;
+    pChunk->m_iStartLocationCounter = iStartLocationCounter;
+
+    iReturnValue = open_source_file(pChunkContext);
+    if(iReturnValue != EXIT_SUCCESS)
+        return iReturnValue;
+
+    iReturnValue = seek_source_file(pChunkContext, iFileOffset);
+    if(iReturnValue != EXIT_SUCCESS)
+        return iReturnValue;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  free_pass_two_chunk
+ * Function Description:  Frees the context of a pass two chunk.  Anything it
+ *                        shares is left for the assembly's context.
+ * Parameters:
+ * pChunk - Pointer to the chunk.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void free_pass_two_chunk(PassTwoChunk* pChunk)
+{
+    if(pChunk->m_pContext == NULL)
+        return;
+
+    close_all_files(pChunk->m_pContext);
+    free_listing_memory(pChunk->m_pContext);
+    free_shared_expression_memory(pChunk->m_pContext);
+    free(pChunk->m_pContext);
+    pChunk->m_pContext = NULL;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  pass_two_chunk_thread
+ * Function Description:  The thread function for a pass two chunk.  Errors are
+ *                        not printed by the thread, pass two shows them when it
+ *                        is done again a line at a time.
+ * Parameters:
+ * vpChunk - Pointer to the chunk.
+ * Returns:  Zero.  The chunk's return value is left in the chunk.
+------------------------------------------------------------------------------*/
+static DWORD WINAPI pass_two_chunk_thread(LPVOID vpChunk)
+{
+    PassTwoChunk* pChunk = (PassTwoChunk*)vpChunk;
+
+    mute_error_output(TRUE);
+    pChunk->m_iReturnValue = assemble_pass_two_chunk(pChunk->m_pContext, pChunk->m_iEndSourceLineNumber);
+
+    return 0;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  assemble_pass_two_chunk
+ * Function Description:  Assembles the lines of a pass two chunk.  Unlike the
+ *                        line at a time loop in do_assembly() the first error
+ *                        stops the chunk.
+ * Parameters:
+ * pContext - Pointer to the chunk's assembler context.
+ * iEndSourceLineNumber - The line the chunk stops before, or zero to go to the
+ *                        end of the source file.
+ * Returns:  Zero for success, END_DIRECTIVE_SUCCESS if an END directive was
+ *           reached, and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+static int assemble_pass_two_chunk(AssemblerContext* pContext, uint32_t iEndSourceLineNumber)
+{
+    int iFunctionReturnValue;
+
+    ssize_t iReadSourceFileReturnValue;
+
+    do
+    {
+        pContext->m_lexer.m_lexerInfo.m_iSourceLineNumber++;
+        if(pContext->m_lexer.m_lexerInfo.m_iSourceLineNumber == iEndSourceLineNumber)
+            break;
+
+        iReadSourceFileReturnValue = read_line_from_source_file(pContext, &pContext->m_lexer.m_cpSourceLine);
+        if(iReadSourceFileReturnValue > 0)
+        {
+            pContext->m_lexer.m_lexerInfo.m_iSourceLineLength = (uint32_t)iReadSourceFileReturnValue;
+
+            iFunctionReturnValue = parse_source_line(pContext);
+            if(iFunctionReturnValue < EXIT_SUCCESS || iFunctionReturnValue == END_DIRECTIVE_SUCCESS)
+                return iFunctionReturnValue;
+
+            if(pContext->m_lexer.m_lexerInfo.m_iLocationCounter > MAX_PROGRAM_MEMORY)
+                return -ExceededProgramMemoryError;
+        }
+        else if(iReadSourceFileReturnValue < 0)
+        {
+            return (int)iReadSourceFileReturnValue;
+        }
+    } while(iReadSourceFileReturnValue > 0);
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  print_symbol_to_table
+ * Function Description:  Prints symbol information to the symbol table in the
+ *                        listing file.
+ * Parameters:
+ * pNode - Pointer to the node from which to print the symbol name and value.
+ * vpWalkData - Pointer to the assembler context.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void print_symbol_to_table(BSTreeNode* pNode, void* vpWalkData)
+{
+    char caText[LISTING_FILE_MAX_COLUMNS + NULL_TERMINATING_BYTE_LENGTH];
+
+    AssemblerContext* pContext = (AssemblerContext*)vpWalkData;
 
     //Print the symbol information to the listing file if the symbol table and
     //listing file are enabled.
-    if(is_symbol_table_enabled() == TRUE && is_listing_file_enabled() == TRUE)
+    if(is_symbol_table_enabled(pContext) == TRUE && is_listing_file_enabled(pContext) == TRUE)
     {
-        snprintf(caText, sizeof(caText), "%-*s%08X", s_iStatementSymbolFieldLength, (char*)(pNode->m_vpKey), *((uint32_t*)(pNode->m_vpDataElement)));
-        write_line_to_listing_file(caText);
+        snprintf(caText, sizeof(caText), "%-*s%08X", pContext->m_lexer.m_iStatementSymbolFieldLength, (char*)(pNode->m_vpKey), ((SymbolInfo*)(pNode->m_vpDataElement))->m_iValue);
+        write_line_to_listing_file(pContext, caText);
     }
 }
@@ -44,15 +44,35 @@
 #define MAX_DIR_MNEMONIC_SIZE           (4)
 #define MAX_OPERANDS                    (1)
 
+#define FAILED_LINES_INITIAL_CAPACITY   (64)
+#define STRING_LITERALS_INITIAL_CAPACITY (64)
+#define STRING_PAYLOADS_INITIAL_SIZE    (1024)
+#define LABEL_LINES_INITIAL_CAPACITY    (256)
+
+#define PASS_TWO_CHUNK_MIN_LINES        (16384)
+#define PASS_TWO_MAX_CHUNKS             (64)
+#define PASS_TWO_CHUNKS_SUCCESS         (1)
+
+#define PASS_ONE_CHUNK_MIN_BYTES        (524288)
+#define PASS_ONE_MAX_CHUNKS             (64)
+#define PASS_ONE_CHUNKS_SUCCESS         (1)
+#define PASS_ONE_CHUNK_STOPPED          (-1)
+
 #define BYTE_DIRECTIVE_SUCCESS          (1)
 #define END_DIRECTIVE_SUCCESS           (2)
 #define EQU_DIRECTIVE_SUCCESS           (3)
 #define ORG_DIRECTIVE_SUCCESS           (4)
+#define DS_DIRECTIVE_SUCCESS            (5)
+#define FILL_DIRECTIVE_SUCCESS          (6)
+#define WORD_DIRECTIVE_SUCCESS          (7)
 
 #define BYTE_DIRECTIVE_TEXT             "BYTE"
+#define DS_DIRECTIVE_TEXT               "DS"
 #define END_DIRECTIVE_TEXT              "END"
 #define EQU_DIRECTIVE_TEXT              "EQU"
+#define FILL_DIRECTIVE_TEXT             "FILL"
 #define ORG_DIRECTIVE_TEXT              "ORG"
+#define WORD_DIRECTIVE_TEXT             "WORD"
 
 #define ADD_INSTRUCTION_TEXT            "ADD"
 #define AND_INSTRUCTION_TEXT            "AND"
@@ -109,9 +129,12 @@ enum Passes
 enum DirectiveIndexes
 {
     ByteDirective = 0,  //Must start at zero to match first index of array.
+    DsDirective,
     EndDirective,
     EquDirective,
-    OrgDirective
+    FillDirective,
+    OrgDirective,
+    WordDirective
 };
 
 enum InstructionIndexes
@@ -168,6 +191,60 @@ typedef struct tagExpressionInfo
     int m_iValue;
 } ExpressionInfo;
 
+//A literal string from a BYTE directive decoded during pass one.  The text
+//offset is where its opening double quote is on the source line and the text
+//length is how much of the line it takes up.  The payload is the characters as
+//they are stored in program memory.  If it has a bad escaped character the
+//payload ends with a zero in its place and the error is reported in pass two.
+typedef struct tagStringLiteral
+{
+    uint32_t m_iSourceLineNumber;
+    uint32_t m_iTextOffset;
+    uint32_t m_iTextLength;
+    uint32_t m_iPayloadOffset;
+    uint32_t m_iPayloadLength;
+    uint32_t m_iNumberOfBytes;
+    uint32_t m_iErrorOffset;
+    int m_iError;
+} StringLiteral;
+
+//A line with a label found during pass one.  Pass two can start at any of these
+//lines since the location counter there is the value of the label.  The file
+//offset is where the line starts in the source file.
+typedef struct tagLabelLine
+{
+    uint32_t m_iSourceLineNumber;
+    size_t m_iFileOffset;
+    SymbolInfo* m_pSymbolInfo;
+} LabelLine;
+
+//A run of source lines assembled by a thread of its own during pass two.  The
+//chunk stops before the end line, or at the end of the source file if the end
+//line is zero.
+typedef struct tagPassTwoChunk
+{
+    AssemblerContext* m_pContext;
+    HANDLE m_hThread;
+    uint32_t m_iEndSourceLineNumber;
+    uint32_t m_iStartLocationCounter;
+    int m_iReturnValue;
+} PassTwoChunk;
+
+//A part of the source file read by a thread of its own during pass one.  The
+//chunk has the lines that start from its start file offset up to, but not
+//including, its end file offset.  Its lines and its location counter are
+//counted from zero.  The chunks share a flag that is set when one of them
+//fails, since then pass one is done a line at a time and the others can stop.
+typedef struct tagPassOneChunk
+{
+    AssemblerContext* m_pContext;
+    HANDLE m_hThread;
+    size_t m_iStartFileOffset;
+    size_t m_iEndFileOffset;
+    volatile LONG* m_ipIsChunkFailed;
+    int m_iReturnValue;
+} PassOneChunk;
+
 typedef struct tagOpcodeInfo
 {
     uint8_t m_iOpCode;
@@ -198,19 +275,71 @@ typedef struct tagLexerInfo
     char* m_cpStatementMnemonicEnd;
     char* m_cpStatementExpresionStart;
     uint8_t m_iPass;
+    uint8_t m_bWithinDoubleQuote;
     int16_t m_iaProgramMemory[MAX_PROGRAM_MEMORY];
     uint32_t m_iLargestSymbolLength;
     uint32_t m_iLargestOperandLength;
+    uint32_t m_iDisplayLength;
+    uint32_t m_iStatementDisplayLength;
     uint32_t m_iSourceLineLength;
     uint32_t m_iSourceLineNumber;
     uint32_t m_iLocationCounter;
 } LexerInfo;
 
+//The state of the lexer for one assembly, from the source line being scanned
+//to the symbol table and the errors found so far.  A pass two chunk has a
+//context of its own that shares everything pass one found with the context of
+//the whole assembly.  A pass one chunk keeps what it finds to itself, and its
+//location counter is relative to the start of the chunk until its first ORG
+//directive.  The location counter on both sides of that ORG is kept so the
+//chunk can be put in place afterwards.
+typedef struct tagLexerContext
+{
+    char* m_cpSourceLine;
+
+    uint32_t m_iStatementSymbolFieldLength;
+
+    LexerInfo m_lexerInfo;
+
+    BSTreeNode* m_pSymbolTableRoot;
+
+    uint32_t m_iErrorCount;
+    int m_iFirstError;
+
+    uint32_t* m_ipFailedLines;
+    uint32_t m_iFailedLineCount;
+    uint32_t m_iFailedLineCapacity;
+    uint32_t m_iFailedLineIndex;
+
+    StringLiteral* m_pStringLiterals;
+    uint32_t m_iNumberOfStringLiterals;
+    uint32_t m_iStringLiteralsCapacity;
+    uint32_t m_iStringLiteralIndex;
+
+    int16_t* m_ipStringPayloads;
+    uint32_t m_iStringPayloadsSize;
+    uint32_t m_iStringPayloadsCapacity;
+
+    LabelLine* m_pLabelLines;
+    uint32_t m_iNumberOfLabelLines;
+    uint32_t m_iLabelLinesCapacity;
+
+    uint8_t m_bIsLocationCounterUnknown;
+
+    uint8_t m_bIsLocationCounterRelative;
+    uint32_t m_iLocationCounterBeforeOrg;
+    uint32_t m_iLocationCounterAfterOrg;
+} LexerContext;
+
 //------------------------------------------------------------------------------
 //Prototypes
-int do_assembly(void);
-void free_lexer_memory(void);
-uint32_t get_location_counter_value(void);
-BSTreeNode* get_symbol_table_root(void);
+int do_assembly(AssemblerContext* pContext);
+void free_lexer_memory(AssemblerContext* pContext);
+uint32_t get_location_counter_value(AssemblerContext* pContext);
+uint8_t get_current_pass(AssemblerContext* pContext);
+uint32_t get_source_line_number(AssemblerContext* pContext);
+uint32_t get_error_count(AssemblerContext* pContext);
+uint32_t get_first_code_byte_location(AssemblerContext* pContext);
+BSTreeNode* get_symbol_table_root(AssemblerContext* pContext);
 
 #endif /*___LEXER_H___*/
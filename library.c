@@ -0,0 +1,314 @@
+/*
+ ********************************************************************************
+ ** Copyright (C) 2026 Donald J. Bartley <djbcoffee@gmail.com>
+ **
+ ** This source file may be used and distributed without restriction provided
+ ** that this copyright statement is not removed from the file and that any
+ ** derivative work contains the original copyright notice and the associated
+ ** disclaimer.
+ **
+ ** This source file is free software; you can redistribute it and/or modify it
+ ** under the terms of the GNU General Public License as published by the Free
+ ** Software Foundation; either version 2 of the License, or (at your option) any
+ ** later version.
+ **
+ ** This source file is distributed in the hope that it will be useful, but
+ ** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along with
+ ** this source file.  If not, see <http://www.gnu.org/licenses/> or write to the
+ ** Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ ** 02110-1301, USA.
+ ********************************************************************************
+ ** File: nanocore-as/src/library.c
+ **
+ ** Description:
+ ** This translation (compilation) unit contains the assembler as a library.  A
+ ** source in memory is assembled to memory, the same way the assembler does a
+ ** source file, without reading or writing any files.  Assemblies on different
+ ** threads share nothing so they can be done at the same time.
+ ********************************************************************************
+ ** Version 1.0.0
+ ********************************************************************************
+ */
+
+//System #includes
+#ifndef _WINDOWS_H
+#include <windows.h>
+#endif
+#ifndef _STDIO_H
+#include <stdio.h>
+#endif
+#ifndef _STDINT_H
+#include <stdint.h>
+#endif
+#ifndef _STDLIB_H
+#include <stdlib.h>
+#endif
+#ifndef _STRING_H
+#include <string.h>
+#endif
+
+//Project-wide #includes
+#ifndef ___UNIVERSAL_H___
+#include "universal.h"
+#endif
+
+//Project #includes
+#ifndef ___ARGUMENTS_H___
+#include "arguments.h"
+#endif
+#ifndef ___BSTREE_H___
+#include "bstree.h"
+#endif
+#ifndef ___CONTEXT_H___
+#include "context.h"
+#endif
+#ifndef ___EXPRESSION_H___
+#include "expression.h"
+#endif
+#ifndef ___FILES_H___
+#include "files.h"
+#endif
+#ifndef ___LEXER_H___
+#include "lexer.h"
+#endif
+#ifndef ___LOG_H___
+#include "log.h"
+#endif
+
+//Reflective #includes
+#ifndef ___LIBRARY_H___
+#include "library.h"
+#endif
+
+//------------------------------------------------------------------------------
+//Global Data
+//None
+
+//------------------------------------------------------------------------------
+//Static Data
+//None
+
+//------------------------------------------------------------------------------
+//Static Prototypes
+static void clear_assembly_result(AssemblyResult* pResult);
+static int copy_symbols_to_result(AssemblerContext* pContext, AssemblyResult* pResult);
+static void count_symbol(BSTreeNode* pNode, void* vpWalkData);
+static void add_symbol_to_result(BSTreeNode* pNode, void* vpWalkData);
+
+//==============================================================================
+//Functions
+/*------------------------------------------------------------------------------
+ * Function name:  assemble_from_memory
+ * Function Description:  Assembles a source in memory.  The binary, listing,
+ *                        symbols, and messages are put in the result instead of
+ *                        being written to files and printed.
+ * Parameters:
+ * cpSourceName - The file name given to the source in the listing, or NULL for
+ *                LIBRARY_DEFAULT_SOURCE_NAME.
+ * cpSource - Pointer to the source text.
+ * iSourceLength - The number of characters in the source text.
+ * pOptions - Pointer to the options, or NULL for the defaults.
+ * pResult - Pointer to the result.  Whatever it held from an earlier assembly is
+ *           replaced.
+ * Returns:  Zero for success and a negative number for failure, the same as the
+ *           exit value of the assembler.
+------------------------------------------------------------------------------*/
+int assemble_from_memory(const char* cpSourceName, const char* cpSource, size_t iSourceLength, const AssemblerOptions* pOptions, AssemblyResult* pResult)
+{
+    int iReturnValue;
+    int iFunctionReturnValue;
+
+    AssemblerOptions options;
+
+    AssemblerContext* pContext;
+
+    //Everything the assembly prints goes to the result.
+    clear_assembly_result(pResult);
+    redirect_message_output(&pResult->m_messages);
+
+    if(pOptions != NULL)
+        options = *pOptions;
+    else
+        get_default_options(&options);
+
+    pContext = create_assembler_context();
+    if(pContext == NULL)
+    {
+        redirect_message_output(NULL);
+        return -MallocReturnedNull;
+    }
+
+    set_assembly_options(pContext, &options);
+    use_memory_files(pContext, cpSource, iSourceLength, &pResult->m_listing, &pResult->m_image);
+
+    iReturnValue = select_source_name(pContext, (cpSourceName != NULL) ? cpSourceName : LIBRARY_DEFAULT_SOURCE_NAME);
+    if(iReturnValue == EXIT_SUCCESS)
+    {
+        iReturnValue = do_assembly(pContext);
+        if(iReturnValue == EXIT_SUCCESS)
+            print_message("Assembly successful.\n");
+
+        //The symbols are wanted even when there were errors.
+        iFunctionReturnValue = copy_symbols_to_result(pContext, pResult);
+        if(iReturnValue == EXIT_SUCCESS)
+            iReturnValue = iFunctionReturnValue;
+
+        pResult->m_iErrorCount = get_error_count(pContext);
+        if(pResult->m_image.m_iLength != 0)
+            pResult->m_iImageOrigin = get_first_code_byte_location(pContext);
+    }
+
+    free_assembler_context(pContext);
+    redirect_message_output(NULL);
+
+    return iReturnValue;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  free_assembly_result
+ * Function Description:  Frees all of the memory of a result and leaves it
+ *                        empty.
+ * Parameters:
+ * pResult - Pointer to the result.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+void free_assembly_result(AssemblyResult* pResult)
+{
+    free_memory_buffer(&pResult->m_image);
+    free_memory_buffer(&pResult->m_listing);
+    free_memory_buffer(&pResult->m_messages);
+    free_memory_buffer(&pResult->m_symbolNames);
+
+    if(pResult->m_pSymbols != NULL)
+        free(pResult->m_pSymbols);
+
+    memset(pResult, 0, sizeof(AssemblyResult));
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  clear_assembly_result
+ * Function Description:  Empties a result for the next assembly.  Its memory is
+ *                        kept.
+ * Parameters:
+ * pResult - Pointer to the result.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void clear_assembly_result(AssemblyResult* pResult)
+{
+    MemoryBuffer* paBuffers[] = {&pResult->m_image, &pResult->m_listing, &pResult->m_messages, &pResult->m_symbolNames};
+
+    uint32_t iIndex;
+
+    for(iIndex = 0; iIndex < sizeof(paBuffers) / sizeof(paBuffers[0]); iIndex++)
+    {
+        paBuffers[iIndex]->m_iLength = 0;
+        if(paBuffers[iIndex]->m_cpData != NULL)
+            paBuffers[iIndex]->m_cpData[0] = '\0';
+    }
+
+    pResult->m_iImageOrigin = 0;
+    pResult->m_iNumberOfSymbols = 0;
+    pResult->m_iErrorCount = 0;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  copy_symbols_to_result
+ * Function Description:  Copies the symbol table of an assembly to a result.
+ *                        The symbols are counted first so that the names can
+ *                        be pointed to without the buffer moving under them.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * pResult - Pointer to the result.
+ * Returns:  Zero for success and a negative number for failure.
+------------------------------------------------------------------------------*/
+static int copy_symbols_to_result(AssemblerContext* pContext, AssemblyResult* pResult)
+{
+    int iReturnValue;
+
+    uint32_t iNewCapacity;
+
+    AssemblySymbol* pNewSymbols;
+
+    //The names are counted in the length of the names buffer.
+    bstree_in_order_walk(get_symbol_table_root(pContext), count_symbol, pResult);
+    iReturnValue = reserve_memory_buffer(&pResult->m_symbolNames, pResult->m_symbolNames.m_iLength);
+    if(iReturnValue != EXIT_SUCCESS)
+    {
+        pResult->m_iNumberOfSymbols = 0;
+        pResult->m_symbolNames.m_iLength = 0;
+        return iReturnValue;
+    }
+
+    if(pResult->m_iNumberOfSymbols > pResult->m_iSymbolsCapacity)
+    {
+        iNewCapacity = (pResult->m_iSymbolsCapacity == 0) ? 1 : pResult->m_iSymbolsCapacity;
+        while(iNewCapacity < pResult->m_iNumberOfSymbols)
+            iNewCapacity *= 2;
+
+        pNewSymbols = realloc(pResult->m_pSymbols, iNewCapacity * sizeof(AssemblySymbol));
+        if(pNewSymbols == NULL)
+        {
+            pResult->m_iNumberOfSymbols = 0;
+            pResult->m_symbolNames.m_iLength = 0;
+            print_error(__func__, MallocReturnedNull);
+            return -MallocReturnedNull;
+        }
+
+        pResult->m_pSymbols = pNewSymbols;
+        pResult->m_iSymbolsCapacity = iNewCapacity;
+    }
+
+    //Now fill them in.
+    pResult->m_iNumberOfSymbols = 0;
+    pResult->m_symbolNames.m_iLength = 0;
+    bstree_in_order_walk(get_symbol_table_root(pContext), add_symbol_to_result, pResult);
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  count_symbol
+ * Function Description:  Counts a symbol, and the length of its name, in a
+ *                        result.
+ * Parameters:
+ * pNode - Pointer to the node of the symbol.
+ * vpWalkData - Pointer to the result.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void count_symbol(BSTreeNode* pNode, void* vpWalkData)
+{
+    AssemblyResult* pResult = (AssemblyResult*)vpWalkData;
+
+    pResult->m_iNumberOfSymbols++;
+    pResult->m_symbolNames.m_iLength += strlen((char*)(pNode->m_vpKey)) + NULL_TERMINATING_BYTE_LENGTH;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  add_symbol_to_result
+ * Function Description:  Adds a symbol to a result that has already been made
+ *                        big enough for it.
+ * Parameters:
+ * pNode - Pointer to the node of the symbol.
+ * vpWalkData - Pointer to the result.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void add_symbol_to_result(BSTreeNode* pNode, void* vpWalkData)
+{
+    AssemblyResult* pResult = (AssemblyResult*)vpWalkData;
+    AssemblySymbol* pSymbol;
+
+    size_t iNameLength;
+
+    iNameLength = strlen((char*)(pNode->m_vpKey)) + NULL_TERMINATING_BYTE_LENGTH;
+    pSymbol = &pResult->m_pSymbols[pResult->m_iNumberOfSymbols];
+    pSymbol->m_cpName = pResult->m_symbolNames.m_cpData + pResult->m_symbolNames.m_iLength;
+    pSymbol->m_iValue = ((SymbolInfo*)(pNode->m_vpDataElement))->m_iValue;
+    memcpy(pResult->m_symbolNames.m_cpData + pResult->m_symbolNames.m_iLength, pNode->m_vpKey, iNameLength);
+
+    pResult->m_symbolNames.m_iLength += iNameLength;
+    pResult->m_iNumberOfSymbols++;
+}
@@ -0,0 +1,81 @@
+/*
+ ********************************************************************************
+ ** Copyright (C) 2026 Donald J. Bartley <djbcoffee@gmail.com>
+ **
+ ** This source file may be used and distributed without restriction provided
+ ** that this copyright statement is not removed from the file and that any
+ ** derivative work contains the original copyright notice and the associated
+ ** disclaimer.
+ **
+ ** This source file is free software; you can redistribute it and/or modify it
+ ** under the terms of the GNU General Public License as published by the Free
+ ** Software Foundation; either version 2 of the License, or (at your option) any
+ ** later version.
+ **
+ ** This source file is distributed in the hope that it will be useful, but
+ ** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along with
+ ** this source file.  If not, see <http://www.gnu.org/licenses/> or write to the
+ ** Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ ** 02110-1301, USA.
+ ********************************************************************************
+ ** File: nanocore-as/src/library.h
+ **
+ ** Description:
+ ** Header file that goes with library.c
+ ********************************************************************************
+ ** Version 1.0.0
+ ********************************************************************************
+ */
+
+#ifndef ___LIBRARY_H___
+#define ___LIBRARY_H___
+
+//------------------------------------------------------------------------------
+//Defines
+#define LIBRARY_DEFAULT_SOURCE_NAME     "source.asm"
+
+//------------------------------------------------------------------------------
+//Enumerations
+//None
+
+//------------------------------------------------------------------------------
+//Structures
+//A symbol from the symbol table of an assembly from memory.
+typedef struct tagAssemblySymbol
+{
+    const char* m_cpName;
+    uint32_t m_iValue;
+} AssemblySymbol;
+
+//What an assembly from memory produces.  The image is what would be written to
+//the binary file and starts at the origin in program memory, it is empty if
+//there were errors.  The listing is what would be written to the listing file
+//and the messages are what would be printed.  The symbols are in ascending
+//order and their names are kept in the symbol names buffer.
+//
+//A result that is all zero is empty.  Its buffers are kept, and only grown, from
+//one assembly to the next so the same result can be passed to many assemblies
+//without them allocating memory.  free_assembly_result() frees it.
+typedef struct tagAssemblyResult
+{
+    MemoryBuffer m_image;
+    uint32_t m_iImageOrigin;
+    MemoryBuffer m_listing;
+    MemoryBuffer m_messages;
+    AssemblySymbol* m_pSymbols;
+    uint32_t m_iNumberOfSymbols;
+    uint32_t m_iSymbolsCapacity;
+    MemoryBuffer m_symbolNames;
+    uint32_t m_iErrorCount;
+} AssemblyResult;
+
+//------------------------------------------------------------------------------
+//Prototypes
+int assemble_from_memory(const char* cpSourceName, const char* cpSource, size_t iSourceLength, const AssemblerOptions* pOptions, AssemblyResult* pResult);
+void free_assembly_result(AssemblyResult* pResult);
+
+#endif /*___LIBRARY_H___*/
@@ -0,0 +1,703 @@
+/*
+ ********************************************************************************
+ ** Copyright (C) 2026 Donald J. Bartley <djbcoffee@gmail.com>
+ **
+ ** This source file may be used and distributed without restriction provided
+ ** that this copyright statement is not removed from the file and that any
+ ** derivative work contains the original copyright notice and the associated
+ ** disclaimer.
+ **
+ ** This source file is free software; you can redistribute it and/or modify it
+ ** under the terms of the GNU General Public License as published by the Free
+ ** Software Foundation; either version 2 of the License, or (at your option) any
+ ** later version.
+ **
+ ** This source file is distributed in the hope that it will be useful, but
+ ** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along with
+ ** this source file.  If not, see <http://www.gnu.org/licenses/> or write to the
+ ** Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ ** 02110-1301, USA.
+ ********************************************************************************
+ ** File: nanocore-as/src/listing.c
+ **
+ ** Description:
+ ** This translation (compilation) unit contains the listing formatter.  Pass two
+ ** records each line it assembles along with the object code the line produced.
+ ** Once the pass is done the lines are formatted for the listing file in blocks,
+ ** each block on a thread of its own, and the blocks are written in source
+ ** order.
+ ********************************************************************************
+ ** Version 1.0.0
+ ********************************************************************************
+ */
+
+//System #includes
+#ifndef _WINDOWS_H
+#include <windows.h>
+#endif
+#ifndef _CTYPE_H
+#include <ctype.h>
+#endif
+#ifndef _STDIO_H
+#include <stdio.h>
+#endif
+#ifndef _STDINT_H
+#include <stdint.h>
+#endif
+#ifndef _STDLIB_H
+#include <stdlib.h>
+#endif
+#ifndef _STRING_H
+#include <string.h>
+#endif
+
+//Project-wide #includes
+#ifndef ___UNIVERSAL_H___
+#include "universal.h"
+#endif
+
+//Project #includes
+#ifndef ___CONTEXT_H___
+#include "context.h"
+#endif
+#ifndef ___FILES_H___
+#include "files.h"
+#endif
+#ifndef ___LEXER_H___
+#include "lexer.h"
+#endif
+#ifndef ___LOG_H___
+#include "log.h"
+#endif
+
+//Reflective #includes
+#ifndef ___LISTING_H___
+#include "listing.h"
+#endif
+
+//------------------------------------------------------------------------------
+//Global Data
+//None
+
+//------------------------------------------------------------------------------
+//Static Data
+//None
+
+//------------------------------------------------------------------------------
+//Static Prototypes
+static int reserve_listing_pool(AssemblerContext* pContext, uint32_t iLength);
+static DWORD WINAPI listing_block_thread(LPVOID vpBlock);
+static int format_listing_block(ListingBlock* pBlock);
+static int format_listing_line(ListingBlock* pBlock, const ListingLine* pLine);
+static int add_listing_block_text(ListingBlock* pBlock, char* cpText);
+
+//==============================================================================
+//Functions
+/*------------------------------------------------------------------------------
+ * Function name:  reset_listing
+ * Function Description:  Throws away all listing lines.  Used before pass two.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+void reset_listing(AssemblerContext* pContext)
+{
+    pContext->m_listing.m_iNumberOfLines = 0;
+    pContext->m_listing.m_iPoolUsed = 0;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  add_listing_line
+ * Function Description:  Records a line assembled by pass two.  The text and
+ *                        object code are copied into the pool.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * pLine - Pointer to the line with its line number, location counter, text and
+ *         object code lengths, and span offsets filled in.
+ * cpText - The text of the line.
+ * ipObjectCode - The object code of the line.
+ * Returns:  Zero for success and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+int add_listing_line(AssemblerContext* pContext, const ListingLine* pLine, const char* cpText, const int16_t* ipObjectCode)
+{
+    int iFunctionReturnValue;
+
+    uint32_t iCounter;
+
+    ListingLine* pNewLines;
+    ListingLine* pNewLine;
+
+    if(pContext->m_listing.m_iNumberOfLines == pContext->m_listing.m_iLinesCapacity)
+    {
+        pContext->m_listing.m_iLinesCapacity = (pContext->m_listing.m_iLinesCapacity == 0) ? LISTING_LINES_INITIAL_CAPACITY : pContext->m_listing.m_iLinesCapacity * 2;
+        pNewLines = realloc(pContext->m_listing.m_pLines, pContext->m_listing.m_iLinesCapacity * sizeof(ListingLine));
+        if(pNewLines == NULL)
+        {
+            print_error(__func__, MallocReturnedNull);
+            return -MallocReturnedNull;
+        }
+
+        pContext->m_listing.m_pLines = pNewLines;
+    }
+
+    iFunctionReturnValue = reserve_listing_pool(pContext, pLine->m_iTextLength + pLine->m_iObjectCodeLength);
+    if(iFunctionReturnValue != EXIT_SUCCESS)
+        return iFunctionReturnValue;
+
+    pNewLine = &pContext->m_listing.m_pLines[pContext->m_listing.m_iNumberOfLines];
+    *pNewLine = *pLine;
+
+    //The text is followed by the object code, a byte for each word of program
+    //memory.
+    pNewLine->m_iTextOffset = pContext->m_listing.m_iPoolUsed;
+    memcpy(pContext->m_listing.m_cpPool + pContext->m_listing.m_iPoolUsed, cpText, pLine->m_iTextLength);
+    pContext->m_listing.m_iPoolUsed += pLine->m_iTextLength;
+
+    pNewLine->m_iObjectCodeOffset = pContext->m_listing.m_iPoolUsed;
+    for(iCounter = 0; iCounter < pLine->m_iObjectCodeLength; iCounter++)
+        pContext->m_listing.m_cpPool[pContext->m_listing.m_iPoolUsed++] = (char)(uint8_t)(ipObjectCode[iCounter]);
+
+    pContext->m_listing.m_iNumberOfLines++;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  append_listing_lines
+ * Function Description:  Adds the listing lines of another context to the end of
+ *                        the listing lines.
+ * Parameters:
+ * pContext - Pointer to the assembler context to add to.
+ * pOtherContext - Pointer to the assembler context with the lines.
+ * Returns:  Zero for success and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+int append_listing_lines(AssemblerContext* pContext, AssemblerContext* pOtherContext)
+{
+    int iFunctionReturnValue;
+
+    uint32_t iNumberOfLines;
+    uint32_t iLine;
+
+    ListingLine* pNewLines;
+    ListingLine* pNewLine;
+
+    if(pOtherContext->m_listing.m_iNumberOfLines == 0)
+        return EXIT_SUCCESS;
+
+    //Make room for all of the lines at once.
+    iNumberOfLines = pContext->m_listing.m_iNumberOfLines + pOtherContext->m_listing.m_iNumberOfLines;
+    if(iNumberOfLines > pContext->m_listing.m_iLinesCapacity)
+    {
+        while(iNumberOfLines > pContext->m_listing.m_iLinesCapacity)
+            pContext->m_listing.m_iLinesCapacity = (pContext->m_listing.m_iLinesCapacity == 0) ? LISTING_LINES_INITIAL_CAPACITY : pContext->m_listing.m_iLinesCapacity * 2;
+
+        pNewLines = realloc(pContext->m_listing.m_pLines, pContext->m_listing.m_iLinesCapacity * sizeof(ListingLine));
+        if(pNewLines == NULL)
+        {
+            print_error(__func__, MallocReturnedNull);
+            return -MallocReturnedNull;
+        }
+
+        pContext->m_listing.m_pLines = pNewLines;
+    }
+
+    iFunctionReturnValue = reserve_listing_pool(pContext, pOtherContext->m_listing.m_iPoolUsed);
+    if(iFunctionReturnValue != EXIT_SUCCESS)
+        return iFunctionReturnValue;
+
+    //The other pool goes after this one so its offsets move up by what is
+    //already here.
+    for(iLine = 0; iLine < pOtherContext->m_listing.m_iNumberOfLines; iLine++)
+    {
+        pNewLine = &pContext->m_listing.m_pLines[pContext->m_listing.m_iNumberOfLines + iLine];
+        *pNewLine = pOtherContext->m_listing.m_pLines[iLine];
+        pNewLine->m_iTextOffset += pContext->m_listing.m_iPoolUsed;
+        pNewLine->m_iObjectCodeOffset += pContext->m_listing.m_iPoolUsed;
+    }
+
+    memcpy(pContext->m_listing.m_cpPool + pContext->m_listing.m_iPoolUsed, pOtherContext->m_listing.m_cpPool, pOtherContext->m_listing.m_iPoolUsed);
+    pContext->m_listing.m_iPoolUsed += pOtherContext->m_listing.m_iPoolUsed;
+    pContext->m_listing.m_iNumberOfLines = iNumberOfLines;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  write_listing_lines
+ * Function Description:  Formats the listing lines and writes them to the
+ *                        listing file.  The lines are done in rounds so only
+ *                        so much formatted text is held at once.  Each round is
+ *                        split into blocks of lines that are formatted at the
+ *                        same time, and then written in source order.  A block
+ *                        whose thread can't be started, or that fails on its
+ *                        thread, is formatted again here.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * iLargestSymbolLength - The length of the largest symbol.
+ * iLargestOperandLength - The length of the operand field.
+ * Returns:  Zero for success and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+int write_listing_lines(AssemblerContext* pContext, uint32_t iLargestSymbolLength, uint32_t iLargestOperandLength)
+{
+    int iReturnValue;
+
+    uint32_t iNumberOfBlocks;
+    uint32_t iBlock;
+    uint32_t iLine;
+
+    SYSTEM_INFO systemInfo;
+
+    ListingBlock* pBlocks;
+
+    pContext->m_listing.m_iLargestSymbolLength = iLargestSymbolLength;
+    pContext->m_listing.m_iLargestOperandLength = iLargestOperandLength;
+
+    //There is no point in more blocks than processors, or than there are lines
+    //to fill them.
+    GetSystemInfo(&systemInfo);
+    iNumberOfBlocks = (pContext->m_listing.m_iNumberOfLines + LISTING_BLOCK_LINES - 1) / LISTING_BLOCK_LINES;
+    iNumberOfBlocks = bmc_min(iNumberOfBlocks, (uint32_t)systemInfo.dwNumberOfProcessors);
+    iNumberOfBlocks = bmc_min(iNumberOfBlocks, (uint32_t)LISTING_MAX_BLOCKS);
+    iNumberOfBlocks = bmc_max(iNumberOfBlocks, (uint32_t)1);
+
+    pBlocks = calloc(iNumberOfBlocks, sizeof(ListingBlock));
+    if(pBlocks == NULL)
+    {
+        print_error(__func__, MallocReturnedNull);
+        return -MallocReturnedNull;
+    }
+
+    for(iBlock = 0; iBlock < iNumberOfBlocks; iBlock++)
+        pBlocks[iBlock].m_pContext = pContext;
+
+    iReturnValue = EXIT_SUCCESS;
+    iLine = 0;
+    while(iLine < pContext->m_listing.m_iNumberOfLines && iReturnValue == EXIT_SUCCESS)
+    {
+        //Hand out the lines of this round.  A single block is formatted here
+        //without a thread.
+        for(iBlock = 0; iBlock < iNumberOfBlocks; iBlock++)
+        {
+            pBlocks[iBlock].m_iFirstLine = iLine;
+            pBlocks[iBlock].m_iEndLine = bmc_min(iLine + LISTING_BLOCK_LINES, pContext->m_listing.m_iNumberOfLines);
+            pBlocks[iBlock].m_iTextUsed = 0;
+            pBlocks[iBlock].m_hThread = NULL;
+            iLine = pBlocks[iBlock].m_iEndLine;
+
+            if(iNumberOfBlocks > 1)
+                pBlocks[iBlock].m_hThread = CreateThread(NULL, 0, listing_block_thread, &pBlocks[iBlock], 0, NULL);
+        }
+
+        for(iBlock = 0; iBlock < iNumberOfBlocks; iBlock++)
+        {
+            if(pBlocks[iBlock].m_hThread != NULL)
+            {
+                WaitForSingleObject(pBlocks[iBlock].m_hThread, INFINITE);
+                CloseHandle(pBlocks[iBlock].m_hThread);
+            }
+            else
+            {
+                pBlocks[iBlock].m_iReturnValue = EXIT_FAILURE;
+            }
+        }
+
+        //Write the blocks in order.
+        for(iBlock = 0; iBlock < iNumberOfBlocks && iReturnValue == EXIT_SUCCESS; iBlock++)
+        {
+            if(pBlocks[iBlock].m_iReturnValue != EXIT_SUCCESS)
+            {
+                pBlocks[iBlock].m_iTextUsed = 0;
+                iReturnValue = format_listing_block(&pBlocks[iBlock]);
+                if(iReturnValue != EXIT_SUCCESS)
+                    break;
+            }
+
+            iReturnValue = write_text_to_listing_file(pContext, pBlocks[iBlock].m_cpText, pBlocks[iBlock].m_iTextUsed);
+        }
+    }
+
+    for(iBlock = 0; iBlock < iNumberOfBlocks; iBlock++)
+    {
+        if(pBlocks[iBlock].m_cpText != NULL)
+            free(pBlocks[iBlock].m_cpText);
+        if(pBlocks[iBlock].m_cpLine != NULL)
+            free(pBlocks[iBlock].m_cpLine);
+    }
+
+    free(pBlocks);
+
+    return iReturnValue;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  free_listing_memory
+ * Function Description:  Frees all allocated memory used by the listing lines.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+void free_listing_memory(AssemblerContext* pContext)
+{
+    if(pContext->m_listing.m_pLines != NULL)
+        free(pContext->m_listing.m_pLines);
+    if(pContext->m_listing.m_cpPool != NULL)
+        free(pContext->m_listing.m_cpPool);
+
+    pContext->m_listing.m_pLines = NULL;
+    pContext->m_listing.m_iNumberOfLines = 0;
+    pContext->m_listing.m_iLinesCapacity = 0;
+    pContext->m_listing.m_cpPool = NULL;
+    pContext->m_listing.m_iPoolSize = 0;
+    pContext->m_listing.m_iPoolUsed = 0;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  reserve_listing_pool
+ * Function Description:  Makes sure the pool has room for more characters.
+ * Parameters:
+ * pContext - Pointer to the assembler context.
+ * iLength - The number of characters needed.
+ * Returns:  Zero for success and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+static int reserve_listing_pool(AssemblerContext* pContext, uint32_t iLength)
+{
+    char* cpNewPool;
+
+    uint32_t iNewPoolSize;
+
+    if(pContext->m_listing.m_iPoolSize - pContext->m_listing.m_iPoolUsed >= iLength)
+        return EXIT_SUCCESS;
+
+    iNewPoolSize = (pContext->m_listing.m_iPoolSize == 0) ? LISTING_POOL_INITIAL_SIZE : pContext->m_listing.m_iPoolSize * 2;
+    while(iNewPoolSize - pContext->m_listing.m_iPoolUsed < iLength)
+        iNewPoolSize *= 2;
+
+    cpNewPool = realloc(pContext->m_listing.m_cpPool, iNewPoolSize);
+    if(cpNewPool == NULL)
+    {
+        print_error(__func__, MallocReturnedNull);
+        return -MallocReturnedNull;
+    }
+
+    pContext->m_listing.m_cpPool = cpNewPool;
+    pContext->m_listing.m_iPoolSize = iNewPoolSize;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  listing_block_thread
+ * Function Description:  The thread function for a block of listing lines.
+ *                        Errors are not printed by the thread, the block is
+ *                        formatted again without a thread to show them.
+ * Parameters:
+ * vpBlock - Pointer to the block.
+ * Returns:  Zero.  The block's return value is left in the block.
+------------------------------------------------------------------------------*/
+static DWORD WINAPI listing_block_thread(LPVOID vpBlock)
+{
+    ListingBlock* pBlock = (ListingBlock*)vpBlock;
+
+    mute_error_output(TRUE);
+    pBlock->m_iReturnValue = format_listing_block(pBlock);
+
+    return 0;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  format_listing_block
+ * Function Description:  Formats the lines of a block into the block's text.
+ * Parameters:
+ * pBlock - Pointer to the block.
+ * Returns:  Zero for success and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+static int format_listing_block(ListingBlock* pBlock)
+{
+    int iFunctionReturnValue;
+
+    uint32_t iLine;
+
+    for(iLine = pBlock->m_iFirstLine; iLine < pBlock->m_iEndLine; iLine++)
+    {
+        iFunctionReturnValue = format_listing_line(pBlock, &pBlock->m_pContext->m_listing.m_pLines[iLine]);
+        if(iFunctionReturnValue != EXIT_SUCCESS)
+            return iFunctionReturnValue;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  format_listing_line
+ * Function Description:  Formats a listing line, and the lines for any object
+ *                        code that doesn't fit on it, into the block's text.
+ * Parameters:
+ * pBlock - Pointer to the block.
+ * pLine - Pointer to the listing line.
+ * Returns:  Zero for success and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+static int format_listing_line(ListingBlock* pBlock, const ListingLine* pLine)
+{
+    char caListing[LISTING_FILE_MAX_COLUMNS + NULL_TERMINATING_BYTE_LENGTH];
+    char caLineNumber[LISTING_FILE_LINE_MAX_DIGITS + NULL_TERMINATING_BYTE_LENGTH];
+    char caLocationCounter[LISTING_FILE_LC_MAX_CHARACTERS + NULL_TERMINATING_BYTE_LENGTH];
+    char caObjectCodeByte[LISTING_FILE_OBJECT_CODE_BYTE_MAX_CHARACTERS + NULL_TERMINATING_BYTE_LENGTH];
+    char caObjectCode[LISTING_FILE_OBJECT_CODE_MAX_CHARACTERS + NULL_TERMINATING_BYTE_LENGTH];
+    char caSource[LISTING_FILE_MAX_COLUMNS + NULL_TERMINATING_BYTE_LENGTH];
+    char* acpSpan[NumberOfListingSpans];
+    char* cpNewLine;
+
+    const char* cpObjectCode;
+
+    uint8_t bWithinDoubleQuote;
+
+    int iFunctionReturnValue;
+
+    uint32_t iStatementSymbolFieldLength;
+    uint32_t iStatementMnemonicFieldLength;
+    uint32_t iNewLineSize;
+    uint32_t iObjectCodeIndex;
+    uint32_t iCounter;
+
+    size_t iLength;
+
+    ListingContext* pListing = &pBlock->m_pContext->m_listing;
+
+    //The formatting puts NULL terminators into the line so work on a copy of it.
+    if(pBlock->m_iLineSize < pLine->m_iTextLength + NULL_TERMINATING_BYTE_LENGTH)
+    {
+        iNewLineSize = (pBlock->m_iLineSize == 0) ? LISTING_TEXT_INITIAL_SIZE : pBlock->m_iLineSize * 2;
+        while(iNewLineSize < pLine->m_iTextLength + NULL_TERMINATING_BYTE_LENGTH)
+            iNewLineSize *= 2;
+
+        cpNewLine = realloc(pBlock->m_cpLine, iNewLineSize);
+        if(cpNewLine == NULL)
+        {
+            print_error(__func__, MallocReturnedNull);
+            return -MallocReturnedNull;
+        }
+
+        pBlock->m_cpLine = cpNewLine;
+        pBlock->m_iLineSize = iNewLineSize;
+    }
+
+    memcpy(pBlock->m_cpLine, pListing->m_cpPool + pLine->m_iTextOffset, pLine->m_iTextLength);
+    pBlock->m_cpLine[pLine->m_iTextLength] = '\0';
+
+    for(iCounter = 0; iCounter < NumberOfListingSpans; iCounter++)
+        acpSpan[iCounter] = (pLine->m_iaSpanOffset[iCounter] != 0) ? pBlock->m_cpLine + pLine->m_iaSpanOffset[iCounter] - 1 : NULL;
+
+    cpObjectCode = pListing->m_cpPool + pLine->m_iObjectCodeOffset;
+    iObjectCodeIndex = 0;
+
+    //Create the line number field.
+    snprintf(caLineNumber, sizeof(caLineNumber), "%0*u", LISTING_FILE_LINE_MAX_DIGITS, pLine->m_iSourceLineNumber);
+
+    //Create the location counter field.
+    snprintf(caLocationCounter, sizeof(caLocationCounter), "%0*X", LISTING_FILE_LC_MAX_CHARACTERS, pLine->m_iLocationCounter);
+
+    //If there is object code then fill in the object code field.  Up to three
+    //bytes can fit in the object code field.
+    caObjectCode[0] = '\0';
+    for(iCounter = 0; iCounter < LISTING_FILE_OBJECT_CODE_BYTES_PER_FIELD && iObjectCodeIndex < pLine->m_iObjectCodeLength; iCounter++)
+    {
+        snprintf(caObjectCodeByte, sizeof(caObjectCodeByte), "%02X ", (uint8_t)(cpObjectCode[iObjectCodeIndex]));
+        strcat(caObjectCode, caObjectCodeByte);
+        iObjectCodeIndex++;
+    }
+
+    //Create the source field.
+    caSource[0] = '\0';
+    if(acpSpan[StartOfLabelSpan] != NULL || acpSpan[StartOfStatementSpan] != NULL || acpSpan[StartOfCommentSpan] != NULL)
+    {
+        //There is something to put in the source field.  Check for comment
+        //only.
+        if(acpSpan[StartOfLabelSpan] == NULL && acpSpan[StartOfStatementSpan] == NULL && acpSpan[StartOfCommentSpan] != NULL)
+        {
+            //The source file only contains a comment.  Start it at the
+            //beginning of the field.  Put a NULL terminator after the comment
+            //and copy the whole comment.
+            *(acpSpan[EndOfCommentSpan] + 1) = '\0';
+            snprintf(caSource, sizeof(caSource), "%s", acpSpan[StartOfCommentSpan]);
+        }
+        else
+        {
+            //There is more to the line then just a comment.  If we have symbols
+            //then set the field length to the size of the largest symbol and add
+            //two for the ':' character after labels and a whitespace.
+            iStatementSymbolFieldLength = (pListing->m_iLargestSymbolLength == 0) ? 0 : pListing->m_iLargestSymbolLength + 2;
+
+            //The statement mnemonic field length is the length of the largest
+            //mnemonic plus one for a whitespace.
+            iStatementMnemonicFieldLength = MAX_DIR_MNEMONIC_SIZE + 1;
+
+            //Place NULL terminators after the symbol and mnemonic if they exist
+            //on the line.
+            if(acpSpan[StatementSymbolStartSpan] != NULL)
+                *(acpSpan[StatementSymbolEndSpan] + 1) = '\0';
+            if(acpSpan[StatementMnemonicStartSpan] != NULL)
+                *(acpSpan[StatementMnemonicEndSpan] + 1) = '\0';
+
+            //Assemble the source line with the symbol and mnemonic.
+            snprintf(caSource, sizeof(caSource), "%-*s%-*s", iStatementSymbolFieldLength, (acpSpan[StatementSymbolStartSpan] == NULL) ? "" : acpSpan[StatementSymbolStartSpan], iStatementMnemonicFieldLength, (acpSpan[StatementMnemonicStartSpan] == NULL) ? "" : acpSpan[StatementMnemonicStartSpan]);
+
+            //Check if there are operands.
+            if(acpSpan[StatementExpressionStartSpan] != NULL)
+            {
+                //Add all operand text without white spaces, except those within
+                //double quotes.  Loop until the operand field has been filled or
+                //we run out of space in the string.
+                bWithinDoubleQuote = FALSE;
+                iCounter = 0;
+                iLength = strlen(caSource);
+                while(iCounter < pListing->m_iLargestOperandLength && (iLength + iCounter) < (sizeof(caSource) - NULL_TERMINATING_BYTE_LENGTH))
+                {
+                    //Check if we have more operand characters.
+                    if(acpSpan[StatementExpressionStartSpan] <= acpSpan[EndOfStatementSpan])
+                    {
+                        //There are more operand characters.  Don't add white
+                        //spaces unless they are in double quotes.
+                        if(bWithinDoubleQuote == FALSE)
+                        {
+                            if(isspace(*acpSpan[StatementExpressionStartSpan]) == 0)
+                            {
+                                strncat(caSource, acpSpan[StatementExpressionStartSpan], 1);
+                                iCounter++;
+                            }
+
+                            if(*acpSpan[StatementExpressionStartSpan] == '"' && *(acpSpan[StatementExpressionStartSpan] - 1) != '\\')
+                                bWithinDoubleQuote = TRUE;
+                        }
+                        else
+                        {
+                            strncat(caSource, acpSpan[StatementExpressionStartSpan], 1);
+                            iCounter++;
+
+                            if(*acpSpan[StatementExpressionStartSpan] == '"' && *(acpSpan[StatementExpressionStartSpan] - 1) != '\\')
+                                bWithinDoubleQuote = FALSE;
+                        }
+
+                        (acpSpan[StatementExpressionStartSpan])++;
+                    }
+                    else
+                    {
+                        //No more operand characters left so fill the field with
+                        //white spaces.
+                        strncat(caSource, " ", 1);
+                        iCounter++;
+                    }
+                }
+            }
+            else if(acpSpan[StartOfCommentSpan] != NULL)
+            {
+                //There are no operands but there is a comment on the line.  We
+                //need to fill the operand field with spaces to align the comment
+                //text at the start of the comment field.  Loop until all the
+                //field has been filled or we run out of room in the string.
+                iCounter = 0;
+                iLength = strlen(caSource);
+                while(iCounter < pListing->m_iLargestOperandLength && (iLength + iCounter) < (sizeof(caSource) - NULL_TERMINATING_BYTE_LENGTH))
+                {
+                    strncat(caSource, " ", 1);
+                    iCounter++;
+                }
+            }
+
+            //Check if there is a comment at the end of the line.
+            if(acpSpan[StartOfCommentSpan] != NULL)
+            {
+                //Calculate how much of it will fit in the remaining space of the
+                //string.
+                iCounter = bmc_min((sizeof(caSource) - NULL_TERMINATING_BYTE_LENGTH) - strlen(caSource), (size_t)(acpSpan[EndOfCommentSpan] - acpSpan[StartOfCommentSpan] + 1));
+                strncat(caSource, acpSpan[StartOfCommentSpan], iCounter);
+            }
+        }
+    }
+
+    //Assemble the listing line.
+    snprintf(caListing, sizeof(caListing), "%-*s%-*s%-*s%s", LISTING_FILE_LINE_FIELD_LENGTH, caLineNumber, LISTING_FILE_LC_FIELD_LENGTH, caLocationCounter, LISTING_FILE_OBJECT_CODE_FIELD_LENGTH, caObjectCode, caSource);
+
+    iFunctionReturnValue = add_listing_block_text(pBlock, caListing);
+    if(iFunctionReturnValue != EXIT_SUCCESS)
+        return iFunctionReturnValue;
+
+    //Check if there is still more object code.  This can happen with the BYTE
+    //directive and a list of numbers greater than four, and with the FILL and
+    //WORD directives.
+    while(iObjectCodeIndex < pLine->m_iObjectCodeLength)
+    {
+        //Create the location counter field.
+        snprintf(caLocationCounter, sizeof(caLocationCounter), "%0*X", LISTING_FILE_LC_MAX_CHARACTERS, pLine->m_iLocationCounter + iObjectCodeIndex);
+
+        //Up to three bytes can fit in the object code field.
+        caObjectCode[0] = '\0';
+        for(iCounter = 0; iCounter < LISTING_FILE_OBJECT_CODE_BYTES_PER_FIELD && iObjectCodeIndex < pLine->m_iObjectCodeLength; iCounter++)
+        {
+            snprintf(caObjectCodeByte, sizeof(caObjectCodeByte), "%02X ", (uint8_t)(cpObjectCode[iObjectCodeIndex]));
+            strcat(caObjectCode, caObjectCodeByte);
+            iObjectCodeIndex++;
+        }
+
+        //Assemble the listing line with only the line, location counter, and
+        //object code fields.
+        snprintf(caListing, sizeof(caListing), "%-*s%-*s%-*s", LISTING_FILE_LINE_FIELD_LENGTH, caLineNumber, LISTING_FILE_LC_FIELD_LENGTH, caLocationCounter, LISTING_FILE_OBJECT_CODE_FIELD_LENGTH, caObjectCode);
+
+        iFunctionReturnValue = add_listing_block_text(pBlock, caListing);
+        if(iFunctionReturnValue != EXIT_SUCCESS)
+            return iFunctionReturnValue;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  add_listing_block_text
+ * Function Description:  Removes any unneeded trailing white spaces from a
+ *                        listing line and adds it, with its line ending, to the
+ *                        end of the block's text.
+ * Parameters:
+ * pBlock - Pointer to the block.
+ * cpText - The listing line.  The trailing white spaces are removed in place.
+ * Returns:  Zero for success and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+static int add_listing_block_text(ListingBlock* pBlock, char* cpText)
+{
+    char* cpNewText;
+
+    size_t iLength;
+    size_t iNewTextSize;
+
+    //Remove any unneeded trailing white spaces from the listing line.
+    iLength = strlen(cpText);
+    while(iLength != 0 && isspace(cpText[iLength - 1]) != 0)
+        iLength--;
+
+    //Two more for the line ending the listing file gets.
+    if(pBlock->m_iTextSize - pBlock->m_iTextUsed < iLength + 2)
+    {
+        iNewTextSize = (pBlock->m_iTextSize == 0) ? LISTING_TEXT_INITIAL_SIZE : pBlock->m_iTextSize * 2;
+        while(iNewTextSize - pBlock->m_iTextUsed < iLength + 2)
+            iNewTextSize *= 2;
+
+        cpNewText = realloc(pBlock->m_cpText, iNewTextSize);
+        if(cpNewText == NULL)
+        {
+            print_error(__func__, MallocReturnedNull);
+            return -MallocReturnedNull;
+        }
+
+        pBlock->m_cpText = cpNewText;
+        pBlock->m_iTextSize = iNewTextSize;
+    }
+
+    memcpy(pBlock->m_cpText + pBlock->m_iTextUsed, cpText, iLength);
+    pBlock->m_iTextUsed += iLength;
+    pBlock->m_cpText[pBlock->m_iTextUsed++] = '\r';
+    pBlock->m_cpText[pBlock->m_iTextUsed++] = '\n';
+
+    return EXIT_SUCCESS;
+}
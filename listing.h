@@ -0,0 +1,121 @@
+/*
+ ********************************************************************************
+ ** Copyright (C) 2026 Donald J. Bartley <djbcoffee@gmail.com>
+ **
+ ** This source file may be used and distributed without restriction provided
+ ** that this copyright statement is not removed from the file and that any
+ ** derivative work contains the original copyright notice and the associated
+ ** disclaimer.
+ **
+ ** This source file is free software; you can redistribute it and/or modify it
+ ** under the terms of the GNU General Public License as published by the Free
+ ** Software Foundation; either version 2 of the License, or (at your option) any
+ ** later version.
+ **
+ ** This source file is distributed in the hope that it will be useful, but
+ ** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along with
+ ** this source file.  If not, see <http://www.gnu.org/licenses/> or write to the
+ ** Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ ** 02110-1301, USA.
+ ********************************************************************************
+ ** File: nanocore-as/src/listing.h
+ **
+ ** Description:
+ ** Header file that goes with listing.c
+ ********************************************************************************
+ ** Version 1.0.0
+ ********************************************************************************
+ */
+
+#ifndef ___LISTING_H___
+#define ___LISTING_H___
+
+//------------------------------------------------------------------------------
+//Defines
+#define LISTING_LINES_INITIAL_CAPACITY  (1024)
+#define LISTING_POOL_INITIAL_SIZE       (65536)
+#define LISTING_TEXT_INITIAL_SIZE       (65536)
+
+#define LISTING_BLOCK_LINES             (16384)
+#define LISTING_MAX_BLOCKS              (64)
+
+//------------------------------------------------------------------------------
+//Enumerations
+enum ListingSpans
+{
+    StartOfLabelSpan = 0,       //Must start at zero to match first index of array.
+    StartOfStatementSpan,
+    EndOfStatementSpan,
+    StartOfCommentSpan,
+    EndOfCommentSpan,
+    StatementSymbolStartSpan,
+    StatementSymbolEndSpan,
+    StatementMnemonicStartSpan,
+    StatementMnemonicEndSpan,
+    StatementExpressionStartSpan,
+    NumberOfListingSpans
+};
+
+//------------------------------------------------------------------------------
+//Structures
+//A source line assembled by pass two.  The pool holds the text of the line, as
+//the lexer left it, at m_iTextOffset and the object code of the line at
+//m_iObjectCodeOffset.  Span offsets are one more than the offset into the line,
+//zero meaning the span isn't there.
+typedef struct tagListingLine
+{
+    uint32_t m_iSourceLineNumber;
+    uint32_t m_iLocationCounter;
+    uint32_t m_iTextOffset;
+    uint32_t m_iTextLength;
+    uint32_t m_iObjectCodeOffset;
+    uint32_t m_iObjectCodeLength;
+    uint32_t m_iaSpanOffset[NumberOfListingSpans];
+} ListingLine;
+
+//A run of listing lines formatted by a thread of its own.  The text is the
+//formatted lines, line endings included, ready for the listing file.  The line
+//is where the text of the line being formatted is copied so it can be changed.
+typedef struct tagListingBlock
+{
+    AssemblerContext* m_pContext;
+    HANDLE m_hThread;
+    uint32_t m_iFirstLine;
+    uint32_t m_iEndLine;
+    char* m_cpText;
+    size_t m_iTextSize;
+    size_t m_iTextUsed;
+    char* m_cpLine;
+    uint32_t m_iLineSize;
+    int m_iReturnValue;
+} ListingBlock;
+
+//The listing lines of one assembly.  The field lengths are those of the symbol
+//and operand fields when the lines are formatted.
+typedef struct tagListingContext
+{
+    ListingLine* m_pLines;
+    uint32_t m_iNumberOfLines;
+    uint32_t m_iLinesCapacity;
+
+    char* m_cpPool;
+    uint32_t m_iPoolSize;
+    uint32_t m_iPoolUsed;
+
+    uint32_t m_iLargestSymbolLength;
+    uint32_t m_iLargestOperandLength;
+} ListingContext;
+
+//------------------------------------------------------------------------------
+//Prototypes
+void reset_listing(AssemblerContext* pContext);
+int add_listing_line(AssemblerContext* pContext, const ListingLine* pLine, const char* cpText, const int16_t* ipObjectCode);
+int append_listing_lines(AssemblerContext* pContext, AssemblerContext* pOtherContext);
+int write_listing_lines(AssemblerContext* pContext, uint32_t iLargestSymbolLength, uint32_t iLargestOperandLength);
+void free_listing_memory(AssemblerContext* pContext);
+
+#endif /*___LISTING_H___*/
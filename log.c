@@ -44,6 +44,9 @@
 #ifndef _STDINT_H
 #include <stdint.h>
 #endif
+#ifndef _STDARG_H
+#include <stdarg.h>
+#endif
 
 //Project-wide #includes
 #ifndef ___UNIVERSAL_H___
@@ -51,7 +54,9 @@
 #endif
 
 //Project #includes
-//None
+#ifndef ___FILES_H___
+#include "files.h"
+#endif
 
 //Reflective #includes
 #ifndef ___LOG_H___
@@ -101,9 +106,34 @@ static const char* s_cpaErrorMessage[] =
     "expression number stack empty",
     "right bracket expected syntax error",
     "specified addressing mode not supported by this instruction",
-    "an attempt was made to move the location counter backwards"
+    "an attempt was made to move the location counter backwards",
+    "number exceeds maximum value error",
+    "unknown max errors option command line argument",
+    "divide by zero error",
+    "symbol value could not be resolved error",
+    "circular symbol definition error",
+    "unknown direct page option command line argument",
+    "instruction sizes did not settle error",
+    "could not read response file",
+    "expression was not compiled in pass one error",
+    "expression needs the lines before its chunk error",
+    "could not create or use the server pipe",
+    "could not connect to the server",
+    "the server request is malformed",
+    "could not read the build manifest or a line of it is malformed",
+    "a module depends on a file that is not a module of the build",
+    "modules of the build depend on each other",
+    "a module it depends on was not assembled",
+    "could not watch the source files for changes"
 };
 
+//Each thread has its own copy so one thread can stop printing errors without
+//hiding those of the others.
+static __thread uint8_t s_bIsErrorOutputMuted = FALSE;
+
+//The buffer the messages of the thread go to instead of stdout, or NULL.
+static __thread MemoryBuffer* s_pMessageBuffer = NULL;
+
 //------------------------------------------------------------------------------
 //Static Prototypes
 //None
@@ -121,5 +151,84 @@ static const char* s_cpaErrorMessage[] =
 ------------------------------------------------------------------------------*/
 void print_error(const char* cpFunction, uint8_t iErrorNumber)
 {
-    printf("ERROR:  In function %s() %s.\n", cpFunction, s_cpaErrorMessage[iErrorNumber]);
+    if(s_bIsErrorOutputMuted == TRUE)
+        return;
+
+    print_message("ERROR:  In function %s() %s.\n", cpFunction, s_cpaErrorMessage[iErrorNumber]);
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  print_message
+ * Function Description:  Prints a message of the assembly to stdout, or adds it
+ *                        to the message buffer of the calling thread if there
+ *                        is one.
+ * Parameters:
+ * cpFormat - The printf() format of the message.
+ * ... - The values for the format.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+void print_message(const char* cpFormat, ...)
+{
+    int iLength;
+
+    va_list arguments;
+
+    va_start(arguments, cpFormat);
+    if(s_pMessageBuffer == NULL)
+    {
+        vprintf(cpFormat, arguments);
+        va_end(arguments);
+        return;
+    }
+
+    iLength = vsnprintf(NULL, 0, cpFormat, arguments);
+    va_end(arguments);
+
+    //A message that doesn't fit is lost, there is nowhere else to report it.
+    if(iLength <= 0 || reserve_memory_buffer(s_pMessageBuffer, s_pMessageBuffer->m_iLength + iLength) != EXIT_SUCCESS)
+        return;
+
+    va_start(arguments, cpFormat);
+    vsnprintf(s_pMessageBuffer->m_cpData + s_pMessageBuffer->m_iLength, iLength + NULL_TERMINATING_BYTE_LENGTH, cpFormat, arguments);
+    va_end(arguments);
+
+    s_pMessageBuffer->m_iLength += iLength;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  mute_error_output
+ * Function Description:  Stops or starts the printing of error messages by the
+ *                        calling thread.
+ * Parameters:
+ * bIsMuted - TRUE to stop printing errors and FALSE to start again.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+void mute_error_output(uint8_t bIsMuted)
+{
+    s_bIsErrorOutputMuted = bIsMuted;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  is_error_output_muted
+ * Function Description:  Getter function for the error output of the calling
+ *                        thread.
+ * Parameters:  None.
+ * Returns:  TRUE if the thread doesn't print errors, otherwise FALSE.
+------------------------------------------------------------------------------*/
+uint8_t is_error_output_muted(void)
+{
+    return s_bIsErrorOutputMuted;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  redirect_message_output
+ * Function Description:  Has the messages printed by the calling thread added
+ *                        to a memory buffer instead of printed to stdout.
+ * Parameters:
+ * pBuffer - Pointer to the buffer, or NULL to print to stdout again.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+void redirect_message_output(MemoryBuffer* pBuffer)
+{
+    s_pMessageBuffer = pBuffer;
 }
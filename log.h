@@ -51,5 +51,9 @@
 //------------------------------------------------------------------------------
 //Prototypes
 void print_error(const char* cpFunction, uint8_t iErrorNumber);
+void print_message(const char* cpFormat, ...);
+void mute_error_output(uint8_t bIsMuted);
+uint8_t is_error_output_muted(void);
+void redirect_message_output(MemoryBuffer* pBuffer);
 
 #endif /*___LOG_H___*/
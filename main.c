@@ -60,12 +60,30 @@
 #ifndef ___BSTREE_H___
 #include "bstree.h"
 #endif
+#ifndef ___BUILD_H___
+#include "build.h"
+#endif
+#ifndef ___CONTEXT_H___
+#include "context.h"
+#endif
+#ifndef ___EXPRESSION_H___
+#include "expression.h"
+#endif
 #ifndef ___FILES_H___
 #include "files.h"
 #endif
+#ifndef ___LAYOUT_H___
+#include "layout.h"
+#endif
 #ifndef ___LEXER_H___
 #include "lexer.h"
 #endif
+#ifndef ___SERVER_H___
+#include "server.h"
+#endif
+#ifndef ___WATCH_H___
+#include "watch.h"
+#endif
 
 //Reflective #includes
 #ifndef ___MAIN_H___
@@ -103,10 +121,17 @@ int main(int argc, char* argv[])
     if(iReturnValue == EXIT_SUCCESS)
     {
         //All arguments have been processed successfully so we can start the
-        //assembly.
-        iReturnValue = do_assembly();
-        if(iReturnValue == EXIT_SUCCESS)
-            printf("Assembly successful.\n");
+        //assembly, here or in the server.
+        if(get_serve_pipe_name() != NULL)
+            iReturnValue = run_server(get_serve_pipe_name());
+        else if(get_connect_pipe_name() != NULL)
+            iReturnValue = run_client(get_connect_pipe_name(), argc, argv);
+        else if(get_build_manifest_name() != NULL)
+            iReturnValue = run_build(get_build_manifest_name());
+        else if(is_watch_enabled() == TRUE)
+            iReturnValue = run_watch();
+        else
+            iReturnValue = assemble_source_files();
     }
     else if(iReturnValue == 1)
     {
@@ -119,11 +144,5 @@ int main(int argc, char* argv[])
     //unit.
     free_argument_memory();
 
-    //Free all allocated memory from the lexer translation (compilation) unit.
-    free_lexer_memory();
-
-    //Close all open files from the files translation (compilation) unit.
-    close_all_files();
-
     return iReturnValue;
 }
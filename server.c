@@ -0,0 +1,596 @@
+/*
+ ********************************************************************************
+ ** Copyright (C) 2026 Donald J. Bartley <djbcoffee@gmail.com>
+ **
+ ** This source file may be used and distributed without restriction provided
+ ** that this copyright statement is not removed from the file and that any
+ ** derivative work contains the original copyright notice and the associated
+ ** disclaimer.
+ **
+ ** This source file is free software; you can redistribute it and/or modify it
+ ** under the terms of the GNU General Public License as published by the Free
+ ** Software Foundation; either version 2 of the License, or (at your option) any
+ ** later version.
+ **
+ ** This source file is distributed in the hope that it will be useful, but
+ ** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along with
+ ** this source file.  If not, see <http://www.gnu.org/licenses/> or write to the
+ ** Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ ** 02110-1301, USA.
+ ********************************************************************************
+ ** File: nanocore-as/src/server.c
+ **
+ ** Description:
+ ** This translation (compilation) unit contains the assembly server and its
+ ** client.  The server stays resident and waits on a named pipe for command
+ ** lines to assemble.  The client passes its working directory and command line
+ ** to the server, and passes the output of the assembly and its exit value back
+ ** to whoever started the client, so it can be used in place of the assembler.
+ ********************************************************************************
+ ** Version 1.0.0
+ ********************************************************************************
+ */
+
+//System #includes
+#ifndef _WINDOWS_H
+#include <windows.h>
+#endif
+#ifndef _STDIO_H
+#include <stdio.h>
+#endif
+#ifndef _STDINT_H
+#include <stdint.h>
+#endif
+#ifndef _STDLIB_H
+#include <stdlib.h>
+#endif
+#ifndef _STRING_H
+#include <string.h>
+#endif
+#ifndef _IO_H_
+#include <io.h>
+#endif
+#ifndef _FCNTL_H_
+#include <fcntl.h>
+#endif
+#ifndef _DIRECT_H_
+#include <direct.h>
+#endif
+
+//Windows XP headers don't have this flag, the pipe is still made but remote
+//clients aren't turned away there.
+#ifndef PIPE_REJECT_REMOTE_CLIENTS
+#define PIPE_REJECT_REMOTE_CLIENTS      (0x00000008)
+#endif
+
+//Project-wide #includes
+#ifndef ___UNIVERSAL_H___
+#include "universal.h"
+#endif
+
+//Project #includes
+#ifndef ___ARGUMENTS_H___
+#include "arguments.h"
+#endif
+#ifndef ___BUILD_H___
+#include "build.h"
+#endif
+#ifndef ___LOG_H___
+#include "log.h"
+#endif
+
+//Reflective #includes
+#ifndef ___SERVER_H___
+#include "server.h"
+#endif
+
+//------------------------------------------------------------------------------
+//Global Data
+//None
+
+//------------------------------------------------------------------------------
+//Static Data
+//None
+
+//------------------------------------------------------------------------------
+//Static Prototypes
+static int create_pipe_security(SECURITY_ATTRIBUTES* pSecurityAttributes, SECURITY_DESCRIPTOR* pSecurityDescriptor, PACL* ppAcl);
+static int serve_request(HANDLE hPipe);
+static int assemble_request(int iArgc, char* acpArgv[]);
+static int read_from_pipe(HANDLE hPipe, void* vpData, size_t iLength);
+static int write_to_pipe(HANDLE hPipe, const void* vpData, size_t iLength);
+
+//==============================================================================
+//Functions
+/*------------------------------------------------------------------------------
+ * Function name:  run_server
+ * Function Description:  Waits on a named pipe for clients and assembles the
+ *                        command line of each one.  Clients are served one at a
+ *                        time, a client that comes while another is being
+ *                        served waits for its turn.  Only the user running
+ *                        the server on this computer may connect, since a
+ *                        request can have files written anywhere that user
+ *                        can write.  The server runs until it is ended.
+ * Parameters:
+ * cpPipeName - The name of the pipe without the pipe prefix.
+ * Returns:  A negative number if the pipe can't be created.
+------------------------------------------------------------------------------*/
+int run_server(const char* cpPipeName)
+{
+    char caPipe[MAX_PATH + NULL_TERMINATING_BYTE_LENGTH];
+
+    int iReturnValue;
+
+    HANDLE hPipe;
+
+    SECURITY_ATTRIBUTES securityAttributes;
+    SECURITY_DESCRIPTOR securityDescriptor;
+    PACL pAcl;
+
+    iReturnValue = create_pipe_security(&securityAttributes, &securityDescriptor, &pAcl);
+    if(iReturnValue < EXIT_SUCCESS)
+        return iReturnValue;
+
+    //The pipe must be the first one of its name so that its security is the
+    //one given here and not that of a pipe someone else made beforehand.
+    snprintf(caPipe, sizeof(caPipe), "%s%s", SERVER_PIPE_PREFIX, cpPipeName);
+    hPipe = CreateNamedPipeA(caPipe, PIPE_ACCESS_DUPLEX | FILE_FLAG_FIRST_PIPE_INSTANCE, PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS, 1, SERVER_PIPE_BUFFER_SIZE, SERVER_PIPE_BUFFER_SIZE, 0, &securityAttributes);
+    if(hPipe == INVALID_HANDLE_VALUE)
+    {
+        free(pAcl);
+        print_error(__func__, ServerPipeError);
+        return -ServerPipeError;
+    }
+
+    printf("Serving assemblies on %s.\n", caPipe);
+    fflush(stdout);
+
+    for(;;)
+    {
+        //A client may have connected between the pipe being created and the
+        //wait, which still counts as connected.
+        if(ConnectNamedPipe(hPipe, NULL) != 0 || GetLastError() == ERROR_PIPE_CONNECTED)
+        {
+            serve_request(hPipe);
+            FlushFileBuffers(hPipe);
+        }
+
+        DisconnectNamedPipe(hPipe);
+    }
+
+    CloseHandle(hPipe);
+    free(pAcl);
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  run_client
+ * Function Description:  Has the server assemble a command line.  The output of
+ *                        the assembly is printed as it comes.
+ * Parameters:
+ * cpPipeName - The name of the server's pipe without the pipe prefix.
+ * iArgc - Number of arguments passed to the program.
+ * acpArgv - Array of character pointers passed to the program.
+ * Returns:  The exit value of the assembly, or a negative number if the server
+ *           can't be reached.
+------------------------------------------------------------------------------*/
+int run_client(const char* cpPipeName, int iArgc, char* acpArgv[])
+{
+    char caPipe[MAX_PATH + NULL_TERMINATING_BYTE_LENGTH];
+    char caWorkingDirectory[MAX_PATH + NULL_TERMINATING_BYTE_LENGTH];
+    char caOutput[SERVER_PIPE_BUFFER_SIZE];
+    char* cpRequest;
+    char* cpEndOfOutput;
+
+    uint8_t bIsOutputDone;
+
+    int iIndex;
+    int iReturnValue;
+
+    int32_t iExitValue;
+
+    uint32_t iRequestLength;
+    uint32_t iExitValueLength;
+    uint32_t iLength;
+
+    size_t iRequestUsed;
+
+    DWORD iBytesRead;
+
+    HANDLE hPipe;
+
+    snprintf(caPipe, sizeof(caPipe), "%s%s", SERVER_PIPE_PREFIX, cpPipeName);
+    if(_getcwd(caWorkingDirectory, sizeof(caWorkingDirectory)) == NULL)
+    {
+        print_error(__func__, ServerRequestError);
+        return -ServerRequestError;
+    }
+
+    //The request is its length followed by the working directory and the
+    //arguments, each with its NULL terminator.  The program name isn't passed.
+    iRequestLength = (uint32_t)(strlen(caWorkingDirectory) + NULL_TERMINATING_BYTE_LENGTH);
+    for(iIndex = 1; iIndex < iArgc; iIndex++)
+        iRequestLength += (uint32_t)(strlen(acpArgv[iIndex]) + NULL_TERMINATING_BYTE_LENGTH);
+
+    if(iRequestLength > SERVER_MAX_REQUEST_SIZE)
+    {
+        print_error(__func__, ServerRequestError);
+        return -ServerRequestError;
+    }
+
+    cpRequest = malloc(sizeof(iRequestLength) + iRequestLength);
+    if(cpRequest == NULL)
+    {
+        print_error(__func__, MallocReturnedNull);
+        return -MallocReturnedNull;
+    }
+
+    memcpy(cpRequest, &iRequestLength, sizeof(iRequestLength));
+    iRequestUsed = sizeof(iRequestLength);
+    strcpy(cpRequest + iRequestUsed, caWorkingDirectory);
+    iRequestUsed += strlen(caWorkingDirectory) + NULL_TERMINATING_BYTE_LENGTH;
+    for(iIndex = 1; iIndex < iArgc; iIndex++)
+    {
+        strcpy(cpRequest + iRequestUsed, acpArgv[iIndex]);
+        iRequestUsed += strlen(acpArgv[iIndex]) + NULL_TERMINATING_BYTE_LENGTH;
+    }
+
+    //Connect to the server, waiting for it if it is serving another client.
+    for(;;)
+    {
+        hPipe = CreateFileA(caPipe, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, NULL);
+        if(hPipe != INVALID_HANDLE_VALUE)
+            break;
+
+        if(GetLastError() != ERROR_PIPE_BUSY || WaitNamedPipeA(caPipe, NMPWAIT_WAIT_FOREVER) == 0)
+        {
+            free(cpRequest);
+            print_error(__func__, ServerConnectError);
+            return -ServerConnectError;
+        }
+    }
+
+    iReturnValue = write_to_pipe(hPipe, cpRequest, iRequestUsed);
+    free(cpRequest);
+
+    //Print the output until its end is reached, the exit value follows it.
+    bIsOutputDone = FALSE;
+    iExitValue = 0;
+    iExitValueLength = 0;
+    while(iReturnValue == EXIT_SUCCESS && iExitValueLength < sizeof(iExitValue))
+    {
+        if(ReadFile(hPipe, caOutput, sizeof(caOutput), &iBytesRead, NULL) == 0 || iBytesRead == 0)
+        {
+            print_error(__func__, ServerConnectError);
+            iReturnValue = -ServerConnectError;
+            break;
+        }
+
+        iLength = 0;
+        if(bIsOutputDone == FALSE)
+        {
+            cpEndOfOutput = memchr(caOutput, SERVER_END_OF_OUTPUT, iBytesRead);
+            iLength = (cpEndOfOutput != NULL) ? (uint32_t)(cpEndOfOutput - caOutput) : (uint32_t)iBytesRead;
+            fwrite(caOutput, 1, iLength, stdout);
+            if(cpEndOfOutput == NULL)
+                continue;
+
+            bIsOutputDone = TRUE;
+            iLength++;
+        }
+
+        while(iLength < iBytesRead && iExitValueLength < sizeof(iExitValue))
+            ((char*)&iExitValue)[iExitValueLength++] = caOutput[iLength++];
+    }
+
+    fflush(stdout);
+    CloseHandle(hPipe);
+
+    return (iReturnValue == EXIT_SUCCESS) ? (int)iExitValue : iReturnValue;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  create_pipe_security
+ * Function Description:  Makes the security for the server's pipe.  Its access
+ *                        list has one entry which lets the user the server runs
+ *                        as use the pipe, so no one else can connect to it.
+ * Parameters:
+ * pSecurityAttributes - The security attributes to fill in for the pipe.
+ * pSecurityDescriptor - The security descriptor the attributes point to.
+ * ppAcl - Set to the access list the descriptor points to.  It must be freed
+ *         once the pipe is closed.
+ * Returns:  Zero for success and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+static int create_pipe_security(SECURITY_ATTRIBUTES* pSecurityAttributes, SECURITY_DESCRIPTOR* pSecurityDescriptor, PACL* ppAcl)
+{
+    uint8_t bIsMade;
+
+    DWORD iTokenUserLength;
+    DWORD iAclLength;
+
+    HANDLE hToken;
+
+    TOKEN_USER* pTokenUser;
+
+    *ppAcl = NULL;
+    if(OpenProcessToken(GetCurrentProcess(), TOKEN_QUERY, &hToken) == 0)
+    {
+        print_error(__func__, ServerPipeError);
+        return -ServerPipeError;
+    }
+
+    //The first call only gets the length of the user's information.
+    iTokenUserLength = 0;
+    GetTokenInformation(hToken, TokenUser, NULL, 0, &iTokenUserLength);
+    pTokenUser = malloc(iTokenUserLength);
+    if(pTokenUser == NULL)
+    {
+        CloseHandle(hToken);
+        print_error(__func__, MallocReturnedNull);
+        return -MallocReturnedNull;
+    }
+
+    bIsMade = FALSE;
+    if(GetTokenInformation(hToken, TokenUser, pTokenUser, iTokenUserLength, &iTokenUserLength) != 0)
+    {
+        //The entry's SID takes the place of its last field.
+        iAclLength = sizeof(ACL) + sizeof(ACCESS_ALLOWED_ACE) - sizeof(DWORD) + GetLengthSid(pTokenUser->User.Sid);
+        *ppAcl = malloc(iAclLength);
+        if(*ppAcl != NULL &&
+           InitializeAcl(*ppAcl, iAclLength, ACL_REVISION) != 0 &&
+           AddAccessAllowedAce(*ppAcl, ACL_REVISION, GENERIC_ALL, pTokenUser->User.Sid) != 0 &&
+           InitializeSecurityDescriptor(pSecurityDescriptor, SECURITY_DESCRIPTOR_REVISION) != 0 &&
+           SetSecurityDescriptorDacl(pSecurityDescriptor, TRUE, *ppAcl, FALSE) != 0)
+            bIsMade = TRUE;
+    }
+
+    free(pTokenUser);
+    CloseHandle(hToken);
+
+    if(bIsMade == FALSE)
+    {
+        free(*ppAcl);
+        *ppAcl = NULL;
+        print_error(__func__, ServerPipeError);
+        return -ServerPipeError;
+    }
+
+    pSecurityAttributes->nLength = sizeof(SECURITY_ATTRIBUTES);
+    pSecurityAttributes->lpSecurityDescriptor = pSecurityDescriptor;
+    pSecurityAttributes->bInheritHandle = FALSE;
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  serve_request
+ * Function Description:  Reads the request of a client and assembles it in the
+ *                        client's working directory.  While the request is
+ *                        assembled everything printed goes to the client.
+ * Parameters:
+ * hPipe - Handle of the pipe connected to the client.
+ * Returns:  Zero for success and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+static int serve_request(HANDLE hPipe)
+{
+    char caWorkingDirectory[MAX_PATH + NULL_TERMINATING_BYTE_LENGTH];
+    char caEndOfOutput[sizeof(char) + sizeof(int32_t)];
+    char* cpRequest;
+    char* cpString;
+    char* cpEnd;
+    char** cppArgv;
+
+    int iArgc;
+    int iReturnValue;
+    int iSavedOutput;
+    int iPipeOutput;
+
+    int32_t iExitValue;
+
+    uint32_t iRequestLength;
+
+    HANDLE hOutput;
+
+    iReturnValue = read_from_pipe(hPipe, &iRequestLength, sizeof(iRequestLength));
+    if(iReturnValue != EXIT_SUCCESS)
+        return iReturnValue;
+
+    if(iRequestLength == 0 || iRequestLength > SERVER_MAX_REQUEST_SIZE)
+    {
+        print_error(__func__, ServerRequestError);
+        return -ServerRequestError;
+    }
+
+    //An extra NULL terminator makes sure the last string has one.
+    cpRequest = malloc(iRequestLength + NULL_TERMINATING_BYTE_LENGTH);
+    if(cpRequest == NULL)
+    {
+        print_error(__func__, MallocReturnedNull);
+        return -MallocReturnedNull;
+    }
+
+    iReturnValue = read_from_pipe(hPipe, cpRequest, iRequestLength);
+    if(iReturnValue != EXIT_SUCCESS)
+    {
+        free(cpRequest);
+        return iReturnValue;
+    }
+
+    cpRequest[iRequestLength] = '\0';
+    cpEnd = cpRequest + iRequestLength;
+
+    //The working directory takes the place of the program name when the
+    //arguments are counted.
+    iArgc = 0;
+    for(cpString = cpRequest; cpString < cpEnd; cpString += strlen(cpString) + NULL_TERMINATING_BYTE_LENGTH)
+        iArgc++;
+
+    cppArgv = malloc((iArgc + 1) * sizeof(char*));
+    if(cppArgv == NULL)
+    {
+        free(cpRequest);
+        print_error(__func__, MallocReturnedNull);
+        return -MallocReturnedNull;
+    }
+
+    cppArgv[0] = SERVER_PROGRAM_NAME;
+    iArgc = 1;
+    for(cpString = cpRequest + strlen(cpRequest) + NULL_TERMINATING_BYTE_LENGTH; cpString < cpEnd; cpString += strlen(cpString) + NULL_TERMINATING_BYTE_LENGTH)
+        cppArgv[iArgc++] = cpString;
+
+    cppArgv[iArgc] = NULL;
+
+    //Move to the client's working directory and send the output to the client.
+    iSavedOutput = -1;
+    iPipeOutput = -1;
+    if(_getcwd(caWorkingDirectory, sizeof(caWorkingDirectory)) != NULL && _chdir(cpRequest) == 0)
+    {
+        fflush(stdout);
+        iSavedOutput = _dup(_fileno(stdout));
+        if(iSavedOutput != -1 && DuplicateHandle(GetCurrentProcess(), hPipe, GetCurrentProcess(), &hOutput, 0, FALSE, DUPLICATE_SAME_ACCESS) != 0)
+        {
+            iPipeOutput = _open_osfhandle((intptr_t)hOutput, _O_WRONLY | _O_BINARY);
+            if(iPipeOutput == -1)
+                CloseHandle(hOutput);
+        }
+
+        if(iPipeOutput != -1 && _dup2(iPipeOutput, _fileno(stdout)) == 0)
+        {
+            iExitValue = (int32_t)assemble_request(iArgc, cppArgv);
+
+            fflush(stdout);
+            _dup2(iSavedOutput, _fileno(stdout));
+        }
+        else
+        {
+            print_error(__func__, ServerPipeError);
+            iExitValue = -ServerPipeError;
+        }
+
+        if(iPipeOutput != -1)
+            _close(iPipeOutput);
+        if(iSavedOutput != -1)
+            _close(iSavedOutput);
+
+        _chdir(caWorkingDirectory);
+    }
+    else
+    {
+        print_error(__func__, ServerRequestError);
+        iExitValue = -ServerRequestError;
+    }
+
+    free(cppArgv);
+    free(cpRequest);
+
+    //Let the client know the output is done and how the assembly went.
+    caEndOfOutput[0] = SERVER_END_OF_OUTPUT;
+    memcpy(&caEndOfOutput[1], &iExitValue, sizeof(iExitValue));
+
+    return write_to_pipe(hPipe, caEndOfOutput, sizeof(caEndOfOutput));
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  assemble_request
+ * Function Description:  Assembles the command line of a client the same way
+ *                        the command line of the program is assembled.
+ * Parameters:
+ * iArgc - Number of arguments.
+ * acpArgv - Array of character pointers to the arguments.
+ * Returns:  The exit value of the assembly.
+------------------------------------------------------------------------------*/
+static int assemble_request(int iArgc, char* acpArgv[])
+{
+    int iReturnValue;
+
+    iReturnValue = process_arguments(iArgc, acpArgv);
+    if(iReturnValue == EXIT_SUCCESS)
+    {
+        //A client can't start a server of its own, or have the server watch
+        //its files.
+        if(get_serve_pipe_name() != NULL || is_watch_enabled() == TRUE)
+        {
+            print_error(__func__, MalformedCommandLine);
+            iReturnValue = -MalformedCommandLine;
+        }
+        else if(get_build_manifest_name() != NULL)
+        {
+            iReturnValue = run_build(get_build_manifest_name());
+        }
+        else
+        {
+            iReturnValue = assemble_source_files();
+        }
+    }
+    else if(iReturnValue == 1)
+    {
+        //Help was requested.  This is not an error so set the return value to
+        //zero.
+        iReturnValue = 0;
+    }
+
+    free_argument_memory();
+
+    return iReturnValue;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  read_from_pipe
+ * Function Description:  Reads an exact number of bytes from a pipe.
+ * Parameters:
+ * hPipe - Handle of the pipe.
+ * vpData - Pointer to where the bytes are put.
+ * iLength - The number of bytes to read.
+ * Returns:  Zero for success and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+static int read_from_pipe(HANDLE hPipe, void* vpData, size_t iLength)
+{
+    DWORD iBytesRead;
+
+    while(iLength != 0)
+    {
+        if(ReadFile(hPipe, vpData, (DWORD)iLength, &iBytesRead, NULL) == 0 || iBytesRead == 0)
+        {
+            print_error(__func__, ServerPipeError);
+            return -ServerPipeError;
+        }
+
+        vpData = (char*)vpData + iBytesRead;
+        iLength -= iBytesRead;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  write_to_pipe
+ * Function Description:  Writes an exact number of bytes to a pipe.
+ * Parameters:
+ * hPipe - Handle of the pipe.
+ * vpData - Pointer to the bytes to write.
+ * iLength - The number of bytes to write.
+ * Returns:  Zero for success and a negative number if an error occurs.
+------------------------------------------------------------------------------*/
+static int write_to_pipe(HANDLE hPipe, const void* vpData, size_t iLength)
+{
+    DWORD iBytesWritten;
+
+    while(iLength != 0)
+    {
+        if(WriteFile(hPipe, vpData, (DWORD)iLength, &iBytesWritten, NULL) == 0 || iBytesWritten == 0)
+        {
+            print_error(__func__, ServerPipeError);
+            return -ServerPipeError;
+        }
+
+        vpData = (const char*)vpData + iBytesWritten;
+        iLength -= iBytesWritten;
+    }
+
+    return EXIT_SUCCESS;
+}
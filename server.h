@@ -0,0 +1,60 @@
+/*
+ ********************************************************************************
+ ** Copyright (C) 2026 Donald J. Bartley <djbcoffee@gmail.com>
+ **
+ ** This source file may be used and distributed without restriction provided
+ ** that this copyright statement is not removed from the file and that any
+ ** derivative work contains the original copyright notice and the associated
+ ** disclaimer.
+ **
+ ** This source file is free software; you can redistribute it and/or modify it
+ ** under the terms of the GNU General Public License as published by the Free
+ ** Software Foundation; either version 2 of the License, or (at your option) any
+ ** later version.
+ **
+ ** This source file is distributed in the hope that it will be useful, but
+ ** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along with
+ ** this source file.  If not, see <http://www.gnu.org/licenses/> or write to the
+ ** Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ ** 02110-1301, USA.
+ ********************************************************************************
+ ** File: nanocore-as/src/server.h
+ **
+ ** Description:
+ ** Header file that goes with server.c
+ ********************************************************************************
+ ** Version 1.0.0
+ ********************************************************************************
+ */
+
+#ifndef ___SERVER_H___
+#define ___SERVER_H___
+
+//------------------------------------------------------------------------------
+//Defines
+#define SERVER_PIPE_PREFIX              "\\\\.\\pipe\\"
+#define SERVER_PIPE_BUFFER_SIZE         (65536)
+#define SERVER_MAX_REQUEST_SIZE         (1048576)
+#define SERVER_PROGRAM_NAME             "nanocore-as.exe"
+
+//The output of a request is text so it never has this character in it.
+#define SERVER_END_OF_OUTPUT            '\0'
+
+//------------------------------------------------------------------------------
+//Enumerations
+//None
+
+//------------------------------------------------------------------------------
+//Structures
+//None
+
+//------------------------------------------------------------------------------
+//Prototypes
+int run_server(const char* cpPipeName);
+int run_client(const char* cpPipeName, int iArgc, char* acpArgv[]);
+
+#endif /*___SERVER_H___*/
@@ -49,6 +49,9 @@
 
 #define VERSION                         "VERSION 1.0.0"
 
+#define FNV_64_OFFSET_BASIS             (0xCBF29CE484222325ULL)
+#define FNV_64_PRIME                    (0x00000100000001B3ULL)
+
 //------------------------------------------------------------------------------
 //Macros
 //(void)(&_min1 == &_min2) is a guaranteed "no-op".  It forces the compiler to
@@ -118,12 +121,42 @@ enum Errors
     NumberStackEmpty,
     RightBracketExpected,
     TypeNotSupported,
-    LocationCounterBackwards
+    LocationCounterBackwards,
+    NumberOverflowError,
+    UnknownMaxErrorsOptionArgument,
+    DivideByZeroError,
+    UnresolvedSymbolError,
+    CircularSymbolError,
+    UnknownDirectPageOptionArgument,
+    LayoutNotSettledError,
+    ResponseFileError,
+    UncompiledExpressionError,
+    DetachedExpressionError,
+    ServerPipeError,
+    ServerConnectError,
+    ServerRequestError,
+    BuildManifestError,
+    UnknownBuildModuleError,
+    CircularBuildDependencyError,
+    FailedBuildDependencyError,
+    WatchError
 };
 
 //------------------------------------------------------------------------------
 //Structures
-//None
+//The assembler context is defined in context.h.  It is declared here so that
+//every header can take a pointer to one.
+typedef struct tagAssemblerContext AssemblerContext;
+
+//A block of memory that text or data is written to in place of a file or the
+//screen.  It grows as needed and is kept from one use to the next.  The data
+//always has a NULL terminating byte after it so text can be used as a string.
+typedef struct tagMemoryBuffer
+{
+    char* m_cpData;
+    size_t m_iLength;
+    size_t m_iSize;
+} MemoryBuffer;
 
 //------------------------------------------------------------------------------
 //Prototypes
@@ -0,0 +1,423 @@
+/*
+ ********************************************************************************
+ ** Copyright (C) 2026 Donald J. Bartley <djbcoffee@gmail.com>
+ **
+ ** This source file may be used and distributed without restriction provided
+ ** that this copyright statement is not removed from the file and that any
+ ** derivative work contains the original copyright notice and the associated
+ ** disclaimer.
+ **
+ ** This source file is free software; you can redistribute it and/or modify it
+ ** under the terms of the GNU General Public License as published by the Free
+ ** Software Foundation; either version 2 of the License, or (at your option) any
+ ** later version.
+ **
+ ** This source file is distributed in the hope that it will be useful, but
+ ** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along with
+ ** this source file.  If not, see <http://www.gnu.org/licenses/> or write to the
+ ** Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ ** 02110-1301, USA.
+ ********************************************************************************
+ ** File: nanocore-as/src/watch.c
+ **
+ ** Description:
+ ** This translation (compilation) unit contains the watch of the source files.
+ ** After every source file is assembled the assembler stays running, and each
+ ** time a source file is saved it is assembled again from the start, the same
+ ** as running the assembler on it again.  Nothing is kept between assemblies.
+ ********************************************************************************
+ ** Version 1.0.0
+ ********************************************************************************
+ */
+
+//System #includes
+#ifndef _WINDOWS_H
+#include <windows.h>
+#endif
+#ifndef _STDIO_H
+#include <stdio.h>
+#endif
+#ifndef _STDINT_H
+#include <stdint.h>
+#endif
+#ifndef _STDLIB_H
+#include <stdlib.h>
+#endif
+#ifndef _STRING_H
+#include <string.h>
+#endif
+#ifndef _LIMITS_H
+#include <limits.h>
+#endif
+
+//Project-wide #includes
+#ifndef ___UNIVERSAL_H___
+#include "universal.h"
+#endif
+
+//Project #includes
+#ifndef ___ARGUMENTS_H___
+#include "arguments.h"
+#endif
+#ifndef ___CONTEXT_H___
+#include "context.h"
+#endif
+#ifndef ___LEXER_H___
+#include "lexer.h"
+#endif
+#ifndef ___LOG_H___
+#include "log.h"
+#endif
+
+//Reflective #includes
+#ifndef ___WATCH_H___
+#include "watch.h"
+#endif
+
+//------------------------------------------------------------------------------
+//Global Data
+//None
+
+//------------------------------------------------------------------------------
+//Static Data
+//None
+
+//------------------------------------------------------------------------------
+//Static Prototypes
+static int create_watched_files(WatchContext* pWatch);
+static void assemble_changed_files(WatchContext* pWatch, uint8_t bIsFirstTime);
+static int assemble_watched_file(WatchContext* pWatch, uint32_t iIndex);
+static uint8_t update_watched_file(WatchedFile* pFile);
+static void start_change_notifications(WatchContext* pWatch);
+static void stop_change_notifications(WatchContext* pWatch);
+static int wait_for_changes(WatchContext* pWatch);
+static void free_watch_memory(WatchContext* pWatch);
+
+//==============================================================================
+//Functions
+/*------------------------------------------------------------------------------
+ * Function name:  run_watch
+ * Function Description:  Assembles the passed source files and then assembles
+ *                        each one again whenever it changes, until the program
+ *                        is ended.
+ * Parameters:  None.
+ * Returns:  A negative number if the files can't be watched.  It doesn't return
+ *           otherwise.
+------------------------------------------------------------------------------*/
+int run_watch(void)
+{
+    WatchContext watch;
+
+    int iReturnValue;
+
+    memset(&watch, 0, sizeof(watch));
+
+    iReturnValue = create_watched_files(&watch);
+    if(iReturnValue == EXIT_SUCCESS)
+    {
+        //Every file is assembled first, the same as without watching.
+        assemble_changed_files(&watch, TRUE);
+        start_change_notifications(&watch);
+
+        printf("\nWatching %u file(s) for changes.\n", watch.m_iNumberOfFiles);
+        fflush(stdout);
+
+        while(iReturnValue == EXIT_SUCCESS)
+        {
+            iReturnValue = wait_for_changes(&watch);
+            if(iReturnValue == EXIT_SUCCESS)
+                assemble_changed_files(&watch, FALSE);
+        }
+
+        stop_change_notifications(&watch);
+    }
+
+    free_watch_memory(&watch);
+
+    return iReturnValue;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  create_watched_files
+ * Function Description:  Sets up a watched file for each passed source file
+ *                        with the path and file name it is opened by and the
+ *                        directory it is in.
+ * Parameters:
+ * pWatch - Pointer to the watch.
+ * Returns:  Zero for success and a negative number for failure.
+------------------------------------------------------------------------------*/
+static int create_watched_files(WatchContext* pWatch)
+{
+    AssemblerContext* pContext;
+
+    WatchedFile* pFile;
+
+    const char* cpPath;
+
+    int iReturnValue;
+
+    uint32_t iIndex;
+
+    pWatch->m_iNumberOfFiles = get_number_of_source_files();
+    pWatch->m_pFiles = (WatchedFile*)calloc(pWatch->m_iNumberOfFiles, sizeof(WatchedFile));
+    if(pWatch->m_pFiles == NULL)
+    {
+        print_error(__func__, MallocReturnedNull);
+        return -MallocReturnedNull;
+    }
+
+    //The source file is split into its path and file name the same way an
+    //assembly does it.
+    pContext = create_assembler_context();
+    if(pContext == NULL)
+        return -MallocReturnedNull;
+
+    iReturnValue = EXIT_SUCCESS;
+    for(iIndex = 0; iIndex < pWatch->m_iNumberOfFiles && iReturnValue == EXIT_SUCCESS; iIndex++)
+    {
+        iReturnValue = select_source_file(pContext, iIndex);
+        if(iReturnValue == EXIT_SUCCESS)
+        {
+            pFile = &pWatch->m_pFiles[iIndex];
+            cpPath = get_assembly_source_file_path(pContext);
+            snprintf(pFile->m_caSourceFile, sizeof(pFile->m_caSourceFile), "%s%s", cpPath, get_assembly_source_full_file_name(pContext));
+            snprintf(pFile->m_caDirectory, sizeof(pFile->m_caDirectory), "%s", (cpPath[0] != '\0') ? cpPath : ".");
+        }
+    }
+
+    free_assembler_context(pContext);
+
+    return iReturnValue;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  assemble_changed_files
+ * Function Description:  Assembles the source files that changed since they
+ *                        were last assembled.  The first time every source file
+ *                        is assembled and the output is the same as without
+ *                        watching.
+ * Parameters:
+ * pWatch - Pointer to the watch.
+ * bIsFirstTime - TRUE if the source files haven't been assembled yet.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void assemble_changed_files(WatchContext* pWatch, uint8_t bIsFirstTime)
+{
+    WatchedFile* pFile;
+
+    uint32_t iIndex;
+    uint32_t iNumberOfSuccesses;
+
+    uint8_t bIsChanged;
+
+    iNumberOfSuccesses = 0;
+    for(iIndex = 0; iIndex < pWatch->m_iNumberOfFiles; iIndex++)
+    {
+        //The time and size are taken before the file is read, so a change
+        //saved while it is being assembled is seen the next time.
+        pFile = &pWatch->m_pFiles[iIndex];
+        bIsChanged = update_watched_file(pFile);
+        if(bIsFirstTime == FALSE)
+        {
+            //A file that was removed is assembled again once it is back.
+            if(bIsChanged == FALSE || pFile->m_bDoesExist == FALSE)
+                continue;
+
+            printf("\nAssembling %s\n", get_source_file_argument(iIndex));
+        }
+        else if(pWatch->m_iNumberOfFiles > 1)
+        {
+            printf("%sAssembling %s\n", (iIndex == 0) ? "" : "\n", get_source_file_argument(iIndex));
+        }
+
+        if(assemble_watched_file(pWatch, iIndex) == EXIT_SUCCESS)
+            iNumberOfSuccesses++;
+
+        fflush(stdout);
+    }
+
+    if(bIsFirstTime == TRUE && pWatch->m_iNumberOfFiles > 1)
+        printf("\n%u of %u file(s) assembled successfully.\n", iNumberOfSuccesses, pWatch->m_iNumberOfFiles);
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  assemble_watched_file
+ * Function Description:  Assembles one of the watched source files in an
+ *                        assembler context of its own, with the lines kept
+ *                        from the last time it was assembled.
+ * Parameters:
+ * pWatch - Pointer to the watch.
+ * iIndex - The index of the source file.
+ * Returns:  Zero for success and a negative number for failure.
+------------------------------------------------------------------------------*/
+static int assemble_watched_file(WatchContext* pWatch, uint32_t iIndex)
+{
+    AssemblerContext* pContext;
+
+    int iReturnValue;
+
+    pContext = create_assembler_context();
+    if(pContext == NULL)
+        return -MallocReturnedNull;
+
+    iReturnValue = select_source_file(pContext, iIndex);
+    if(iReturnValue == EXIT_SUCCESS)
+    {
+        iReturnValue = do_assembly(pContext);
+        if(iReturnValue == EXIT_SUCCESS)
+            printf("Assembly successful.\n");
+    }
+
+    free_assembler_context(pContext);
+
+    return iReturnValue;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  update_watched_file
+ * Function Description:  Gets the last write time and size of a watched source
+ *                        file and keeps them.
+ * Parameters:
+ * pFile - Pointer to the watched file.
+ * Returns:  TRUE if the file was written, created, or removed since the last
+ *           time and FALSE otherwise.
+------------------------------------------------------------------------------*/
+static uint8_t update_watched_file(WatchedFile* pFile)
+{
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+
+    uint64_t iFileSize;
+
+    uint8_t bIsChanged;
+
+    if(GetFileAttributesExA(pFile->m_caSourceFile, GetFileExInfoStandard, &attributes) == 0)
+    {
+        bIsChanged = pFile->m_bDoesExist;
+        pFile->m_bDoesExist = FALSE;
+        return bIsChanged;
+    }
+
+    iFileSize = ((uint64_t)attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+    bIsChanged = (pFile->m_bDoesExist == FALSE || CompareFileTime(&attributes.ftLastWriteTime, &pFile->m_lastWriteTime) != 0 || iFileSize != pFile->m_iFileSize) ? TRUE : FALSE;
+
+    pFile->m_bDoesExist = TRUE;
+    pFile->m_lastWriteTime = attributes.ftLastWriteTime;
+    pFile->m_iFileSize = iFileSize;
+
+    return bIsChanged;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  start_change_notifications
+ * Function Description:  Asks to be notified of changes in the directories the
+ *                        source files are in, once for each directory.  If any
+ *                        of them can't be watched the files are checked every
+ *                        WATCH_POLL_INTERVAL milliseconds instead.
+ * Parameters:
+ * pWatch - Pointer to the watch.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void start_change_notifications(WatchContext* pWatch)
+{
+    HANDLE hNotification;
+
+    uint32_t iIndex;
+    uint32_t iEarlier;
+
+    for(iIndex = 0; iIndex < pWatch->m_iNumberOfFiles; iIndex++)
+    {
+        //Skip a directory that an earlier file is in.
+        for(iEarlier = 0; iEarlier < iIndex; iEarlier++)
+        {
+            if(strcasecmp(pWatch->m_pFiles[iEarlier].m_caDirectory, pWatch->m_pFiles[iIndex].m_caDirectory) == 0)
+                break;
+        }
+
+        if(iEarlier != iIndex)
+            continue;
+
+        hNotification = INVALID_HANDLE_VALUE;
+        if(pWatch->m_iNumberOfNotifications < MAXIMUM_WAIT_OBJECTS)
+            hNotification = FindFirstChangeNotificationA(pWatch->m_pFiles[iIndex].m_caDirectory, FALSE, FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+
+        if(hNotification == INVALID_HANDLE_VALUE)
+        {
+            stop_change_notifications(pWatch);
+            return;
+        }
+
+        pWatch->m_haNotifications[pWatch->m_iNumberOfNotifications] = hNotification;
+        pWatch->m_iNumberOfNotifications++;
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  stop_change_notifications
+ * Function Description:  Closes the change notifications of the directories.
+ * Parameters:
+ * pWatch - Pointer to the watch.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void stop_change_notifications(WatchContext* pWatch)
+{
+    uint32_t iIndex;
+
+    for(iIndex = 0; iIndex < pWatch->m_iNumberOfNotifications; iIndex++)
+        FindCloseChangeNotification(pWatch->m_haNotifications[iIndex]);
+
+    pWatch->m_iNumberOfNotifications = 0;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  wait_for_changes
+ * Function Description:  Waits until something in one of the directories
+ *                        changes, or for the poll interval when there are no
+ *                        notifications.  The change may be to another file, or
+ *                        to a listing or binary file the assembler wrote, so
+ *                        the source files still have to be checked.
+ * Parameters:
+ * pWatch - Pointer to the watch.
+ * Returns:  Zero for success and a negative number for failure.
+------------------------------------------------------------------------------*/
+static int wait_for_changes(WatchContext* pWatch)
+{
+    DWORD iWaitResult;
+
+    if(pWatch->m_iNumberOfNotifications == 0)
+    {
+        Sleep(WATCH_POLL_INTERVAL);
+        return EXIT_SUCCESS;
+    }
+
+    iWaitResult = WaitForMultipleObjects(pWatch->m_iNumberOfNotifications, pWatch->m_haNotifications, FALSE, INFINITE);
+    if(iWaitResult >= WAIT_OBJECT_0 + pWatch->m_iNumberOfNotifications || FindNextChangeNotification(pWatch->m_haNotifications[iWaitResult - WAIT_OBJECT_0]) == 0)
+    {
+        print_error(__func__, WatchError);
+        return -WatchError;
+    }
+
+    //An editor can take more than one write to save a file, give it a moment
+    //to finish.
+    Sleep(WATCH_SETTLE_INTERVAL);
+
+    return EXIT_SUCCESS;
+}
+
+/*------------------------------------------------------------------------------
+ * Function name:  free_watch_memory
+ * Function Description:  Frees the memory of the watch.
+ * Parameters:
+ * pWatch - Pointer to the watch.
+ * Returns:  None.
+------------------------------------------------------------------------------*/
+static void free_watch_memory(WatchContext* pWatch)
+{
+    if(pWatch->m_pFiles != NULL)
+        free(pWatch->m_pFiles);
+
+    memset(pWatch, 0, sizeof(WatchContext));
+}
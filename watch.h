@@ -0,0 +1,76 @@
+/*
+ ********************************************************************************
+ ** Copyright (C) 2026 Donald J. Bartley <djbcoffee@gmail.com>
+ **
+ ** This source file may be used and distributed without restriction provided
+ ** that this copyright statement is not removed from the file and that any
+ ** derivative work contains the original copyright notice and the associated
+ ** disclaimer.
+ **
+ ** This source file is free software; you can redistribute it and/or modify it
+ ** under the terms of the GNU General Public License as published by the Free
+ ** Software Foundation; either version 2 of the License, or (at your option) any
+ ** later version.
+ **
+ ** This source file is distributed in the hope that it will be useful, but
+ ** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ ** FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ ** more details.
+ **
+ ** You should have received a copy of the GNU General Public License along with
+ ** this source file.  If not, see <http://www.gnu.org/licenses/> or write to the
+ ** Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ ** 02110-1301, USA.
+ ********************************************************************************
+ ** File: nanocore-as/src/watch.h
+ **
+ ** Description:
+ ** Header file that goes with watch.c
+ ********************************************************************************
+ ** Version 1.0.0
+ ********************************************************************************
+ */
+
+#ifndef ___WATCH_H___
+#define ___WATCH_H___
+
+//------------------------------------------------------------------------------
+//Defines
+#define WATCH_POLL_INTERVAL         (500)
+#define WATCH_SETTLE_INTERVAL       (100)
+
+//------------------------------------------------------------------------------
+//Enumerations
+//None
+
+//------------------------------------------------------------------------------
+//Structures
+//A source file being watched.  The last write time and size are from when it
+//was last assembled.
+typedef struct tagWatchedFile
+{
+    char m_caSourceFile[MAX_PATH + FILENAME_MAX + NULL_TERMINATING_BYTE_LENGTH];
+    char m_caDirectory[MAX_PATH + NULL_TERMINATING_BYTE_LENGTH];
+
+    uint8_t m_bDoesExist;
+    FILETIME m_lastWriteTime;
+    uint64_t m_iFileSize;
+} WatchedFile;
+
+//The source files being watched and a change notification for each directory
+//they are in.  Without any notifications the files are checked every
+//WATCH_POLL_INTERVAL milliseconds instead.
+typedef struct tagWatchContext
+{
+    WatchedFile* m_pFiles;
+    uint32_t m_iNumberOfFiles;
+
+    HANDLE m_haNotifications[MAXIMUM_WAIT_OBJECTS];
+    uint32_t m_iNumberOfNotifications;
+} WatchContext;
+
+//------------------------------------------------------------------------------
+//Prototypes
+int run_watch(void);
+
+#endif /*___WATCH_H___*/